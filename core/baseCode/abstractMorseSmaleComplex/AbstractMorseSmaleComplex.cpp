@@ -1,6 +1,10 @@
 #include<AbstractMorseSmaleComplex.h>
 
 AbstractMorseSmaleComplex::AbstractMorseSmaleComplex():
+  UseHierarchy{},
+  HierarchyFileName{},
+  PersistenceThreshold{-1},
+  hierarchyKey_{},
   ReverveSaddleMaximumConnection{},
   ReverveSaddleSaddleConnection{},
   ComputeAscendingSeparatrices1{},
@@ -69,3 +73,92 @@ AbstractMorseSmaleComplex::AbstractMorseSmaleComplex():
 AbstractMorseSmaleComplex::~AbstractMorseSmaleComplex(){
 }
 
+
+int AbstractMorseSmaleComplex::saveHierarchy(){
+  if(HierarchyFileName.length())
+    return discreteGradient_.writeHierarchy(HierarchyFileName);
+
+  return 0;
+}
+
+int AbstractMorseSmaleComplex::replayHierarchy(){
+  // a negative threshold replays the whole hierarchy
+  int numberOfReversals=-1;
+  if(PersistenceThreshold>=0)
+    numberOfReversals=discreteGradient_.getHierarchy().getNumberOfReversals(PersistenceThreshold);
+
+  return discreteGradient_.replayHierarchy(numberOfReversals);
+}
+
+int AbstractMorseSmaleComplex::pointerJumping(vector<int>& successors){
+  // each element points to the next cell of its v-path, the roots (critical
+  // cells) point to themselves : replace every pointer by its root
+  const int numberOfElements=successors.size();
+  vector<int>& jumps=segmentationJumps_;
+  jumps.resize(numberOfElements);
+
+  bool hasChanged=true;
+  while(hasChanged){
+    hasChanged=false;
+
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber_) reduction(||:hasChanged)
+#endif
+    for(int i=0; i<numberOfElements; ++i){
+      const int successorId=successors[i];
+      const int jumpId=successors[successorId];
+
+      jumps[i]=jumpId;
+      if(jumpId!=successorId)
+        hasChanged=true;
+    }
+
+    successors.swap(jumps);
+  }
+
+  return 0;
+}
+
+int AbstractMorseSmaleComplex::getSeparatricesLayout(const vector<Separatrix>& separatrices,
+    const int firstSeparatrixId,
+    SeparatricesLayout& layout) const{
+  int separatrixId=firstSeparatrixId;
+
+  const int numberOfSeparatrices=separatrices.size();
+  for(int i=0; i<numberOfSeparatrices; ++i){
+    const Separatrix& separatrix=separatrices[i];
+
+    if(separatrix.isValid_){
+      for(const int geometryId : separatrix.geometry_){
+        layout.separatrices_.push_back(i);
+        layout.separatrixIds_.push_back(separatrixId);
+        layout.geometries_.push_back(geometryId);
+      }
+      ++separatrixId;
+    }
+  }
+
+  return 0;
+}
+
+int AbstractMorseSmaleComplex::getSeparatrices1Layout(const vector<Separatrix>& separatrices,
+    const vector<vector<Cell>>& separatricesGeometry,
+    const int firstSeparatrixId,
+    SeparatricesLayout& layout) const{
+  getSeparatricesLayout(separatrices, firstSeparatrixId, layout);
+
+  // a vpath of n cells gives n points and n-1 lines
+  const int numberOfGeometries=layout.geometries_.size();
+  layout.pointOffsets_.resize(numberOfGeometries+1);
+  layout.cellOffsets_.resize(numberOfGeometries+1);
+  layout.pointOffsets_[0]=(*outputSeparatrices1_numberOfPoints_);
+  layout.cellOffsets_[0]=(*outputSeparatrices1_numberOfCells_);
+  for(int i=0; i<numberOfGeometries; ++i){
+    const int numberOfPoints=separatricesGeometry[layout.geometries_[i]].size();
+
+    layout.pointOffsets_[i+1]=layout.pointOffsets_[i]+numberOfPoints;
+    layout.cellOffsets_[i+1]=layout.cellOffsets_[i]+std::max(numberOfPoints-1, 0);
+  }
+
+  return 0;
+}
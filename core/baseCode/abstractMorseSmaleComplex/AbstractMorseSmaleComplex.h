@@ -94,6 +94,18 @@ namespace ttk{
     vector<int> geometry_;
   };
 
+  struct SeparatricesLayout{
+    // one entry per separatrix geometry, in output order
+    vector<int> separatrices_;
+    vector<int> separatrixIds_;
+    vector<int> geometries_;
+
+    // flat offsets of the geometries in the output arrays
+    vector<int> pointOffsets_;
+    vector<int> cellOffsets_;
+    vector<int> connectivityOffsets_;
+  };
+
   class AbstractMorseSmaleComplex : public Debug{
 
     public:
@@ -116,6 +128,21 @@ namespace ttk{
         return 0;
       }
 
+      int setUseHierarchy(const bool state){
+        UseHierarchy=state;
+        return 0;
+      }
+
+      int setHierarchyFileName(const string& fileName){
+        HierarchyFileName=fileName;
+        return 0;
+      }
+
+      int setPersistenceThreshold(const double persistenceThreshold){
+        PersistenceThreshold=persistenceThreshold;
+        return 0;
+      }
+
       int setComputeAscendingSeparatrices1(const bool state){
         ComputeAscendingSeparatrices1=state;
         return 0;
@@ -265,6 +292,50 @@ namespace ttk{
 
     protected:
 
+      int pointerJumping(vector<int>& successors);
+
+      template<typename dataType>
+        int loadHierarchy();
+
+      int saveHierarchy();
+
+      int replayHierarchy();
+
+      int getSeparatricesLayout(const vector<Separatrix>& separatrices,
+          const int firstSeparatrixId,
+          SeparatricesLayout& layout) const;
+
+      int getSeparatrices1Layout(const vector<Separatrix>& separatrices,
+          const vector<vector<Cell>>& separatricesGeometry,
+          const int firstSeparatrixId,
+          SeparatricesLayout& layout) const;
+
+      template<typename dataType>
+        int resizeSeparatrices1(const int numberOfPoints,
+            const int numberOfCells) const;
+
+      template<typename dataType>
+        int setSeparatrix1Geometry(const vector<Cell>& geometry,
+            const int firstPointId,
+            const int firstCellId,
+            const int sourceId,
+            const int destinationId,
+            const int separatrixId,
+            const char separatrixType,
+            const dataType separatrixFunctionMaximum,
+            const dataType separatrixFunctionMinimum,
+            const dataType separatrixFunctionDiff,
+            const char isOnBoundary) const;
+
+      template<typename dataType>
+        int resizeSeparatrices2(const int numberOfPoints,
+            const int numberOfCells,
+            const int connectivitySize) const;
+
+      bool UseHierarchy;
+      string HierarchyFileName;
+      double PersistenceThreshold;
+      unsigned long long hierarchyKey_;
       bool ReverveSaddleMaximumConnection;
       bool ReverveSaddleSaddleConnection;
       bool ComputeAscendingSeparatrices1;
@@ -278,6 +349,11 @@ namespace ttk{
 
       DiscreteGradient discreteGradient_;
 
+      // segmentation buffers, reused across calls
+      vector<int> segmentationSuccessors_;
+      vector<int> segmentationJumps_;
+      vector<int> cellSegmentation_;
+
       void* inputScalarField_;
       Triangulation* inputTriangulation_;
       void* inputOffsets_;
@@ -325,4 +401,144 @@ namespace ttk{
   };
 }
 
+template<typename dataType>
+int AbstractMorseSmaleComplex::loadHierarchy(){
+  // only computed when a hierarchy is requested, reused by buildHierarchy()
+  hierarchyKey_=discreteGradient_.getHierarchyKey<dataType>();
+
+  // in-memory hierarchy of the same input and parameters
+  if(!discreteGradient_.getHierarchy().isEmpty() and
+      discreteGradient_.getHierarchy().key_==hierarchyKey_)
+    return 0;
+
+  // hierarchy file of the same input and parameters
+  if(HierarchyFileName.length() and
+      !discreteGradient_.readHierarchy(HierarchyFileName)){
+    if(discreteGradient_.getHierarchy().key_==hierarchyKey_)
+      return 0;
+
+    stringstream msg;
+    msg << "[AbstractMorseSmaleComplex] `" << HierarchyFileName
+      << "' was built for another input or other parameters, rebuilding."
+      << endl;
+    dMsg(cout, msg.str(), infoMsg);
+  }
+
+  discreteGradient_.clearHierarchy();
+  return -1;
+}
+
+template<typename dataType>
+int AbstractMorseSmaleComplex::resizeSeparatrices1(const int numberOfPoints,
+    const int numberOfCells) const{
+  vector<dataType>* outputSeparatrices1_cells_separatrixFunctionMaxima=
+    static_cast<vector<dataType>*>(outputSeparatrices1_cells_separatrixFunctionMaxima_);
+  vector<dataType>* outputSeparatrices1_cells_separatrixFunctionMinima=
+    static_cast<vector<dataType>*>(outputSeparatrices1_cells_separatrixFunctionMinima_);
+  vector<dataType>* outputSeparatrices1_cells_separatrixFunctionDiffs=
+    static_cast<vector<dataType>*>(outputSeparatrices1_cells_separatrixFunctionDiffs_);
+
+  outputSeparatrices1_points_->resize(3*numberOfPoints);
+  outputSeparatrices1_points_smoothingMask_->resize(numberOfPoints);
+  outputSeparatrices1_points_cellDimensions_->resize(numberOfPoints);
+  outputSeparatrices1_points_cellIds_->resize(numberOfPoints);
+
+  // each cell is a line : [2, pointId, pointId]
+  outputSeparatrices1_cells_->resize(3*numberOfCells);
+  outputSeparatrices1_cells_sourceIds_->resize(numberOfCells);
+  outputSeparatrices1_cells_destinationIds_->resize(numberOfCells);
+  outputSeparatrices1_cells_separatrixIds_->resize(numberOfCells);
+  outputSeparatrices1_cells_separatrixTypes_->resize(numberOfCells);
+  outputSeparatrices1_cells_separatrixFunctionMaxima->resize(numberOfCells);
+  outputSeparatrices1_cells_separatrixFunctionMinima->resize(numberOfCells);
+  outputSeparatrices1_cells_separatrixFunctionDiffs->resize(numberOfCells);
+  outputSeparatrices1_cells_isOnBoundary_->resize(numberOfCells);
+
+  return 0;
+}
+
+template<typename dataType>
+int AbstractMorseSmaleComplex::setSeparatrix1Geometry(const vector<Cell>& geometry,
+    const int firstPointId,
+    const int firstCellId,
+    const int sourceId,
+    const int destinationId,
+    const int separatrixId,
+    const char separatrixType,
+    const dataType separatrixFunctionMaximum,
+    const dataType separatrixFunctionMinimum,
+    const dataType separatrixFunctionDiff,
+    const char isOnBoundary) const{
+  vector<dataType>& outputSeparatrices1_cells_separatrixFunctionMaxima=
+    *static_cast<vector<dataType>*>(outputSeparatrices1_cells_separatrixFunctionMaxima_);
+  vector<dataType>& outputSeparatrices1_cells_separatrixFunctionMinima=
+    *static_cast<vector<dataType>*>(outputSeparatrices1_cells_separatrixFunctionMinima_);
+  vector<dataType>& outputSeparatrices1_cells_separatrixFunctionDiffs=
+    *static_cast<vector<dataType>*>(outputSeparatrices1_cells_separatrixFunctionDiffs_);
+
+  int pointId=firstPointId;
+  int cellId=firstCellId;
+  const int numberOfCells=geometry.size();
+  for(int i=0; i<numberOfCells; ++i){
+    const Cell& cell=geometry[i];
+
+    float point[3];
+    discreteGradient_.getCellIncenter(cell, point);
+
+    (*outputSeparatrices1_points_)[3*pointId]=point[0];
+    (*outputSeparatrices1_points_)[3*pointId+1]=point[1];
+    (*outputSeparatrices1_points_)[3*pointId+2]=point[2];
+
+    (*outputSeparatrices1_points_smoothingMask_)[pointId]=(i==0 or i==numberOfCells-1)?0:1;
+    (*outputSeparatrices1_points_cellDimensions_)[pointId]=cell.dim_;
+    (*outputSeparatrices1_points_cellIds_)[pointId]=cell.id_;
+
+    if(i){
+      (*outputSeparatrices1_cells_)[3*cellId]=2;
+      (*outputSeparatrices1_cells_)[3*cellId+1]=pointId-1;
+      (*outputSeparatrices1_cells_)[3*cellId+2]=pointId;
+
+      (*outputSeparatrices1_cells_sourceIds_)[cellId]=sourceId;
+      (*outputSeparatrices1_cells_destinationIds_)[cellId]=destinationId;
+      (*outputSeparatrices1_cells_separatrixIds_)[cellId]=separatrixId;
+      (*outputSeparatrices1_cells_separatrixTypes_)[cellId]=separatrixType;
+      outputSeparatrices1_cells_separatrixFunctionMaxima[cellId]=separatrixFunctionMaximum;
+      outputSeparatrices1_cells_separatrixFunctionMinima[cellId]=separatrixFunctionMinimum;
+      outputSeparatrices1_cells_separatrixFunctionDiffs[cellId]=separatrixFunctionDiff;
+      (*outputSeparatrices1_cells_isOnBoundary_)[cellId]=isOnBoundary;
+
+      ++cellId;
+    }
+
+    ++pointId;
+  }
+
+  return 0;
+}
+
+template<typename dataType>
+int AbstractMorseSmaleComplex::resizeSeparatrices2(const int numberOfPoints,
+    const int numberOfCells,
+    const int connectivitySize) const{
+  vector<dataType>* outputSeparatrices2_cells_separatrixFunctionMaxima=
+    static_cast<vector<dataType>*>(outputSeparatrices2_cells_separatrixFunctionMaxima_);
+  vector<dataType>* outputSeparatrices2_cells_separatrixFunctionMinima=
+    static_cast<vector<dataType>*>(outputSeparatrices2_cells_separatrixFunctionMinima_);
+  vector<dataType>* outputSeparatrices2_cells_separatrixFunctionDiffs=
+    static_cast<vector<dataType>*>(outputSeparatrices2_cells_separatrixFunctionDiffs_);
+
+  outputSeparatrices2_points_->resize(3*numberOfPoints);
+
+  outputSeparatrices2_cells_->resize(connectivitySize);
+  outputSeparatrices2_cells_sourceIds_->resize(numberOfCells);
+  outputSeparatrices2_cells_separatrixIds_->resize(numberOfCells);
+  outputSeparatrices2_cells_separatrixTypes_->resize(numberOfCells);
+  outputSeparatrices2_cells_separatrixFunctionMaxima->resize(numberOfCells);
+  outputSeparatrices2_cells_separatrixFunctionMinima->resize(numberOfCells);
+  outputSeparatrices2_cells_separatrixFunctionDiffs->resize(numberOfCells);
+  outputSeparatrices2_cells_isOnBoundary_->resize(numberOfCells);
+
+  return 0;
+}
+
 #endif // ABSTRACTMORSESMALECOMPLEX_H
@@ -0,0 +1,145 @@
+/// \ingroup baseCode
+/// \class ttk::Hash
+/// \author agent <agent@local>
+/// \date October 2026.
+///
+/// \brief FNV-1a hashing helpers, used to key cached results and files on
+/// the content of their inputs.
+///
+/// Large per-vertex (or per-cell) arrays are hashed by fixed-size chunks in
+/// parallel. The chunk keys are then combined in order, hence the resulting
+/// key does not depend on the number of threads.
+
+#ifndef                 _HASH_H
+#define                 _HASH_H
+
+#include                <Debug.h>
+
+namespace ttk{
+
+  class Hash{
+
+    public:
+
+      static inline unsigned long long getBasis(){
+        return 14695981039346656037ULL;
+      }
+
+      /// Hash \p byteNumber bytes, starting from \p key.
+      static inline unsigned long long addBytes(unsigned long long key,
+        const void *data, const long long int &byteNumber){
+
+        const unsigned long long fnvPrime = 1099511628211ULL;
+        const unsigned char *bytes = (const unsigned char *) data;
+
+        for(long long int i = 0; i < byteNumber; i++)
+          key = (key^bytes[i])*fnvPrime;
+
+        return key;
+      }
+
+      /// Hash a single value (e.g. a size or a parameter), starting from
+      /// \p key.
+      template <class valueType>
+        static inline unsigned long long addValue(
+          const unsigned long long &key, const valueType &value){
+        return addBytes(key, &value, sizeof(valueType));
+      }
+
+      /// Hash arrays of \p elementNumber elements, chunk by chunk, starting
+      /// from \p key.
+      /// \param arrays Pointers to the arrays, along with the size (in
+      /// bytes) of their elements. Each chunk hashes its range of every array.
+      /// \param elementNumber Number of elements of each array.
+      /// \param threadNumber Number of threads.
+      /// \return The key of the arrays.
+      static inline unsigned long long addArrays(
+        const unsigned long long &key,
+        const vector<pair<const void *, int> > &arrays,
+        const long long int &elementNumber, const int &threadNumber){
+
+        const long long int chunkSize = 65536;
+        const long long int chunkNumber =
+          (elementNumber + chunkSize - 1)/chunkSize;
+        vector<unsigned long long> chunkKeys(chunkNumber, getBasis());
+
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber)
+#endif
+        for(long long int i = 0; i < chunkNumber; i++){
+
+          const long long int begin = i*chunkSize;
+          long long int end = begin + chunkSize;
+          if(end > elementNumber)
+            end = elementNumber;
+
+          for(int j = 0; j < (int) arrays.size(); j++){
+            const unsigned char *bytes =
+              (const unsigned char *) arrays[j].first;
+            chunkKeys[i] = addBytes(chunkKeys[i],
+              bytes + begin*arrays[j].second, (end - begin)*arrays[j].second);
+          }
+        }
+
+        unsigned long long arraysKey = key;
+        for(long long int i = 0; i < chunkNumber; i++)
+          arraysKey = addValue(arraysKey, chunkKeys[i]);
+
+        return arraysKey;
+      }
+
+      /// Hash the connectivity of a triangulation (grid dimensions for
+      /// implicit grids, cell vertices otherwise).
+      template <class triangulationType>
+        static inline unsigned long long addConnectivity(
+          const unsigned long long &key, triangulationType *triangulation,
+          const int &threadNumber){
+
+        unsigned long long connectivityKey =
+          addValue(key, triangulation->getNumberOfVertices());
+        connectivityKey =
+          addValue(connectivityKey, triangulation->getNumberOfCells());
+
+        vector<int> gridDimensions;
+        if((!triangulation->getGridDimensions(gridDimensions))
+          &&(gridDimensions.size())){
+          return addBytes(connectivityKey, gridDimensions.data(),
+            gridDimensions.size()*sizeof(int));
+        }
+
+        // cell vertices, by chunks of cells
+        const long long int cellNumber = triangulation->getNumberOfCells();
+        const long long int chunkSize = 65536;
+        const long long int chunkNumber =
+          (cellNumber + chunkSize - 1)/chunkSize;
+        vector<unsigned long long> chunkKeys(chunkNumber, getBasis());
+
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber)
+#endif
+        for(long long int i = 0; i < chunkNumber; i++){
+
+          const long long int begin = i*chunkSize;
+          long long int end = begin + chunkSize;
+          if(end > cellNumber)
+            end = cellNumber;
+
+          for(long long int j = begin; j < end; j++){
+            const int vertexNumber = triangulation->getCellVertexNumber(j);
+            for(int k = 0; k < vertexNumber; k++){
+              int vertexId = -1;
+              triangulation->getCellVertex(j, k, vertexId);
+              chunkKeys[i] = addValue(chunkKeys[i], vertexId);
+            }
+          }
+        }
+
+        for(long long int i = 0; i < chunkNumber; i++)
+          connectivityKey = addValue(connectivityKey, chunkKeys[i]);
+
+        return connectivityKey;
+      }
+  };
+}
+
+#endif
@@ -10,7 +10,13 @@ ContinuousScatterPlot::ContinuousScatterPlot():
   inputScalarField2_{},
   scalarMin_{},
   scalarMax_{},
-  density_{}
+  density_{},
+  validPointMask_{},
+  progressive_{},
+  progressiveLevelNumber_{8},
+  progressiveErrorThreshold_{},
+  progressiveSink_{},
+  progressiveSinkData_{}
 {}
 
 ContinuousScatterPlot::~ContinuousScatterPlot(){
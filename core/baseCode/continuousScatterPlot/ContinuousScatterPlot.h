@@ -12,6 +12,12 @@
 /// Proc. of IEEE VIS 2008.\n
 /// IEEE Transactions on Visualization and Computer Graphics, 2008.
 ///
+/// In progressive mode (see setProgressive()), the tetrahedra are rasterized
+/// in a low-discrepancy order by levels of doubling size. After each level,
+/// the density image is extrapolated to the whole data-set and published
+/// (see setProgressiveSink()) along with an error estimate, such that a 
+/// preview is available after processing a small fraction of the data.
+///
 /// \sa vtkContinuousScatterPlot.cpp %for a usage example.
 
 #ifndef _CONTINUOUSSCATTERPLOT_H
@@ -28,6 +34,15 @@ namespace ttk{
 
     public:
 
+      /// Callback receiving the intermediate density images in progressive
+      /// mode. \p processedRatio is the fraction of the tetrahedra processed
+      /// so far and \p error the relative L1 difference with the previous
+      /// image. Returning a non-zero value stops the refinement (the current
+      /// image is then kept as output).
+      typedef int (*ProgressiveSink)(const vector<vector<double>>& density,
+        const vector<vector<char>>& mask, const double& processedRatio,
+        const double& error, void* sinkData);
+
       ContinuousScatterPlot();
       ~ContinuousScatterPlot();
 
@@ -88,8 +103,47 @@ namespace ttk{
         return 0;
       }
 
+      inline int setProgressive(const bool& onOff){
+        progressive_=onOff;
+        return 0;
+      }
+
+      /// Set the number of intermediate images in progressive mode (the
+      /// first one is computed out of 1/2^(levelNumber-1) of the tetrahedra).
+      inline int setProgressiveLevelNumber(const int& levelNumber){
+        progressiveLevelNumber_=levelNumber;
+        return 0;
+      }
+
+      /// Stop the refinement once the error estimate gets below the given
+      /// threshold (0: process all the tetrahedra).
+      inline int setProgressiveErrorThreshold(const double& threshold){
+        progressiveErrorThreshold_=threshold;
+        return 0;
+      }
+
+      inline int setProgressiveSink(ProgressiveSink sink, void* sinkData){
+        progressiveSink_=sink;
+        progressiveSinkData_=sinkData;
+        return 0;
+      }
+
     protected:
 
+      template<typename dataType1, typename dataType2>
+        int rasterizeCell(const int& cell, const double* sampling,
+          vector<vector<double>>& densityImage,
+          vector<vector<char>>& maskImage) const;
+
+      // rasterize the tetrahedra (k*stride)%numberOfCells, k in [begin,end)
+      template<typename dataType1, typename dataType2>
+        int rasterizeCells(const long long int& begin,
+          const long long int& end, const long long int& stride,
+          const double* sampling) const;
+
+      template<typename dataType1, typename dataType2>
+        int rasterizeProgressively(const double* sampling) const;
+
       int vertexNumber_;
       Triangulation* triangulation_;
       bool withDummyValue_;
@@ -101,6 +155,11 @@ namespace ttk{
       double* scalarMax_;
       vector<vector<double>>* density_;
       vector<vector<char>>* validPointMask_;
+      bool progressive_;
+      int progressiveLevelNumber_;
+      double progressiveErrorThreshold_;
+      ProgressiveSink progressiveSink_;
+      void* progressiveSinkData_;
   };
 }
 
@@ -123,356 +182,493 @@ int ContinuousScatterPlot::execute() const{
   }
 #endif
 
-  dataType1* scalars1=static_cast<dataType1*>(inputScalarField1_);
-  dataType2* scalars2=static_cast<dataType2*>(inputScalarField2_);
-
   Timer t;
 
   // helpers:
   const int numberOfCells=triangulation_->getNumberOfCells();
 
   // rendering helpers:
-  // constant ray direction (ortho)
-  const double d[3]{0,0,-1};
   const double delta[2]{scalarMax_[0]-scalarMin_[0],scalarMax_[1]-scalarMin_[1]};
   const double sampling[2]{delta[0]/resolutions_[0],delta[1]/resolutions_[1]};
-  const double epsilon{0.000001};
 
-#ifdef withOpenMP
-#pragma omp parallel for num_threads(threadNumber_)
-#endif
-  for(int cell=0; cell<numberOfCells; ++cell){
-    bool isDummy{};
-
-    // get tetrahedron info
-    int vertex[4];
-    double data[4][3];
-    float position[4][3];
-    double localScalarMin[2]{};
-    double localScalarMax[2]{};
-    // for each triangle
-    for(int k=0; k<4; ++k){
-      // get indices
-      triangulation_->getCellVertex(cell,k,vertex[k]);
-
-      // get scalars
-      data[k][0]=scalars1[vertex[k]];
-      data[k][1]=scalars2[vertex[k]];
-      data[k][2]=0;
-
-      if(withDummyValue_ and (data[k][0]==dummyValue_ or data[k][1]==dummyValue_)){
-        isDummy=true;
-        break;
-      }
+  int ret{};
+  if(progressive_)
+    ret=rasterizeProgressively<dataType1,dataType2>(sampling);
+  else
+    ret=rasterizeCells<dataType1,dataType2>(0,numberOfCells,1,sampling);
+  if(ret) return ret;
+
+  {
+    stringstream msg;
+    msg << "[ContinuousScatterPlot] Data-set (" << numberOfCells
+      << " tetrahedra) processed in "
+      << t.getElapsedTime() << " s. (" << threadNumber_
+      << " thread(s))."
+      << endl;
+    dMsg(cout, msg.str(), timeMsg);
+  }
+
+  return 0;
+}
+
+template<typename dataType1, typename dataType2>
+int ContinuousScatterPlot::rasterizeCell(const int& cell,
+    const double* sampling, vector<vector<double>>& densityImage,
+    vector<vector<char>>& maskImage) const{
+
+  const dataType1* scalars1=static_cast<const dataType1*>(inputScalarField1_);
+  const dataType2* scalars2=static_cast<const dataType2*>(inputScalarField2_);
+
+  // rendering helpers:
+  const double epsilon{0.000001};
 
-      // get local stats
-      if(!k or localScalarMin[0]>data[k][0])
-        localScalarMin[0]=data[k][0];
-      if(!k or localScalarMin[1]>data[k][1])
-        localScalarMin[1]=data[k][1];
-      if(!k or localScalarMax[0]<data[k][0])
-        localScalarMax[0]=data[k][0];
-      if(!k or localScalarMax[1]<data[k][1])
-        localScalarMax[1]=data[k][1];
-
-      // get positions
-      triangulation_->getVertexPoint(vertex[k],position[k][0],position[k][1],position[k][2]);
+  bool isDummy{};
+
+  // get tetrahedron info
+  int vertex[4];
+  double data[4][3];
+  float position[4][3];
+  double localScalarMin[2]{};
+  double localScalarMax[2]{};
+  // for each triangle
+  for(int k=0; k<4; ++k){
+    // get indices
+    triangulation_->getCellVertex(cell,k,vertex[k]);
+
+    // get scalars
+    data[k][0]=scalars1[vertex[k]];
+    data[k][1]=scalars2[vertex[k]];
+    data[k][2]=0;
+
+    if(withDummyValue_ and (data[k][0]==dummyValue_ or data[k][1]==dummyValue_)){
+      isDummy=true;
+      break;
     }
-    if(isDummy) continue;
 
-    // gradient:
-    double g0[3];
-    double g1[3];
-    {
-      double v12[3];
-      double v13[3];
-      double v14[3];
-      double s12[3];
-      double s13[3];
-      double s14[3];
-      for(int k=0; k<3; ++k){
-        v12[k]=position[1][k]-position[0][k];
-        v13[k]=position[2][k]-position[0][k];
-        v14[k]=position[3][k]-position[0][k];
+    // get local stats
+    if(!k or localScalarMin[0]>data[k][0])
+      localScalarMin[0]=data[k][0];
+    if(!k or localScalarMin[1]>data[k][1])
+      localScalarMin[1]=data[k][1];
+    if(!k or localScalarMax[0]<data[k][0])
+      localScalarMax[0]=data[k][0];
+    if(!k or localScalarMax[1]<data[k][1])
+      localScalarMax[1]=data[k][1];
+
+    // get positions
+    triangulation_->getVertexPoint(vertex[k],position[k][0],position[k][1],position[k][2]);
+  }
+  if(isDummy) return 0;
 
-        s12[k]=data[1][k]-data[0][k];
-        s13[k]=data[2][k]-data[0][k];
-        s14[k]=data[3][k]-data[0][k];
-      }
+  // gradient:
+  double g0[3];
+  double g1[3];
+  {
+    double v12[3];
+    double v13[3];
+    double v14[3];
+    double s12[3];
+    double s13[3];
+    double s14[3];
+    for(int k=0; k<3; ++k){
+      v12[k]=position[1][k]-position[0][k];
+      v13[k]=position[2][k]-position[0][k];
+      v14[k]=position[3][k]-position[0][k];
+
+      s12[k]=data[1][k]-data[0][k];
+      s13[k]=data[2][k]-data[0][k];
+      s14[k]=data[3][k]-data[0][k];
+    }
 
-      double a[3];
-      double b[3];
-      double c[3];
-      Geometry::crossProduct(v13,v12,a);
-      Geometry::crossProduct(v12,v14,b);
-      Geometry::crossProduct(v14,v13,c);
-      double det=Geometry::dotProduct(v14,a);
-      if(det == 0.){
-        for(int k=0; k<3; ++k){
-          g0[k]=0.0;
-          g1[k]=0.0;
-        }
+    double a[3];
+    double b[3];
+    double c[3];
+    Geometry::crossProduct(v13,v12,a);
+    Geometry::crossProduct(v12,v14,b);
+    Geometry::crossProduct(v14,v13,c);
+    double det=Geometry::dotProduct(v14,a);
+    if(det == 0.){
+      for(int k=0; k<3; ++k){
+        g0[k]=0.0;
+        g1[k]=0.0;
       }
-      else{
-        double invDet=1.0/det;
-        for(int k=0; k<3; ++k){
-          g0[k]=(s14[0]*a[k] + s13[0]*b[k] + s12[0]*c[k]) * invDet;
-          g1[k]=(s14[1]*a[k] + s13[1]*b[k] + s12[1]*c[k]) * invDet;
-        }
+    }
+    else{
+      double invDet=1.0/det;
+      for(int k=0; k<3; ++k){
+        g0[k]=(s14[0]*a[k] + s13[0]*b[k] + s12[0]*c[k]) * invDet;
+        g1[k]=(s14[1]*a[k] + s13[1]*b[k] + s12[1]*c[k]) * invDet;
       }
     }
+  }
+
+  // volume:
+  double volume;
+  bool isLimit{};
+  {
+    double cp[3];
+    Geometry::crossProduct(g0,g1,cp);
+    volume=Geometry::magnitude(cp);
+    if(volume == 0.) isLimit=true;
+  }
+
+  // classification:
+  int index[4]{0,1,2,3};
+  bool isInTriangle{};
+  if(Geometry::isPointInTriangle(data[0],data[1],data[2],data[3]))
+    isInTriangle=true;
+  else if(Geometry::isPointInTriangle(data[0],data[1],data[3],data[2])){
+    isInTriangle=true;
+    index[0]=0;
+    index[1]=1;
+    index[2]=3;
+    index[3]=2;
+  }
+  else if(Geometry::isPointInTriangle(data[0],data[2],data[3],data[1])){
+    isInTriangle=true;
+    index[0]=0;
+    index[1]=2;
+    index[2]=3;
+    index[3]=1;
+  }
+  else if(Geometry::isPointInTriangle(data[1],data[2],data[3],data[0])){
+    isInTriangle=true;
+    index[0]=1;
+    index[1]=2;
+    index[2]=3;
+    index[3]=0;
+  }
 
-    // volume:
-    double volume;
-    bool isLimit{};
+  // projection:
+  double density{};
+  // projected triangles (local vertex indices, 4: imaginary vertex)
+  int triangles[4][3];
+  int triangleNumber{};
+  double imaginaryPosition[3]{};
+  // class 0
+  if(isInTriangle){
+    // mass density
+    double massDensity{};
     {
-      double cp[3];
-      Geometry::crossProduct(g0,g1,cp);
-      volume=Geometry::magnitude(cp);
-      if(volume == 0.) isLimit=true;
+      double A;
+      Geometry::computeTriangleArea(data[index[0]],data[index[1]],data[index[2]],A);
+      double invA=1.0/A;
+      if(A == 0.){
+        invA=0.0;
+        isLimit=true;
+      }
+
+      double alpha, beta, gamma;
+      Geometry::computeTriangleArea(data[index[1]],data[index[2]],data[index[3]],alpha);
+      Geometry::computeTriangleArea(data[index[0]],data[index[2]],data[index[3]],beta);
+      Geometry::computeTriangleArea(data[index[0]],data[index[1]],data[index[3]],gamma);
+
+      alpha*=invA;
+      beta*=invA;
+      gamma*=invA;
+
+      double p0[3];
+      double p1[3];
+      for(int k=0; k<3; ++k){
+        p0[k]=position[index[3]][k];
+        p1[k]=alpha*position[index[0]][k]+beta*position[index[1]][k]+gamma*position[index[2]][k];
+      }
+      massDensity=Geometry::distance(p0,p1);
     }
 
-    // classification:
-    int index[4]{0,1,2,3};
-    bool isInTriangle{};
-    if(Geometry::isPointInTriangle(data[0],data[1],data[2],data[3]))
-      isInTriangle=true;
-    else if(Geometry::isPointInTriangle(data[0],data[1],data[3],data[2])){
-      isInTriangle=true;
+    if(isLimit) density=numeric_limits<decltype(density)>::max();
+    else density=massDensity/volume;
+
+    triangles[0][0]=index[3];
+    triangles[0][1]=index[0];
+    triangles[0][2]=index[1];
+
+    triangles[1][0]=index[3];
+    triangles[1][1]=index[0];
+    triangles[1][2]=index[2];
+
+    triangles[2][0]=index[3];
+    triangles[2][1]=index[1];
+    triangles[2][2]=index[2];
+    triangleNumber=3;
+  }
+  // class 1
+  else{
+    double massDensity{};
+    double p[3]{0,0,0};
+    if(Geometry::computeSegmentIntersection(data[0][0],data[0][1],
+          data[1][0],data[1][1],
+          data[2][0],data[2][1],
+          data[3][0],data[3][1],
+          p[0],p[1])){
       index[0]=0;
       index[1]=1;
-      index[2]=3;
-      index[3]=2;
+      index[2]=2;
+      index[3]=3;
     }
-    else if(Geometry::isPointInTriangle(data[0],data[2],data[3],data[1])){
-      isInTriangle=true;
+    else if(Geometry::computeSegmentIntersection(data[0][0],data[0][1],
+          data[2][0],data[2][1],
+          data[1][0],data[1][1],
+          data[3][0],data[3][1],
+          p[0],p[1])){
       index[0]=0;
       index[1]=2;
-      index[2]=3;
-      index[3]=1;
+      index[2]=1;
+      index[3]=3;
     }
-    else if(Geometry::isPointInTriangle(data[1],data[2],data[3],data[0])){
-      isInTriangle=true;
-      index[0]=1;
-      index[1]=2;
-      index[2]=3;
-      index[3]=0;
+    else if(Geometry::computeSegmentIntersection(data[0][0],data[0][1],
+          data[3][0],data[3][1],
+          data[1][0],data[1][1],
+          data[2][0],data[2][1],
+          p[0],p[1])){
+      index[0]=0;
+      index[1]=3;
+      index[2]=1;
+      index[3]=2;
     }
 
-    // projection:
-    double density{};
-    vector<vector<int>> triangles;
-    double imaginaryPosition[3]{};
-    vector<int> triangle(3);
-    // class 0
-    if(isInTriangle){
-      // mass density
-      double massDensity{};
-      {
-        double A;
-        Geometry::computeTriangleArea(data[index[0]],data[index[1]],data[index[2]],A);
-        double invA=1.0/A;
-        if(A == 0.){
-          invA=0.0;
-          isLimit=true;
-        }
+    double a=Geometry::distance(data[index[0]],p);
+    double b=Geometry::distance(data[index[0]],data[index[1]]);
+    double r0=a/b;
 
-        double alpha, beta, gamma;
-        Geometry::computeTriangleArea(data[index[1]],data[index[2]],data[index[3]],alpha);
-        Geometry::computeTriangleArea(data[index[0]],data[index[2]],data[index[3]],beta);
-        Geometry::computeTriangleArea(data[index[0]],data[index[1]],data[index[3]],gamma);
+    a=Geometry::distance(data[index[2]],p);
+    b=Geometry::distance(data[index[2]],data[index[3]]);
+    double r1=a/b;
 
-        alpha*=invA;
-        beta*=invA;
-        gamma*=invA;
+    double p0[3];
+    double p1[3];
+    for(int k=0; k<3; ++k){
+      p0[k]=position[index[0]][k]+r0*(position[index[1]][k]-position[index[0]][k]);
+      p1[k]=position[index[2]][k]+r1*(position[index[3]][k]-position[index[2]][k]);
+    }
+    massDensity=Geometry::distance(p0,p1);
 
-        double p0[3];
-        double p1[3];
-        for(int k=0; k<3; ++k){
-          p0[k]=position[index[3]][k];
-          p1[k]=alpha*position[index[0]][k]+beta*position[index[1]][k]+gamma*position[index[2]][k];
-        }
-        massDensity=Geometry::distance(p0,p1);
-      }
+    if(isLimit) density=numeric_limits<decltype(density)>::max();
+    else density=massDensity/volume;
 
-      if(isLimit) density=numeric_limits<decltype(density)>::max();
-      else density=massDensity/volume;
+    imaginaryPosition[0]=p[0];
+    imaginaryPosition[1]=p[1];
+    imaginaryPosition[2]=0;
 
-      triangle[0]=vertex[index[3]];
-      triangle[1]=vertex[index[0]];
-      triangle[2]=vertex[index[1]];
-      triangles.push_back(triangle);
+    // four triangles projection
+    for(int k=0; k<4; ++k)
+      triangles[k][0]=4; // new geometry
+    triangles[0][1]=index[0];
+    triangles[0][2]=index[2];
 
-      triangle[0]=vertex[index[3]];
-      triangle[1]=vertex[index[0]];
-      triangle[2]=vertex[index[2]];
-      triangles.push_back(triangle);
+    triangles[1][1]=index[2];
+    triangles[1][2]=index[1];
 
-      triangle[0]=vertex[index[3]];
-      triangle[1]=vertex[index[1]];
-      triangle[2]=vertex[index[2]];
-      triangles.push_back(triangle);
-    }
-    // class 1
-    else{
-      double massDensity{};
-      double p[3]{0,0,0};
-      if(Geometry::computeSegmentIntersection(data[0][0],data[0][1],
-            data[1][0],data[1][1],
-            data[2][0],data[2][1],
-            data[3][0],data[3][1],
-            p[0],p[1])){
-        index[0]=0;
-        index[1]=1;
-        index[2]=2;
-        index[3]=3;
-      }
-      else if(Geometry::computeSegmentIntersection(data[0][0],data[0][1],
-            data[2][0],data[2][1],
-            data[1][0],data[1][1],
-            data[3][0],data[3][1],
-            p[0],p[1])){
-        index[0]=0;
-        index[1]=2;
-        index[2]=1;
-        index[3]=3;
-      }
-      else if(Geometry::computeSegmentIntersection(data[0][0],data[0][1],
-            data[3][0],data[3][1],
-            data[1][0],data[1][1],
-            data[2][0],data[2][1],
-            p[0],p[1])){
-        index[0]=0;
-        index[1]=3;
-        index[2]=1;
-        index[3]=2;
-      }
+    triangles[2][1]=index[1];
+    triangles[2][2]=index[3];
 
-      double a=Geometry::distance(data[index[0]],p);
-      double b=Geometry::distance(data[index[0]],data[index[1]]);
-      double r0=a/b;
+    triangles[3][1]=index[3];
+    triangles[3][2]=index[0];
+    triangleNumber=4;
+  }
 
-      a=Geometry::distance(data[index[2]],p);
-      b=Geometry::distance(data[index[2]],data[index[3]]);
-      double r1=a/b;
+  // rendering:
+  // "Fast, Minimum Storage Ray/Triangle Intersection", Tomas Moller & Ben Trumbore
+  // with a constant ray direction (0,0,-1), the barycentric coordinates are
+  // linear functions of the ray origin: the triangles are set up once here.
+  double triangleOrigins[4][2];
+  double triangleEdges[4][4];
+  double triangleFactors[4];
+  bool isDegenerate[4];
+  for(int k=0; k<triangleNumber; ++k){
+    const double* p0=(triangles[k][0]==4) ?
+      imaginaryPosition : data[triangles[k][0]];
+    const double* p1=data[triangles[k][1]];
+    const double* p2=data[triangles[k][2]];
+
+    triangleOrigins[k][0]=p0[0];
+    triangleOrigins[k][1]=p0[1];
+    triangleEdges[k][0]=p1[0]-p0[0];
+    triangleEdges[k][1]=p1[1]-p0[1];
+    triangleEdges[k][2]=p2[0]-p0[0];
+    triangleEdges[k][3]=p2[1]-p0[1];
+
+    const double a=triangleEdges[k][0]*triangleEdges[k][3]
+      -triangleEdges[k][1]*triangleEdges[k][2];
+    isDegenerate[k]=(a>-epsilon and a<epsilon);
+    triangleFactors[k]=1.0/a;
+  }
 
-      double p0[3];
-      double p1[3];
-      for(int k=0; k<3; ++k){
-        p0[k]=position[index[0]][k]+r0*(position[index[1]][k]-position[index[0]][k]);
-        p1[k]=position[index[2]][k]+r1*(position[index[3]][k]-position[index[2]][k]);
+  {
+    const int minI=floor((localScalarMin[0]-scalarMin_[0])/sampling[0]);
+    const int minJ=floor((localScalarMin[1]-scalarMin_[1])/sampling[1]);
+    const int maxI=ceil((localScalarMax[0]-scalarMin_[0])/sampling[0]);
+    const int maxJ=ceil((localScalarMax[1]-scalarMin_[1])/sampling[1]);
+
+    for(int i=minI; i<maxI; ++i){
+      // set ray origin
+      const double o0=scalarMin_[0]+i*sampling[0];
+      for(int j=minJ; j<maxJ; ++j){
+        const double o1=scalarMin_[1]+j*sampling[1];
+        for(int k=0; k<triangleNumber; ++k){
+          if(isDegenerate[k]) continue;
+
+          const double s0=o0-triangleOrigins[k][0];
+          const double s1=o1-triangleOrigins[k][1];
+          const double f=triangleFactors[k];
+
+          const double u=f*(s0*triangleEdges[k][3]-s1*triangleEdges[k][2]);
+          if(u<0.0) continue;
+
+          const double v=f*(-(s0*triangleEdges[k][1]-s1*triangleEdges[k][0]));
+          if(v<0.0 or (u+v)>1.0) continue;
+
+          // triangle/ray intersection below
+          densityImage[i][j]+=(1.0-u-v)*density;
+          maskImage[i][j]=1;
+          break;
+        }
       }
-      massDensity=Geometry::distance(p0,p1);
-
-      if(isLimit) density=numeric_limits<decltype(density)>::max();
-      else density=massDensity/volume;
-
-      imaginaryPosition[0]=p[0];
-      imaginaryPosition[1]=p[1];
-      imaginaryPosition[2]=0;
-
-      // four triangles projection
-      triangle[0]=-1; // new geometry
-      triangle[1]=vertex[index[0]];
-      triangle[2]=vertex[index[2]];
-      triangles.push_back(triangle);
-
-      triangle[1]=vertex[index[2]];
-      triangle[2]=vertex[index[1]];
-      triangles.push_back(triangle);
+    }
+  }
 
-      triangle[1]=vertex[index[1]];
-      triangle[2]=vertex[index[3]];
-      triangles.push_back(triangle);
+  return 0;
+}
 
-      triangle[1]=vertex[index[3]];
-      triangle[2]=vertex[index[0]];
-      triangles.push_back(triangle);
-    }
+template<typename dataType1, typename dataType2>
+int ContinuousScatterPlot::rasterizeCells(const long long int& begin,
+    const long long int& end, const long long int& stride,
+    const double* sampling) const{
+
+  const long long int numberOfCells=triangulation_->getNumberOfCells();
+
+  // one image per thread (the first thread accumulates in the output):
+  // no atomic operation is needed and, with a static schedule, the sums are
+  // carried out in the same order from one run to the next.
+  vector<vector<vector<double>>> threadedDensities(threadNumber_-1);
+  vector<vector<vector<char>>> threadedMasks(threadNumber_-1);
+  vector<vector<vector<double>>*> densityImages(threadNumber_,density_);
+  vector<vector<vector<char>>*> maskImages(threadNumber_,validPointMask_);
+  for(int t=1; t<threadNumber_; ++t){
+    threadedDensities[t-1].resize(resolutions_[0],
+      vector<double>(resolutions_[1],0.0));
+    threadedMasks[t-1].resize(resolutions_[0],
+      vector<char>(resolutions_[1],0));
+    densityImages[t]=&(threadedDensities[t-1]);
+    maskImages[t]=&(threadedMasks[t-1]);
+  }
 
-    // rendering:
-    // "Fast, Minimum Storage Ray/Triangle Intersection", Tomas Moller & Ben Trumbore
-    {
-      const int minI=floor((localScalarMin[0]-scalarMin_[0])/sampling[0]);
-      const int minJ=floor((localScalarMin[1]-scalarMin_[1])/sampling[1]);
-      const int maxI=ceil((localScalarMax[0]-scalarMin_[0])/sampling[0]);
-      const int maxJ=ceil((localScalarMax[1]-scalarMin_[1])/sampling[1]);
-
-      for(int i=minI; i<maxI; ++i){
-        for(int j=minJ; j<maxJ; ++j){
-          // set ray origin
-          const double o[3]{scalarMin_[0]+i*sampling[0],scalarMin_[1]+j*sampling[1],1};
-          for(unsigned int k=0; k<triangles.size(); ++k){
-            const auto& triangle=triangles[k];
-
-            // get triangle info
-            double p0[3];
-            if(isInTriangle){
-              p0[0]=scalars1[triangle[0]];
-              p0[1]=scalars2[triangle[0]];
-            }
-            else{
-              p0[0]=imaginaryPosition[0];
-              p0[1]=imaginaryPosition[1];
-            }
-            p0[2]=0;
-
-            const double p1[3]{(double)scalars1[triangle[1]],(double)scalars2[triangle[1]],0};
-            const double p2[3]{(double)scalars1[triangle[2]],(double)scalars2[triangle[2]],0};
-            const double e1[3]{p1[0]-p0[0],p1[1]-p0[1],0};
-            const double e2[3]{p2[0]-p0[0],p2[1]-p0[1],0};
-
-            double q[3];
-            Geometry::crossProduct(d,e2,q);
-            const double a=Geometry::dotProduct(e1,q);
-            if(a>-epsilon and a<epsilon) continue;
-
-            const double f=1.0/a;
-            const double s[3]{o[0]-p0[0],o[1]-p0[1],1};
-            const double u=f * Geometry::dotProduct(s,q);
-            if(u<0.0) continue;
-
-            double r[3];
-            Geometry::crossProduct(s,e1,r);
-            const double v=f * Geometry::dotProduct(d,r);
-            if(v<0.0 or (u+v)>1.0) continue;
-
-            // triangle/ray intersection below
 #ifdef withOpenMP
-#ifdef _WIN32
-#pragma omp atomic
-#else
-#pragma omp atomic update
+#pragma omp parallel for schedule(static) num_threads(threadNumber_)
 #endif
+  for(long long int k=begin; k<end; ++k){
+    int threadId=0;
+#ifdef withOpenMP
+    threadId=omp_get_thread_num();
 #endif
-            (*density_)[i][j]+=(1.0-u-v)*density;
+    rasterizeCell<dataType1,dataType2>((k*stride)%numberOfCells,sampling,
+      *(densityImages[threadId]),*(maskImages[threadId]));
+  }
 
+  // reduction, in thread order
+  if(threadNumber_>1){
 #ifdef withOpenMP
-#ifdef _WIN32
-#pragma omp atomic 
-            (*validPointMask_)[i][j] += 1;
-#else
-#pragma omp atomic write
-            (*validPointMask_)[i][j]=1;
+#pragma omp parallel for num_threads(threadNumber_)
 #endif
-#else
+    for(int i=0; i<resolutions_[0]; ++i){
+      for(int t=0; t<threadNumber_-1; ++t){
+        for(int j=0; j<resolutions_[1]; ++j){
+          (*density_)[i][j]+=threadedDensities[t][i][j];
+          if(threadedMasks[t][i][j])
             (*validPointMask_)[i][j]=1;
-#endif
-            break;
-          }
         }
       }
     }
   }
 
-  {
-    stringstream msg;
-    msg << "[ContinuousScatterPlot] Data-set (" << numberOfCells
-      << " tetrahedra) processed in "
-      << t.getElapsedTime() << " s. (" << threadNumber_
-      << " thread(s))."
-      << endl;
-    dMsg(cout, msg.str(), timeMsg);
+  return 0;
+}
+
+template<typename dataType1, typename dataType2>
+int ContinuousScatterPlot::rasterizeProgressively(
+    const double* sampling) const{
+
+  const long long int numberOfCells=triangulation_->getNumberOfCells();
+
+  // low-discrepancy order: the k-th processed tetrahedron is
+  // (k*stride)%numberOfCells, with a stride close to the golden section of
+  // the number of tetrahedra and coprime with it, such that each level 
+  // spreads over the whole data-set.
+  long long int stride=max(1LL,(long long int)(0.6180339887*numberOfCells));
+  for(;;++stride){
+    long long int a=stride, b=numberOfCells;
+    while(b){
+      long long int r=a%b;
+      a=b;
+      b=r;
+    }
+    if(a==1) break;
+  }
+
+  const int levelNumber=max(progressiveLevelNumber_,1);
+  vector<vector<double>> estimate, previousEstimate;
+
+  long long int begin=0;
+  for(int level=0; level<levelNumber; ++level){
+
+    // avoid any processing if the abort signal is sent
+    if(wrapper_ and wrapper_->needsToAbort()) return -7;
+
+    // each level doubles the number of processed tetrahedra
+    long long int end=numberOfCells;
+    if(level<levelNumber-1)
+      end=ceil(numberOfCells/pow(2.0,levelNumber-1-level));
+
+    rasterizeCells<dataType1,dataType2>(begin,end,stride,sampling);
+
+    begin=end;
+    const double processedRatio=end/(double)numberOfCells;
+
+    // extrapolation of the density out of the processed tetrahedra
+    estimate=*density_;
+    if(processedRatio<1){
+      for(auto& column : estimate)
+        for(auto& value : column)
+          value/=processedRatio;
+    }
+
+    // relative L1 difference with the previous level (on finite densities)
+    double error{1};
+    if(level){
+      double difference{}, norm{};
+      for(unsigned int i=0; i<estimate.size(); ++i){
+        for(unsigned int j=0; j<estimate[i].size(); ++j){
+          if(isfinite(estimate[i][j]) and isfinite(previousEstimate[i][j])){
+            difference+=fabs(estimate[i][j]-previousEstimate[i][j]);
+            norm+=fabs(estimate[i][j]);
+          }
+        }
+      }
+      error=(norm>0)?difference/norm:0;
+    }
+
+    {
+      stringstream msg;
+      msg << "[ContinuousScatterPlot] Level #" << level << ": "
+        << 100*processedRatio << "% of the tetrahedra, error: "
+        << error << endl;
+      dMsg(cout, msg.str(), infoMsg);
+    }
+
+    if(wrapper_) wrapper_->updateProgress(processedRatio);
+
+    bool isDone=(level and progressiveErrorThreshold_>0
+        and error<=progressiveErrorThreshold_);
+    if(progressiveSink_ and progressiveSink_(estimate,*validPointMask_,
+          processedRatio,error,progressiveSinkData_))
+      isDone=true;
+
+    if(isDone and processedRatio<1){
+      density_->swap(estimate);
+      break;
+    }
+
+    previousEstimate.swap(estimate);
   }
 
   return 0;
@@ -165,6 +165,7 @@ SubLevelSetTree::SubLevelSetTree(){
   minimumList_ = NULL;
   maximumList_ = NULL;
   vertexSoSoffsets_ = NULL;
+  vertexOrder_ = NULL;
   vertexScalars_ = NULL;
   maintainRegularVertices_ = true;
   vertexPositions_ = NULL;
@@ -230,19 +231,28 @@ int SubLevelSetTree::build(){
     extremumList = maximumList_;
   }
 
-  set< 
-    // is merging
-    pair<bool,
-	 // function value
-	 pair<double, 
-	      // vertex offset
-	      pair<int, 
-		   // vertex id
-		   int> > >, filtrationCtCmp > filtrationFront;
+  vector<int> localVertexOrder;
+  const vector<int> *vertexOrder = vertexOrder_;
+  if((!vertexOrder)||((int) vertexOrder->size() != vertexNumber_)){
+    buildVertexOrder(localVertexOrder);
+    vertexOrder = &localVertexOrder;
+  }
+
+  // the filtration front is a heap of (position in the filtration, vertex id)
+  // pairs. the filtration goes along the vertex order for the merge tree and
+  // in reverse order for the split tree.
+  priority_queue<pair<int, int>, vector<pair<int, int> >, 
+    greater<pair<int, int> > > filtrationFront;
 
   seeds.resize(extremumList->size());
   seedSuperArcs.resize(seeds.size());
 
+  // one node per vertex
+  if(maintainRegularVertices_){
+    nodeList_.reserve(vertexNumber_);
+    arcList_.reserve(vertexNumber_);
+  }
+
   for(int i = 0; i < (int) extremumList->size(); i++){
     // link each minimum to a union find seed
     vertexSeeds[(*extremumList)[i]] = &(seeds[i]);
@@ -251,13 +261,13 @@ int SubLevelSetTree::build(){
     seedSuperArcs[i].push_back(openSuperArc(makeNode((*extremumList)[i]))); 
 
     // add each minimum to the filtration front
-    pair<bool, pair<double, pair<int, int> > > v;
-    v.first = isMergeTree;
-    v.second.first = (*vertexScalars_)[(*extremumList)[i]];
-    v.second.second.first = (*vertexSoSoffsets_)[(*extremumList)[i]];
-    v.second.second.second = (*extremumList)[i];
-    
-    filtrationFront.insert(v);
+    if(!visitedVertices[(*extremumList)[i]]){
+      int position = (*vertexOrder)[(*extremumList)[i]];
+      if(!isMergeTree)
+        position = vertexNumber_ - 1 - position;
+      filtrationFront.push(pair<int, int>(position, (*extremumList)[i]));
+      visitedVertices[(*extremumList)[i]] = true;
+    }
   }
 
   bool merge = false;
@@ -265,8 +275,8 @@ int SubLevelSetTree::build(){
   // filtration loop
   do{
     
-    vertexId = filtrationFront.begin()->second.second.second;
-    filtrationFront.erase(filtrationFront.begin());
+    vertexId = filtrationFront.top().second;
+    filtrationFront.pop();
 
     starSets.clear();
 
@@ -287,14 +297,10 @@ int SubLevelSetTree::build(){
       }
 
       if(!visitedVertices[nId]){
-        
-        pair<bool, pair<double, pair<int, int> > > v;
-        v.first = isMergeTree;
-        v.second.first = (*vertexScalars_)[nId];
-        v.second.second.first = (*vertexSoSoffsets_)[nId];
-        v.second.second.second = nId;
-        
-        filtrationFront.insert(v);
+        int position = (*vertexOrder)[nId];
+        if(!isMergeTree)
+          position = vertexNumber_ - 1 - position;
+        filtrationFront.push(pair<int, int>(position, nId));
         visitedVertices[nId] = true;
       }
     }
@@ -724,6 +730,209 @@ int SubLevelSetTree::exportNodePosToVtk(const int &nodeId, const int &pointId,
   return 0;
 }
 
+// binary exports: little-endian, whatever the host byte order.
+// header: magic, version, flags, sizes, then the offsets of the sections 
+// (from the beginning of the file).
+static const char contourTreeMagic[8] = {'T','T','K','C','T','R','E','E'};
+static const char persistenceCurveMagic[8] = {'T','T','K','P','C','U','R','V'};
+static const char persistenceDiagramMagic[8] = 
+  {'T','T','K','P','D','I','A','G'};
+static const int binaryExportVersion = 1;
+static const int binaryCompressedFlag = 1;
+static const int binaryScalarFlag = 2;
+static const int binaryMinimumListFlag = 4;
+static const int binaryMaximumListFlag = 8;
+static const int binarySoSFlag = 16;
+
+static void appendBinaryValue(vector<char> &buffer, 
+  const unsigned long long &value, const int &byteNumber){
+
+  for(int i = 0; i < byteNumber; i++)
+    buffer.push_back((char) ((value >> (8*i)) & 0xFF));
+}
+
+static void appendBinaryDouble(vector<char> &buffer, const double &value){
+  
+  unsigned long long bits = 0;
+  memcpy(&bits, &value, sizeof(double));
+  appendBinaryValue(buffer, bits, 8);
+}
+
+// compressed: zig-zag encoded deltas, stored as base-128 varints.
+static void appendBinaryIntArray(vector<char> &buffer, 
+  const vector<int> &array, const bool &compressed){
+
+  long long int previous = 0;
+  for(int i = 0; i < (int) array.size(); i++){
+    if(compressed){
+      long long int delta = array[i] - previous;
+      unsigned long long zigZag = (((unsigned long long) delta) << 1) 
+        ^ ((unsigned long long) (delta >> 63));
+      while(zigZag >= 0x80){
+        buffer.push_back((char) ((zigZag & 0x7F) | 0x80));
+        zigZag >>= 7;
+      }
+      buffer.push_back((char) zigZag);
+      previous = array[i];
+    }
+    else{
+      appendBinaryValue(buffer, (unsigned int) array[i], 4);
+    }
+  }
+}
+
+static int readBinaryValue(const vector<char> &buffer, size_t &cursor,
+  const int &byteNumber, unsigned long long &value){
+
+  if(cursor + byteNumber > buffer.size())
+    return -1;
+
+  value = 0;
+  for(int i = 0; i < byteNumber; i++){
+    value |= 
+      ((unsigned long long) (unsigned char) buffer[cursor + i]) << (8*i);
+  }
+  cursor += byteNumber;
+
+  return 0;
+}
+
+static int readBinaryInt(const vector<char> &buffer, size_t &cursor, 
+  int &value){
+
+  unsigned long long bits = 0;
+  if(readBinaryValue(buffer, cursor, 4, bits))
+    return -1;
+  value = (int) (unsigned int) bits;
+
+  return 0;
+}
+
+static int readBinaryDouble(const vector<char> &buffer, size_t &cursor, 
+  double &value){
+
+  unsigned long long bits = 0;
+  if(readBinaryValue(buffer, cursor, 8, bits))
+    return -1;
+  memcpy(&value, &bits, sizeof(double));
+
+  return 0;
+}
+
+static int readBinaryIntArray(const vector<char> &buffer, size_t cursor, 
+  const bool &compressed, vector<int> &array){
+
+  long long int previous = 0;
+  for(int i = 0; i < (int) array.size(); i++){
+    if(compressed){
+      unsigned long long zigZag = 0;
+      int shift = 0;
+      unsigned char byte = 0x80;
+      while(byte & 0x80){
+        if((cursor >= buffer.size())||(shift > 63))
+          return -1;
+        byte = (unsigned char) buffer[cursor];
+        zigZag |= ((unsigned long long) (byte & 0x7F)) << shift;
+        shift += 7;
+        cursor++;
+      }
+      long long int delta = 
+        (long long int) (zigZag >> 1) ^ -((long long int) (zigZag & 1));
+      previous += delta;
+      array[i] = (int) previous;
+    }
+    else{
+      if(readBinaryInt(buffer, cursor, array[i]))
+        return -1;
+    }
+  }
+
+  return 0;
+}
+
+// writes the header and the sections, with their offsets.
+static int writeBinaryFile(const string &fileName, const char *magic,
+  const int &flags, const vector<unsigned long long> &sizes, 
+  const vector<vector<char> > &sections){
+
+  ofstream file(fileName.data(), ios::out | ios::binary);
+  if(!file)
+    return -1;
+
+  vector<char> header(magic, magic + 8);
+  appendBinaryValue(header, binaryExportVersion, 4);
+  appendBinaryValue(header, flags, 4);
+  appendBinaryValue(header, sizes.size(), 4);
+  appendBinaryValue(header, sections.size(), 4);
+  for(int i = 0; i < (int) sizes.size(); i++)
+    appendBinaryValue(header, sizes[i], 8);
+
+  unsigned long long offset = header.size() + 8*sections.size();
+  for(int i = 0; i < (int) sections.size(); i++){
+    appendBinaryValue(header, offset, 8);
+    offset += sections[i].size();
+  }
+
+  file.write(header.data(), header.size());
+  for(int i = 0; i < (int) sections.size(); i++){
+    if(sections[i].size())
+      file.write(sections[i].data(), sections[i].size());
+  }
+
+  if(!file)
+    return -2;
+
+  return 0;
+}
+
+// reads the whole file and checks its header.
+static int readBinaryFile(const string &fileName, const char *magic,
+  vector<char> &buffer, int &flags, vector<unsigned long long> &sizes,
+  vector<unsigned long long> &offsets){
+
+  ifstream file(fileName.data(), ios::in | ios::binary | ios::ate);
+  if(!file)
+    return -1;
+
+  long long int fileSize = file.tellg();
+  if(fileSize < 24)
+    return -2;
+  buffer.resize(fileSize);
+  file.seekg(0, ios::beg);
+  file.read(buffer.data(), fileSize);
+  if(!file)
+    return -1;
+
+  if(!equal(magic, magic + 8, buffer.begin()))
+    return -2;
+
+  size_t cursor = 8;
+  unsigned long long value = 0;
+  readBinaryValue(buffer, cursor, 4, value);
+  if(value != (unsigned long long) binaryExportVersion)
+    return -2;
+  readBinaryValue(buffer, cursor, 4, value);
+  flags = (int) value;
+  
+  unsigned long long sizeNumber = 0, sectionNumber = 0;
+  readBinaryValue(buffer, cursor, 4, sizeNumber);
+  readBinaryValue(buffer, cursor, 4, sectionNumber);
+  if((sizeNumber != sizes.size())||(sectionNumber != offsets.size()))
+    return -3;
+
+  for(int i = 0; i < (int) sizes.size(); i++){
+    if(readBinaryValue(buffer, cursor, 8, sizes[i]))
+      return -3;
+  }
+  for(int i = 0; i < (int) offsets.size(); i++){
+    if((readBinaryValue(buffer, cursor, 8, offsets[i]))
+      ||(offsets[i] > buffer.size()))
+      return -3;
+  }
+
+  return 0;
+}
+
 int SubLevelSetTree::exportPersistenceCurve(const string &fileName) const{
   vector<pair<double, int> > persistencePlot;
 
@@ -747,6 +956,41 @@ int SubLevelSetTree::exportPersistenceCurve(const string &fileName) const{
   return 0;
 }
 
+int SubLevelSetTree::exportPersistenceCurveToBinary(const string &fileName,
+  const bool &compressed) const{
+
+  vector<pair<double, int> > persistencePlot;
+
+  getPersistencePlot(persistencePlot);
+
+  vector<double> persistences(persistencePlot.size());
+  vector<int> pairNumbers(persistencePlot.size());
+  for(int i = 0; i < (int) persistencePlot.size(); i++){
+    persistences[i] = persistencePlot[i].first;
+    pairNumbers[i] = persistencePlot[i].second;
+  }
+
+  // sections: persistences, numbers of pairs
+  vector<vector<char> > sections(2);
+  sections[0].reserve(8*persistences.size());
+  for(int i = 0; i < (int) persistences.size(); i++)
+    appendBinaryDouble(sections[0], persistences[i]);
+  appendBinaryIntArray(sections[1], pairNumbers, compressed);
+
+  vector<unsigned long long> sizes(1, persistencePlot.size());
+
+  if(writeBinaryFile(fileName, persistenceCurveMagic, 
+    (compressed ? binaryCompressedFlag : 0), sizes, sections)){
+    stringstream msg;
+    msg << "[ContourTree] Could not write file `" << fileName
+      << "'!" << endl;
+    dMsg(cerr, msg.str(), 1);
+    return -1;
+  }
+
+  return 0;
+}
+
 int SubLevelSetTree::exportPersistenceDiagram(const string &fileName) const{
 
   vector<pair<double, double> > diagram;
@@ -773,6 +1017,136 @@ int SubLevelSetTree::exportPersistenceDiagram(const string &fileName) const{
   return 0;
 }
 
+int SubLevelSetTree::exportPersistenceDiagramToBinary(
+  const string &fileName) const{
+
+  vector<pair<double, double> > diagram;
+  
+  getPersistenceDiagram(diagram);
+
+  // single section: (birth, death) pairs
+  vector<vector<char> > sections(1);
+  sections[0].reserve(16*diagram.size());
+  for(int i = 0; i < (int) diagram.size(); i++){
+    appendBinaryDouble(sections[0], diagram[i].first);
+    appendBinaryDouble(sections[0], diagram[i].second);
+  }
+
+  vector<unsigned long long> sizes(1, diagram.size());
+
+  if(writeBinaryFile(fileName, persistenceDiagramMagic, 0, sizes, 
+    sections)){
+    stringstream msg;
+    msg << "[ContourTree] Could not write file `" << fileName
+      << "'!" << endl;
+    dMsg(cerr, msg.str(), 1);
+    return -1;
+  }
+
+  return 0;
+}
+
+int SubLevelSetTree::exportToBinary(const string &fileName, 
+  const bool &compressed) const{
+
+  Timer t;
+
+  int nodeNumber = (int) nodeList_.size(),
+    superArcNumber = (int) superArcList_.size();
+
+  vector<int> nodeVertexIds(nodeNumber);
+  for(int i = 0; i < nodeNumber; i++)
+    nodeVertexIds[i] = nodeList_[i].getVertexId();
+
+  vector<int> downNodeIds(superArcNumber), upNodeIds(superArcNumber),
+    prunedFlags(superArcNumber), regularNodeOffsets(superArcNumber + 1, 0),
+    regularNodeIds;
+  for(int i = 0; i < superArcNumber; i++){
+    downNodeIds[i] = superArcList_[i].getDownNodeId();
+    upNodeIds[i] = superArcList_[i].getUpNodeId();
+    prunedFlags[i] = superArcList_[i].pruned_;
+    regularNodeOffsets[i + 1] = regularNodeOffsets[i] 
+      + superArcList_[i].getNumberOfRegularNodes();
+  }
+  regularNodeIds.resize(regularNodeOffsets[superArcNumber]);
+  for(int i = 0; i < superArcNumber; i++){
+    for(int j = 0; j < superArcList_[i].getNumberOfRegularNodes(); j++){
+      regularNodeIds[regularNodeOffsets[i] + j] = 
+        superArcList_[i].getRegularNodeId(j);
+    }
+  }
+
+  // down super arcs of each node, in their original order
+  vector<int> downSuperArcIds;
+  for(int i = 0; i < nodeNumber; i++){
+    for(int j = 0; j < nodeList_[i].getNumberOfDownSuperArcs(); j++)
+      downSuperArcIds.push_back(nodeList_[i].getDownSuperArcId(j));
+  }
+
+  // sections: node vertex ids, node scalars, super arc down nodes, 
+  // super arc up nodes, pruned flags, regular node offsets, regular node ids,
+  // node down super arcs, minimum list, maximum list, node SoS offsets.
+  // the extremum lists give the type of the tree (join, split or both).
+  int flags = (compressed ? binaryCompressedFlag : 0);
+  vector<vector<char> > sections(11);
+  appendBinaryIntArray(sections[0], nodeVertexIds, compressed);
+  if((vertexScalars_)&&((int) vertexScalars_->size() == vertexNumber_)){
+    flags |= binaryScalarFlag;
+    sections[1].reserve(8*nodeNumber);
+    for(int i = 0; i < nodeNumber; i++)
+      appendBinaryDouble(sections[1], (*vertexScalars_)[nodeVertexIds[i]]);
+  }
+  appendBinaryIntArray(sections[2], downNodeIds, compressed);
+  appendBinaryIntArray(sections[3], upNodeIds, compressed);
+  appendBinaryIntArray(sections[4], prunedFlags, compressed);
+  appendBinaryIntArray(sections[5], regularNodeOffsets, compressed);
+  appendBinaryIntArray(sections[6], regularNodeIds, compressed);
+  appendBinaryIntArray(sections[7], downSuperArcIds, compressed);
+  if(minimumList_){
+    flags |= binaryMinimumListFlag;
+    appendBinaryIntArray(sections[8], *minimumList_, compressed);
+  }
+  if(maximumList_){
+    flags |= binaryMaximumListFlag;
+    appendBinaryIntArray(sections[9], *maximumList_, compressed);
+  }
+  if((vertexSoSoffsets_)&&((int) vertexSoSoffsets_->size() == vertexNumber_)){
+    flags |= binarySoSFlag;
+    vector<int> nodeSoSoffsets(nodeNumber);
+    for(int i = 0; i < nodeNumber; i++)
+      nodeSoSoffsets[i] = (*vertexSoSoffsets_)[nodeVertexIds[i]];
+    appendBinaryIntArray(sections[10], nodeSoSoffsets, compressed);
+  }
+
+  // sizes: vertices, nodes, super arcs, regular nodes, node down super arcs,
+  // minima, maxima
+  vector<unsigned long long> sizes(7);
+  sizes[0] = vertexNumber_;
+  sizes[1] = nodeNumber;
+  sizes[2] = superArcNumber;
+  sizes[3] = regularNodeIds.size();
+  sizes[4] = downSuperArcIds.size();
+  sizes[5] = (minimumList_ ? minimumList_->size() : 0);
+  sizes[6] = (maximumList_ ? maximumList_->size() : 0);
+
+  if(writeBinaryFile(fileName, contourTreeMagic, flags, sizes, sections)){
+    stringstream msg;
+    msg << "[ContourTree] Could not write file `" << fileName
+      << "'!" << endl;
+    dMsg(cerr, msg.str(), 1);
+    return -1;
+  }
+
+  {
+    stringstream msg;
+    msg << "[ContourTree] Tree written to `" << fileName << "' in "
+      << t.getElapsedTime() << " s." << endl;
+    dMsg(cout, msg.str(), timeMsg);
+  }
+
+  return 0;
+}
+
 int SubLevelSetTree::exportToSvg(const string &fileName,
 				 const double &scaleX, const double &scaleY){
 
@@ -1217,6 +1591,42 @@ int SubLevelSetTree::flush(){
   return 0;
 }
 
+int SubLevelSetTree::buildVertexOrder(vector<int> &vertexOrder) const{
+
+  if((!vertexNumber_)||(!vertexScalars_)
+    ||((int) vertexScalars_->size() != vertexNumber_))
+    return -1;
+  if((!vertexSoSoffsets_)||((int) vertexSoSoffsets_->size() != vertexNumber_))
+    return -2;
+
+  vector<int> sortedVertices(vertexNumber_);
+  for(int i = 0; i < vertexNumber_; i++)
+    sortedVertices[i] = i;
+
+  // vertex ids break the remaining ties
+  auto vertexCmp = [this](const int &vertexId0, const int &vertexId1){
+    return (isSosLowerThan(vertexId0, vertexId1)
+      ||((!isSosLowerThan(vertexId1, vertexId0))&&(vertexId0 < vertexId1)));
+  };
+
+#if defined(withOpenMP) && !defined(__APPLE__) && !defined(_WIN32)
+  __gnu_parallel::sort(sortedVertices.begin(), sortedVertices.end(), 
+    vertexCmp);
+#else
+  sort(sortedVertices.begin(), sortedVertices.end(), vertexCmp);
+#endif
+
+  vertexOrder.resize(vertexNumber_);
+  
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber_)
+#endif
+  for(int i = 0; i < vertexNumber_; i++)
+    vertexOrder[sortedVertices[i]] = i;
+
+  return 0;
+}
+
 int SubLevelSetTree::buildExtremumList(vector<int> &extremumList, 
 				       const bool &isSubLevelSet){
 
@@ -1229,10 +1639,24 @@ int SubLevelSetTree::buildExtremumList(vector<int> &extremumList,
   if((!vertexSoSoffsets_)||(!vertexSoSoffsets_->size()))
     return -3;
   
-  vector<pair<bool, pair<double, pair<int, int> > > > tmpList;
+  int threadNumber = threadNumber_;
+  if(threadNumber < 1)
+    threadNumber = 1;
 
+  // per-thread lists, concatenated in thread order (deterministic output)
+  vector<vector<pair<bool, pair<double, pair<int, int> > > > > 
+    threadedLists(threadNumber);
+  
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber) schedule(static)
+#endif
   for(int i = 0; i <triangulation_->getNumberOfVertices(); i++){
     
+    int threadId = 0;
+#ifdef withOpenMP
+    threadId = omp_get_thread_num();
+#endif
+
     bool isExtremum = true;
     int neighborNumber=triangulation_->getVertexNeighborNumber(i);
     for(int j = 0; j <neighborNumber; j++){
@@ -1262,10 +1686,16 @@ int SubLevelSetTree::buildExtremumList(vector<int> &extremumList,
       entry.second.first = (*vertexScalars_)[i];
       entry.second.second.first = (*vertexSoSoffsets_)[i];
       entry.second.second.second = i;
-      tmpList.push_back(entry);
+      threadedLists[threadId].push_back(entry);
     }
   }
 
+  vector<pair<bool, pair<double, pair<int, int> > > > tmpList;
+  for(int i = 0; i < threadNumber; i++){
+    tmpList.insert(tmpList.end(), 
+      threadedLists[i].begin(), threadedLists[i].end());
+  }
+
   sort(tmpList.begin(), tmpList.end(), filtrationCmp);
   
   extremumList.resize(tmpList.size());
@@ -1369,116 +1799,89 @@ int SubLevelSetTree::getPersistencePairs(vector<pair<pair<int,int>,double>> &pai
     return -2;
   
   
-  pairs.resize(extremumList->size());
+  pairs.clear();
+  pairs.reserve(extremumList->size());
 
-  vector<int> min2arc(vertexNumber_, -1);
+  // elder rule, processed bottom-up (from the leaves) on the super arcs:
+  // each node keeps the oldest extremum of its sub-tree. the younger extrema
+  // of the branches merging at a node die at that node.
+  int nodeNumber = getNumberOfNodes();
+  vector<int> oldestExtremum(nodeNumber, -1);
+  vector<int> pendingArcNumber(nodeNumber, 0);
+  vector<int> nodeStack;
+  vector<pair<pair<int, int>, double> > rootPairs;
 
-  // compute the initial persistence
-  int leafId = 0;
-  for(int i=0; i<getNumberOfSuperArcs(); ++i){
-    const SuperArc *a = getSuperArc(i);
-    const Node *n = getNode(a->getDownNodeId());
-    int nodeId = n->getVertexId();
-    
-    if(!n->getNumberOfDownSuperArcs()){
-      // internal, split trees and merges trees have their leaves at the bottom
-      double extremumScalar=0;
-      double saddleScalar=0;
-      int saddleId = getNode(a->getUpNodeId())->getVertexId();
-      
-      extremumScalar=(*vertexScalars_)[nodeId];
-      saddleScalar=(*vertexScalars_)[saddleId];
-      
-      pairs[leafId].first.first=nodeId;
-      pairs[leafId].first.second=saddleId;
-      pairs[leafId].second=fabs(saddleScalar-extremumScalar);
-      float persistence=pairs[leafId].second;
-      if(isnan(persistence))
-        pairs[leafId].second=0;
-      
-      // save that in the map
-      min2arc[nodeId]=i;
-      leafId++;
+  for(int i = 0; i < nodeNumber; i++){
+    const Node *n = getNode(i);
+    pendingArcNumber[i] = n->getNumberOfDownSuperArcs();
+    if((!pendingArcNumber[i])&&(n->getNumberOfUpSuperArcs())){
+      // leaf
+      oldestExtremum[i] = n->getVertexId();
+      nodeStack.push_back(i);
     }
   }
 
-  // sort the pairs and start the processing
-  sort(pairs.begin(), pairs.end(), _pCmp);
-  
-  vector<int> pairedSaddles(vertexNumber_, 0);
-  // now start the pairing...
-  for(unsigned int i=0; i<pairs.size(); ++i){
-    pairedSaddles[pairs[i].first.second]++;
-    
-    // now update the persistence of all others
-    for(unsigned int j=i+1; j<pairs.size(); ++j){
-      if((pairs[j].first.second == pairs[i].first.second)
-	 &&(pairedSaddles[pairs[i].first.second] + 1 == 
-	    (getVertexNode(pairs[i].first.second))->getNumberOfDownSuperArcs())){
-        // that pair contains a minimum competing with our guy
-        // and the saddle is fully paired
-        
-        const SuperArc *a=getSuperArc(min2arc[pairs[j].first.first]);
-        do{
-          if(!(getNode(a->getUpNodeId())->getNumberOfUpSuperArcs()))
-            break;
-          
-          int nextArcId=getNode(a->getUpNodeId())->getUpSuperArcId(0);
-          a=getSuperArc(nextArcId);
-          
-          if(a){
-            int saddleId=getNode(a->getUpNodeId())->getVertexId();
-            if(!getNode(a->getUpNodeId())->getNumberOfDownSuperArcs())
-              break;
+  while(nodeStack.size()){
 
-            if(pairedSaddles[saddleId] <
-	       (getVertexNode(saddleId))->getNumberOfDownSuperArcs() - 1){
-              
-              double extremumScalar=0;
-	      double saddleScalar=0;
-              
-              extremumScalar = (*vertexScalars_)[pairs[j].first.first];
-              saddleScalar = (*vertexScalars_)[saddleId];
-              pairs[j].first.second = saddleId;
-              pairs[j].second = fabs(saddleScalar - extremumScalar);
-              float persistence=pairs[j].second;
-              if(isnan(persistence))
-                pairs[j].second = 0;
-              break;
-            }
-          }
-        }while(a);
-        
-        if(a){
-          // we indeed update the persistence of the competitor
-          sort(pairs.begin() + j, pairs.end(), _pCmp);
+    int nodeId = nodeStack.back();
+    nodeStack.pop_back();
+
+    const Node *n = getNode(nodeId);
+    int extremumId = oldestExtremum[nodeId];
+
+    if(!n->getNumberOfUpSuperArcs()){
+      // root, the oldest extremum dies here
+      rootPairs.push_back(pair<pair<int, int>, double>(
+        pair<int, int>(extremumId, n->getVertexId()), 0));
+      continue;
+    }
+
+    for(int i = 0; i < n->getNumberOfUpSuperArcs(); i++){
+      int upNodeId = getSuperArc(n->getUpSuperArcId(i))->getUpNodeId();
+      int saddleId = getNode(upNodeId)->getVertexId();
+
+      if(oldestExtremum[upNodeId] == -1){
+        oldestExtremum[upNodeId] = extremumId;
+      }
+      else{
+        int youngerId = oldestExtremum[upNodeId];
+        if((isMergeTree && isSosLowerThan(extremumId, youngerId))
+          ||((!isMergeTree) && isSosHigherThan(extremumId, youngerId))){
+          oldestExtremum[upNodeId] = extremumId;
         }
-        
-        break;
+        else{
+          youngerId = extremumId;
+        }
+        pairs.push_back(pair<pair<int, int>, double>(
+          pair<int, int>(youngerId, saddleId), 0));
       }
+
+      pendingArcNumber[upNodeId]--;
+      if(!pendingArcNumber[upNodeId])
+        nodeStack.push_back(upNodeId);
     }
   }
 
-  // the last entry should have infinite persistence
-  //pairs.erase(pairs.end() - 1);
- 
-  // let's pair the global maximum with the global min
-  for(int i=0; i < getNumberOfSuperArcs(); i++){
-    const SuperArc *a=getSuperArc(i);
-    const Node *up=getNode(a->getUpNodeId());
-    if(!up->getNumberOfUpSuperArcs()){
-      // global min
-      pairs.back().first.second=up->getVertexId();
-      pairs.back().second=fabs((*vertexScalars_)[pairs.back().first.first]
-			       - (*vertexScalars_)[pairs.back().first.second]);
-      float persistence=pairs.back().second;
-      if(isnan(persistence))
-        pairs.back().second=0;
-      break;
-    }
+  for(int i = 0; i < (int) pairs.size(); i++){
+    pairs[i].second = fabs((*vertexScalars_)[pairs[i].first.second]
+      - (*vertexScalars_)[pairs[i].first.first]);
+    float persistence = pairs[i].second;
+    if(isnan(persistence))
+      pairs[i].second = 0;
+  }
+
+  sort(pairs.begin(), pairs.end(), _pCmp);
+
+  // the pair of the global extremum (with the root) comes last
+  for(int i = 0; i < (int) rootPairs.size(); i++){
+    rootPairs[i].second = fabs((*vertexScalars_)[rootPairs[i].first.second]
+      - (*vertexScalars_)[rootPairs[i].first.first]);
+    float persistence = rootPairs[i].second;
+    if(isnan(persistence))
+      rootPairs[i].second = 0;
+    pairs.push_back(rootPairs[i]);
   }
 
-  
   if(debugLevel_ >= 4){
     stringstream msg;
     msg << "[ContourTree] "
@@ -1814,6 +2217,259 @@ const bool SubLevelSetTree::isSosLowerThan(const int &vertexId0,
 	     &&((*vertexSoSoffsets_)[vertexId0] < (*vertexSoSoffsets_)[vertexId1])));
 }
 
+int SubLevelSetTree::loadFromBinary(const string &fileName, 
+  vector<double> *nodeScalars){
+
+  Timer t;
+
+  vector<char> buffer;
+  int flags = 0;
+  vector<unsigned long long> sizes(7), offsets(11);
+
+  if(readBinaryFile(fileName, contourTreeMagic, buffer, flags, sizes, 
+    offsets)){
+    stringstream msg;
+    msg << "[ContourTree] `" << fileName 
+      << "' is not a valid binary tree file." << endl;
+    dMsg(cerr, msg.str(), 1);
+    return -1;
+  }
+
+  // each integer takes at least one byte
+  for(int i = 0; i < (int) sizes.size(); i++){
+    if(sizes[i] > buffer.size())
+      return -2;
+  }
+
+  bool compressed = (flags & binaryCompressedFlag);
+  int nodeNumber = sizes[1], superArcNumber = sizes[2];
+
+  vector<int> nodeVertexIds(nodeNumber), downNodeIds(superArcNumber), 
+    upNodeIds(superArcNumber), prunedFlags(superArcNumber),
+    regularNodeOffsets(superArcNumber + 1), regularNodeIds(sizes[3]),
+    downSuperArcIds(sizes[4]), minimumList(sizes[5]), maximumList(sizes[6]),
+    nodeSoSoffsets;
+
+  int ret = 0;
+  ret |= readBinaryIntArray(buffer, offsets[0], compressed, nodeVertexIds);
+  ret |= readBinaryIntArray(buffer, offsets[2], compressed, downNodeIds);
+  ret |= readBinaryIntArray(buffer, offsets[3], compressed, upNodeIds);
+  ret |= readBinaryIntArray(buffer, offsets[4], compressed, prunedFlags);
+  ret |= readBinaryIntArray(buffer, offsets[5], compressed, 
+    regularNodeOffsets);
+  ret |= readBinaryIntArray(buffer, offsets[6], compressed, regularNodeIds);
+  ret |= readBinaryIntArray(buffer, offsets[7], compressed, downSuperArcIds);
+  ret |= readBinaryIntArray(buffer, offsets[8], compressed, minimumList);
+  ret |= readBinaryIntArray(buffer, offsets[9], compressed, maximumList);
+  if(flags & binarySoSFlag){
+    nodeSoSoffsets.resize(nodeNumber);
+    ret |= readBinaryIntArray(buffer, offsets[10], compressed, nodeSoSoffsets);
+  }
+
+  // consistency
+  for(int i = 0; (!ret)&&(i < nodeNumber); i++){
+    if((nodeVertexIds[i] < 0)||(nodeVertexIds[i] >= (int) sizes[0]))
+      ret = -1;
+  }
+  for(int i = 0; (!ret)&&(i < superArcNumber); i++){
+    if((downNodeIds[i] < 0)||(downNodeIds[i] >= nodeNumber)
+      ||(upNodeIds[i] < -1)||(upNodeIds[i] >= nodeNumber)
+      ||(regularNodeOffsets[i] > regularNodeOffsets[i + 1]))
+      ret = -1;
+  }
+  if((!ret)&&((regularNodeOffsets[0])
+    ||(regularNodeOffsets[superArcNumber] != (int) regularNodeIds.size())))
+    ret = -1;
+  for(int i = 0; (!ret)&&(i < (int) regularNodeIds.size()); i++){
+    if((regularNodeIds[i] < 0)||(regularNodeIds[i] >= nodeNumber))
+      ret = -1;
+  }
+  for(int i = 0; (!ret)&&(i < (int) minimumList.size()); i++){
+    if((minimumList[i] < 0)||(minimumList[i] >= (int) sizes[0]))
+      ret = -1;
+  }
+  for(int i = 0; (!ret)&&(i < (int) maximumList.size()); i++){
+    if((maximumList[i] < 0)||(maximumList[i] >= (int) sizes[0]))
+      ret = -1;
+  }
+  // each closed super arc is listed once, by its up node (in node order)
+  vector<int> downSuperArcOffsets(nodeNumber + 1, 0);
+  for(int i = 0; (!ret)&&(i < superArcNumber); i++){
+    if(upNodeIds[i] != -1)
+      downSuperArcOffsets[upNodeIds[i] + 1]++;
+  }
+  for(int i = 0; i < nodeNumber; i++)
+    downSuperArcOffsets[i + 1] += downSuperArcOffsets[i];
+  if((!ret)&&(downSuperArcOffsets[nodeNumber] != (int) downSuperArcIds.size()))
+    ret = -1;
+  for(int i = 0; (!ret)&&(i < nodeNumber); i++){
+    for(int j = downSuperArcOffsets[i]; j < downSuperArcOffsets[i + 1]; j++){
+      if((downSuperArcIds[j] < 0)||(downSuperArcIds[j] >= superArcNumber)
+        ||(upNodeIds[downSuperArcIds[j]] != i)){
+        ret = -1;
+        break;
+      }
+    }
+  }
+
+  if(ret){
+    stringstream msg;
+    msg << "[ContourTree] `" << fileName << "' is corrupted." << endl;
+    dMsg(cerr, msg.str(), 1);
+    return -3;
+  }
+
+  setNumberOfVertices(sizes[0]);
+  flush();
+
+  nodeList_.resize(nodeNumber);
+  for(int i = 0; i < nodeNumber; i++){
+    nodeList_[i].setVertexId(nodeVertexIds[i]);
+    vertex2node_[nodeVertexIds[i]] = i;
+  }
+
+  superArcList_.resize(superArcNumber);
+  for(int i = 0; i < superArcNumber; i++){
+    SuperArc &a = superArcList_[i];
+    a.setDownNodeId(downNodeIds[i]);
+    a.setUpNodeId(upNodeIds[i]);
+    a.pruned_ = prunedFlags[i];
+    nodeList_[downNodeIds[i]].addUpSuperArcId(i);
+
+    // regular nodes and arcs
+    int previousNodeId = downNodeIds[i];
+    for(int j = regularNodeOffsets[i]; j < regularNodeOffsets[i + 1]; j++){
+      int nodeId = regularNodeIds[j];
+      a.appendRegularNode(nodeId);
+      vertex2superArc_[nodeVertexIds[nodeId]] = i;
+      vertex2superArcNode_[nodeVertexIds[nodeId]] = 
+        a.getNumberOfRegularNodes() - 1;
+      makeArc(previousNodeId, nodeId);
+      previousNodeId = nodeId;
+    }
+    if(upNodeIds[i] != -1)
+      makeArc(previousNodeId, upNodeIds[i]);
+  }
+
+  for(int i = 0; i < nodeNumber; i++){
+    for(int j = downSuperArcOffsets[i]; j < downSuperArcOffsets[i + 1]; j++)
+      nodeList_[i].addDownSuperArcId(downSuperArcIds[j]);
+  }
+
+  // tree type
+  loadedMinimumList_.swap(minimumList);
+  loadedMaximumList_.swap(maximumList);
+  minimumList_ = 
+    ((flags & binaryMinimumListFlag) ? &loadedMinimumList_ : NULL);
+  maximumList_ = 
+    ((flags & binaryMaximumListFlag) ? &loadedMaximumList_ : NULL);
+
+  // SoS offsets of the nodes (the other vertices keep their identifier), 
+  // unless the caller already provided the whole field
+  if((flags & binarySoSFlag)&&((!vertexSoSoffsets_)
+    ||(vertexSoSoffsets_ == &loadedSoSoffsets_)
+    ||((int) vertexSoSoffsets_->size() != vertexNumber_))){
+    loadedSoSoffsets_.resize(vertexNumber_);
+    for(int i = 0; i < vertexNumber_; i++)
+      loadedSoSoffsets_[i] = i;
+    for(int i = 0; i < nodeNumber; i++)
+      loadedSoSoffsets_[nodeVertexIds[i]] = nodeSoSoffsets[i];
+    vertexSoSoffsets_ = &loadedSoSoffsets_;
+  }
+
+  // scalars of the nodes, same policy
+  vector<double> localNodeScalars;
+  if(!nodeScalars)
+    nodeScalars = &localNodeScalars;
+  nodeScalars->clear();
+  if(flags & binaryScalarFlag){
+    nodeScalars->resize(nodeNumber);
+    size_t cursor = offsets[1];
+    for(int i = 0; i < nodeNumber; i++){
+      if(readBinaryDouble(buffer, cursor, (*nodeScalars)[i])){
+        nodeScalars->clear();
+        return -4;
+      }
+    }
+    if((!vertexScalars_)||(vertexScalars_ == &loadedScalars_)
+      ||((int) vertexScalars_->size() != vertexNumber_)){
+      loadedScalars_.resize(vertexNumber_);
+      for(int i = 0; i < vertexNumber_; i++)
+        loadedScalars_[i] = 0;
+      for(int i = 0; i < nodeNumber; i++)
+        loadedScalars_[nodeVertexIds[i]] = (*nodeScalars)[i];
+      vertexScalars_ = &loadedScalars_;
+    }
+  }
+
+  {
+    stringstream msg;
+    msg << "[ContourTree] Tree read from `" << fileName << "' in "
+      << t.getElapsedTime() << " s. (n: " << getNumberOfNodes() 
+      << ", a: " << getNumberOfSuperArcs() << ")" << endl;
+    dMsg(cout, msg.str(), timeMsg);
+  }
+
+  return 0;
+}
+
+int SubLevelSetTree::loadPersistenceCurveFromBinary(const string &fileName,
+  vector<pair<double, int> > &plot){
+
+  vector<char> buffer;
+  int flags = 0;
+  vector<unsigned long long> sizes(1), offsets(2);
+
+  plot.clear();
+
+  if((readBinaryFile(fileName, persistenceCurveMagic, buffer, flags, sizes,
+    offsets))||(sizes[0] > buffer.size()))
+    return -1;
+
+  vector<int> pairNumbers(sizes[0]);
+  if(readBinaryIntArray(buffer, offsets[1], (flags & binaryCompressedFlag),
+    pairNumbers))
+    return -2;
+
+  plot.resize(sizes[0]);
+  size_t cursor = offsets[0];
+  for(int i = 0; i < (int) plot.size(); i++){
+    if(readBinaryDouble(buffer, cursor, plot[i].first)){
+      plot.clear();
+      return -2;
+    }
+    plot[i].second = pairNumbers[i];
+  }
+
+  return 0;
+}
+
+int SubLevelSetTree::loadPersistenceDiagramFromBinary(const string &fileName,
+  vector<pair<double, double> > &diagram){
+
+  vector<char> buffer;
+  int flags = 0;
+  vector<unsigned long long> sizes(1), offsets(1);
+
+  diagram.clear();
+
+  if((readBinaryFile(fileName, persistenceDiagramMagic, buffer, flags, sizes,
+    offsets))||(sizes[0] > buffer.size()))
+    return -1;
+
+  diagram.resize(sizes[0]);
+  size_t cursor = offsets[0];
+  for(int i = 0; i < (int) diagram.size(); i++){
+    if((readBinaryDouble(buffer, cursor, diagram[i].first))
+      ||(readBinaryDouble(buffer, cursor, diagram[i].second))){
+      diagram.clear();
+      return -2;
+    }
+  }
+
+  return 0;
+}
+
 int SubLevelSetTree::moveRegularNode(const Node *n, const Node *oldDown,
 				     const Node *oldUp, const Node *newDown, const Node *newUp){
  
@@ -2431,12 +3087,24 @@ int ContourTree::build(){
   }
 
   // build the actual extrema list
+  // per-thread lists, concatenated in thread order (sorted by vertex id)
+  int threadNumber = threadNumber_;
+  if(threadNumber < 1)
+    threadNumber = 1;
 
-  minimumList_ = new vector<int>;
-  maximumList_ = new vector<int>;
+  vector<vector<int> > threadedMinima(threadNumber), 
+    threadedMaxima(threadNumber);
 
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber) schedule(static)
+#endif
   for(int i = 0; i < vertexNumber_; i++){
       
+    int threadId = 0;
+#ifdef withOpenMP
+    threadId = omp_get_thread_num();
+#endif
+
     bool isMin = true, isMax = true;
     int neighborNumber=triangulation_->getVertexNeighborNumber(i);
     for(int j = 0; j <neighborNumber; j++){
@@ -2458,45 +3126,52 @@ int ContourTree::build(){
     }
 
     if((isMin)&&(!isMax))
-      minimumList_->push_back(i);
+      threadedMinima[threadId].push_back(i);
     if((isMax)&&(!isMin))
-      maximumList_->push_back(i);
+      threadedMaxima[threadId].push_back(i);
   }
 
-#ifdef withOpenMP
-#pragma omp parallel sections
-#endif
-  {
-    
-#ifdef withOpenMP
-#pragma omp section
-#endif
-    {
-      // 1) build the merge tree
-      mergeTree_.setMinimumList(*minimumList_);
-      mergeTree_.setNumberOfVertices(vertexNumber_);
-      mergeTree_.setVertexScalars(vertexScalars_);
-      mergeTree_.setVertexPositions(vertexPositions_);
-      mergeTree_.setTriangulation(triangulation_);
-      mergeTree_.setVertexSoSoffsets(vertexSoSoffsets_);
-      mergeTree_.build();
-    }
+  minimumList_ = new vector<int>;
+  maximumList_ = new vector<int>;
+
+  for(int i = 0; i < threadNumber; i++){
+    minimumList_->insert(minimumList_->end(), 
+      threadedMinima[i].begin(), threadedMinima[i].end());
+    maximumList_->insert(maximumList_->end(), 
+      threadedMaxima[i].begin(), threadedMaxima[i].end());
+  }
+
+  // the vertex order (parallel sort) is shared by the merge and split trees,
+  // their sweeps are then run concurrently
+  vector<int> vertexOrder;
+  buildVertexOrder(vertexOrder);
+
+  mergeTree_.setMinimumList(*minimumList_);
+  splitTree_.setMaximumList(*maximumList_);
 
+  SubLevelSetTree *subTrees[2] = {&mergeTree_, &splitTree_};
+  for(int i = 0; i < 2; i++){
+    subTrees[i]->setThreadNumber(threadNumber_);
+    subTrees[i]->setNumberOfVertices(vertexNumber_);
+    subTrees[i]->setVertexScalars(vertexScalars_);
+    subTrees[i]->setVertexPositions(vertexPositions_);
+    subTrees[i]->setTriangulation(triangulation_);
+    subTrees[i]->setVertexSoSoffsets(vertexSoSoffsets_);
+    subTrees[i]->setVertexOrder(&vertexOrder);
+  }
+
+  // 1) build the merge tree
+  // 2) build the split tree
 #ifdef withOpenMP
-#pragma omp section
+#pragma omp parallel for num_threads(threadNumber_)
 #endif
-    {
-      // 2) build the split tree
-      splitTree_.setMaximumList(*maximumList_);
-      splitTree_.setNumberOfVertices(vertexNumber_);
-      splitTree_.setVertexScalars(vertexScalars_);
-      splitTree_.setVertexPositions(vertexPositions_);
-      splitTree_.setVertexSoSoffsets(vertexSoSoffsets_);
-      splitTree_.setTriangulation(triangulation_);
-      splitTree_.build();
-    }
+  for(int i = 0; i < 2; i++){
+    subTrees[i]->build();
   }
 
+  for(int i = 0; i < 2; i++)
+    subTrees[i]->setVertexOrder(NULL);
+
   // note: at this point, the split tree is layed out upside down.
   
   // 3) merge the two trees into the contour tree
@@ -2530,28 +3205,52 @@ int ContourTree::combineTrees(){
     return -1;
   
   queue<const Node *> nodeQueue;
-  const Node          *mergeNode = NULL, *splitNode = NULL;
   int                 initNumber = 0;
+
+  // the contour tree ends up with one node per vertex
+  nodeList_.reserve(vertexNumber_);
+  arcList_.reserve(vertexNumber_);
+
+  vector<char> isMergeNodeEligible, isSplitNodeEligible;
   
   do{
 
     int initQueueSize = (int)nodeQueue.size();
 
-    for(int i = 0; i < mergeTree_.getNumberOfNodes(); i++){
-      mergeNode = mergeTree_.getNode(i);
-      splitNode = splitTree_.getVertexNode(mergeNode->getVertexId());
-      if(isNodeEligible(mergeNode)){
-        nodeQueue.push(mergeNode);
+    // the eligibility tests are independent, the eligible nodes are then
+    // queued in node order
+    int mergeNodeNumber = mergeTree_.getNumberOfNodes(),
+      splitNodeNumber = splitTree_.getNumberOfNodes();
+    isMergeNodeEligible.resize(mergeNodeNumber);
+    isSplitNodeEligible.resize(splitNodeNumber);
+
+#ifdef withOpenMP
+#pragma omp parallel num_threads(threadNumber_)
+#endif
+    {
+#ifdef withOpenMP
+#pragma omp for
+#endif
+      for(int i = 0; i < mergeNodeNumber; i++){
+        isMergeNodeEligible[i] = isNodeEligible(mergeTree_.getNode(i));
       }
-    }
-    for(int i = 0; i < splitTree_.getNumberOfNodes(); i++){
-      splitNode = splitTree_.getNode(i);
-      mergeNode = mergeTree_.getVertexNode(splitNode->getVertexId());
-      if(isNodeEligible(splitNode)){
-        nodeQueue.push(splitNode);
+#ifdef withOpenMP
+#pragma omp for
+#endif
+      for(int i = 0; i < splitNodeNumber; i++){
+        isSplitNodeEligible[i] = isNodeEligible(splitTree_.getNode(i));
       }
     }
 
+    for(int i = 0; i < mergeNodeNumber; i++){
+      if(isMergeNodeEligible[i])
+        nodeQueue.push(mergeTree_.getNode(i));
+    }
+    for(int i = 0; i < splitNodeNumber; i++){
+      if(isSplitNodeEligible[i])
+        nodeQueue.push(splitTree_.getNode(i));
+    }
+
     // no more eligible nodes
     if((int) nodeQueue.size() == initQueueSize) break;
 
@@ -2705,8 +3404,32 @@ int ContourTree::finalize(){
     }
   }
 
+  // 1) end node of the chain of regular nodes following each up arc of each
+  // non-regular node (independent walks)
+  int nodeNumber = (int) nodeList_.size();
+  vector<int> upArcOffsets(nodeNumber + 1, 0);
+  for(int i = 0; i < nodeNumber; i++){
+    upArcOffsets[i + 1] = upArcOffsets[i];
+    if(!isRegularNode(i))
+      upArcOffsets[i + 1] += nodeList_[i].getNumberOfUpArcs();
+  }
+
+  vector<int> chainEnds(upArcOffsets[nodeNumber], -1);
+
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber_) schedule(dynamic, 64)
+#endif
+  for(int i = 0; i < nodeNumber; i++){
+    for(int j = upArcOffsets[i]; j < upArcOffsets[i + 1]; j++){
+      chainEnds[j] = getChainEnd(i, j - upArcOffsets[i]);
+    }
+  }
+
+  // 2) super arcs, numbered in breadth-first order from the minima
   vector<bool>  inQueue(nodeList_.size(), false);
   queue<int>    nodeIdQueue;
+  vector<pair<int, int> > superArcChains;
+  int firstSuperArcId = (int) superArcList_.size();
 
   for(int i = 0; i < (int) nodeList_.size(); i++){
     if(!nodeList_[i].getNumberOfDownArcs()){
@@ -2721,8 +3444,15 @@ int ContourTree::finalize(){
     nodeIdQueue.pop();
 
     for(int i = 0; i < nodeList_[nodeId].getNumberOfUpArcs(); i++){
-      int nextNodeId = 
-        finalizeSuperArc(nodeId, i);
+
+      int superArcId = openSuperArc(nodeId);
+      superArcChains.push_back(pair<int, int>(nodeId, i));
+
+      int nextNodeId = chainEnds[upArcOffsets[nodeId] + i];
+      if(nextNodeId != nodeId){
+        superArcList_[superArcId].setUpNodeId(nextNodeId);
+        nodeList_[nextNodeId].addDownSuperArcId(superArcId);
+      }
       
       if(!inQueue[nextNodeId]){
         nodeIdQueue.push(nextNodeId);
@@ -2731,44 +3461,49 @@ int ContourTree::finalize(){
     }
   }
 
+  // 3) regular nodes of each super arc (independent walks)
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber_) schedule(dynamic, 64)
+#endif
+  for(int i = 0; i < (int) superArcChains.size(); i++){
+    finalizeSuperArc(firstSuperArcId + i, 
+      superArcChains[i].first, superArcChains[i].second);
+  }
+
   return 0;
 }
 
-int ContourTree::finalizeSuperArc(const int &nodeId, const int &arcId){
+int ContourTree::getChainEnd(const int &nodeId, const int &arcId) const{
+
+  int currentNodeId = 
+    arcList_[nodeList_[nodeId].getUpArcId(arcId)].getUpNodeId();
+
+  while((currentNodeId != nodeId)&&(isRegularNode(currentNodeId))){
+    currentNodeId =
+      arcList_[nodeList_[currentNodeId].getUpArcId(0)].getUpNodeId();
+  }
+
+  return currentNodeId;
+}
+
+int ContourTree::finalizeSuperArc(const int &superArcId, 
+  const int &nodeId, const int &arcId){
 
   if((nodeId < 0)||(nodeId >= (int) nodeList_.size())) return -1;
   if((arcId < 0)||(arcId >= nodeList_[nodeId].getNumberOfUpArcs())) return -2;
 
-  int superArcId = openSuperArc(nodeId);
-
-  int currentNodeId = nodeId;
+  int currentNodeId = 
+    arcList_[nodeList_[nodeId].getUpArcId(arcId)].getUpNodeId();
  
-  do{
-    
-    if(nodeList_[currentNodeId].getNumberOfUpArcs()){
-      if(currentNodeId != nodeId){
+  while((currentNodeId != nodeId)&&(isRegularNode(currentNodeId))){
         
-        superArcList_[superArcId].appendRegularNode(currentNodeId);
-        vertex2superArc_[nodeList_[currentNodeId].getVertexId()] = superArcId;
-        vertex2superArcNode_[nodeList_[currentNodeId].getVertexId()] =  
-          superArcList_[superArcId].getNumberOfRegularNodes() - 1;
-
-        currentNodeId =
-          arcList_[nodeList_[currentNodeId].getUpArcId(0)].getUpNodeId();
-      }
-      else{
-        currentNodeId = 
-          arcList_[nodeList_[currentNodeId].getUpArcId(arcId)].getUpNodeId();
-      }
-    }
+    superArcList_[superArcId].appendRegularNode(currentNodeId);
+    vertex2superArc_[nodeList_[currentNodeId].getVertexId()] = superArcId;
+    vertex2superArcNode_[nodeList_[currentNodeId].getVertexId()] =  
+      superArcList_[superArcId].getNumberOfRegularNodes() - 1;
 
-  }while((currentNodeId != nodeId)
-	 &&(nodeList_[currentNodeId].getNumberOfUpArcs() == 1)
-	 &&(nodeList_[currentNodeId].getNumberOfDownArcs() == 1));
-  
-  if(currentNodeId != nodeId){
-    superArcList_[superArcId].setUpNodeId(currentNodeId);
-    nodeList_[currentNodeId].addDownSuperArcId(superArcId);
+    currentNodeId =
+      arcList_[nodeList_[currentNodeId].getUpArcId(0)].getUpNodeId();
   }
 
   return currentNodeId;
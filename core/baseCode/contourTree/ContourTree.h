@@ -21,11 +21,22 @@
 #include                <Triangulation.h>
 
 #include                <math.h>
+#include                <cstring>
 
 #include                <queue>
 #include                <set>
 #include                <vector>
 
+#ifdef __APPLE__
+#include                <algorithm>
+#else
+#ifdef _WIN32
+#include                <algorithm>
+#else
+#include                <parallel/algorithm>
+#endif
+#endif
+
 using namespace std;
 
 namespace ttk{
@@ -253,6 +264,10 @@ namespace ttk{
 			  const bool &isSubLevelSet = true);
 
     bool buildPlanarLayout(const double &scaleX, const double &scaleY);
+
+    // position of each vertex in the ascending (function value, SoS offset)
+    // order, computed with a parallel sort.
+    int buildVertexOrder(vector<int> &vertexOrder) const;
       
     int buildSaddleList(vector<int> &vertexList) const;
       
@@ -263,9 +278,22 @@ namespace ttk{
     int clearRoot(const int &vertexId);
 
     int exportPersistenceCurve(const string &fileName = "output.plot") const;
+
+    // binary exports: little-endian, small header (magic, version, flags,
+    // sizes and section offsets) followed by the sections. if compressed, 
+    // the integer sections are stored as delta-encoded varints.
+    int exportPersistenceCurveToBinary(const string &fileName,
+      const bool &compressed = false) const;
       
     int exportPersistenceDiagram(
 				 const string &fileName = "output.plot") const;
+
+    // (birth, death) doubles only, hence never compressed.
+    int exportPersistenceDiagramToBinary(const string &fileName) const;
+
+    // super arcs (with their regular nodes) and node scalars.
+    int exportToBinary(const string &fileName, 
+      const bool &compressed = false) const;
       
     int exportToSvg(const string &fileName,
 		    const double &scaleX = 1, const double &scaleY = 1);
@@ -412,6 +440,23 @@ namespace ttk{
     int moveRegularNode(const Node *n, const Node *oldDown, const Node *oldUp, 
 			const Node *newDown, const Node *newUp);
 
+    // restores the nodes, super arcs and arcs of a tree written with 
+    // exportToBinary(), as well as its type and extremum lists. the scalars 
+    // of the nodes are stored in nodeScalars if provided. if no scalar field 
+    // (respectively SoS offsets) has been set, the stored node scalars 
+    // (respectively SoS offsets) are used, such that the persistence pairs 
+    // can be queried on the reloaded tree.
+    int loadFromBinary(const string &fileName, 
+      vector<double> *nodeScalars = NULL);
+
+    // returns -1 if the file is not a valid binary persistence curve file.
+    static int loadPersistenceCurveFromBinary(const string &fileName,
+      vector<pair<double, int> > &plot);
+
+    // returns -1 if the file is not a valid binary persistence diagram file.
+    static int loadPersistenceDiagramFromBinary(const string &fileName,
+      vector<pair<double, double> > &diagram);
+
     int print(ostream &stream, const int &debugLevel) const; 
 
     inline void setMaximumList(vector<int> &maximumList){
@@ -450,6 +495,12 @@ namespace ttk{
     inline void setVertexSoSoffsets(vector<int> *vertexSoSoffsets){
       vertexSoSoffsets_ = vertexSoSoffsets;};
 
+    // optional, see buildVertexOrder(). the same order can be shared by the 
+    // merge and split trees of a given field. if not provided, build() 
+    // computes it.
+    inline void setVertexOrder(const vector<int> *vertexOrder){
+      vertexOrder_ = vertexOrder;};
+
     virtual int simplify(const double &simplificationThreshold,
 		 ContourTreeSimplificationMetric *metric = NULL);
 
@@ -492,8 +543,13 @@ namespace ttk{
     double                      minScalar_, maxScalar_;
     const vector<real>          *vertexScalars_;
     vector<int>                 *vertexSoSoffsets_;
+    const vector<int>           *vertexOrder_;
     Triangulation               *triangulation_;
     vector<int>                 *minimumList_, *maximumList_;
+    // storage of the data restored by loadFromBinary()
+    vector<int>                 loadedMinimumList_, loadedMaximumList_,
+      loadedSoSoffsets_;
+    vector<real>                loadedScalars_;
     vector<Node>                nodeList_, originalNodeList_;
     vector<Arc>                 arcList_;
     vector<SuperArc>            superArcList_, originalSuperArcList_;
@@ -553,10 +609,19 @@ namespace ttk{
 
     int finalize();
 
-    int finalizeSuperArc(const int &nodeId, const int &arcId);
+    // appends the regular nodes following the up arc arcId of nodeId to the
+    // super arc superArcId. returns the id of the super arc up node.
+    int finalizeSuperArc(const int &superArcId, 
+      const int &nodeId, const int &arcId);
+
+    int getChainEnd(const int &nodeId, const int &arcId) const;
 
     bool isNodeEligible(const Node *n) const;
 
+    inline bool isRegularNode(const int &nodeId) const{
+      return ((nodeList_[nodeId].getNumberOfUpArcs() == 1)
+        &&(nodeList_[nodeId].getNumberOfDownArcs() == 1));};
+
     SubLevelSetTree             mergeTree_, splitTree_;
   };
 }
@@ -5,6 +5,7 @@ DiscreteGradient::DiscreteGradient():
   ReverseSaddleMaximumConnection{},
   ReverseSaddleSaddleConnection{},
   CollectPersistencePairs{},
+  CollectHierarchy{},
 
   dimensionality_{-1},
   gradient_{},
@@ -30,7 +31,9 @@ DiscreteGradient::DiscreteGradient():
   outputGradientGlyphs_cells_{},
   outputGradientGlyphs_cells_pairTypes_{},
 
-  outputPersistencePairs_{}
+  outputPersistencePairs_{},
+
+  hierarchy_{}
 {}
 
 DiscreteGradient::~DiscreteGradient(){
@@ -772,6 +775,344 @@ int DiscreteGradient::reverseDescendingPathOnWall(const vector<Cell>& vpath){
   return 0;
 }
 
+int DiscreteGradient::addReversalToHierarchy(const char type,
+    const double persistence,
+    const vector<Cell>& vpath){
+  hierarchy_.types_.push_back(type);
+  hierarchy_.persistences_.push_back(persistence);
+  hierarchy_.pathIds_.push_back(hierarchy_.addPath(vpath));
+  hierarchy_.offsets_.push_back(hierarchy_.pathIds_.size());
+
+  return 0;
+}
+
+int DiscreteGradient::addReversalToHierarchy(const double persistence,
+    const vector<int>& segmentIds){
+  // the segment ids are local to the current saddle-maximum pass, see
+  // addSegmentsToHierarchy()
+  hierarchy_.types_.push_back(GradientHierarchy::ascendingPath);
+  hierarchy_.persistences_.push_back(persistence);
+  hierarchy_.pathIds_.insert(hierarchy_.pathIds_.end(),
+      segmentIds.begin(), segmentIds.end());
+  hierarchy_.offsets_.push_back(hierarchy_.pathIds_.size());
+
+  return 0;
+}
+
+int DiscreteGradient::addSegmentsToHierarchy(const vector<Segment>& segments,
+    const int firstReversal){
+  const int numberOfSegments=segments.size();
+  const int numberOfReversals=hierarchy_.getNumberOfReversals();
+  const int firstPathIdIndex=hierarchy_.offsets_[firstReversal];
+  const int numberOfPathIdIndices=hierarchy_.pathIds_.size();
+
+  // store the cells of the reversed segments of the pass once, by increasing
+  // segment id so that the replay reverses them in the same order
+  vector<int> pathIds(numberOfSegments, -1);
+  for(int i=firstPathIdIndex; i<numberOfPathIdIndices; ++i)
+    pathIds[hierarchy_.pathIds_[i]]=0;
+  for(int i=0; i<numberOfSegments; ++i){
+    if(pathIds[i]==0)
+      pathIds[i]=hierarchy_.addPath(segments[i].cells_)+1;
+  }
+
+  for(int i=firstReversal; i<numberOfReversals; ++i){
+    if(hierarchy_.types_[i]!=GradientHierarchy::ascendingPath) continue;
+
+    for(int j=hierarchy_.offsets_[i]; j<hierarchy_.offsets_[i+1]; ++j)
+      hierarchy_.pathIds_[j]=pathIds[hierarchy_.pathIds_[j]]-1;
+  }
+
+  return 0;
+}
+
+int DiscreteGradient::getHierarchyPath(const int pathId,
+    const int firstDim,
+    const int secondDim,
+    vector<Cell>& vpath) const{
+  vpath.clear();
+  const int firstCell=hierarchy_.pathOffsets_[pathId];
+  for(int i=firstCell; i<hierarchy_.pathOffsets_[pathId+1]; ++i){
+    const int cellDim=((i-firstCell)%2) ? secondDim : firstDim;
+    vpath.push_back(Cell(cellDim, hierarchy_.cells_[i]));
+  }
+
+  return 0;
+}
+
+int DiscreteGradient::replayHierarchy(const int numberOfReversals){
+  Timer t;
+
+#ifndef withKamikaze
+  if(hierarchy_.isEmpty())
+    return -1;
+  if(hierarchy_.dimensionality_!=dimensionality_)
+    return -2;
+#endif
+
+  int numberOfReplayedReversals=hierarchy_.getNumberOfReversals();
+  if(numberOfReversals>=0 and numberOfReversals<numberOfReplayedReversals)
+    numberOfReplayedReversals=numberOfReversals;
+
+  gradient_=hierarchy_.gradient_;
+  dmtMax2PL_=hierarchy_.dmtMax2PL_;
+
+  // the saddle-maximum segments are toggled by the cancellations and
+  // reversed at the end of their pass, as in reverseSaddleMaximumConnections()
+  vector<char> isReversedPath(hierarchy_.getNumberOfPaths(), false);
+  vector<int> toggledPaths;
+  vector<Cell> vpath;
+  for(int i=0; i<=numberOfReplayedReversals; ++i){
+    const bool isLastReversal=(i==numberOfReplayedReversals);
+    const char type=isLastReversal ? -1 : hierarchy_.types_[i];
+
+    if(type==GradientHierarchy::ascendingPath){
+      for(int j=hierarchy_.offsets_[i]; j<hierarchy_.offsets_[i+1]; ++j){
+        const int pathId=hierarchy_.pathIds_[j];
+        isReversedPath[pathId]=!isReversedPath[pathId];
+        toggledPaths.push_back(pathId);
+      }
+      continue;
+    }
+
+    if(toggledPaths.size()){
+      std::sort(toggledPaths.begin(), toggledPaths.end());
+      toggledPaths.erase(std::unique(toggledPaths.begin(), toggledPaths.end()),
+          toggledPaths.end());
+      for(const int pathId : toggledPaths){
+        if(isReversedPath[pathId]){
+          getHierarchyPath(pathId, dimensionality_-1, dimensionality_, vpath);
+          reverseAscendingPath(vpath);
+          isReversedPath[pathId]=false;
+        }
+      }
+      toggledPaths.clear();
+    }
+
+    if(isLastReversal) break;
+
+    const int pathId=hierarchy_.pathIds_[hierarchy_.offsets_[i]];
+    if(type==GradientHierarchy::ascendingPathOnWall){
+      getHierarchyPath(pathId, 1, 2, vpath);
+      reverseAscendingPathOnWall(vpath);
+    }
+    else if(type==GradientHierarchy::descendingPathOnWall){
+      getHierarchyPath(pathId, 2, 1, vpath);
+      reverseDescendingPathOnWall(vpath);
+    }
+  }
+
+  {
+    stringstream msg;
+    msg << "[DiscreteGradient] " << numberOfReplayedReversals << "/"
+      << hierarchy_.getNumberOfReversals() << " reversal(s) replayed in "
+      << t.getElapsedTime() << " s." << endl;
+    dMsg(cout, msg.str(), timeMsg);
+  }
+
+  return 0;
+}
+
+// binary layout (host byte order) :
+// magic, version, field key, dimensionality, number of cells by dimension,
+// initial gradient (size+data for each array), dmtMax2PL,
+// types, persistences, offsets (size+data for each array) of the
+// cancellations, their path ids, path offsets and path cells
+static const char hierarchyMagic[8]={'T','T','K','G','R','A','D','H'};
+static const int hierarchyVersion=3;
+
+template <typename T>
+static int writeHierarchyArray(ofstream& file, const vector<T>& array){
+  const int size=array.size();
+  file.write(reinterpret_cast<const char*>(&size), sizeof(int));
+  if(size)
+    file.write(reinterpret_cast<const char*>(array.data()), size*sizeof(T));
+
+  return 0;
+}
+
+template <typename T>
+static int readHierarchyArray(ifstream& file, vector<T>& array){
+  int size{};
+  file.read(reinterpret_cast<char*>(&size), sizeof(int));
+  if(!file or size<0)
+    return -1;
+
+  array.resize(size);
+  if(size)
+    file.read(reinterpret_cast<char*>(array.data()), size*sizeof(T));
+  if(!file)
+    return -1;
+
+  return 0;
+}
+
+static bool isValidHierarchyOffsets(const vector<int>& offsets,
+    const int numberOfElements){
+  if(offsets.empty() or offsets[0]!=0 or offsets.back()!=numberOfElements)
+    return false;
+  for(size_t i=1; i<offsets.size(); ++i){
+    if(offsets[i]<offsets[i-1])
+      return false;
+  }
+
+  return true;
+}
+
+static bool isValidHierarchy(const GradientHierarchy& hierarchy){
+  const int numberOfReversals=hierarchy.types_.size();
+  if((int)hierarchy.persistences_.size()!=numberOfReversals or
+      (int)hierarchy.offsets_.size()!=numberOfReversals+1 or
+      !isValidHierarchyOffsets(hierarchy.offsets_, hierarchy.pathIds_.size()) or
+      !isValidHierarchyOffsets(hierarchy.pathOffsets_, hierarchy.cells_.size()))
+    return false;
+
+  for(int i=0; i<numberOfReversals; ++i){
+    const char type=hierarchy.types_[i];
+    const int numberOfPaths=hierarchy.offsets_[i+1]-hierarchy.offsets_[i];
+    if(type!=GradientHierarchy::ascendingPath and numberOfPaths!=1)
+      return false;
+    if(type<GradientHierarchy::ascendingPath or
+        type>GradientHierarchy::descendingPathOnWall)
+      return false;
+  }
+  for(const int pathId : hierarchy.pathIds_){
+    if(pathId<0 or pathId>=hierarchy.getNumberOfPaths())
+      return false;
+  }
+
+  return true;
+}
+
+int DiscreteGradient::writeHierarchy(const string& fileName) const{
+  Timer t;
+
+#ifndef withKamikaze
+  if(hierarchy_.isEmpty())
+    return -1;
+#endif
+
+  ofstream file(fileName.data(), ios::out | ios::binary);
+  if(!file){
+    stringstream msg;
+    msg << "[DiscreteGradient] Could not open file `" << fileName
+      << "'!" << endl;
+    dMsg(cerr, msg.str(), fatalMsg);
+    return -2;
+  }
+
+  file.write(hierarchyMagic, sizeof(hierarchyMagic));
+  file.write(reinterpret_cast<const char*>(&hierarchyVersion), sizeof(int));
+  file.write(reinterpret_cast<const char*>(&hierarchy_.key_), sizeof(unsigned long long));
+  file.write(reinterpret_cast<const char*>(&hierarchy_.dimensionality_), sizeof(int));
+  writeHierarchyArray(file, hierarchy_.numberOfCells_);
+
+  for(int i=0; i<hierarchy_.dimensionality_; ++i){
+    writeHierarchyArray(file, hierarchy_.gradient_[i][i]);
+    writeHierarchyArray(file, hierarchy_.gradient_[i][i+1]);
+  }
+  writeHierarchyArray(file, hierarchy_.dmtMax2PL_);
+
+  writeHierarchyArray(file, hierarchy_.types_);
+  writeHierarchyArray(file, hierarchy_.persistences_);
+  writeHierarchyArray(file, hierarchy_.offsets_);
+  writeHierarchyArray(file, hierarchy_.pathIds_);
+  writeHierarchyArray(file, hierarchy_.pathOffsets_);
+  writeHierarchyArray(file, hierarchy_.cells_);
+
+  if(!file){
+    stringstream msg;
+    msg << "[DiscreteGradient] Could not write file `" << fileName
+      << "'!" << endl;
+    dMsg(cerr, msg.str(), fatalMsg);
+    return -3;
+  }
+
+  {
+    stringstream msg;
+    msg << "[DiscreteGradient] Hierarchy written to `" << fileName << "' in "
+      << t.getElapsedTime() << " s." << endl;
+    dMsg(cout, msg.str(), timeMsg);
+  }
+
+  return 0;
+}
+
+int DiscreteGradient::readHierarchy(const string& fileName){
+  Timer t;
+
+  hierarchy_.clear();
+
+  ifstream file(fileName.data(), ios::in | ios::binary);
+  if(!file)
+    return -1;
+
+  char magic[sizeof(hierarchyMagic)];
+  int version{};
+  file.read(magic, sizeof(magic));
+  file.read(reinterpret_cast<char*>(&version), sizeof(int));
+  if(!file or !std::equal(magic, magic+sizeof(magic), hierarchyMagic) or version!=hierarchyVersion){
+    stringstream msg;
+    msg << "[DiscreteGradient] `" << fileName
+      << "' is not a gradient hierarchy file." << endl;
+    dMsg(cerr, msg.str(), fatalMsg);
+    return -2;
+  }
+
+  // the hierarchy must match the current triangulation
+  int ret{};
+  file.read(reinterpret_cast<char*>(&hierarchy_.key_), sizeof(unsigned long long));
+  file.read(reinterpret_cast<char*>(&hierarchy_.dimensionality_), sizeof(int));
+  ret|=readHierarchyArray(file, hierarchy_.numberOfCells_);
+  bool isMatching=(!ret and hierarchy_.dimensionality_==dimensionality_ and
+      (int)hierarchy_.numberOfCells_.size()==getNumberOfDimensions());
+  for(int i=0; isMatching and i<getNumberOfDimensions(); ++i)
+    isMatching=(hierarchy_.numberOfCells_[i]==getNumberOfCells(i));
+  if(!isMatching){
+    stringstream msg;
+    msg << "[DiscreteGradient] `" << fileName
+      << "' does not match the input triangulation." << endl;
+    dMsg(cerr, msg.str(), fatalMsg);
+    hierarchy_.clear();
+    return -3;
+  }
+
+  hierarchy_.gradient_.resize(dimensionality_);
+  for(int i=0; i<dimensionality_; ++i){
+    hierarchy_.gradient_[i].resize(getNumberOfDimensions());
+    ret|=readHierarchyArray(file, hierarchy_.gradient_[i][i]);
+    ret|=readHierarchyArray(file, hierarchy_.gradient_[i][i+1]);
+  }
+  ret|=readHierarchyArray(file, hierarchy_.dmtMax2PL_);
+
+  ret|=readHierarchyArray(file, hierarchy_.types_);
+  ret|=readHierarchyArray(file, hierarchy_.persistences_);
+  ret|=readHierarchyArray(file, hierarchy_.offsets_);
+  ret|=readHierarchyArray(file, hierarchy_.pathIds_);
+  ret|=readHierarchyArray(file, hierarchy_.pathOffsets_);
+  ret|=readHierarchyArray(file, hierarchy_.cells_);
+
+  if(!ret and !isValidHierarchy(hierarchy_))
+    ret=-1;
+  if(ret){
+    stringstream msg;
+    msg << "[DiscreteGradient] `" << fileName << "' is corrupted." << endl;
+    dMsg(cerr, msg.str(), fatalMsg);
+    hierarchy_.clear();
+    return -4;
+  }
+
+  {
+    stringstream msg;
+    msg << "[DiscreteGradient] Hierarchy of "
+      << hierarchy_.getNumberOfReversals() << " reversal(s) read from `"
+      << fileName << "' in " << t.getElapsedTime() << " s." << endl;
+    dMsg(cout, msg.str(), timeMsg);
+  }
+
+  return 0;
+}
+
 int DiscreteGradient::getEdgeIncenter(const int edgeId, float incenter[3]) const{
   int vertexId[2];
   inputTriangulation_->getEdgeVertex(edgeId, 0, vertexId[0]);
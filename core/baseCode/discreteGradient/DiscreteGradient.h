@@ -19,6 +19,7 @@
 #include<Triangulation.h>
 #include<Geometry.h>
 #include<Wrapper.h>
+#include<Hash.h>
 #include<ScalarFieldCriticalPoints.h>
 
 #include<queue>
@@ -276,6 +277,83 @@ namespace ttk{
     int numberOfSlots_;
   };
 
+  // ordered list of the cancellations performed by
+  // DiscreteGradient::reverseGradient(), replayable on the initial gradient :
+  // each cancellation reverses its paths (a wall path, or the saddle-maximum
+  // segments of its vpath, which are toggled)
+  struct GradientHierarchy{
+    enum ReversalType{
+      ascendingPath=0,
+      ascendingPathOnWall,
+      descendingPathOnWall
+    };
+
+    GradientHierarchy():
+      key_{},
+      dimensionality_{-1}
+    {}
+
+    int clear(){
+      key_=0;
+      dimensionality_=-1;
+      numberOfCells_.clear();
+      gradient_.clear();
+      dmtMax2PL_.clear();
+      types_.clear();
+      persistences_.clear();
+      offsets_.clear();
+      pathIds_.clear();
+      pathOffsets_.clear();
+      cells_.clear();
+
+      return 0;
+    }
+
+    bool isEmpty() const{
+      return gradient_.empty();
+    }
+
+    int getNumberOfReversals() const{
+      return types_.size();
+    }
+
+    // the cancellations are in processing order : a threshold maps to the
+    // prefix of the cancellations of lower or equal persistence
+    int getNumberOfReversals(const double persistenceThreshold) const{
+      const int numberOfReversals=types_.size();
+      for(int i=0; i<numberOfReversals; ++i){
+        if(persistences_[i]>persistenceThreshold)
+          return i;
+      }
+      return numberOfReversals;
+    }
+
+    int getNumberOfPaths() const{
+      return pathOffsets_.size()-1;
+    }
+
+    int addPath(const vector<Cell>& path){
+      for(const Cell& cell : path)
+        cells_.push_back(cell.id_);
+      pathOffsets_.push_back(cells_.size());
+
+      return getNumberOfPaths()-1;
+    }
+
+    // see DiscreteGradient::getHierarchyKey()
+    unsigned long long key_;
+    int dimensionality_;
+    vector<int> numberOfCells_;
+    vector<vector<vector<int>>> gradient_;
+    vector<int> dmtMax2PL_;
+    vector<char> types_;
+    vector<double> persistences_;
+    vector<int> offsets_;
+    vector<int> pathIds_;
+    vector<int> pathOffsets_;
+    vector<int> cells_;
+  };
+
   template <typename dataType>
     struct SaddleMaximumVPathComparator{
       bool operator()(const pair<dataType,int>& v1, const pair<dataType,int>& v2) const{
@@ -346,6 +424,11 @@ namespace ttk{
         return 0;
       }
 
+      int setCollectHierarchy(const bool state){
+        CollectHierarchy=state;
+        return 0;
+      }
+
       template <typename dataType>
         dataType scalarMax(const Cell& cell, const dataType* const scalars) const;
 
@@ -487,7 +570,7 @@ namespace ttk{
             set<pair<dataType,int>,SaddleMaximumVPathComparator<dataType>>& S,
             vector<Segment>& segments,
             vector<VPath>& vpaths,
-            vector<CriticalPoint>& criticalPoints) const;
+            vector<CriticalPoint>& criticalPoints);
 
       template <typename dataType>
         int proto_processSaddleMaximumConnections(const int iterationThreshold,
@@ -499,10 +582,11 @@ namespace ttk{
             vector<int>& pl2dmt_maximum,
             vector<Segment>& segments,
             vector<VPath>& vpaths,
-            vector<CriticalPoint>& criticalPoints) const;
+            vector<CriticalPoint>& criticalPoints);
 
       template <typename dataType>
-        int reverseSaddleMaximumConnections(const vector<Segment>& segments);
+        int reverseSaddleMaximumConnections(const vector<Segment>& segments,
+            const int firstReversal);
 
       template <typename dataType>
         int simplifySaddleMaximumConnections(const vector<char>& isRemovableMaximum,
@@ -769,6 +853,41 @@ namespace ttk{
 
       int reverseDescendingPathOnWall(const vector<Cell>& vpath);
 
+      int addReversalToHierarchy(const char type,
+          const double persistence,
+          const vector<Cell>& vpath);
+
+      int addReversalToHierarchy(const double persistence,
+          const vector<int>& segmentIds);
+
+      int addSegmentsToHierarchy(const vector<Segment>& segments,
+          const int firstReversal);
+
+      int getHierarchyPath(const int pathId,
+          const int firstDim,
+          const int secondDim,
+          vector<Cell>& vpath) const;
+
+      template <typename dataType>
+        unsigned long long getHierarchyKey() const;
+
+      template <typename dataType>
+        int buildHierarchy(const unsigned long long key);
+
+      int replayHierarchy(const int numberOfReversals);
+
+      int writeHierarchy(const string& fileName) const;
+
+      int readHierarchy(const string& fileName);
+
+      int clearHierarchy(){
+        return hierarchy_.clear();
+      }
+
+      const GradientHierarchy& getHierarchy() const{
+        return hierarchy_;
+      }
+
       int getEdgeIncenter(int edgeId, float incenter[3]) const;
 
       int getTriangleIncenter(int triangleId, float incenter[3]) const;
@@ -796,6 +915,7 @@ namespace ttk{
       bool ReverseSaddleMaximumConnection;
       bool ReverseSaddleSaddleConnection;
       bool CollectPersistencePairs;
+      bool CollectHierarchy;
 
       int dimensionality_;
       vector<vector<vector<int>>> gradient_;
@@ -822,6 +942,8 @@ namespace ttk{
       vector<int>* outputGradientGlyphs_cells_pairTypes_;
 
       vector<tuple<Cell,Cell>>* outputPersistencePairs_;
+
+      GradientHierarchy hierarchy_;
   };
 }
 
@@ -1616,14 +1738,14 @@ int DiscreteGradient::buildGradient(){
   for(int i=0; i<numberOfDimensions; ++i)
     numberOfCells[i]=getNumberOfCells(i);
 
+  // the gradient memory is reused across calls
   dmtMax2PL_.clear();
-  gradient_.clear();
   gradient_.resize(dimensionality_);
   for(int i=0; i<dimensionality_; ++i){
     // init gradient memory
     gradient_[i].resize(numberOfDimensions);
-    gradient_[i][i].resize(numberOfCells[i], -1);
-    gradient_[i][i+1].resize(numberOfCells[i+1], -1);
+    gradient_[i][i].assign(numberOfCells[i], -1);
+    gradient_[i][i+1].assign(numberOfCells[i+1], -1);
 
     // compute gradient pairs
     assignGradient<dataType>(i, scalars, offsets, gradient_[i]);
@@ -2519,7 +2641,7 @@ int DiscreteGradient::processSaddleMaximumConnections(const int iterationThresho
     set<pair<dataType,int>,SaddleMaximumVPathComparator<dataType>>& S,
     vector<Segment>& segments,
     vector<VPath>& vpaths,
-    vector<CriticalPoint>& criticalPoints) const{
+    vector<CriticalPoint>& criticalPoints){
   Timer t;
 
   const dataType* const scalars=static_cast<dataType*>(inputScalarField_);
@@ -2545,6 +2667,9 @@ int DiscreteGradient::processSaddleMaximumConnections(const int iterationThresho
         vpath.states_[i]*=-1;
       }
 
+      if(CollectHierarchy)
+        addReversalToHierarchy(vpath.persistence_, vpath.segments_);
+
       // search new destination for newVPath
       int newDestinationId=-1;
       const int sourceId=vpath.source_;
@@ -2651,11 +2776,14 @@ int DiscreteGradient::processSaddleMaximumConnections(const int iterationThresho
 }
 
 template <typename dataType>
-int DiscreteGradient::reverseSaddleMaximumConnections(const vector<Segment>& segments){
+int DiscreteGradient::reverseSaddleMaximumConnections(const vector<Segment>& segments,
+    const int firstReversal){
   Timer t;
 
-  const int numberOfSegments=segments.size();
+  if(CollectHierarchy)
+    addSegmentsToHierarchy(segments, firstReversal);
 
+  const int numberOfSegments=segments.size();
   for(int i=0; i<numberOfSegments; ++i){
     const Segment& segment=segments[i];
     if(segment.isValid_ and segment.orientation_==false)
@@ -2689,10 +2817,11 @@ int DiscreteGradient::simplifySaddleMaximumConnections(const vector<char>& isRem
   orderSaddleMaximumConnections<dataType>(vpaths, S);
 
   // Part 3 : process the vpaths
+  const int firstReversal=hierarchy_.getNumberOfReversals();
   processSaddleMaximumConnections<dataType>(iterationThreshold, S, segments, vpaths, criticalPoints);
 
   // Part 4 : gradient reversal
-  reverseSaddleMaximumConnections<dataType>(segments);
+  reverseSaddleMaximumConnections<dataType>(segments, firstReversal);
 
   {
     stringstream msg;
@@ -2886,7 +3015,7 @@ int DiscreteGradient::proto_processSaddleMaximumConnections(const int iterationT
     vector<int>& pl2dmt_maximum,
     vector<Segment>& segments,
     vector<VPath>& vpaths,
-    vector<CriticalPoint>& criticalPoints) const{
+    vector<CriticalPoint>& criticalPoints){
   Timer t;
 
   const dataType* const scalars=static_cast<dataType*>(inputScalarField_);
@@ -3068,6 +3197,9 @@ int DiscreteGradient::proto_processSaddleMaximumConnections(const int iterationT
         vpath.states_[i]*=-1;
       }
 
+      if(CollectHierarchy)
+        addReversalToHierarchy(vpath.persistence_, vpath.segments_);
+
       // search new destination for newVPath
       int newDestinationId=-1;
       const int sourceId=vpath.source_;
@@ -3220,6 +3352,7 @@ int DiscreteGradient::proto_simplifySaddleMaximumConnections(const vector<pair<i
   orderSaddleMaximumConnections<dataType>(vpaths, S);
 
   // Part 3 : process the vpaths
+  const int firstReversal=hierarchy_.getNumberOfReversals();
   proto_processSaddleMaximumConnections<dataType>(iterationThreshold,
       isPL,
       allowBoundary,
@@ -3232,7 +3365,7 @@ int DiscreteGradient::proto_simplifySaddleMaximumConnections(const vector<pair<i
       dmt_criticalPoints);
 
   // Part 4 : gradient reversal
-  reverseSaddleMaximumConnections<dataType>(segments);
+  reverseSaddleMaximumConnections<dataType>(segments, firstReversal);
 
   {
     stringstream msg;
@@ -3572,6 +3705,9 @@ int DiscreteGradient::processSaddleSaddleConnections1(const int iterationThresho
         }
 
         reverseAscendingPathOnWall(path);
+
+        if(CollectHierarchy)
+          addReversalToHierarchy(GradientHierarchy::ascendingPathOnWall, vpath.persistence_, path);
       }
 
       // add persistence pair to collection if necessary
@@ -3908,8 +4044,12 @@ int DiscreteGradient::proto_processSaddleSaddleConnections1(const int iterationT
           vpath.invalidate();
       }
 
-      if(vpath.isValid_)
+      if(vpath.isValid_){
         reverseAscendingPathOnWall(path);
+
+        if(CollectHierarchy)
+          addReversalToHierarchy(GradientHierarchy::ascendingPathOnWall, vpath.persistence_, path);
+      }
     }
 
     if(vpath.isValid_){
@@ -4503,6 +4643,9 @@ int DiscreteGradient::processSaddleSaddleConnections2(const int iterationThresho
         }
 
         reverseDescendingPathOnWall(path);
+
+        if(CollectHierarchy)
+          addReversalToHierarchy(GradientHierarchy::descendingPathOnWall, vpath.persistence_, path);
       }
 
       // add persistence pair to collection if necessary
@@ -4839,8 +4982,12 @@ int DiscreteGradient::proto_processSaddleSaddleConnections2(const int iterationT
           vpath.invalidate();
       }
 
-      if(vpath.isValid_)
+      if(vpath.isValid_){
         reverseDescendingPathOnWall(path);
+
+        if(CollectHierarchy)
+          addReversalToHierarchy(GradientHierarchy::descendingPathOnWall, vpath.persistence_, path);
+      }
     }
 
     if(vpath.isValid_){
@@ -5199,4 +5346,56 @@ int DiscreteGradient::reverseGradient(){
   return 0;
 }
 
+template<typename dataType>
+unsigned long long DiscreteGradient::getHierarchyKey() const{
+  // the reversals depend on the connectivity, the scalars and offsets and
+  // the simplification parameters
+  unsigned long long key=Hash::addConnectivity(Hash::getBasis(),
+      inputTriangulation_, threadNumber_);
+
+  key=Hash::addValue(key, ReverseSaddleMaximumConnection);
+  key=Hash::addValue(key, ReverseSaddleSaddleConnection);
+  key=Hash::addValue(key, IterationThreshold);
+
+  key=Hash::addValue(key, sizeof(dataType));
+  key=Hash::addArrays(key,
+      {{inputScalarField_, sizeof(dataType)}, {inputOffsets_, sizeof(int)}},
+      inputTriangulation_->getNumberOfVertices(), threadNumber_);
+
+  return key;
+}
+
+template<typename dataType>
+int DiscreteGradient::buildHierarchy(const unsigned long long key){
+  Timer t;
+
+  // assume that the initial gradient has been built
+  hierarchy_.clear();
+  hierarchy_.key_=key;
+  hierarchy_.dimensionality_=dimensionality_;
+  const int numberOfDimensions=getNumberOfDimensions();
+  for(int i=0; i<numberOfDimensions; ++i)
+    hierarchy_.numberOfCells_.push_back(getNumberOfCells(i));
+  hierarchy_.gradient_=gradient_;
+  hierarchy_.offsets_.push_back(0);
+  hierarchy_.pathOffsets_.push_back(0);
+
+  CollectHierarchy=true;
+
+  reverseGradient<dataType>();
+
+  CollectHierarchy=false;
+  hierarchy_.dmtMax2PL_=dmtMax2PL_;
+
+  {
+    stringstream msg;
+    msg << "[DiscreteGradient] Hierarchy of "
+      << hierarchy_.getNumberOfReversals() << " reversal(s) built in "
+      << t.getElapsedTime() << " s." << endl;
+    dMsg(cout, msg.str(), timeMsg);
+  }
+
+  return 0;
+}
+
 #endif // DISCRETEGRADIENT_H
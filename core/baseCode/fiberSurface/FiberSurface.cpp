@@ -1,80 +1,5 @@
 #include                  <FiberSurface.h>
 
-struct _fiberSurfaceVertexCmpX{
-  
-  bool operator()(
-    const FiberSurface::Vertex &v0, 
-    const FiberSurface::Vertex &v1){
-    
-    if(fabs(v0.p_[0] - v1.p_[0]) < pow(10, -DBL_DIG)){
-      // let's consider x coordinates are equal
-      if(fabs(v0.p_[1] - v1.p_[1]) < pow(10, -DBL_DIG)){
-        // let's consider y coordinates are equal
-        if(fabs(v0.p_[2] - v1.p_[2]) < pow(10, -DBL_DIG)){
-          // let's consider z coordinates are equal
-          // NOTE: the local Id should be sufficient
-          return v0.globalId_ < v1.globalId_;
-        }
-        else return v0.p_[2] < v1.p_[2];
-      }
-      else return v0.p_[1] < v1.p_[1];
-    }
-    else{
-      return v0.p_[0] < v1.p_[0];
-    }
-  }
-}FiberSurfaceVertexComparisonX;
-
-struct _fiberSurfaceVertexCmpY{
-  
-  bool operator()(
-    const FiberSurface::Vertex &v0, 
-    const FiberSurface::Vertex &v1){
-    
-    if(fabs(v0.p_[1] - v1.p_[1]) < pow(10, -DBL_DIG)){
-      // let's consider y coordinates are equal
-      if(fabs(v0.p_[2] - v1.p_[2]) < pow(10, -DBL_DIG)){
-        // let's consider z coordinates are equal
-        if(fabs(v0.p_[0] - v1.p_[0]) < pow(10, -DBL_DIG)){
-          // let's consider x coordinates are equal
-          // NOTE: the local Id should be sufficient
-          return v0.globalId_ < v1.globalId_;
-        }
-        else return v0.p_[0] < v1.p_[0];
-      }
-      else return v0.p_[2] < v1.p_[2];
-    }
-    else{
-      return v0.p_[1] < v1.p_[1];
-    }
-  }
-}FiberSurfaceVertexComparisonY;
-
-struct _fiberSurfaceVertexCmpZ{
-  
-  bool operator()(
-    const FiberSurface::Vertex &v0, 
-    const FiberSurface::Vertex &v1){
-    
-    if(fabs(v0.p_[2] - v1.p_[2]) < pow(10, -DBL_DIG)){
-      // let's consider z coordinates are equal
-      if(fabs(v0.p_[0] - v1.p_[0]) < pow(10, -DBL_DIG)){
-        // let's consider x coordinates are equal
-        if(fabs(v0.p_[1] - v1.p_[1]) < pow(10, -DBL_DIG)){
-          // let's consider y coordinates are equal
-          // NOTE: the local Id should be sufficient
-          return v0.globalId_ < v1.globalId_;
-        }
-        else return v0.p_[1] < v1.p_[1];
-      }
-      else return v0.p_[0] < v1.p_[0];
-    }
-    else{
-      return v0.p_[2] < v1.p_[2];
-    }
-  }
-}FiberSurfaceVertexComparisonZ;
-
 struct _fiberSurfaceTriangleCmp{
   
   bool operator()(
@@ -121,6 +46,10 @@ FiberSurface::FiberSurface(){
   pointSnappingThreshold_ = pow10(-FLT_DIG+1);
   edgeCollapseThreshold_ = pow10(-FLT_DIG+2);
   
+  chunkSink_ = NULL;
+  chunkSinkData_ = NULL;
+  chunkSize_ = 65536;
+  
 }
 
 FiberSurface::~FiberSurface(){
@@ -1227,6 +1156,11 @@ int FiberSurface::mergeEdges(const double &distanceThreshold) const{
     }
     
     bool hasMerged = false;
+    
+    // collapses are first listed per polygon edge and applied afterwards, 
+    // hence the threads only read the vertex list.
+    vector<vector<pair<int, int> > > 
+      edgeCollapses(polygonEdgeTriangleLists_.size());
  
 #ifdef withOpenMP
 #pragma omp parallel for num_threads(threadNumber_)
@@ -1333,16 +1267,9 @@ int FiberSurface::mergeEdges(const double &distanceThreshold) const{
                 isCollapsible = false;
               }
               
-#ifdef withOpenMP
-#pragma omp critical
-#endif
               if(isCollapsible){
-                for(int k = 0; k < 3; k++){
-                  (*globalVertexList_)[destination].p_[k] = 
-                    (*globalVertexList_)[source].p_[k];
-                }
-                
-                hasMerged = true;
+                edgeCollapses[i].push_back(
+                  pair<int, int>(source, destination));
               }
             }
           }
@@ -1350,6 +1277,26 @@ int FiberSurface::mergeEdges(const double &distanceThreshold) const{
       }
     }
     
+    // apply the collapses, at most one per vertex in each iteration
+    vector<bool> isCollapsed((*globalVertexList_).size(), false);
+    for(int i = 0; i < (int) edgeCollapses.size(); i++){
+      for(int j = 0; j < (int) edgeCollapses[i].size(); j++){
+        
+        int source = edgeCollapses[i][j].first;
+        int destination = edgeCollapses[i][j].second;
+        
+        if((!isCollapsed[source])&&(!isCollapsed[destination])){
+          for(int k = 0; k < 3; k++){
+            (*globalVertexList_)[destination].p_[k] = 
+              (*globalVertexList_)[source].p_[k];
+          }
+          isCollapsed[source] = true;
+          isCollapsed[destination] = true;
+          hasMerged = true;
+        }
+      }
+    }
+    
     if(!hasMerged)
       break;
     
@@ -1376,219 +1323,103 @@ int FiberSurface::mergeVertices(const double &distanceThreshold) const{
  
   Timer t;
   
-  vector<Vertex> tmpList = (*globalVertexList_);
+  int vertexNumber = (*globalVertexList_).size();
   
-  for(int i = 0; i < (int) tmpList.size(); i++){
-    tmpList[i].localId_ = i;
-  }
-  
-  // now do a parallel sort
-  int uniqueVertexNumber = 0;
-  for(int k = 0; k < 3; k++){
-    
-    switch(k){
-      case 0:
-        sort(
-          tmpList.begin(), tmpList.end(), FiberSurfaceVertexComparisonX);
-        break;
-        
-      case 1:
-        sort(
-          tmpList.begin(), tmpList.end(), FiberSurfaceVertexComparisonY);
-        break;
-        
-      case 2:
-        sort(
-          tmpList.begin(), tmpList.end(), FiberSurfaceVertexComparisonZ);
-        break;
-    }
-    
-    // NOTE:
-    // ethaneDiol dataset 
-    // 0.019224 in parallel (2 cores HT)
-    // 0.041353 in sequential (speedup: x2.15, perfect (HT))
-    
-    // now merge the thing
-    // 1. Identity duplicates
-    // NOTE: order is important, so no parallelism
-    // NOTE: points are represented with single precision (floats) so use that 
-    // as a limit for distances
-    uniqueVertexNumber = 0;
-    double distance = 0;
-    for(int i = 0; i < (int) tmpList.size(); i++){
-      
-      bool canMerge = false;
-      
-      if(i){
-        distance = Geometry::distance(tmpList[i].p_, tmpList[i - 1].p_);
-        
-        if(distance <= distanceThreshold){
-          
-          // one of the two is -1 (interior vertex)
-//           if((tmpList[i - 1].meshEdge_.first == -1)
-//             ||(tmpList[i].meshEdge_.first == -1)){
-//             canMerge = true;
-//           }
-//           
-//           // one vertex in common
-//           if((tmpList[i].meshEdge_.first == 
-//             tmpList[i - 1].meshEdge_.first)
-//             ||
-//             (tmpList[i].meshEdge_.first == 
-//             tmpList[i - 1].meshEdge_.second)){
-//             canMerge = true;
-//           }
-//           
-//           // one vertex in common
-//           if((tmpList[i].meshEdge_.second == 
-//             tmpList[i - 1].meshEdge_.first)
-//             ||
-//             (tmpList[i].meshEdge_.second == 
-//             tmpList[i - 1].meshEdge_.second)){
-//             canMerge = true;
-//           }
-          
-          // NOTE: still some bugs here in terms of manifoldness.
-          
-          if((tmpList[i].meshEdge_.first == 
-            tmpList[i - 1].meshEdge_.first)
-            &&
-            (tmpList[i].meshEdge_.second == 
-            tmpList[i - 1].meshEdge_.second)){
-            canMerge = true;
-          }
-          if((tmpList[i].meshEdge_.first == 
-            tmpList[i - 1].meshEdge_.second)
-            &&
-            (tmpList[i].meshEdge_.second == 
-            tmpList[i - 1].meshEdge_.first)){
-            canMerge = true;
-          }
-          
-//           canMerge = true;
-        }
-        
-        if(canMerge){
-          tmpList[i].globalId_ = tmpList[i - 1].globalId_;
-          if((tmpList[i].isBasePoint_)||(tmpList[i - 1].isBasePoint_)){
-            tmpList[i].isBasePoint_ = true;
-            tmpList[i - 1].isBasePoint_ = true;
-          }
-          if((tmpList[i].isIntersectionPoint_)
-            ||(tmpList[i - 1].isIntersectionPoint_)){
-            tmpList[i].isIntersectionPoint_ = true;
-            tmpList[i - 1].isIntersectionPoint_ = true;
-          }
-          for(int j = 0; j < 3; j++){
-            tmpList[i].p_[j] = tmpList[i - 1].p_[j];
-          }
-          
-          // update meshEdge...
-          if((tmpList[i - 1].meshEdge_.first == -1)
-            &&(tmpList[i].meshEdge_.first != -1)){
-            tmpList[i - 1].meshEdge_ = tmpList[i].meshEdge_;
-          }
-          if((tmpList[i].meshEdge_.first == -1)
-            &&(tmpList[i].meshEdge_.first != -1)){
-            tmpList[i].meshEdge_ = tmpList[i - 1].meshEdge_;
-          }
-        }
-      }
-      
-      if((!i)||(!canMerge)){
-        tmpList[i].globalId_ = uniqueVertexNumber;
-        uniqueVertexNumber++;
-      }
-    
-      (*globalVertexList_)[
-        tmpList[i].localId_].globalId_ = tmpList[i].globalId_;
+  vector<double> pointSet(3*vertexNumber);
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber_)
+#endif
+  for(int i = 0; i < vertexNumber; i++){
+    for(int j = 0; j < 3; j++){
+      pointSet[3*i + j] = (*globalVertexList_)[i].p_[j];
     }
   }
   
-  // update the triangles
-  for(int i = 0; i < (int) polygonEdgeTriangleLists_.size(); i++){
-    for(int j = 0; j < (int) polygonEdgeTriangleLists_[i]->size(); j++){
-      for(int k = 0; k < 3; k++){
-        (*polygonEdgeTriangleLists_[i])[j].vertexIds_[k] = 
-          (*globalVertexList_)[
-            (*polygonEdgeTriangleLists_[i])[j].vertexIds_[k]].globalId_;
-      }
-    }
-  }
+  // 1. identify duplicates with a grid hash (linear time)
+  // NOTE: points are represented with single precision (floats) so use that 
+  // as a limit for distances
+  const vector<Vertex> &vertexList = *globalVertexList_;
+  vector<int> weldedIds;
+  int uniqueVertexNumber = 0;
   
+  VertexWelder vertexWelder;
+  vertexWelder.setDebugLevel(debugLevel_);
+  vertexWelder.setThreadNumber(threadNumber_);
+  vertexWelder.setDistanceThreshold(distanceThreshold);
+  vertexWelder.setInputDataPointer(pointSet.data());
+  vertexWelder.setVertexNumber(vertexNumber);
+  
+  // NOTE: still some bugs here in terms of manifoldness.
+  // only merge vertices computed on the same mesh edge
+  vertexWelder.execute<double>(weldedIds, uniqueVertexNumber,
+    [&vertexList](const int &vertexId0, const int &vertexId1){
+      const pair<int, int> &edge0 = vertexList[vertexId0].meshEdge_;
+      const pair<int, int> &edge1 = vertexList[vertexId1].meshEdge_;
+      return ((edge0.first == edge1.first)&&(edge0.second == edge1.second))
+        ||((edge0.first == edge1.second)&&(edge0.second == edge1.first));
+    });
+  
+  vector<double>().swap(pointSet);
   
   // 2. create the actual global list
-  // NOTE: order is no longer important, we can do this in parallel.
-  (*globalVertexList_).resize(uniqueVertexNumber);
-  
-  // duplicate vertices but only a subset have the right edge information 
-  // (because they have actually been computed on the edge)
-  int lastId = -1;
-  for(int i = 0; i < (int) tmpList.size(); i++){
+  // the first vertex of each group is kept (welded vertices are numbered in 
+  // the order of their first vertex).
+  vector<Vertex> tmpList(uniqueVertexNumber);
+  int keptVertexNumber = 0;
+  for(int i = 0; i < vertexNumber; i++){
     
-    if(lastId != -1){
-      if((tmpList[lastId].globalId_ == tmpList[i].globalId_)
-        &&(tmpList[i].meshEdge_.first != -1)){
-        
-        (*globalVertexList_)[tmpList[lastId].globalId_].meshEdge_ 
-          = tmpList[i].meshEdge_;
-        (*globalVertexList_)[tmpList[lastId].globalId_].isBasePoint_ = true;
-        lastId = -1;
-      }
-    }
+    const Vertex &v = (*globalVertexList_)[i];
+    Vertex &u = tmpList[weldedIds[i]];
     
-    if((!i)||(tmpList[i].globalId_ != tmpList[i - 1].globalId_)){
-      (*globalVertexList_)[tmpList[i].globalId_] = tmpList[i];
-      if((*globalVertexList_)[tmpList[i].globalId_].meshEdge_.first == -1){
-        lastId = i;
-      }
-      else{
-        lastId = -1;
+    if(weldedIds[i] == keptVertexNumber){
+      u = v;
+      u.localId_ = i;
+      u.globalId_ = weldedIds[i];
+      keptVertexNumber++;
+    }
+    else{
+      if(v.isBasePoint_)
+        u.isBasePoint_ = true;
+      if(v.isIntersectionPoint_)
+        u.isIntersectionPoint_ = true;
+      
+      // duplicate vertices but only a subset have the right edge information 
+      // (because they have actually been computed on the edge)
+      if((u.meshEdge_.first == -1)&&(v.meshEdge_.first != -1)){
+        u.meshEdge_ = v.meshEdge_;
+        u.isBasePoint_ = true;
       }
     }
   }
+  (*globalVertexList_).swap(tmpList);
   
   // 3. update the 2-sheets, ignore zero-area triangles 
-  // and free their vertex memory
   // NOTE: order is no longer important, parallel
-  vector<vector<bool> > keepTriangle(polygonEdgeTriangleLists_.size());
-  vector<vector<FiberSurface::Triangle> > 
-    tmpTriangleLists(polygonEdgeTriangleLists_.size());
-  for(int i = 0; i < (int) polygonEdgeTriangleLists_.size(); i++){
-    tmpTriangleLists[i] = (*polygonEdgeTriangleLists_[i]);
-    keepTriangle[i].resize((*polygonEdgeTriangleLists_[i]).size(), true);
-  }
-  
 #ifdef withOpenMP
 #pragma omp parallel for num_threads(threadNumber_)
 #endif
   for(int i = 0; i < (int) polygonEdgeTriangleLists_.size(); i++){
-    for(int j = 0; j < (int) tmpTriangleLists[i].size(); j++){
-      for(int k = 0; k < 3; k++){
-        if((k)
-          &&(tmpTriangleLists[i][j].vertexIds_[k] ==           
-          tmpTriangleLists[i][j].vertexIds_[(k - 1)])){
-          keepTriangle[i][j] = false;
-        }
-      }
-      if(tmpTriangleLists[i][j].vertexIds_[0] 
-        == tmpTriangleLists[i][j].vertexIds_[2]){
-        keepTriangle[i][j] = false;
-      }
-    }
-    
     
+    vector<Triangle> &triangleList = (*polygonEdgeTriangleLists_[i]);
     
-    // now copy triangles over with non zero-area triangles
     // NOTE: no need to re-allocate the memory, we know we are not going to use
     // more.
-    (*polygonEdgeTriangleLists_[i]).resize(0);
-    for(int j = 0; j < (int) tmpTriangleLists[i].size(); j++){
+    int triangleNumber = 0;
+    for(int j = 0; j < (int) triangleList.size(); j++){
       
-      if(keepTriangle[i][j]){
-        (*polygonEdgeTriangleLists_[i]).push_back(tmpTriangleLists[i][j]);
+      Triangle triangle = triangleList[j];
+      for(int k = 0; k < 3; k++){
+        triangle.vertexIds_[k] = weldedIds[triangle.vertexIds_[k]];
+      }
+      
+      if((triangle.vertexIds_[0] != triangle.vertexIds_[1])
+        &&(triangle.vertexIds_[1] != triangle.vertexIds_[2])
+        &&(triangle.vertexIds_[2] != triangle.vertexIds_[0])){
+        triangleList[triangleNumber] = triangle;
+        triangleNumber++;
       }
     }
+    triangleList.resize(triangleNumber);
   }
  
   {
@@ -1770,3 +1601,173 @@ int FiberSurface::snapVertexBarycentrics(
     
   return 0;
 }
+
+int FiberSurface::weldChunk(const int &polygonEdgeId, const int &chunkEnd,
+  const vector<int> &vertexLastPositions,
+  const vector<Vertex> &chunkVertexList,
+  vector<Triangle> &chunkTriangleList,
+  vector<BoundaryVertex> &boundaryVertexList,
+  int &vertexNumber,
+  vector<Vertex> &newVertexList) const{
+  
+  const int boundaryVertexNumber = boundaryVertexList.size();
+  const int pointNumber = boundaryVertexNumber + chunkVertexList.size();
+  
+  // 1. weld the chunk vertices together and with the boundary vertices of 
+  // the previous chunks (listed first)
+  vector<double> pointSet(3*pointNumber);
+  vector<const pair<int, int> *> meshEdges(pointNumber);
+  for(int i = 0; i < pointNumber; i++){
+    const double *p = NULL;
+    if(i < boundaryVertexNumber){
+      p = boundaryVertexList[i].p_;
+      meshEdges[i] = &(boundaryVertexList[i].meshEdge_);
+    }
+    else{
+      p = chunkVertexList[i - boundaryVertexNumber].p_;
+      meshEdges[i] = &(chunkVertexList[i - boundaryVertexNumber].meshEdge_);
+    }
+    for(int j = 0; j < 3; j++)
+      pointSet[3*i + j] = p[j];
+  }
+  
+  vector<int> weldedIds;
+  int weldedVertexNumber = 0;
+  
+  VertexWelder vertexWelder;
+  vertexWelder.setDebugLevel(fatalMsg);
+  vertexWelder.setThreadNumber(threadNumber_);
+  vertexWelder.setDistanceThreshold(pointSnappingThreshold_);
+  vertexWelder.setInputDataPointer(pointSet.data());
+  vertexWelder.setVertexNumber(pointNumber);
+  
+  // same merging criterion as mergeVertices()
+  vertexWelder.execute<double>(weldedIds, weldedVertexNumber,
+    [&meshEdges](const int &vertexId0, const int &vertexId1){
+      const pair<int, int> &edge0 = *(meshEdges[vertexId0]);
+      const pair<int, int> &edge1 = *(meshEdges[vertexId1]);
+      return ((edge0.first == edge1.first)&&(edge0.second == edge1.second))
+        ||((edge0.first == edge1.second)&&(edge0.second == edge1.first));
+    });
+  
+  vector<double>().swap(pointSet);
+  
+  // 2. processing position of the last tetrahedron which may produce a 
+  // duplicate of each chunk vertex: the last one of the star of its mesh 
+  // edge, or of the vertices of its tetrahedron (vertices computed within a 
+  // face). vertices on the fiber of a polygon vertex may be duplicated by 
+  // another polygon edge, they are kept until the end.
+  vector<int> vertexTets(chunkVertexList.size(), -1);
+  for(int i = 0; i < (int) chunkTriangleList.size(); i++){
+    for(int j = 0; j < 3; j++)
+      vertexTets[chunkTriangleList[i].vertexIds_[j]] = 
+        chunkTriangleList[i].tetId_;
+  }
+  
+  vector<int> groupLastPositions(weldedVertexNumber, -1);
+  vector<int> groupFirstPoints(weldedVertexNumber, -1);
+  for(int i = 0; i < pointNumber; i++){
+    
+    const int groupId = weldedIds[i];
+    if(groupFirstPoints[groupId] == -1)
+      groupFirstPoints[groupId] = i;
+    
+    int lastPosition = -1;
+    if(i < boundaryVertexNumber){
+      lastPosition = boundaryVertexList[i].lastPosition_;
+    }
+    else{
+      const Vertex &v = chunkVertexList[i - boundaryVertexNumber];
+      const int tetId = vertexTets[i - boundaryVertexNumber];
+      if((v.t_ <= 0)||(v.t_ >= 1)){
+        lastPosition = INT_MAX;
+      }
+      else if(v.meshEdge_.first != -1){
+        lastPosition = min(vertexLastPositions[v.meshEdge_.first],
+          vertexLastPositions[v.meshEdge_.second]);
+      }
+      else if(tetId != -1){
+        for(int j = 0; j < 4; j++){
+          int vertexId = -1;
+          if(triangulation_)
+            triangulation_->getCellVertex(tetId, j, vertexId);
+          else
+            vertexId = tetList_[5*tetId + 1 + j];
+          lastPosition = max(lastPosition, vertexLastPositions[vertexId]);
+        }
+      }
+    }
+    
+    groupLastPositions[groupId] = 
+      max(groupLastPositions[groupId], lastPosition);
+  }
+  
+  // 3. global ids (welded vertices are numbered in the order of their first
+  // point, hence boundary vertices come first)
+  vector<int> globalIds(weldedVertexNumber, -1);
+  newVertexList.clear();
+  
+  for(int i = 0; i < weldedVertexNumber; i++){
+    
+    const int pointId = groupFirstPoints[i];
+    
+    if(pointId < boundaryVertexNumber){
+      globalIds[i] = boundaryVertexList[pointId].globalId_;
+    }
+    else{
+      globalIds[i] = vertexNumber;
+      vertexNumber++;
+      
+      newVertexList.push_back(chunkVertexList[pointId - boundaryVertexNumber]);
+      newVertexList.back().polygonEdgeId_ = polygonEdgeId;
+      newVertexList.back().localId_ = globalIds[i];
+      newVertexList.back().globalId_ = globalIds[i];
+    }
+  }
+  
+  // 4. keep the vertices which may still be duplicated by the next chunks
+  vector<BoundaryVertex> nextBoundaryVertexList;
+  for(int i = 0; i < weldedVertexNumber; i++){
+    
+    if(groupLastPositions[i] < chunkEnd)
+      continue;
+    
+    const int pointId = groupFirstPoints[i];
+    
+    BoundaryVertex b;
+    if(pointId < boundaryVertexNumber){
+      b = boundaryVertexList[pointId];
+    }
+    else{
+      const Vertex &v = chunkVertexList[pointId - boundaryVertexNumber];
+      for(int j = 0; j < 3; j++)
+        b.p_[j] = v.p_[j];
+      b.meshEdge_ = v.meshEdge_;
+    }
+    b.globalId_ = globalIds[i];
+    b.lastPosition_ = groupLastPositions[i];
+    nextBoundaryVertexList.push_back(b);
+  }
+  boundaryVertexList.swap(nextBoundaryVertexList);
+  
+  // 5. update the triangles and remove the zero-area ones
+  int triangleNumber = 0;
+  for(int i = 0; i < (int) chunkTriangleList.size(); i++){
+    
+    Triangle &triangle = chunkTriangleList[i];
+    for(int j = 0; j < 3; j++){
+      triangle.vertexIds_[j] = globalIds[
+        weldedIds[boundaryVertexNumber + triangle.vertexIds_[j]]];
+    }
+    
+    if((triangle.vertexIds_[0] != triangle.vertexIds_[1])
+      &&(triangle.vertexIds_[1] != triangle.vertexIds_[2])
+      &&(triangle.vertexIds_[2] != triangle.vertexIds_[0])){
+      chunkTriangleList[triangleNumber] = triangle;
+      triangleNumber++;
+    }
+  }
+  chunkTriangleList.resize(triangleNumber);
+  
+  return 0;
+}
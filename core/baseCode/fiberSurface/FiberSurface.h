@@ -46,6 +46,7 @@
 #include                  <RangeDrivenOctree.h>
 #endif
 #include                  <Triangulation.h>
+#include                  <VertexWelder.h>
 #include                  <Wrapper.h>
 
 namespace ttk{
@@ -75,6 +76,14 @@ namespace ttk{
           polygonEdgeId_; 
       };
       
+      /// Callback receiving the chunks of a streamed fiber surface (see 
+      /// computeSurfaceStreaming()). The vertex list only contains the 
+      /// vertices which are new to the chunk, their globalId_ being their 
+      /// index in the overall output. Triangle vertex ids are global ids.
+      /// A non-zero return value stops the extraction.
+      typedef int (*ChunkSink)(const vector<Vertex> &vertexList,
+        const vector<Triangle> &triangleList, void *sinkData);
+      
       FiberSurface();
       
       ~FiberSurface();
@@ -106,6 +115,15 @@ namespace ttk{
           
       template <class dataTypeU, class dataTypeV>
         inline int computeSurface();
+        
+      /// Extract the fiber surface by chunks of tetrahedra and hand each chunk
+      /// over to the chunk sink as soon as it is finished. Vertices are welded
+      /// across chunks with VertexWelder. Only the vertices which may still 
+      /// be duplicated by the next chunks are kept in between, hence the 
+      /// output never needs to be stored as a whole. No post-processing 
+      /// (finalize()) is performed in this mode.
+      template <class dataTypeU, class dataTypeV>
+        inline int computeSurfaceStreaming();
       
                  
 #ifdef withrangeDrivenOctree
@@ -135,6 +153,18 @@ namespace ttk{
           const pair<double, double> &rangePoint1,
           const int &polygonEdgeId = 0) const;
               
+      inline int setChunkSink(ChunkSink sink, void *sinkData = NULL){
+        chunkSink_ = sink;
+        chunkSinkData_ = sinkData;
+        return 0;
+      }
+      
+      /// Set the number of tetrahedra processed per streamed chunk.
+      inline int setChunkSize(const int &tetNumber){
+        chunkSize_ = tetNumber;
+        return 0;
+      }
+              
       inline int setGlobalVertexList(vector<Vertex> *globalList){
         globalVertexList_ = globalList;
         return 0;
@@ -148,6 +178,16 @@ namespace ttk{
         return 0;
       }
       
+#ifdef withrangeDrivenOctree
+      /// Set the path of a binary file storing the range driven octree. If 
+      /// the file matches the input fields, the octree is read from it, 
+      /// otherwise the octree is built and written to it.
+      inline int setOctreeFileName(const string &fileName){
+        octreeFileName_ = fileName;
+        return 0;
+      }
+#endif
+      
       inline int setPointMerging(const bool &onOff){
         pointSnapping_ = onOff;
         return 0;
@@ -246,6 +286,17 @@ namespace ttk{
         pair<double, double> intersection_;
       }IntersectionTriangle;
       
+      // streamed vertex which may still be welded with the vertices of the 
+      // next chunks (see computeSurfaceStreaming())
+      typedef struct _boundaryVertex{
+        double p_[3];
+        pair<int, int> meshEdge_;
+        int globalId_;
+        // processing position of the last tetrahedron which may produce a 
+        // duplicate of this vertex
+        int lastPosition_;
+      }BoundaryVertex;
+      
       template <class dataTypeU, class dataTypeV>
         inline int computeBaseTriangle(
           const int &tetId, 
@@ -267,7 +318,8 @@ namespace ttk{
           const int &localEdgeId1, const double &t1,
             const double &u1, const double &v1,
           const int &localEdgeId2, const double &t2,
-            const double &u2, const double &v2) const;
+            const double &u2, const double &v2,
+          vector<Vertex> &vertexList, vector<Triangle> &triangleList) const;
         
       template <class dataTypeU, class dataTYpeV>
         inline int computeCase1(const int &polygonEdgeId, const int &tetId, 
@@ -276,7 +328,8 @@ namespace ttk{
           const int &localEdgeId1, const double &t1,
             const double &u1, const double &v1,
           const int &localEdgeId2, const double &t2,
-            const double &u2, const double &v2) const;
+            const double &u2, const double &v2,
+          vector<Vertex> &vertexList, vector<Triangle> &triangleList) const;
         
       template <class dataTypeU, class dataTYpeV>
         inline int computeCase2(const int &polygonEdgeId, const int &tetId, 
@@ -285,7 +338,8 @@ namespace ttk{
           const int &localEdgeId1, const double &t1,
             const double &u1, const double &v1,
           const int &localEdgeId2, const double &t2,
-            const double &u2, const double &v2) const;
+            const double &u2, const double &v2,
+          vector<Vertex> &vertexList, vector<Triangle> &triangleList) const;
         
       template <class dataTypeU, class dataTYpeV>
         inline int computeCase3(const int &polygonEdgeId, const int &tetId, 
@@ -294,7 +348,8 @@ namespace ttk{
           const int &localEdgeId1, const double &t1,
             const double &u1, const double &v1,
           const int &localEdgeId2, const double &t2,
-            const double &u2, const double &v2) const;
+            const double &u2, const double &v2,
+          vector<Vertex> &vertexList, vector<Triangle> &triangleList) const;
         
       template <class dataTypeU, class dataTYpeV>
         inline int computeCase4(const int &polygonEdgeId, const int &tetId, 
@@ -303,7 +358,8 @@ namespace ttk{
           const int &localEdgeId1, const double &t1,
             const double &u1, const double &v1,
           const int &localEdgeId2, const double &t2,
-            const double &u2, const double &v2) const;
+            const double &u2, const double &v2,
+          vector<Vertex> &vertexList, vector<Triangle> &triangleList) const;
             
       int computeTriangleFiber(const int &tetId, const int &triangleId,
         const pair<double, double> &intersection,
@@ -405,6 +461,23 @@ namespace ttk{
       
       int mergeVertices(const double &distanceThreshold) const;
       
+      int weldChunk(const int &polygonEdgeId, const int &chunkEnd,
+        const vector<int> &vertexLastPositions,
+        const vector<Vertex> &chunkVertexList,
+        vector<Triangle> &chunkTriangleList,
+        vector<BoundaryVertex> &boundaryVertexList,
+        int &vertexNumber,
+        vector<Vertex> &newVertexList) const;
+      
+      // same as the public version, writing into the given lists (for 
+      // instance, per-thread buffers).
+      template <class dataTypeU, class dataTypeV>
+        inline int processTetrahedron(const int &tetId,
+          const pair<double, double> &rangePoint0, 
+          const pair<double, double> &rangePoint1,
+          const int &polygonEdgeId,
+          vector<Vertex> &vertexList, vector<Triangle> &triangleList) const;
+      
       template <class dataTypeU, class dataTypeV>
         inline int remeshIntersections() const;
        
@@ -421,7 +494,11 @@ namespace ttk{
         
        
       bool                pointSnapping_;
+      
+      ChunkSink           chunkSink_;
+      void                *chunkSinkData_;
         
+      int                 chunkSize_;
       int                 pointNumber_, tetNumber_, polygonEdgeNumber_;
       const void          *uField_, *vField_;
       const float         *pointSet_;
@@ -445,6 +522,7 @@ namespace ttk{
                           
 #ifdef withrangeDrivenOctree
       RangeDrivenOctree   octree_;
+      string              octreeFileName_;
 #endif
   };
 }
@@ -473,7 +551,19 @@ template <class dataTypeU, class dataTypeV>
     }
     octree_.setRange(uField_, vField_);
     
-    octree_.build<dataTypeU, dataTypeV>();
+    // the key hashes the whole input, only compute it for the octree files
+    unsigned long long fieldKey = 0;
+    if(!octreeFileName_.empty())
+      fieldKey = octree_.getFieldKey<dataTypeU, dataTypeV>();
+    
+    if((octreeFileName_.empty())
+      ||(octree_.read(octreeFileName_, fieldKey))){
+      
+      octree_.build<dataTypeU, dataTypeV>(fieldKey);
+      
+      if(!octreeFileName_.empty())
+        octree_.write(octreeFileName_);
+    }
   }
     
   return 0;
@@ -614,30 +704,31 @@ template<class dataTypeU, class dataTypeV>
     const int &localEdgeId1, const double &t1,
       const double &u1, const double &v1, 
     const int &localEdgeId2, const double &t2,
-      const double &u2, const double &v2) const{
+      const double &u2, const double &v2,
+    vector<Vertex> &vertexList, vector<Triangle> &triangleList) const{
 
   // that one's easy, make just one triangle 
-  int vertexId = (*polygonEdgeVertexLists_[polygonEdgeId]).size();
+  int vertexId = vertexList.size();
   
   // alloc 1 more triangle
-  (*polygonEdgeTriangleLists_[polygonEdgeId]).resize(
-    (*polygonEdgeTriangleLists_[polygonEdgeId]).size() + 1);
-  (*polygonEdgeTriangleLists_[polygonEdgeId]).back().tetId_ = tetId;
-  (*polygonEdgeTriangleLists_[polygonEdgeId]).back().caseId_ = 0;
-  (*polygonEdgeTriangleLists_[polygonEdgeId]).back().polygonEdgeId_ 
+  triangleList.resize(
+    triangleList.size() + 1);
+  triangleList.back().tetId_ = tetId;
+  triangleList.back().caseId_ = 0;
+  triangleList.back().polygonEdgeId_ 
     = polygonEdgeId;
   
-  (*polygonEdgeTriangleLists_[polygonEdgeId]).back().vertexIds_[0] = vertexId;
-  (*polygonEdgeTriangleLists_[polygonEdgeId]).back().vertexIds_[1] = 
+  triangleList.back().vertexIds_[0] = vertexId;
+  triangleList.back().vertexIds_[1] = 
     vertexId + 1;
-  (*polygonEdgeTriangleLists_[polygonEdgeId]).back().vertexIds_[2] = 
+  triangleList.back().vertexIds_[2] = 
     vertexId + 2;
   
   // alloc 3 more vertices
-  (*polygonEdgeVertexLists_[polygonEdgeId]).resize(vertexId + 3);
+  vertexList.resize(vertexId + 3);
   for(int i = 0; i < 3; i++){
-    (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].isBasePoint_ = true;
-    (*polygonEdgeVertexLists_[polygonEdgeId])[
+    vertexList[vertexId + i].isBasePoint_ = true;
+    vertexList[
       vertexId + i].isIntersectionPoint_ = false;
   }
   
@@ -660,9 +751,9 @@ template<class dataTypeU, class dataTypeV>
           triangulation_->getCellVertex(tetId, 
             edgeImplicitEncoding_[2*localEdgeId0 + 1], vertexId1);
         }
-        (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].uv_.first = u0;
-        (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].uv_.second = v0;
-        (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].t_ = t0;
+        vertexList[vertexId + i].uv_.first = u0;
+        vertexList[vertexId + i].uv_.second = v0;
+        vertexList[vertexId + i].t_ = t0;
         break;
         
       case 1:
@@ -678,9 +769,9 @@ template<class dataTypeU, class dataTypeV>
           triangulation_->getCellVertex(tetId, 
             edgeImplicitEncoding_[2*localEdgeId1 + 1], vertexId1);
         }
-        (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].uv_.first = u1;
-        (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].uv_.second = v1;
-        (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].t_ = t1;
+        vertexList[vertexId + i].uv_.first = u1;
+        vertexList[vertexId + i].uv_.second = v1;
+        vertexList[vertexId + i].t_ = t1;
         break;
         
       case 2:
@@ -696,9 +787,9 @@ template<class dataTypeU, class dataTypeV>
           triangulation_->getCellVertex(tetId, 
             edgeImplicitEncoding_[2*localEdgeId2 + 1], vertexId1);
         }
-        (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].uv_.first = u2;
-        (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].uv_.second = v2;
-        (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].t_ = t2;
+        vertexList[vertexId + i].uv_.first = u2;
+        vertexList[vertexId + i].uv_.second = v2;
+        vertexList[vertexId + i].t_ = t2;
         break;
     }
     
@@ -708,8 +799,8 @@ template<class dataTypeU, class dataTypeV>
     p0[1] = ((dataTypeV *) vField_)[vertexId0];
     p1[0] = ((dataTypeU *) uField_)[vertexId1];
     p1[1] = ((dataTypeV *) vField_)[vertexId1];
-    p[0] = (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].uv_.first;
-    p[1] = (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].uv_.second;
+    p[0] = vertexList[vertexId + i].uv_.first;
+    p[1] = vertexList[vertexId + i].uv_.second;
     Geometry::computeBarycentricCoordinates(
       p0.data(), p1.data(), p.data(), baryCentrics, 2);
    
@@ -731,16 +822,16 @@ template<class dataTypeU, class dataTypeV>
         c1 = pB[j];
       }
       
-      (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].p_[j] = 
+      vertexList[vertexId + i].p_[j] = 
         baryCentrics[0]*c0
         + baryCentrics[1]*c1;
     }
    
     if(vertexId0 < vertexId1)
-      (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].meshEdge_ 
+      vertexList[vertexId + i].meshEdge_ 
         = pair<int, int>(vertexId0, vertexId1);
     else
-      (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].meshEdge_ 
+      vertexList[vertexId + i].meshEdge_ 
         = pair<int, int>(vertexId1, vertexId0);
   }
 
@@ -756,54 +847,55 @@ template <class dataTypeU, class dataTypeV>
     const int &localEdgeId1, const double &t1,
       const double &u1, const double &v1, 
     const int &localEdgeId2, const double &t2,
-      const double &u2, const double &v2) const{
+      const double &u2, const double &v2,
+    vector<Vertex> &vertexList, vector<Triangle> &triangleList) const{
  
-  int vertexId = (*polygonEdgeVertexLists_[polygonEdgeId]).size();
+  int vertexId = vertexList.size();
     
   // alloc 5 more vertices
-  (*polygonEdgeVertexLists_[polygonEdgeId]).resize(vertexId + 5);
+  vertexList.resize(vertexId + 5);
   for(int i = 0; i < 5; i++){
-    (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].isBasePoint_ = true;
-    (*polygonEdgeVertexLists_[polygonEdgeId])[
+    vertexList[vertexId + i].isBasePoint_ = true;
+    vertexList[
       vertexId + i].isIntersectionPoint_ = false;
-    (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].meshEdge_ 
+    vertexList[vertexId + i].meshEdge_ 
       = pair<int, int>(-1, -1);
   }
   
   // alloc 3 more triangles
-  int triangleId = (*polygonEdgeTriangleLists_[polygonEdgeId]).size();
-  (*polygonEdgeTriangleLists_[polygonEdgeId]).resize(triangleId + 3);
+  int triangleId = triangleList.size();
+  triangleList.resize(triangleId + 3);
   
   for(int i = 0; i < 3; i++){
     
-    (*polygonEdgeTriangleLists_[polygonEdgeId])[triangleId + i].tetId_ = tetId;
-    (*polygonEdgeTriangleLists_[polygonEdgeId])[triangleId + i].caseId_ = 1;
-    (*polygonEdgeTriangleLists_[polygonEdgeId])[triangleId + i].polygonEdgeId_ 
+    triangleList[triangleId + i].tetId_ = tetId;
+    triangleList[triangleId + i].caseId_ = 1;
+    triangleList[triangleId + i].polygonEdgeId_ 
       = polygonEdgeId;
     
     switch(i){
       case 0:
-        (*polygonEdgeTriangleLists_[polygonEdgeId])[
+        triangleList[
           triangleId + i].vertexIds_[0] = vertexId;
-        (*polygonEdgeTriangleLists_[polygonEdgeId])[triangleId 
+        triangleList[triangleId 
           + i].vertexIds_[1] = vertexId + 1;
-        (*polygonEdgeTriangleLists_[polygonEdgeId])[
+        triangleList[
           triangleId + i].vertexIds_[2] = vertexId + 2;
         break;
       case 1:
-        (*polygonEdgeTriangleLists_[polygonEdgeId])[
+        triangleList[
           triangleId + i].vertexIds_[0] = vertexId + 1;
-        (*polygonEdgeTriangleLists_[polygonEdgeId])[
+        triangleList[
           triangleId + i].vertexIds_[1] = vertexId + 2;
-        (*polygonEdgeTriangleLists_[polygonEdgeId])[
+        triangleList[
           triangleId + i].vertexIds_[2] = vertexId + 3;
         break;
       case 2:
-        (*polygonEdgeTriangleLists_[polygonEdgeId])[
+        triangleList[
           triangleId + i].vertexIds_[0] = vertexId + 2;
-        (*polygonEdgeTriangleLists_[polygonEdgeId])[
+        triangleList[
           triangleId + i].vertexIds_[1] = vertexId + 3;
-        (*polygonEdgeTriangleLists_[polygonEdgeId])[
+        triangleList[
           triangleId + i].vertexIds_[2] = vertexId + 4;
         break;
     }
@@ -843,15 +935,15 @@ template <class dataTypeU, class dataTypeV>
     if(!i){
       // just take the pivot vertex
       for(int j = 0; j < 3; j++){
-        (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId].p_[j] = 
+        vertexList[vertexId].p_[j] = 
           basePoints[pivotVertexId][j];
       }
       
-      (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId].t_ = 
+      vertexList[vertexId].t_ = 
         basePointParameterization[pivotVertexId];
-      (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId].uv_ = 
+      vertexList[vertexId].uv_ = 
         basePointProjections[pivotVertexId];
-      (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId].meshEdge_ = 
+      vertexList[vertexId].meshEdge_ = 
         baseEdges[pivotVertexId];
     }
     else{
@@ -909,7 +1001,7 @@ template <class dataTypeU, class dataTypeV>
           break;
       }
       
-      (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].t_ = t;
+      vertexList[vertexId + i].t_ = t;
       
       interpolateBasePoints(
         basePoints[vertexId0],
@@ -919,10 +1011,10 @@ template <class dataTypeU, class dataTypeV>
         basePointProjections[vertexId1],
         basePointParameterization[vertexId1],
         t,
-        (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i]);
+        vertexList[vertexId + i]);
 //       snapToBasePoint(
 //         basePoints, basePointProjections, basePointParameterization,
-//         (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i]);
+//         vertexList[vertexId + i]);
       
     }
   }
@@ -939,45 +1031,46 @@ template <class dataTypeU, class dataTypeV>
     const int &localEdgeId1, const double &t1,
       const double &u1, const double &v1, 
     const int &localEdgeId2, const double &t2,
-      const double &u2, const double &v2) const{
+      const double &u2, const double &v2,
+    vector<Vertex> &vertexList, vector<Triangle> &triangleList) const{
  
-  int vertexId = (*polygonEdgeVertexLists_[polygonEdgeId]).size();
+  int vertexId = vertexList.size();
     
   // alloc 4 more vertices
-  (*polygonEdgeVertexLists_[polygonEdgeId]).resize(vertexId + 4);
+  vertexList.resize(vertexId + 4);
   for(int i = 0; i < 4; i++){
-    (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].isBasePoint_ = true;
-    (*polygonEdgeVertexLists_[polygonEdgeId])[
+    vertexList[vertexId + i].isBasePoint_ = true;
+    vertexList[
       vertexId + i].isIntersectionPoint_ = false;
-    (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].meshEdge_ 
+    vertexList[vertexId + i].meshEdge_ 
       = pair<int, int>(-1, -1);
   }
   
   // alloc 2 more triangles
-  int triangleId = (*polygonEdgeTriangleLists_[polygonEdgeId]).size();
-  (*polygonEdgeTriangleLists_[polygonEdgeId]).resize(triangleId + 2);
+  int triangleId = triangleList.size();
+  triangleList.resize(triangleId + 2);
   
   for(int i = 0; i < 2; i++){
     
-    (*polygonEdgeTriangleLists_[polygonEdgeId])[triangleId + i].tetId_ = tetId;
-    (*polygonEdgeTriangleLists_[polygonEdgeId])[triangleId + i].caseId_ = 2;
-    (*polygonEdgeTriangleLists_[polygonEdgeId])[triangleId + i].polygonEdgeId_ 
+    triangleList[triangleId + i].tetId_ = tetId;
+    triangleList[triangleId + i].caseId_ = 2;
+    triangleList[triangleId + i].polygonEdgeId_ 
       = polygonEdgeId;
     
     if(!i){
-      (*polygonEdgeTriangleLists_[polygonEdgeId])[
+      triangleList[
         triangleId + i].vertexIds_[0] = vertexId;
-      (*polygonEdgeTriangleLists_[polygonEdgeId])[
+      triangleList[
         triangleId + i].vertexIds_[1] = vertexId + 1;
-      (*polygonEdgeTriangleLists_[polygonEdgeId])[
+      triangleList[
         triangleId + i].vertexIds_[2] = vertexId + 2;
     }
     else{
-      (*polygonEdgeTriangleLists_[polygonEdgeId])[
+      triangleList[
         triangleId + i].vertexIds_[0] = vertexId + 1;
-      (*polygonEdgeTriangleLists_[polygonEdgeId])[
+      triangleList[
         triangleId + i].vertexIds_[1] = vertexId + 3;
-      (*polygonEdgeTriangleLists_[polygonEdgeId])[
+      triangleList[
         triangleId + i].vertexIds_[2] = vertexId + 2;
     }
   }
@@ -1085,7 +1178,7 @@ template <class dataTypeU, class dataTypeV>
         break;
     }
     
-    (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].t_ = t;
+    vertexList[vertexId + i].t_ = t;
     
     interpolateBasePoints(
       basePoints[vertexId0],
@@ -1095,10 +1188,10 @@ template <class dataTypeU, class dataTypeV>
       basePointProjections[vertexId1],
       basePointParameterization[vertexId1],
       t,
-      (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i]);
+      vertexList[vertexId + i]);
 //     snapToBasePoint(
 //       basePoints, basePointProjections, basePointParameterization,
-//       (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i]);
+//       vertexList[vertexId + i]);
     
   }
   
@@ -1114,35 +1207,36 @@ template <class dataTypeU, class dataTypeV>
     const int &localEdgeId1, const double &t1,
       const double &u1, const double &v1, 
     const int &localEdgeId2, const double &t2,
-      const double &u2, const double &v2) const{
+      const double &u2, const double &v2,
+    vector<Vertex> &vertexList, vector<Triangle> &triangleList) const{
  
-  int vertexId = (*polygonEdgeVertexLists_[polygonEdgeId]).size();
+  int vertexId = vertexList.size();
     
   // alloc 3 more vertices
-  (*polygonEdgeVertexLists_[polygonEdgeId]).resize(vertexId + 3);
+  vertexList.resize(vertexId + 3);
   for(int i = 0; i < 3; i++){
-    (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].isBasePoint_ = true;
-    (*polygonEdgeVertexLists_[polygonEdgeId])[
+    vertexList[vertexId + i].isBasePoint_ = true;
+    vertexList[
       vertexId + i].isIntersectionPoint_ = false;
-    (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].meshEdge_ 
+    vertexList[vertexId + i].meshEdge_ 
       = pair<int, int>(-1, -1);
   }
   
   // alloc 1 more triangle
-  int triangleId = (*polygonEdgeTriangleLists_[polygonEdgeId]).size();
-  (*polygonEdgeTriangleLists_[polygonEdgeId]).resize(triangleId + 1);
+  int triangleId = triangleList.size();
+  triangleList.resize(triangleId + 1);
   
   
-  (*polygonEdgeTriangleLists_[polygonEdgeId])[triangleId].tetId_ = tetId;
-  (*polygonEdgeTriangleLists_[polygonEdgeId])[triangleId].caseId_ = 3;
-  (*polygonEdgeTriangleLists_[polygonEdgeId]).back().polygonEdgeId_ 
+  triangleList[triangleId].tetId_ = tetId;
+  triangleList[triangleId].caseId_ = 3;
+  triangleList.back().polygonEdgeId_ 
     = polygonEdgeId;
   
-  (*polygonEdgeTriangleLists_[polygonEdgeId])[triangleId].vertexIds_[0] = 
+  triangleList[triangleId].vertexIds_[0] = 
     vertexId;
-  (*polygonEdgeTriangleLists_[polygonEdgeId])[triangleId].vertexIds_[1] = 
+  triangleList[triangleId].vertexIds_[1] = 
     vertexId + 1;
-  (*polygonEdgeTriangleLists_[polygonEdgeId])[triangleId].vertexIds_[2] = 
+  triangleList[triangleId].vertexIds_[2] = 
     vertexId + 2;
   
   // compute the base triangle vertices like in case 1
@@ -1192,15 +1286,15 @@ template <class dataTypeU, class dataTypeV>
     if(!i){
       // special case of the pivot vertex
       for(int j = 0; j < 3; j++){
-        (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId].p_[j] = 
+        vertexList[vertexId].p_[j] = 
           basePoints[pivotVertexId][j];
       }
       
-      (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId].t_ = 
+      vertexList[vertexId].t_ = 
         basePointParameterization[pivotVertexId];
-      (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId].uv_ = 
+      vertexList[vertexId].uv_ = 
         basePointProjections[pivotVertexId];
-      (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId].meshEdge_ = 
+      vertexList[vertexId].meshEdge_ = 
         baseEdges[pivotVertexId];
     }
     else{
@@ -1227,7 +1321,7 @@ template <class dataTypeU, class dataTypeV>
           t = 1;
       }
       
-      (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].t_ = t;
+      vertexList[vertexId + i].t_ = t;
       
       interpolateBasePoints(
         basePoints[vertexId0],
@@ -1237,10 +1331,10 @@ template <class dataTypeU, class dataTypeV>
         basePointProjections[vertexId1],
         basePointParameterization[vertexId1],
         t,
-        (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i]);
+        vertexList[vertexId + i]);
 //       snapToBasePoint(
 //         basePoints, basePointProjections, basePointParameterization,
-//         (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i]);
+//         vertexList[vertexId + i]);
       
     }
   }
@@ -1257,45 +1351,46 @@ template <class dataTypeU, class dataTypeV>
     const int &localEdgeId1, const double &t1,
       const double &u1, const double &v1, 
     const int &localEdgeId2, const double &t2,
-      const double &u2, const double &v2) const{
+      const double &u2, const double &v2,
+    vector<Vertex> &vertexList, vector<Triangle> &triangleList) const{
 
-  int vertexId = (*polygonEdgeVertexLists_[polygonEdgeId]).size();
+  int vertexId = vertexList.size();
     
   // alloc 4 more vertices
-  (*polygonEdgeVertexLists_[polygonEdgeId]).resize(vertexId + 4);
+  vertexList.resize(vertexId + 4);
   for(int i = 0; i < 4; i++){
-    (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].isBasePoint_ = true;
-    (*polygonEdgeVertexLists_[polygonEdgeId])[
+    vertexList[vertexId + i].isBasePoint_ = true;
+    vertexList[
       vertexId + i].isIntersectionPoint_ = false;
-    (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].meshEdge_ 
+    vertexList[vertexId + i].meshEdge_ 
       = pair<int, int>(-1, -1);
   }
   
   // alloc 2 more triangles
-  int triangleId = (*polygonEdgeTriangleLists_[polygonEdgeId]).size();
-  (*polygonEdgeTriangleLists_[polygonEdgeId]).resize(triangleId + 2);
+  int triangleId = triangleList.size();
+  triangleList.resize(triangleId + 2);
   
   for(int i = 0; i < 2; i++){
     
-    (*polygonEdgeTriangleLists_[polygonEdgeId])[triangleId + i].tetId_ = tetId;
-    (*polygonEdgeTriangleLists_[polygonEdgeId])[triangleId + i].caseId_ = 4;
-    (*polygonEdgeTriangleLists_[polygonEdgeId])[triangleId + i].polygonEdgeId_ 
+    triangleList[triangleId + i].tetId_ = tetId;
+    triangleList[triangleId + i].caseId_ = 4;
+    triangleList[triangleId + i].polygonEdgeId_ 
       = polygonEdgeId;
     
     if(!i){
-      (*polygonEdgeTriangleLists_[polygonEdgeId])[
+      triangleList[
         triangleId + i].vertexIds_[0] = vertexId;
-      (*polygonEdgeTriangleLists_[polygonEdgeId])[
+      triangleList[
         triangleId + i].vertexIds_[1] = vertexId + 1;
-      (*polygonEdgeTriangleLists_[polygonEdgeId])[
+      triangleList[
         triangleId + i].vertexIds_[2] = vertexId + 2;
     }
     else{
-      (*polygonEdgeTriangleLists_[polygonEdgeId])[
+      triangleList[
         triangleId + i].vertexIds_[0] = vertexId + 1;
-      (*polygonEdgeTriangleLists_[polygonEdgeId])[
+      triangleList[
         triangleId + i].vertexIds_[1] = vertexId + 3;
-      (*polygonEdgeTriangleLists_[polygonEdgeId])[
+      triangleList[
         triangleId + i].vertexIds_[2] = vertexId + 2;
     }
   }
@@ -1372,7 +1467,7 @@ template <class dataTypeU, class dataTypeV>
           t = 0;
       }
       
-      (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].t_ = t;
+      vertexList[vertexId + i].t_ = t;
       
       interpolateBasePoints(
         basePoints[vertexId0],
@@ -1382,38 +1477,38 @@ template <class dataTypeU, class dataTypeV>
         basePointProjections[vertexId1],
         basePointParameterization[vertexId1],
         t,
-        (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i]);
+        vertexList[vertexId + i]);
 //       snapToBasePoint(
 //         basePoints, basePointProjections, basePointParameterization,
-//         (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i]);
+//         vertexList[vertexId + i]);
       
     }
     else{
       if(i == 2){
         // take (pivotVertexId-1)%3
         for(int j = 0; j < 3; j++){
-          (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].p_[j] = 
+          vertexList[vertexId + i].p_[j] = 
             basePoints[(pivotVertexId + 2)%3][j];
         }
         
-        (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].t_ = 
+        vertexList[vertexId + i].t_ = 
           basePointParameterization[(pivotVertexId + 2)%3];
-        (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].uv_ = 
+        vertexList[vertexId + i].uv_ = 
           basePointProjections[(pivotVertexId + 2)%3];
-        (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].meshEdge_ = 
+        vertexList[vertexId + i].meshEdge_ = 
           baseEdges[(pivotVertexId + 2)%3];
       }
       else{
         // take (pivtoVertexId+1)%3
         for(int j = 0; j < 3; j++){
-          (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].p_[j] = 
+          vertexList[vertexId + i].p_[j] = 
             basePoints[(pivotVertexId + 1)%3][j];
         }
-        (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].t_ = 
+        vertexList[vertexId + i].t_ = 
           basePointParameterization[(pivotVertexId + 1)%3];
-        (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].uv_ = 
+        vertexList[vertexId + i].uv_ = 
           basePointProjections[(pivotVertexId + 1)%3];
-        (*polygonEdgeVertexLists_[polygonEdgeId])[vertexId + i].meshEdge_ = 
+        vertexList[vertexId + i].meshEdge_ = 
           baseEdges[(pivotVertexId + 1)%3];
       }
     }
@@ -1632,41 +1727,116 @@ template <class dataTypeU, class dataTypeV>
 #endif
   
   Timer t;
+  
+  // flatten the (polygon edge, tetrahedron) pairs into a single work list, 
+  // so that the extraction also runs in parallel within each polygon edge.
+  vector<long long int> edgeOffsets(polygonEdgeNumber_ + 1, 0);
+  vector<vector<int> > edgeTetLists;
+  
+  int tetNumber = tetNumber_;
+  if(triangulation_){
+    tetNumber = triangulation_->getNumberOfCells();
+  }
  
 #ifdef withrangeDrivenOctree
   if(!octree_.empty()){
     
+    edgeTetLists.resize(polygonEdgeNumber_);
 #ifdef withOpenMP
 #pragma omp parallel for num_threads(threadNumber_)
 #endif
     for(int i = 0; i < polygonEdgeNumber_; i++){
-      
-      computeSurfaceWithOctree<dataTypeU, dataTypeV>(
-        (*polygon_)[i].first, (*polygon_)[i].second, i);
+      octree_.rangeSegmentQuery(
+        (*polygon_)[i].first, (*polygon_)[i].second, edgeTetLists[i]);
     }
   }
-  else{
-    // regular extraction (the octree has not been computed)
+#endif
+  
+  for(int i = 0; i < polygonEdgeNumber_; i++){
+    if(edgeTetLists.empty())
+      edgeOffsets[i + 1] = edgeOffsets[i] + tetNumber;
+    else
+      edgeOffsets[i + 1] = edgeOffsets[i] + edgeTetLists[i].size();
+  }
+  
+  // per-thread output buffers (one per polygon edge), passed to 
+  // processTetrahedron()
+  int threadNumber = 1;
 #ifdef withOpenMP
-#pragma omp parallel for num_threads(threadNumber_)
+  threadNumber = threadNumber_;
 #endif
-    for(int i = 0; i < polygonEdgeNumber_; i++){
-      computeSurface<dataTypeU, dataTypeV>(
-        (*polygon_)[i].first, (*polygon_)[i].second, i);
-    }
+  vector<vector<Vertex> > threadedVertexLists(
+    threadNumber*polygonEdgeNumber_);
+  vector<vector<Triangle> > threadedTriangleLists(
+    threadNumber*polygonEdgeNumber_);
+  
+  const long long int workNumber = edgeOffsets.back();
+  
+  // static schedule: each thread processes a contiguous range of the work 
+  // list, hence merging the buffers in thread order preserves the sequential
+  // output order.
+#ifdef withOpenMP
+#pragma omp parallel for schedule(static) num_threads(threadNumber)
+#endif
+  for(long long int i = 0; i < workNumber; i++){
+    
+    int threadId = 0;
+#ifdef withOpenMP
+    threadId = omp_get_thread_num();
+#endif
+    
+    int polygonEdgeId = upper_bound(edgeOffsets.begin(), edgeOffsets.end(), i)
+      - edgeOffsets.begin() - 1;
+    int tetId = i - edgeOffsets[polygonEdgeId];
+    if(!edgeTetLists.empty())
+      tetId = edgeTetLists[polygonEdgeId][tetId];
+    
+    const int bufferId = threadId*polygonEdgeNumber_ + polygonEdgeId;
+    processTetrahedron<dataTypeU, dataTypeV>(tetId, 
+      (*polygon_)[polygonEdgeId].first, (*polygon_)[polygonEdgeId].second,
+      polygonEdgeId, 
+      threadedVertexLists[bufferId], threadedTriangleLists[bufferId]);
   }
   
-#else 
+  // merge the per-thread buffers into the polygon edge lists
 #ifdef withOpenMP
 #pragma omp parallel for num_threads(threadNumber_)
 #endif
   for(int i = 0; i < polygonEdgeNumber_; i++){
     
-    computeSurface<dataTypeU, dataTypeV>(
-      (*polygon_)[i].first, (*polygon_)[i].second, i);
+    int vertexNumber = polygonEdgeVertexLists_[i]->size();
+    int triangleNumber = polygonEdgeTriangleLists_[i]->size();
+    for(int j = 0; j < threadNumber; j++){
+      vertexNumber += threadedVertexLists[j*polygonEdgeNumber_ + i].size();
+      triangleNumber += threadedTriangleLists[j*polygonEdgeNumber_ + i].size();
+    }
+    polygonEdgeVertexLists_[i]->reserve(vertexNumber);
+    polygonEdgeTriangleLists_[i]->reserve(triangleNumber);
+    
+    for(int j = 0; j < threadNumber; j++){
+      
+      vector<Vertex> &vertexList = 
+        threadedVertexLists[j*polygonEdgeNumber_ + i];
+      vector<Triangle> &triangleList = 
+        threadedTriangleLists[j*polygonEdgeNumber_ + i];
+      
+      int vertexOffset = polygonEdgeVertexLists_[i]->size();
+      for(int k = 0; k < (int) triangleList.size(); k++){
+        for(int l = 0; l < 3; l++)
+          triangleList[k].vertexIds_[l] += vertexOffset;
+      }
+      
+      polygonEdgeVertexLists_[i]->insert(polygonEdgeVertexLists_[i]->end(),
+        vertexList.begin(), vertexList.end());
+      polygonEdgeTriangleLists_[i]->insert(
+        polygonEdgeTriangleLists_[i]->end(),
+        triangleList.begin(), triangleList.end());
+      
+      vector<Vertex>().swap(vertexList);
+      vector<Triangle>().swap(triangleList);
+    }
   }
-#endif
-   
+  
   finalize<dataTypeU, dataTypeV>(pointSnapping_, NULL, NULL, NULL);
     
   {
@@ -1681,6 +1851,165 @@ template <class dataTypeU, class dataTypeV>
   return 0;
 }
 
+template <class dataTypeU, class dataTypeV>
+  inline int FiberSurface::computeSurfaceStreaming(){
+    
+#ifndef withKamikaze
+  if((!tetNumber_)&&(!triangulation_))
+    return -1;
+  if((!tetList_)&&(!triangulation_))
+    return -2;
+  if(!uField_)
+    return -3;
+  if(!vField_)
+    return -4;
+  if((!pointSet_)&&(!triangulation_))
+    return -5;
+  if(!polygon_)
+    return -6;
+  if(polygonEdgeNumber_ != (int) polygon_->size())
+    return -7;
+  if(!chunkSink_)
+    return -8;
+  if(chunkSize_ <= 0)
+    return -9;
+#endif
+  
+  Timer t;
+  
+  int tetNumber = tetNumber_, pointNumber = pointNumber_;
+  if(triangulation_){
+    tetNumber = triangulation_->getNumberOfCells();
+    pointNumber = triangulation_->getNumberOfVertices();
+  }
+  
+  // per-thread output buffers, passed to processTetrahedron(). their size is
+  // bounded by the chunk size.
+  int threadNumber = 1;
+#ifdef withOpenMP
+  threadNumber = threadNumber_;
+#endif
+  vector<vector<Vertex> > threadedVertexLists(threadNumber);
+  vector<vector<Triangle> > threadedTriangleLists(threadNumber);
+  
+  vector<int> edgeTetList, vertexLastPositions(pointNumber, -1);
+  vector<Vertex> chunkVertexList, newVertexList;
+  vector<Triangle> chunkTriangleList;
+  vector<BoundaryVertex> boundaryVertexList;
+  
+  int ret = 0, chunkNumber = 0, vertexNumber = 0;
+  long long int triangleNumber = 0;
+  
+  for(int i = 0; (i < polygonEdgeNumber_)&&(!ret); i++){
+    
+    bool isTetListed = false;
+    int edgeTetNumber = tetNumber;
+#ifdef withrangeDrivenOctree
+    if(!octree_.empty()){
+      // the query returns the tetrahedra leaf after leaf, hence the chunks 
+      // are spatially coherent.
+      edgeTetList.clear();
+      octree_.rangeSegmentQuery(
+        (*polygon_)[i].first, (*polygon_)[i].second, edgeTetList);
+      isTetListed = true;
+      edgeTetNumber = edgeTetList.size();
+    }
+#endif
+    
+    // position of the last tetrahedron of each vertex star, in processing 
+    // order (bounds the lifetime of the chunk boundary vertices)
+    for(int j = 0; j < edgeTetNumber; j++){
+      int tetId = j;
+      if(isTetListed)
+        tetId = edgeTetList[j];
+      for(int k = 0; k < 4; k++){
+        int vertexId = -1;
+        if(triangulation_)
+          triangulation_->getCellVertex(tetId, k, vertexId);
+        else
+          vertexId = tetList_[5*tetId + 1 + k];
+        vertexLastPositions[vertexId] = j;
+      }
+    }
+    
+    for(int j = 0; (j < edgeTetNumber)&&(!ret); j += chunkSize_){
+      
+      int chunkEnd = j + chunkSize_;
+      if(chunkEnd > edgeTetNumber)
+        chunkEnd = edgeTetNumber;
+      
+#ifdef withOpenMP
+#pragma omp parallel for schedule(static) num_threads(threadNumber)
+#endif
+      for(int k = j; k < chunkEnd; k++){
+        
+        int threadId = 0;
+#ifdef withOpenMP
+        threadId = omp_get_thread_num();
+#endif
+        
+        int tetId = k;
+        if(isTetListed)
+          tetId = edgeTetList[k];
+        
+        processTetrahedron<dataTypeU, dataTypeV>(tetId, 
+          (*polygon_)[i].first, (*polygon_)[i].second, i,
+          threadedVertexLists[threadId], threadedTriangleLists[threadId]);
+      }
+      
+      // gather the per-thread buffers in thread order
+      chunkVertexList.clear();
+      chunkTriangleList.clear();
+      for(int k = 0; k < threadNumber; k++){
+        
+        int vertexOffset = chunkVertexList.size();
+        for(int l = 0; l < (int) threadedTriangleLists[k].size(); l++){
+          for(int m = 0; m < 3; m++)
+            threadedTriangleLists[k][l].vertexIds_[m] += vertexOffset;
+        }
+        
+        chunkVertexList.insert(chunkVertexList.end(),
+          threadedVertexLists[k].begin(), threadedVertexLists[k].end());
+        chunkTriangleList.insert(chunkTriangleList.end(),
+          threadedTriangleLists[k].begin(), threadedTriangleLists[k].end());
+        
+        threadedVertexLists[k].clear();
+        threadedTriangleLists[k].clear();
+      }
+      
+      weldChunk(i, chunkEnd, vertexLastPositions, 
+        chunkVertexList, chunkTriangleList, 
+        boundaryVertexList, vertexNumber, newVertexList);
+      
+      if(chunkTriangleList.size()){
+        ret = chunkSink_(newVertexList, chunkTriangleList, chunkSinkData_);
+        chunkNumber++;
+        triangleNumber += chunkTriangleList.size();
+      }
+    }
+  }
+  
+  if(ret){
+    stringstream msg;
+    msg << "[FiberSurface] Extraction interrupted by the chunk sink ("
+      << ret << ")." << endl;
+    dMsg(cerr, msg.str(), fatalMsg);
+    return -10;
+  }
+  
+  {
+    stringstream msg;
+    msg << "[FiberSurface] FiberSurface streamed in "
+      << t.getElapsedTime() << " s. (" << vertexNumber
+      << " vertices, " << triangleNumber << " triangles, " 
+      << chunkNumber << " chunk(s), " << threadNumber_
+      << " thread(s))" << endl;
+    dMsg(cout, msg.str(), timeMsg);
+  }
+  
+  return 0;
+}
+
 #ifdef withrangeDrivenOctree
 template <class dataTypeU, class dataTypeV>
   inline int FiberSurface::computeSurfaceWithOctree(
@@ -1788,6 +2117,19 @@ template <class dataTypeU, class dataTypeV>
     const pair<double, double> &rangePoint0,
     const pair<double, double> &rangePoint1,
     const int &polygonEdgeId) const{
+  
+  return processTetrahedron<dataTypeU, dataTypeV>(tetId, 
+    rangePoint0, rangePoint1, polygonEdgeId,
+    *polygonEdgeVertexLists_[polygonEdgeId], 
+    *polygonEdgeTriangleLists_[polygonEdgeId]);
+}
+
+template <class dataTypeU, class dataTypeV>
+  inline int FiberSurface::processTetrahedron(const int &tetId,
+    const pair<double, double> &rangePoint0,
+    const pair<double, double> &rangePoint1,
+    const int &polygonEdgeId,
+    vector<Vertex> &vertexList, vector<Triangle> &triangleList) const{
 
   double rangeEdge[2];
   rangeEdge[0] = rangePoint0.first - rangePoint1.first;
@@ -2064,7 +2406,8 @@ template <class dataTypeU, class dataTypeV>
             polygonEdgeId, tetId, 
             triangleEdges[i][0], t[0], uv[0].first, uv[0].second,
             triangleEdges[i][1], t[1], uv[1].first, uv[1].second,
-            triangleEdges[i][2], t[2], uv[2].first, uv[2].second);
+            triangleEdges[i][2], t[2], uv[2].first, uv[2].second,
+            vertexList, triangleList);
         }
         else if(lowerVertexNumber == 3){
           // well do nothing (empty triangle)
@@ -2079,21 +2422,24 @@ template <class dataTypeU, class dataTypeV>
             polygonEdgeId, tetId,
             triangleEdges[i][0], t[0], uv[0].first, uv[0].second,
             triangleEdges[i][1], t[1], uv[1].first, uv[1].second,
-            triangleEdges[i][2], t[2], uv[2].first, uv[2].second);
+            triangleEdges[i][2], t[2], uv[2].first, uv[2].second,
+            vertexList, triangleList);
         }
         else if((lowerVertexNumber == 2)&&(upperVertexNumber == 1)){
           createdVertices += computeCase2<dataTypeU, dataTypeV>(
             polygonEdgeId, tetId, 
             triangleEdges[i][0], t[0], uv[0].first, uv[0].second,
             triangleEdges[i][1], t[1], uv[1].first, uv[1].second,
-            triangleEdges[i][2], t[2], uv[2].first, uv[2].second);
+            triangleEdges[i][2], t[2], uv[2].first, uv[2].second,
+            vertexList, triangleList);
         }
         else if((lowerVertexNumber == 1)&&(upperVertexNumber == 2)){
           createdVertices += computeCase2<dataTypeU, dataTypeV>(
             polygonEdgeId, tetId, 
             triangleEdges[i][0], t[0], uv[0].first, uv[0].second,
             triangleEdges[i][1], t[1], uv[1].first, uv[1].second,
-            triangleEdges[i][2], t[2], uv[2].first, uv[2].second);
+            triangleEdges[i][2], t[2], uv[2].first, uv[2].second,
+            vertexList, triangleList);
         }
         else if((greyVertexNumber == 1)
           &&(lowerVertexNumber == 2)){
@@ -2101,7 +2447,8 @@ template <class dataTypeU, class dataTypeV>
             polygonEdgeId, tetId, 
             triangleEdges[i][0], t[0], uv[0].first, uv[0].second,
             triangleEdges[i][1], t[1], uv[1].first, uv[1].second,
-            triangleEdges[i][2], t[2], uv[2].first, uv[2].second);
+            triangleEdges[i][2], t[2], uv[2].first, uv[2].second,
+            vertexList, triangleList);
         }
         else if((greyVertexNumber == 1)
           &&(upperVertexNumber == 2)){
@@ -2109,7 +2456,8 @@ template <class dataTypeU, class dataTypeV>
             polygonEdgeId, tetId, 
             triangleEdges[i][0], t[0], uv[0].first, uv[0].second,
             triangleEdges[i][1], t[1], uv[1].first, uv[1].second,
-            triangleEdges[i][2], t[2], uv[2].first, uv[2].second);
+            triangleEdges[i][2], t[2], uv[2].first, uv[2].second,
+            vertexList, triangleList);
         }
         else if((greyVertexNumber == 2)
           &&(lowerVertexNumber == 1)){
@@ -2117,7 +2465,8 @@ template <class dataTypeU, class dataTypeV>
             polygonEdgeId, tetId,
             triangleEdges[i][0], t[0], uv[0].first, uv[0].second,
             triangleEdges[i][1], t[1], uv[1].first, uv[1].second,
-            triangleEdges[i][2], t[2], uv[2].first, uv[2].second);
+            triangleEdges[i][2], t[2], uv[2].first, uv[2].second,
+            vertexList, triangleList);
         }
         else if((greyVertexNumber == 2)
           &&(upperVertexNumber == 1)){
@@ -2125,7 +2474,8 @@ template <class dataTypeU, class dataTypeV>
             polygonEdgeId, tetId, 
             triangleEdges[i][0], t[0], uv[0].first, uv[0].second,
             triangleEdges[i][1], t[1], uv[1].first, uv[1].second,
-            triangleEdges[i][2], t[2], uv[2].first, uv[2].second);
+            triangleEdges[i][2], t[2], uv[2].first, uv[2].second,
+            vertexList, triangleList);
         }
       }
     }
@@ -2139,7 +2489,7 @@ template <class dataTypeU, class dataTypeV>
       vector<int> createdVertexList(createdVertices);
       for(int i = 0; i < (int) createdVertices; i++){
         createdVertexList[i] = 
-          polygonEdgeVertexLists_[polygonEdgeId]->size() - 1 - i;
+          vertexList.size() - 1 - i;
       }
       
       vector<bool> snappedVertices(createdVertices, false);
@@ -2154,9 +2504,9 @@ template <class dataTypeU, class dataTypeV>
               // not the same vertex
               // not snapped already
               
-              if((*polygonEdgeVertexLists_[polygonEdgeId])[
+              if(vertexList[
                   createdVertexList[i]].t_ == 
-                (*polygonEdgeVertexLists_[polygonEdgeId])[
+                vertexList[
                   createdVertexList[j]].t_){
                 colinearVertices.push_back(j);
               }
@@ -2176,16 +2526,16 @@ template <class dataTypeU, class dataTypeV>
               if(j != k){
                 
                 double distance = Geometry::distance(
-                  (*polygonEdgeVertexLists_[polygonEdgeId])[
+                  vertexList[
                     createdVertexList[colinearVertices[j]]].p_,
-                  (*polygonEdgeVertexLists_[polygonEdgeId])[
+                  vertexList[
                       createdVertexList[colinearVertices[k]]].p_);
                 
 //                 bool basePointSnap = true;
 //                 for(int l = 0; l < 3; l++){
-//                   if((*polygonEdgeVertexLists_[polygonEdgeId])[
+//                   if(vertexList[
 //                     createdVertexList[colinearVertices[j]]].p_[l] != 
-//                   (*polygonEdgeVertexLists_[polygonEdgeId])[
+//                   vertexList[
 //                       createdVertexList[colinearVertices[k]]].p_[l]){
 //                     basePointSnap = false;
 //                     break;
@@ -2210,40 +2560,40 @@ template <class dataTypeU, class dataTypeV>
                 // snap minPair.first to j
                 
                 for(int k = 0; k < 3; k++){
-                  (*polygonEdgeVertexLists_[polygonEdgeId])[
+                  vertexList[
                     createdVertexList[colinearVertices[minPair.first]]].p_[k] = 
-                  (*polygonEdgeVertexLists_[polygonEdgeId])[
+                  vertexList[
                     createdVertexList[colinearVertices[j]]].p_[k];
                 }
-                (*polygonEdgeVertexLists_[polygonEdgeId])[
+                vertexList[
                     createdVertexList[colinearVertices[minPair.first]]].uv_ = 
-                (*polygonEdgeVertexLists_[polygonEdgeId])[
+                vertexList[
                     createdVertexList[colinearVertices[j]]].uv_;
                     
-                (*polygonEdgeVertexLists_[polygonEdgeId])[
+                vertexList[
                     createdVertexList[colinearVertices[minPair.first]]].t_ =
-                (*polygonEdgeVertexLists_[polygonEdgeId])[
+                vertexList[
                     createdVertexList[colinearVertices[j]]].t_;
                     
-                (*polygonEdgeVertexLists_[polygonEdgeId])[
+                vertexList[
                   createdVertexList[
                     colinearVertices[minPair.first]]].isBasePoint_ = 
-                (*polygonEdgeVertexLists_[polygonEdgeId])[
+                vertexList[
                   createdVertexList[colinearVertices[j]]].isBasePoint_;
                   
-                (*polygonEdgeVertexLists_[polygonEdgeId])[
+                vertexList[
                   createdVertexList[
                     colinearVertices[minPair.first]]].isIntersectionPoint_ = 
-                (*polygonEdgeVertexLists_[polygonEdgeId])[
+                vertexList[
                   createdVertexList[
                     colinearVertices[j]]].isIntersectionPoint_;
-                if((*polygonEdgeVertexLists_[polygonEdgeId])[
+                if(vertexList[
                   createdVertexList[
                     colinearVertices[j]]].meshEdge_.first != -1){
-                  (*polygonEdgeVertexLists_[polygonEdgeId])[
+                  vertexList[
                     createdVertexList[
                       colinearVertices[minPair.first]]].meshEdge_ = 
-                  (*polygonEdgeVertexLists_[polygonEdgeId])[
+                  vertexList[
                     createdVertexList[
                       colinearVertices[j]]].meshEdge_;
                 }
@@ -2251,40 +2601,40 @@ template <class dataTypeU, class dataTypeV>
                     
                 // snap minPair.second to j
                 for(int k = 0; k < 3; k++){
-                  (*polygonEdgeVertexLists_[polygonEdgeId])[
+                  vertexList[
                     createdVertexList[colinearVertices[minPair.second]]].p_[k] 
-                    = (*polygonEdgeVertexLists_[polygonEdgeId])[
+                    = vertexList[
                     createdVertexList[colinearVertices[j]]].p_[k];
                 }
-                (*polygonEdgeVertexLists_[polygonEdgeId])[
+                vertexList[
                     createdVertexList[colinearVertices[minPair.second]]].uv_ = 
-                (*polygonEdgeVertexLists_[polygonEdgeId])[
+                vertexList[
                     createdVertexList[colinearVertices[j]]].uv_;
                     
-                (*polygonEdgeVertexLists_[polygonEdgeId])[
+                vertexList[
                     createdVertexList[colinearVertices[minPair.second]]].t_ =
-                (*polygonEdgeVertexLists_[polygonEdgeId])[
+                vertexList[
                     createdVertexList[colinearVertices[j]]].t_;
                     
-                (*polygonEdgeVertexLists_[polygonEdgeId])[
+                vertexList[
                   createdVertexList[
                     colinearVertices[minPair.second]]].isBasePoint_ = 
-                (*polygonEdgeVertexLists_[polygonEdgeId])[
+                vertexList[
                   createdVertexList[colinearVertices[j]]].isBasePoint_;
                   
-                (*polygonEdgeVertexLists_[polygonEdgeId])[
+                vertexList[
                   createdVertexList[
                     colinearVertices[minPair.second]]].isIntersectionPoint_ = 
-                (*polygonEdgeVertexLists_[polygonEdgeId])[
+                vertexList[
                   createdVertexList[
                     colinearVertices[j]]].isIntersectionPoint_;
-                if((*polygonEdgeVertexLists_[polygonEdgeId])[
+                if(vertexList[
                   createdVertexList[
                     colinearVertices[j]]].meshEdge_.first != -1){
-                (*polygonEdgeVertexLists_[polygonEdgeId])[
+                vertexList[
                   createdVertexList[
                     colinearVertices[minPair.second]]].meshEdge_ = 
-                (*polygonEdgeVertexLists_[polygonEdgeId])[
+                vertexList[
                   createdVertexList[
                     colinearVertices[j]]].meshEdge_;
                 }
@@ -1,5 +1,6 @@
 ttk_add_baseCode_package(geometry)
 ttk_add_baseCode_package(triangulation)
+ttk_add_baseCode_package(vertexWelder)
 ttk_add_optional_baseCode_package(rangeDrivenOctree)
 
 # if the package is not a template, uncomment the following line
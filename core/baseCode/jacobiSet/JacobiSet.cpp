@@ -12,11 +12,14 @@ template <class dataTypeU, class dataTypeV>
   
   edgeList_ = NULL;
   edgeFanLinkEdgeLists_ = NULL;
+  edgeFanLinkEdgeOffsets_ = NULL;
   edgeFans_ = NULL;
+  edgeFanOffsets_ = NULL;
   sosOffsetsU_ = NULL;
   sosOffsetsV_ = NULL;
 
   triangulation_ = NULL;  
+  useEdgeLinks_ = false;
 }
 
 template <class dataTypeU, class dataTypeV> 
@@ -27,8 +30,10 @@ template <class dataTypeU, class dataTypeV>
 template <class dataTypeU, class dataTypeV> 
   int JacobiSet<dataTypeU, dataTypeV>::connectivityPreprocessing(
     const vector<vector<int> > &edgeStarList,
-    vector<vector<pair<int, int> > > &edgeFanLinkEdgeLists,
-    vector<vector<long long int> > &edgeFans,
+    vector<long long int> &edgeFans,
+    vector<long long int> &edgeFanOffsets,
+    vector<pair<int, int> > &edgeFanLinkEdgeLists,
+    vector<long long int> &edgeFanLinkEdgeOffsets,
     vector<int> &sosOffsets) const{
 
   Timer t;
@@ -45,20 +50,27 @@ template <class dataTypeU, class dataTypeV>
     return -4;
 #endif
 
-  edgeFanLinkEdgeLists.resize(edgeList_->size());
+  int edgeNumber = edgeList_->size();
   
-  int count = 0;
-
-  // edge triangle fans [each thread writes in a different spot]
+  // edge triangle fans, in CSR format
   //    for each edge
   //      for each triangle 
   //        list of vertices
-  edgeFans.resize(edgeList_->size());
-  // pre-allocate memory
-  for(int i = 0; i < (int) edgeFans.size(); i++){
-    // we store 4 integers per triangle per edge
-    edgeFans[i].resize(edgeStarList[i].size()*4);
+  // we store 4 integers per triangle per edge, hence the offsets are given by
+  // a prefix sum over the edge star sizes and each edge writes in its own 
+  // pre-allocated slot (no lock).
+  edgeFanOffsets.resize(edgeNumber + 1);
+  edgeFanOffsets[0] = 0;
+  for(int i = 0; i < edgeNumber; i++){
+    edgeFanOffsets[i + 1] = edgeFanOffsets[i] + 4*edgeStarList[i].size();
   }
+  edgeFans.resize(edgeFanOffsets.back());
+  
+  // the one skeleton of a fan of n triangles has at most 3n edges.
+  // each edge first writes its link edges in a slot of that size, the slots
+  // are compacted afterwards.
+  vector<pair<int, int> > edgeSlots(3*(edgeFanOffsets.back()/4));
+  vector<int> edgeSlotSizes(edgeNumber, 0);
  
   if(!sosOffsets.size()){
     sosOffsets.resize(vertexNumber_);
@@ -67,31 +79,15 @@ template <class dataTypeU, class dataTypeV>
     }
   }
   
-  vector<ZeroSkeleton> threadedLinkers(threadNumber_);
-  vector<vector<long long int> > threadedLinks(threadNumber_);
-  for(int i = 0; i < threadNumber_; i++){
-    threadedLinkers[i].setDebugLevel(debugLevel_);
-    threadedLinkers[i].setThreadNumber(1);
-  }
-  
-  vector<OneSkeleton> threadedEdgeListers(threadNumber_);
-  for(int i = 0; i < threadNumber_; i++){
-    threadedEdgeListers[i].setDebugLevel(debugLevel_);
-    threadedEdgeListers[i].setThreadNumber(1);
-  }
- 
-  vector<vector<int> > threadedTriangleIds(threadNumber_);
-  for(int i = 0; i < (int) threadedTriangleIds.size(); i++){
-    threadedTriangleIds[i].resize(4);
-    threadedTriangleIds[i][0] = 3;
-  }
+  // thread 0 processes the first edges (static schedule)
+  int progressStep = edgeNumber/(10*threadNumber_);
+  if(!progressStep)
+    progressStep = 1;
   
 #ifdef withOpenMP
-  omp_lock_t writeLock;
-  omp_init_lock(&writeLock);
-#pragma omp parallel for num_threads(threadNumber_) 
+#pragma omp parallel for schedule(static) num_threads(threadNumber_) 
 #endif
-  for(int i = 0; i < (int) edgeList_->size(); i++){
+  for(int i = 0; i < edgeNumber; i++){
 
     // avoid any processing if the abort signal is sent
     if((!wrapper_)||((wrapper_)&&(!wrapper_->needsToAbort()))){
@@ -105,6 +101,8 @@ template <class dataTypeU, class dataTypeV>
       int pivotVertexId = (*edgeList_)[i].first;
       int otherExtremityId = (*edgeList_)[i].second;
       
+      long long int *edgeFan = &(edgeFans[edgeFanOffsets[i]]);
+      
       // A) compute triangle fans
       // format: #vertices, id0, id1, id2, etc.
       for(int j = 0; j < (int) edgeStarList[i].size(); j++){
@@ -118,59 +116,77 @@ template <class dataTypeU, class dataTypeV>
           
           bool hasPivotVertex = false;
           bool hasOtherExtremity = false;
+          edgeFan[j*4] = 3;
           for(int l = 0; l < 3; l++){
-            threadedTriangleIds[threadId][l + 1] 
-              = tetList_[5*tetId + 1 + (l + k)%4];
-            if(threadedTriangleIds[threadId][l + 1] == pivotVertexId){
+            edgeFan[j*4 + l + 1] = tetList_[5*tetId + 1 + (l + k)%4];
+            if(edgeFan[j*4 + l + 1] == pivotVertexId){
               hasPivotVertex = true;
             }
-            if(threadedTriangleIds[threadId][l + 1] == otherExtremityId){
+            if(edgeFan[j*4 + l + 1] == otherExtremityId){
               hasOtherExtremity = true;
             }
           }
           
           if((hasPivotVertex)&&(!hasOtherExtremity)){
-            for(int l = 0; l < (int) threadedTriangleIds[threadId].size(); l++){
-              edgeFans[i][j*4 + l] = 
-                threadedTriangleIds[threadId][l];
-            }
             break;
           }
         }
       }
       
-      // set-up the link of the edge fan
-      threadedLinkers[threadId].buildVertexLink(
-        pivotVertexId, edgeFans[i].size()/4, 
-          edgeFans[i].data(), threadedLinks[threadId]);
-      
-      // now compute the edge list of the link
-      threadedEdgeListers[threadId].buildEdgeSubList(
-        edgeFans[i].size()/4, edgeFans[i].data(),
-        edgeFanLinkEdgeLists[i]);
+      // B) compute the edge list of the fan (in order of first appearance)
+      pair<int, int> *edgeSlot = &(edgeSlots[3*(edgeFanOffsets[i]/4)]);
+      int &edgeSlotSize = edgeSlotSizes[i];
+      for(int j = 0; j < (int) edgeStarList[i].size(); j++){
+        for(int k = 0; k < 2; k++){
+          for(int l = k + 1; l < 3; l++){
+            
+            pair<int, int> edgeIds(
+              edgeFan[j*4 + 1 + k], edgeFan[j*4 + 1 + l]);
+            if(edgeIds.first > edgeIds.second){
+              swap(edgeIds.first, edgeIds.second);
+            }
+            
+            bool isIn = false;
+            for(int m = 0; m < edgeSlotSize; m++){
+              if(edgeSlot[m] == edgeIds){
+                isIn = true;
+                break;
+              }
+            }
+            if(!isIn){
+              edgeSlot[edgeSlotSize] = edgeIds;
+              edgeSlotSize++;
+            }
+          }
+        }
+      }
       
       // update the progress bar of the wrapping code -- to adapt
-      if(debugLevel_ > advancedInfoMsg){
-#ifdef withOpenMP
-        omp_set_lock(&writeLock);
-#endif
-        if((wrapper_)
-          &&(!(count % ((vertexNumber_)/10)))){
-          wrapper_->updateProgress((count + 1.0)
-            /vertexNumber_);
-        }
-
-        count++;
-#ifdef withOpenMP
-        omp_unset_lock(&writeLock);
-#endif
+      if((debugLevel_ > advancedInfoMsg)&&(wrapper_)&&(!threadId)
+        &&(!(i % progressStep))){
+        wrapper_->updateProgress((i + 1.0)*threadNumber_/edgeNumber);
       }
     }
   }
-   
+  
+  // compact the link edge lists
+  edgeFanLinkEdgeOffsets.resize(edgeNumber + 1);
+  edgeFanLinkEdgeOffsets[0] = 0;
+  for(int i = 0; i < edgeNumber; i++){
+    edgeFanLinkEdgeOffsets[i + 1] = 
+      edgeFanLinkEdgeOffsets[i] + edgeSlotSizes[i];
+  }
+  edgeFanLinkEdgeLists.resize(edgeFanLinkEdgeOffsets.back());
+  
 #ifdef withOpenMP
-  omp_destroy_lock(&writeLock);
+#pragma omp parallel for num_threads(threadNumber_) 
 #endif
+  for(int i = 0; i < edgeNumber; i++){
+    for(int j = 0; j < edgeSlotSizes[i]; j++){
+      edgeFanLinkEdgeLists[edgeFanLinkEdgeOffsets[i] + j] = 
+        edgeSlots[3*(edgeFanOffsets[i]/4) + j];
+    }
+  }
   
   {
     stringstream msg;
@@ -238,19 +254,28 @@ template <class dataTypeU, class dataTypeV>
   
   vector<vector<pair<int, char> > > threadedCriticalTypes(threadNumber_);
   
+  // per-thread link buffers, re-used from one edge to the next
+  vector<vector<pair<int, int> > > threadedLinkEdges(threadNumber_);
+  vector<vector<int> > threadedLinkVertices(threadNumber_),
+    threadedLinkParents(threadNumber_);
+  vector<vector<char> > threadedLinkSides(threadNumber_);
+  
 #ifdef withOpenMP
 #pragma omp parallel for num_threads(threadNumber_)
 #endif
   for(int i = 0; i < edgeNumber; i++){
     
-    char type = getCriticalType(i);
+    int threadId = 0;
+#ifdef withOpenMP
+    threadId = omp_get_thread_num();
+#endif
+    
+    char type = getCriticalType(i, 
+      threadedLinkEdges[threadId], threadedLinkVertices[threadId],
+      threadedLinkSides[threadId], threadedLinkParents[threadId]);
     
     if(type != -2){
       // -2: regular vertex
-      int threadId = 0;
-#ifdef withOpenMP
-      threadId = omp_get_thread_num();
-#endif
       threadedCriticalTypes[threadId].push_back(pair<int, char>(i, type));
     }
   }
@@ -331,16 +356,14 @@ template <class dataTypeU, class dataTypeV>
     return -3;
   if(!edgeList_)
     return -4;
-  if(!edgeFanLinkEdgeLists_)
+  if((!edgeFanLinkEdgeLists_)||(!edgeFanLinkEdgeOffsets_))
     return -5;
-  if(!edgeFans_)
+  if((!edgeFans_)||(!edgeFanOffsets_))
     return -6;
   if(!sosOffsetsU_)
     return -7;
 #endif
 
-  int count = 0;
-  
   jacobiSet.clear();
   
   dataTypeU *uField = (dataTypeU *) uField_;
@@ -365,13 +388,21 @@ template <class dataTypeU, class dataTypeV>
   }
 
   vector<vector<pair<int, char> > > threadedCriticalTypes(threadNumber_);
+  
+  // link edge lists of the current edges (re-used across edges)
+  vector<vector<pair<int, int> > > threadedLinkEdgeLists(threadNumber_);
+  
+  int edgeNumber = edgeList_->size();
+  
+  // thread 0 processes the first edges (static schedule)
+  int progressStep = edgeNumber/(10*threadNumber_);
+  if(!progressStep)
+    progressStep = 1;
 
 #ifdef withOpenMP
-  omp_lock_t writeLock;
-  omp_init_lock(&writeLock);
-#pragma omp parallel for num_threads(threadNumber_) 
+#pragma omp parallel for schedule(static) num_threads(threadNumber_) 
 #endif
-  for(int i = 0; i < (int) edgeList_->size(); i++){
+  for(int i = 0; i < edgeNumber; i++){
 
     // avoid any processing if the abort signal is sent
     if((!wrapper_)||((wrapper_)&&(!wrapper_->needsToAbort()))){
@@ -402,10 +433,11 @@ template <class dataTypeU, class dataTypeV>
       rangeNormal[0] = -rangeEdge[1];
       rangeNormal[1] = rangeEdge[0];
       
-      for(int j = 0; j < (int) (*edgeFans_)[i].size()/4; j++){
+      for(long long int j = (*edgeFanOffsets_)[i]; 
+        j < (*edgeFanOffsets_)[i + 1]; j += 4){
         for(int k = 0; k < 3; k++){
           
-          int vertexId = (*edgeFans_)[i][j*4 + 1 + k];
+          int vertexId = (*edgeFans_)[j + 1 + k];
           
           // we can compute the distance field (in the rage)
           double projectedVertex[2];
@@ -429,9 +461,12 @@ template <class dataTypeU, class dataTypeV>
       // also, lots of things in there can be done out of the loop
       
       // in the loop
+      threadedLinkEdgeLists[threadId].assign(
+        edgeFanLinkEdgeLists_->begin() + (*edgeFanLinkEdgeOffsets_)[i],
+        edgeFanLinkEdgeLists_->begin() + (*edgeFanLinkEdgeOffsets_)[i + 1]);
       char type = 
         threadedCriticalPoints[threadId].getCriticalType(pivotVertexId,
-          (*edgeFanLinkEdgeLists_)[i]);
+          threadedLinkEdgeLists[threadId]);
         
       if(type != -2){
         // -2: regular vertex
@@ -439,20 +474,9 @@ template <class dataTypeU, class dataTypeV>
       }
       
       // update the progress bar of the wrapping code -- to adapt
-      if(debugLevel_ > advancedInfoMsg){
-#ifdef withOpenMP
-        omp_set_lock(&writeLock);
-#endif
-        if((wrapper_)
-          &&(!(count % ((vertexNumber_)/10)))){
-          wrapper_->updateProgress((count + 1.0)
-            /vertexNumber_);
-        }
-
-        count++;
-#ifdef withOpenMP
-        omp_unset_lock(&writeLock);
-#endif
+      if((debugLevel_ > advancedInfoMsg)&&(wrapper_)&&(!threadId)
+        &&(!(i % progressStep))){
+        wrapper_->updateProgress((i + 1.0)*threadNumber_/edgeNumber);
       }
     }
   }
@@ -463,11 +487,7 @@ template <class dataTypeU, class dataTypeV>
       jacobiSet.push_back(threadedCriticalTypes[i][j]);
     }
   }
-  
-#ifdef withOpenMP
-  omp_destroy_lock(&writeLock);
-#endif
- 
+
   if(debugLevel_ >= Debug::infoMsg){
     int minimumNumber = 0, saddleNumber = 0, maximumNumber = 0, 
       monkeySaddleNumber = 0;
@@ -518,6 +538,21 @@ template <class dataTypeU, class dataTypeV>
 template <class dataTypeU, class dataTypeV> 
   char JacobiSet<dataTypeU, dataTypeV>::getCriticalType(const int &edgeId){
   
+  vector<pair<int, int> > linkEdges;
+  vector<int> linkVertices, linkParents;
+  vector<char> linkSides;
+  
+  return getCriticalType(edgeId, 
+    linkEdges, linkVertices, linkSides, linkParents);
+}
+
+template <class dataTypeU, class dataTypeV> 
+  char JacobiSet<dataTypeU, dataTypeV>::getCriticalType(const int &edgeId,
+    vector<pair<int, int> > &linkEdges,
+    vector<int> &linkVertices,
+    vector<char> &linkSides,
+    vector<int> &linkParents){
+  
   dataTypeU *uField = (dataTypeU *) uField_;
   dataTypeV *vField = (dataTypeV *) vField_;
   
@@ -541,229 +576,178 @@ template <class dataTypeU, class dataTypeV>
   rangeNormal[0] = -rangeEdge[1];
   rangeNormal[1] = rangeEdge[0];
   
-  int starNumber = triangulation_->getEdgeStarNumber(edgeId);
-  vector<int> lowerNeighbors, upperNeighbors;
+  // 1. gather the edges of the link (one per tetrahedron of the star)
+  linkEdges.clear();
+  
+  if(useEdgeLinks_){
+    // link edges, as given by the triangulation
+    int linkNumber = triangulation_->getEdgeLinkNumber(edgeId);
+    for(int i = 0; i < linkNumber; i++){
+      int linkEdgeId = -1;
+      triangulation_->getEdgeLink(edgeId, i, linkEdgeId);
+      
+      pair<int, int> linkEdge(-1, -1);
+      triangulation_->getEdgeVertex(linkEdgeId, 0, linkEdge.first);
+      triangulation_->getEdgeVertex(linkEdgeId, 1, linkEdge.second);
+      linkEdges.push_back(linkEdge);
+    }
+  }
+  else{
+    int starNumber = triangulation_->getEdgeStarNumber(edgeId);
+    linkEdges.resize(starNumber);
+    for(int i = 0; i < starNumber; i++){
+      getStarLinkEdge(edgeId, i, vertexId0, vertexId1, linkEdges[i]);
+    }
+  }
+  
+  // 2. classify the link vertices with regard to the fiber of the edge and
+  // re-index the link edges with local vertex identifiers.
+  linkVertices.clear();
+  linkSides.clear();
   
-  int neighborNumber = 0;
+  int lowerNumber = 0, upperNumber = 0;
+  bool isConsistent = true;
   
-  for(int i = 0; i < starNumber; i++){
-    
-    int tetId = -1;
-    triangulation_->getEdgeStar(edgeId, i, tetId);
-    
-    int vertexNumber = triangulation_->getCellVertexNumber(tetId);
-    for(int j = 0; j < vertexNumber; j++){
-      int vertexId = -1;
-      triangulation_->getCellVertex(tetId, j, vertexId);
+  for(int i = 0; i < (int) linkEdges.size(); i++){
+    for(int j = 0; j < 2; j++){
       
-      if((vertexId != -1)&&(vertexId != vertexId0)&&(vertexId != vertexId1)){
-        // new neighbor
-        bool isIn = false;
-        for(int k = 0; k < (int) lowerNeighbors.size(); k++){
-          if(vertexId == lowerNeighbors[k]){
-            isIn = true;
-            break;
-          }
+      int &vertexId = (j ? linkEdges[i].second : linkEdges[i].first);
+      
+      if(vertexId == -1)
+        continue;
+      
+      int localId = -1;
+      for(int k = 0; k < (int) linkVertices.size(); k++){
+        if(linkVertices[k] == vertexId){
+          localId = k;
+          break;
         }
+      }
+      
+      if(localId == -1){
+        // new neighbor
+        localId = linkVertices.size();
+        linkVertices.push_back(vertexId);
         
-        if(!isIn){
-          for(int k = 0; k < (int) upperNeighbors.size(); k++){
-            if(vertexId == upperNeighbors[k]){
-              isIn = true;
-              break;
-            }
-          }
-        }
+        // compute the actual distance field
+        double projectedVertex[2];
+        projectedVertex[0] = uField[vertexId];
+        projectedVertex[1] = vField[vertexId];
         
-        if(!isIn){
-          // compute the actual distance field
-          // A) compute the distance field
-          double projectedVertex[2];
-          projectedVertex[0] = uField[vertexId];
-          projectedVertex[1] = vField[vertexId];
+        double vertexRangeEdge[2];
+        vertexRangeEdge[0] = projectedVertex[0] - projectedPivotVertex[0];
+        vertexRangeEdge[1] = projectedVertex[1] - projectedPivotVertex[1];
         
-          double vertexRangeEdge[2];
-          vertexRangeEdge[0] = projectedVertex[0] - projectedPivotVertex[0];
-          vertexRangeEdge[1] = projectedVertex[1] - projectedPivotVertex[1];
-          
-          // signed distance: linear function of the dot product
-          double distance = 
-            vertexRangeEdge[0]*rangeNormal[0] 
-              + vertexRangeEdge[1]*rangeNormal[1];
+        // signed distance: linear function of the dot product
+        double distance = 
+          vertexRangeEdge[0]*rangeNormal[0] 
+            + vertexRangeEdge[1]*rangeNormal[1];
+        
+        if(distance == 0){
+          // degenerate
+          // compute the distance field out of the offset positions
+          double offsetProjectedPivotVertex[2];
+          offsetProjectedPivotVertex[0] = (*sosOffsetsU_)[vertexId0];
+          offsetProjectedPivotVertex[1] = 
+            (*sosOffsetsV_)[vertexId0]*(*sosOffsetsV_)[vertexId0];
+            
+          double offsetProjectedOtherVertex[2];
+          offsetProjectedOtherVertex[0] = (*sosOffsetsU_)[vertexId1];
+          offsetProjectedOtherVertex[1] = 
+            (*sosOffsetsV_)[vertexId1]*(*sosOffsetsV_)[vertexId1];
+  
+          double offsetRangeEdge[2];
+          offsetRangeEdge[0] = 
+            offsetProjectedOtherVertex[0] - offsetProjectedPivotVertex[0];
+          offsetRangeEdge[1] =
+            offsetProjectedOtherVertex[1] - offsetProjectedPivotVertex[1];
+            
+          double offsetRangeNormal[2];
+          offsetRangeNormal[0] = -offsetRangeEdge[1];
+          offsetRangeNormal[1] = offsetRangeEdge[0];
           
-          neighborNumber++;
-              
-          if(distance < 0){
-            lowerNeighbors.push_back(vertexId);
-          }
-          else if(distance > 0){
-            upperNeighbors.push_back(vertexId);
-          }
-          else{
-            // degenerate
-            // compute the distance field out of the offset positions
-            double offsetProjectedPivotVertex[2];
-            offsetProjectedPivotVertex[0] = (*sosOffsetsU_)[vertexId0];
-            offsetProjectedPivotVertex[1] = 
-              (*sosOffsetsV_)[vertexId0]*(*sosOffsetsV_)[vertexId0];
-              
-            double offsetProjectedOtherVertex[2];
-            offsetProjectedOtherVertex[0] = (*sosOffsetsU_)[vertexId1];
-            offsetProjectedOtherVertex[1] = 
-              (*sosOffsetsV_)[vertexId1]*(*sosOffsetsV_)[vertexId1];
-  
-            double offsetRangeEdge[2];
-            offsetRangeEdge[0] = 
-              offsetProjectedOtherVertex[0] - offsetProjectedPivotVertex[0];
-            offsetRangeEdge[1] =
-              offsetProjectedOtherVertex[1] - offsetProjectedPivotVertex[1];
-              
-            double offsetRangeNormal[2];
-            offsetRangeNormal[0] = -offsetRangeEdge[1];
-            offsetRangeNormal[1] = offsetRangeEdge[0];
+          projectedVertex[0] = (*sosOffsetsU_)[vertexId];
+          projectedVertex[1] = 
+            (*sosOffsetsV_)[vertexId]*(*sosOffsetsV_)[vertexId];
             
-            projectedVertex[0] = (*sosOffsetsU_)[vertexId];
-            projectedVertex[1] = 
-              (*sosOffsetsV_)[vertexId]*(*sosOffsetsV_)[vertexId];
-              
-            vertexRangeEdge[0] = 
-              projectedVertex[0] - offsetProjectedPivotVertex[0];
-            vertexRangeEdge[1] = 
-              projectedVertex[1] - offsetProjectedPivotVertex[1];
-                
-            distance = 
-              vertexRangeEdge[0]*offsetRangeNormal[0] 
-              + vertexRangeEdge[1]*offsetRangeNormal[1];
+          vertexRangeEdge[0] = 
+            projectedVertex[0] - offsetProjectedPivotVertex[0];
+          vertexRangeEdge[1] = 
+            projectedVertex[1] - offsetProjectedPivotVertex[1];
               
-            if(distance < 0){
-              lowerNeighbors.push_back(vertexId);
-            }
-            else if (distance > 0){
-              upperNeighbors.push_back(vertexId);
-            }
-            else{
-              stringstream msg;
-              msg << 
-                "[JacobiSet] Inconsistent (non-bijective?) offsets for vertex #"
-                << vertexId << endl;
-              dMsg(cerr, msg.str(), Debug::infoMsg);
-            }
-          }
+          distance = 
+            vertexRangeEdge[0]*offsetRangeNormal[0] 
+            + vertexRangeEdge[1]*offsetRangeNormal[1];
+        }
+        
+        if(distance < 0){
+          linkSides.push_back(-1);
+          lowerNumber++;
+        }
+        else if(distance > 0){
+          linkSides.push_back(1);
+          upperNumber++;
+        }
+        else{
+          linkSides.push_back(0);
+          isConsistent = false;
+          stringstream msg;
+          msg << 
+            "[JacobiSet] Inconsistent (non-bijective?) offsets for vertex #"
+            << vertexId << endl;
+          dMsg(cerr, msg.str(), Debug::infoMsg);
         }
       }
+      
+      vertexId = localId;
     }
   }
   
   // at this point, we know if each vertex of the edge link is higher or not.
-  if((int) (lowerNeighbors.size() + upperNeighbors.size()) != neighborNumber){
+  if(!isConsistent){
     // Inconsistent offsets (cf above error message)
     return -2;
   }
   
-  if(lowerNeighbors.empty()){
+  if(!lowerNumber){
     // minimum
     return 0;
   }
-  if(upperNeighbors.empty()){
+  if(!upperNumber){
     // maximum
     return 2;
   }
   
-  // let's check the connectivity now
-  vector<UnionFind> lowerSeeds(lowerNeighbors.size());
-  vector<UnionFind *> lowerList(lowerNeighbors.size());
-  vector<UnionFind> upperSeeds(upperNeighbors.size());
-  vector<UnionFind *> upperList(upperNeighbors.size());
+  // 3. let's check the connectivity now
+  linkParents.resize(linkVertices.size());
+  for(int i = 0; i < (int) linkParents.size(); i++)
+    linkParents[i] = i;
   
-  for(int i = 0; i < (int) lowerSeeds.size(); i++){
-    lowerList[i] = &(lowerSeeds[i]);
-  }
-  for(int i = 0; i < (int) upperSeeds.size(); i++){
-    upperList[i] = &(upperSeeds[i]);
-  }
+  int lowerComponentNumber = lowerNumber, 
+    upperComponentNumber = upperNumber;
   
-  for(int i = 0; i < starNumber; i++){
+  for(int i = 0; i < (int) linkEdges.size(); i++){
     
-    int tetId = -1;
-    triangulation_->getEdgeStar(edgeId, i, tetId);
+    if((linkEdges[i].first == -1)||(linkEdges[i].second == -1))
+      continue;
     
-    int vertexNumber = triangulation_->getCellVertexNumber(tetId);
-    for(int j = 0; j < vertexNumber; j++){
-      int edgeVertexId0 = -1;
-      triangulation_->getCellVertex(tetId, j, edgeVertexId0);
-      if((edgeVertexId0 != vertexId0)&&(edgeVertexId0 != vertexId1)){
-        for(int k = j + 1; k < vertexNumber; k++){
-          int edgeVertexId1 = -1;
-          triangulation_->getCellVertex(tetId, k, edgeVertexId1);
-          if((edgeVertexId1 != vertexId0)&&(edgeVertexId1 != vertexId1)){
-            // processing the edge (edgeVertexId0, edgeVertexId1)
-            
-            // we need to find out if they're lower or not
-            bool lower0 = false;
-            for(int l = 0; l < (int) lowerNeighbors.size(); l++){
-              if(lowerNeighbors[l] == edgeVertexId0){
-                lower0 = true;
-                break;
-              }
-            }
-            bool lower1 = false;
-            for(int l = 0; l < (int) lowerNeighbors.size(); l++){
-              if(lowerNeighbors[l] == edgeVertexId1){
-                lower1 = true;
-                break;
-              }
-            }
-            
-            vector<int> *neighbors = &lowerNeighbors;
-            vector<UnionFind *> *seeds = &lowerList;
-            
-            if(!lower0){
-              neighbors = &upperNeighbors;
-              seeds = &upperList;
-            }
-            
-            if(lower0 == lower1){
-              // connect their union-find sets!
-              int lowerId0 = -1, lowerId1 = -1;
-              for(int l = 0; l < (int) neighbors->size(); l++){
-                if((*neighbors)[l] == edgeVertexId0){
-                  lowerId0 = l;
-                }
-                if((*neighbors)[l] == edgeVertexId1){
-                  lowerId1 = l;
-                }
-              }
-              
-              if((lowerId0 != -1)&&(lowerId1 != -1)){
-                (*seeds)[lowerId0] = 
-                  makeUnion((*seeds)[lowerId0], (*seeds)[lowerId1]);
-                (*seeds)[lowerId1] = (*seeds)[lowerId0];
-              }
-            }
-            
-            break;
-          }
-        }
-      }
+    if(linkSides[linkEdges[i].first] != linkSides[linkEdges[i].second])
+      continue;
+    
+    // connect their union-find sets!
+    int root0 = findLinkRoot(linkParents, linkEdges[i].first);
+    int root1 = findLinkRoot(linkParents, linkEdges[i].second);
+    
+    if(root0 != root1){
+      linkParents[root1] = root0;
+      if(linkSides[root0] < 0)
+        lowerComponentNumber--;
+      else
+        upperComponentNumber--;
     }
   }
   
-  // update the UF if necessary
-  for(int i = 0; i < (int) lowerList.size(); i++)
-    lowerList[i] = lowerList[i]->find();
-  for(int i = 0; i < (int) upperList.size(); i++)
-    upperList[i] = upperList[i]->find();
-  
-  vector<UnionFind *>::iterator it;
-  sort(lowerList.begin(), lowerList.end());
-  it = unique(lowerList.begin(), lowerList.end());
-  lowerList.resize(distance(lowerList.begin(), it));
-  
-  sort(upperList.begin(), upperList.end());
-  it = unique(upperList.begin(), upperList.end());
-  upperList.resize(distance(upperList.begin(), it));
-  
-  if((upperList.size() == 1)&&(lowerList.size() == 1))
+  if((upperComponentNumber == 1)&&(lowerComponentNumber == 1))
     return -2;
   
   return 1;
@@ -9,6 +9,11 @@
 /// Given a bivariate scalar field defined on a PL 3-manifold, this package
 /// produces the list of Jacobi edges (each entry is a pair given by the edge
 /// identifier and the Jacobi edge type).
+///
+/// The link of each edge is queried from the triangulation (see 
+/// ttk::Triangulation::preprocessEdgeLinks()): implicit regular grids compute
+/// it on the fly, explicit triangulations store it once, for all the 
+/// JacobiSet objects processing them. No edge fan is stored.
 /// \param dataTypeU Data type of the input first component field (char, float, 
 /// etc.).
 /// \param dataTypeV Data type of the input second component field (char, float,
@@ -41,9 +46,14 @@ namespace ttk{
       
       ~JacobiSet();
 
+      /// Compute the triangle fan of each edge and the edge list of each 
+      /// fan, in CSR format: the data of the edge i lies in the range 
+      /// [offsets[i], offsets[i + 1]) of the corresponding list.
       int connectivityPreprocessing(const vector<vector<int> > &edgeStarList,
-        vector<vector<pair<int, int> > > &edgeFanLinkEdgeLists,
-        vector<vector<long long int> > &edgeFans,
+        vector<long long int> &edgeFans,
+        vector<long long int> &edgeFanOffsets,
+        vector<pair<int, int> > &edgeFanLinkEdgeLists,
+        vector<long long int> &edgeFanLinkEdgeOffsets,
         vector<int> &sosOffsets) const;
       
       int execute(vector<pair<int, char> > &jacobiSet);
@@ -53,14 +63,18 @@ namespace ttk{
       int perturbate(const dataTypeU &uEpsilon = pow(10, -DBL_DIG),
         const dataTypeV &vEpsilon = pow(10, -DBL_DIG)) const;
       
-      int setEdgeFans(const vector<vector<long long int> > *edgeFans){
+      int setEdgeFans(const vector<long long int> *edgeFans,
+        const vector<long long int> *edgeFanOffsets){
         edgeFans_ = edgeFans;
+        edgeFanOffsets_ = edgeFanOffsets;
         return 0;
       }
       
       int setEdgeFanLinkEdgeList(
-        const vector<vector<pair<int, int> > > *edgeFanLinkEdgeLists){
+        const vector<pair<int, int> > *edgeFanLinkEdgeLists,
+        const vector<long long int> *edgeFanLinkEdgeOffsets){
         edgeFanLinkEdgeLists_ = edgeFanLinkEdgeLists;
+        edgeFanLinkEdgeOffsets_ = edgeFanLinkEdgeOffsets;
         return 0;
       }
       
@@ -110,7 +124,16 @@ namespace ttk{
         // pre-condition functions
         if(triangulation_){
           triangulation_->preprocessEdges();
+          
+          // edge stars are also used by client packages (e.g. ReebSpace)
           triangulation_->preprocessEdgeStars();
+          
+          // the edge links are kept by the triangulation (implicit grids 
+          // provide them for free), hence computed once and for all.
+          useEdgeLinks_ = (triangulation_->getDimensionality() == 3);
+          
+          if(useEdgeLinks_)
+            triangulation_->preprocessEdgeLinks();
         }
         
         return 0;
@@ -120,14 +143,58 @@ namespace ttk{
     
       int executeLegacy(vector<pair<int, char> > &jacobiSet);
       
+      // same as getCriticalType(), with caller-provided buffers (one set per 
+      // thread) to avoid per-edge allocations.
+      char getCriticalType(const int &edgeId,
+        vector<pair<int, int> > &linkEdges,
+        vector<int> &linkVertices,
+        vector<char> &linkSides,
+        vector<int> &linkParents);
+      
+      // link edge of the edge (vertexId0, vertexId1) in its starId-th 
+      // tetrahedron.
+      inline int getStarLinkEdge(const int &edgeId, const int &starId,
+        const int &vertexId0, const int &vertexId1, 
+        pair<int, int> &linkEdge) const{
+        
+        int tetId = -1;
+        triangulation_->getEdgeStar(edgeId, starId, tetId);
+        
+        linkEdge.first = linkEdge.second = -1;
+        int vertexNumber = triangulation_->getCellVertexNumber(tetId);
+        for(int i = 0; i < vertexNumber; i++){
+          int vertexId = -1;
+          triangulation_->getCellVertex(tetId, i, vertexId);
+          if((vertexId != -1)&&(vertexId != vertexId0)
+            &&(vertexId != vertexId1)){
+            if(linkEdge.first == -1)
+              linkEdge.first = vertexId;
+            else if(linkEdge.second == -1)
+              linkEdge.second = vertexId;
+          }
+        }
+        
+        return 0;
+      }
+      
+      inline int findLinkRoot(vector<int> &linkParents, int vertexId) const{
+        while(linkParents[vertexId] != vertexId){
+          linkParents[vertexId] = linkParents[linkParents[vertexId]];
+          vertexId = linkParents[vertexId];
+        }
+        return vertexId;
+      }
+      
+      bool                  useEdgeLinks_;
       int                   vertexNumber_;
       const long long int   *tetList_;
       const void            *uField_, *vField_;
       const vector<pair<int, int> > *edgeList_;
-      // for each edge, one skeleton of its triangle fan
-      const vector<vector<pair<int, int> > > *edgeFanLinkEdgeLists_;
-      // for each edge, the one skeleton of its triangle fan
-      const vector<vector<long long int> > *edgeFans_;
+      // for each edge, one skeleton of its triangle fan (CSR)
+      const vector<pair<int, int> > *edgeFanLinkEdgeLists_;
+      const vector<long long int> *edgeFanLinkEdgeOffsets_;
+      // for each edge, its triangle fan (CSR)
+      const vector<long long int> *edgeFans_, *edgeFanOffsets_;
       vector<int>           *sosOffsetsU_, *sosOffsetsV_;
       vector<int>           localSosOffsetsU_, localSosOffsetsV_;
       Triangulation         *triangulation_;
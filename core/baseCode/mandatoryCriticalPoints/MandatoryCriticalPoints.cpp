@@ -39,6 +39,8 @@ void MandatoryCriticalPoints::flush() {
   lowerMinimumList_.clear();
   upperMaximumList_.clear();
   lowerMaximumList_.clear();
+  upperVertexOrder_.clear();
+  lowerVertexOrder_.clear();
   mandatoryMinimumVertex_.clear();
   mandatoryMaximumVertex_.clear();
   mandatoryMinimumInterval_.clear();
@@ -97,12 +99,20 @@ int MandatoryCriticalPoints::buildSubTrees(){
   #endif
 
   // upperMaximumList_ and lowerMinimumList_ computation (not sorted by function value)
-  lowerMinimumList_.clear();
-  upperMaximumList_.clear();
+  // per-thread lists, concatenated in thread order (sorted by vertex id)
+  int threadNumber = threadNumber_;
+  if(threadNumber < 1)
+    threadNumber = 1;
+  vector<vector<int> > threadedLowerMinima(threadNumber);
+  vector<vector<int> > threadedUpperMaxima(threadNumber);
   #ifdef withOpenMP
-  #pragma omp parallel for num_threads(threadNumber_)
+  #pragma omp parallel for num_threads(threadNumber) schedule(static)
   #endif
   for(int i=0 ; i<vertexNumber_ ; i++){
+    int threadId = 0;
+    #ifdef withOpenMP
+    threadId = omp_get_thread_num();
+    #endif
     bool isLowerMin = true;
     bool isUpperMax = true;
     int neighborNumber = triangulation_->getVertexNeighborNumber(i);
@@ -120,77 +130,52 @@ int MandatoryCriticalPoints::buildSubTrees(){
       if(!isUpperMax && !isLowerMin)
       break;
     }
-    if(isLowerMin){
-      #ifdef withOpenMP
-      #pragma omp critical
-      #endif
-      {
-        lowerMinimumList_.push_back(i);
-      }
-    }
-    if(isUpperMax){
-      #ifdef withOpenMP
-      #pragma omp critical
-      #endif
-      {
-        upperMaximumList_.push_back(i);
-      }
-    }
+    if(isLowerMin)
+      threadedLowerMinima[threadId].push_back(i);
+    if(isUpperMax)
+      threadedUpperMaxima[threadId].push_back(i);
+  }
+  lowerMinimumList_.clear();
+  upperMaximumList_.clear();
+  for(int i=0 ; i<threadNumber ; i++){
+    lowerMinimumList_.insert(lowerMinimumList_.end(),
+      threadedLowerMinima[i].begin(), threadedLowerMinima[i].end());
+    upperMaximumList_.insert(upperMaximumList_.end(),
+      threadedUpperMaxima[i].begin(), threadedUpperMaxima[i].end());
+  }
+
+  // upper bound trees first
+  SubLevelSetTree *trees[4] = {
+    &upperJoinTree_, &upperSplitTree_, &lowerJoinTree_, &lowerSplitTree_};
+  for(int i=0 ; i<4 ; i++){
+    bool isUpper = (i < 2);
+    trees[i]->setThreadNumber(threadNumber_);
+    trees[i]->setNumberOfVertices(vertexNumber_);
+    trees[i]->setVertexScalars(
+      isUpper ? &upperVertexScalars_ : &lowerVertexScalars_);
+    trees[i]->setVertexPositions(&vertexPositions_);
+    trees[i]->setTriangulation(triangulation_);
+    trees[i]->setVertexSoSoffsets(&vertexSoSoffsets_);
+    trees[i]->setVertexOrder(
+      isUpper ? &upperVertexOrder_ : &lowerVertexOrder_);
   }
 
+  // the vertex orders (parallel sorts) are shared by the join and split
+  // trees of each bound, the four sweeps then run concurrently
+  upperJoinTree_.buildVertexOrder(upperVertexOrder_);
+  lowerJoinTree_.buildVertexOrder(lowerVertexOrder_);
+  upperJoinTree_.buildExtremumList(upperMinimumList_, true);
+  lowerSplitTree_.buildExtremumList(lowerMaximumList_, false);
+  lowerJoinTree_.setMinimumList(lowerMinimumList_);
+  upperSplitTree_.setMaximumList(upperMaximumList_);
+
   #ifdef withOpenMP
-  #pragma omp parallel sections num_threads(threadNumber_)
+  #pragma omp parallel for num_threads(threadNumber_) schedule(dynamic)
   #endif
-  {
-    #ifdef withOpenMP
-    #pragma omp section
-    #endif
-    {
-      upperJoinTree_.setNumberOfVertices(vertexNumber_);
-      upperJoinTree_.setVertexScalars(&upperVertexScalars_);
-      upperJoinTree_.setVertexPositions(&vertexPositions_);
-      upperJoinTree_.setTriangulation(triangulation_);
-      upperJoinTree_.setVertexSoSoffsets(&vertexSoSoffsets_);
-      upperJoinTree_.buildExtremumList(upperMinimumList_, true);
-      upperJoinTree_.build();
-    }
-    #ifdef withOpenMP
-    #pragma omp section
-    #endif
-    {
-      lowerJoinTree_.setNumberOfVertices(vertexNumber_);
-      lowerJoinTree_.setVertexScalars(&lowerVertexScalars_);
-      lowerJoinTree_.setVertexPositions(&vertexPositions_);
-      lowerJoinTree_.setTriangulation(triangulation_);
-      lowerJoinTree_.setVertexSoSoffsets(&vertexSoSoffsets_);
-      lowerJoinTree_.setMinimumList(lowerMinimumList_);
-      lowerJoinTree_.build();
-    }
-    #ifdef withOpenMP
-    #pragma omp section
-    #endif
-    {
-      upperSplitTree_.setNumberOfVertices(vertexNumber_);
-      upperSplitTree_.setVertexScalars(&upperVertexScalars_);
-      upperSplitTree_.setVertexPositions(&vertexPositions_);
-      upperSplitTree_.setTriangulation(triangulation_);
-      upperSplitTree_.setVertexSoSoffsets(&vertexSoSoffsets_);
-      upperSplitTree_.setMaximumList(upperMaximumList_);
-      upperSplitTree_.build();
-    }
-    #ifdef withOpenMP
-    #pragma omp section
-    #endif
-    {
-      lowerSplitTree_.setNumberOfVertices(vertexNumber_);
-      lowerSplitTree_.setVertexScalars(&lowerVertexScalars_);
-      lowerSplitTree_.setVertexPositions(&vertexPositions_);
-      lowerSplitTree_.setTriangulation(triangulation_);
-      lowerSplitTree_.setVertexSoSoffsets(&vertexSoSoffsets_);
-      lowerSplitTree_.buildExtremumList(lowerMaximumList_, false);
-      lowerSplitTree_.build();
-    }
+  for(int i=0 ; i<4 ; i++){
+    trees[i]->build();
   }
+
   {
     stringstream msg;
     msg << "[MandatoryCriticalPoints] ";
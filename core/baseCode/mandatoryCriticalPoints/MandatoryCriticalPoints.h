@@ -625,6 +625,10 @@ namespace ttk{
       vector<int>                   upperMaximumList_;
       /// List of vertex id of the maxima in the lower bound scalar field.
       vector<int>                   lowerMaximumList_;
+      /// Vertex order of the upper bound scalar field.
+      vector<int>                   upperVertexOrder_;
+      /// Vertex order of the lower bound scalar field.
+      vector<int>                   lowerVertexOrder_;
       /// Mandatory vertex for each minimum component.
       vector<int>                   mandatoryMinimumVertex_;
       /// Mandatory vertex for each maximum component.
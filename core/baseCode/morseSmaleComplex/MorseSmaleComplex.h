@@ -44,6 +44,18 @@ namespace ttk{
         return abstractMorseSmaleComplex_->setReverveSaddleSaddleConnection(state);
       }
 
+      int setUseHierarchy(const bool state){
+        return abstractMorseSmaleComplex_->setUseHierarchy(state);
+      }
+
+      int setHierarchyFileName(const string& fileName){
+        return abstractMorseSmaleComplex_->setHierarchyFileName(fileName);
+      }
+
+      int setPersistenceThreshold(const double persistenceThreshold){
+        return abstractMorseSmaleComplex_->setPersistenceThreshold(persistenceThreshold);
+      }
+
       int setComputeAscendingSeparatrices1(const bool state){
         return abstractMorseSmaleComplex_->setComputeAscendingSeparatrices1(state);
       }
@@ -84,61 +84,58 @@ int MorseSmaleComplex2D::getSeparatrices(const vector<Cell>& criticalPoints,
 int MorseSmaleComplex2D::setAscendingSegmentation(const vector<Cell>& criticalPoints,
     vector<int>& maxSeeds,
     int* const morseSmaleManifold,
-    int& numberOfMaxima) const{
+    int& numberOfMaxima){
   const int numberOfVertices=inputTriangulation_->getNumberOfVertices();
   std::fill(morseSmaleManifold,morseSmaleManifold+numberOfVertices, -1);
 
   const int numberOfCells=inputTriangulation_->getNumberOfCells();
-  vector<int> morseSmaleManifoldOnCells(numberOfCells, -1);
+  vector<int>& morseSmaleManifoldOnCells=cellSegmentation_;
+  morseSmaleManifoldOnCells.assign(numberOfCells, -1);
 
   // get the seeds : maxima
   const int numberOfCriticalPoints=criticalPoints.size();
   for(int i=0; i<numberOfCriticalPoints; ++i){
     const Cell& criticalPoint=criticalPoints[i];
 
-    if(criticalPoint.dim_==2)
+    if(criticalPoint.dim_==2){
+      morseSmaleManifoldOnCells[criticalPoint.id_]=maxSeeds.size();
       maxSeeds.push_back(criticalPoint.id_);
+    }
   }
   const int numberOfSeeds=maxSeeds.size();
   numberOfMaxima=numberOfSeeds;
 
+  // each triangle points to the other triangle sharing its paired edge
+  // (a paired edge on the boundary ends the v-path)
+  vector<int>& successors=segmentationSuccessors_;
+  successors.resize(numberOfCells);
 #ifdef withOpenMP
 #pragma omp parallel for num_threads(threadNumber_)
 #endif
-  for(int i=0; i<numberOfSeeds; ++i){
-    queue<int> bfs;
-
-    // push the seed
-    {
-      const int seedId=maxSeeds[i];
-      bfs.push(seedId);
+  for(int i=0; i<numberOfCells; ++i){
+    successors[i]=i;
+
+    const int pairedCellId=discreteGradient_.getPairedCell(Cell(2, i), true);
+    if(pairedCellId!=-1){
+      const int starNumber=inputTriangulation_->getEdgeStarNumber(pairedCellId);
+      for(int j=0; j<starNumber; ++j){
+        int neighborId;
+        inputTriangulation_->getEdgeStar(pairedCellId, j, neighborId);
+
+        if(neighborId!=i)
+          successors[i]=neighborId;
+      }
     }
+  }
 
-    // BFS traversal
-    while(!bfs.empty()){
-      const int triangleId=bfs.front();
-      bfs.pop();
-
-      if(morseSmaleManifoldOnCells[triangleId]==-1){
-        morseSmaleManifoldOnCells[triangleId]=i;
-
-        for(int j=0; j<3; ++j){
-          int edgeId;
-          inputTriangulation_->getCellEdge(triangleId, j, edgeId);
-
-          const int starNumber=inputTriangulation_->getEdgeStarNumber(edgeId);
-          for(int k=0; k<starNumber; ++k){
-            int neighborId;
-            inputTriangulation_->getEdgeStar(edgeId, k, neighborId);
-
-            const int pairedCellId=discreteGradient_.getPairedCell(Cell(2, neighborId), true);
+  pointerJumping(successors);
 
-            if(pairedCellId==edgeId)
-              bfs.push(neighborId);
-          }
-        }
-      }
-    }
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber_)
+#endif
+  for(int i=0; i<numberOfCells; ++i){
+    if(successors[i]!=i)
+      morseSmaleManifoldOnCells[i]=morseSmaleManifoldOnCells[successors[i]];
   }
 
   // put segmentation infos from cells to points
@@ -156,61 +153,54 @@ int MorseSmaleComplex2D::setAscendingSegmentation(const vector<Cell>& criticalPo
 
 int MorseSmaleComplex2D::setDescendingSegmentation(const vector<Cell>& criticalPoints,
     int* const morseSmaleManifold,
-    int& numberOfMinima) const{
+    int& numberOfMinima){
   const int numberOfVertices=inputTriangulation_->getNumberOfVertices();
   std::fill(morseSmaleManifold,morseSmaleManifold+numberOfVertices, -1);
 
   // get the seeds : minima
-  vector<int> seeds;
+  numberOfMinima=0;
   const int numberOfCriticalPoints=criticalPoints.size();
   for(int i=0; i<numberOfCriticalPoints; ++i){
     const Cell& criticalPoint=criticalPoints[i];
 
-    if(criticalPoint.dim_==0)
-      seeds.push_back(criticalPoint.id_);
+    if(criticalPoint.dim_==0){
+      morseSmaleManifold[criticalPoint.id_]=numberOfMinima;
+      ++numberOfMinima;
+    }
   }
-  const int numberOfSeeds=seeds.size();
-  numberOfMinima=numberOfSeeds;
 
+  // each vertex points to the other end of its paired edge
+  vector<int>& successors=segmentationSuccessors_;
+  successors.resize(numberOfVertices);
 #ifdef withOpenMP
 #pragma omp parallel for num_threads(threadNumber_)
 #endif
-  for(int i=0; i<numberOfSeeds; ++i){
-    queue<int> bfs;
-
-    // push the seed
-    {
-      const int seedId=seeds[i];
-      bfs.push(seedId);
-    }
-
-    // BFS traversal
-    while(!bfs.empty()){
-      const int vertexId=bfs.front();
-      bfs.pop();
-
-      if(morseSmaleManifold[vertexId]==-1){
-        morseSmaleManifold[vertexId]=i;
-
-        const int edgeNumber=inputTriangulation_->getVertexEdgeNumber(vertexId);
-        for(int j=0; j<edgeNumber; ++j){
-          int edgeId;
-          inputTriangulation_->getVertexEdge(vertexId, j, edgeId);
-
-          for(int k=0; k<2; ++k){
-            int neighborId;
-            inputTriangulation_->getEdgeVertex(edgeId, k, neighborId);
+  for(int i=0; i<numberOfVertices; ++i){
+    successors[i]=i;
 
-            const int pairedCellId=discreteGradient_.getPairedCell(Cell(0, neighborId));
+    const int pairedCellId=discreteGradient_.getPairedCell(Cell(0, i));
+    if(pairedCellId!=-1){
+      for(int j=0; j<2; ++j){
+        int neighborId;
+        inputTriangulation_->getEdgeVertex(pairedCellId, j, neighborId);
 
-            if(pairedCellId==edgeId)
-              bfs.push(neighborId);
-          }
-        }
+        if(neighborId!=i)
+          successors[i]=neighborId;
       }
     }
   }
 
+  pointerJumping(successors);
+
+  // the root of each vertex is a minimum
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber_)
+#endif
+  for(int i=0; i<numberOfVertices; ++i){
+    if(successors[i]!=i)
+      morseSmaleManifold[i]=morseSmaleManifold[successors[i]];
+  }
+
   return 0;
 }
 
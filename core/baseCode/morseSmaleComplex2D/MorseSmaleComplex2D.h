@@ -41,11 +41,11 @@ namespace ttk{
       int setAscendingSegmentation(const vector<Cell>& criticalPoints,
           vector<int>& maxSeeds,
           int* const morseSmaleManifold,
-          int& numberOfMinima) const;
+          int& numberOfMaxima);
 
       int setDescendingSegmentation(const vector<Cell>& criticalPoints,
           int* const morseSmaleManifold,
-          int& numberOfMinima) const;
+          int& numberOfMinima);
 
       int setFinalSegmentation(const int numberOfMaxima,
           const int numberOfMinima,
@@ -60,87 +60,53 @@ template<typename dataType>
 int MorseSmaleComplex2D::setSeparatrices(const vector<Separatrix>& separatrices,
     const vector<vector<Cell>>& separatricesGeometry) const{
   const dataType* const scalars=static_cast<dataType*>(inputScalarField_);
-  vector<dataType>* outputSeparatrices1_cells_separatrixFunctionMaxima=
-    static_cast<vector<dataType>*>(outputSeparatrices1_cells_separatrixFunctionMaxima_);
-  vector<dataType>* outputSeparatrices1_cells_separatrixFunctionMinima=
-    static_cast<vector<dataType>*>(outputSeparatrices1_cells_separatrixFunctionMinima_);
-  vector<dataType>* outputSeparatrices1_cells_separatrixFunctionDiffs=
-    static_cast<vector<dataType>*>(outputSeparatrices1_cells_separatrixFunctionDiffs_);
 
   (*outputSeparatrices1_numberOfPoints_)=0;
   (*outputSeparatrices1_numberOfCells_)=0;
 
+  SeparatricesLayout layout;
+  getSeparatrices1Layout(separatrices, separatricesGeometry, 0, layout);
+  resizeSeparatrices1<dataType>(layout.pointOffsets_.back(), layout.cellOffsets_.back());
+
   const int dimensionality=inputTriangulation_->getCellVertexNumber(0)-1;
 
-  int pointId{};
-  int cellId{};
-  int separatrixId{};
-  for(const Separatrix& separatrix : separatrices){
-    if(separatrix.isValid_){
-      const Cell& saddle=separatrix.source_;
-      const Cell& extremum=separatrix.destination_;
-
-      // get separatrix type
-      const char separatrixType=std::min(extremum.dim_, dimensionality-1);
-
-      // compute separatrix function diff
-      const dataType separatrixFunctionMaximum=std::max(discreteGradient_.scalarMax<dataType>(saddle, scalars),
-          discreteGradient_.scalarMax<dataType>(extremum, scalars));
-      const dataType separatrixFunctionMinimum=std::min(discreteGradient_.scalarMin<dataType>(saddle, scalars),
-          discreteGradient_.scalarMin<dataType>(extremum, scalars));
-      const dataType separatrixFunctionDiff=separatrixFunctionMaximum-separatrixFunctionMinimum;
-
-      // get boundary condition
-      const char isOnBoundary=(char)discreteGradient_.isBoundary(saddle) + (char)discreteGradient_.isBoundary(extremum);
-
-      for(const int geometryId : separatrix.geometry_){
-        int oldPointId=-1;
-        for(auto cellIte=separatricesGeometry[geometryId].begin(); cellIte!=separatricesGeometry[geometryId].end(); ++cellIte){
-          const Cell& cell=*cellIte;
-
-          float point[3];
-          discreteGradient_.getCellIncenter(cell, point);
-
-          outputSeparatrices1_points_->push_back(point[0]);
-          outputSeparatrices1_points_->push_back(point[1]);
-          outputSeparatrices1_points_->push_back(point[2]);
-
-          if(cellIte==separatricesGeometry[geometryId].begin() or
-              cellIte==separatricesGeometry[geometryId].end()-1)
-            outputSeparatrices1_points_smoothingMask_->push_back(0);
-          else
-            outputSeparatrices1_points_smoothingMask_->push_back(1);
-          outputSeparatrices1_points_cellDimensions_->push_back(cell.dim_);
-          outputSeparatrices1_points_cellIds_->push_back(cell.id_);
-
-          if(oldPointId!=-1){
-            outputSeparatrices1_cells_->push_back(2);
-            outputSeparatrices1_cells_->push_back(oldPointId);
-            outputSeparatrices1_cells_->push_back(pointId);
-
-            outputSeparatrices1_cells_sourceIds_->push_back(saddle.id_);
-            outputSeparatrices1_cells_destinationIds_->push_back(extremum.id_);
-            outputSeparatrices1_cells_separatrixIds_->push_back(separatrixId);
-            outputSeparatrices1_cells_separatrixTypes_->push_back(separatrixType);
-            outputSeparatrices1_cells_separatrixFunctionMaxima->push_back(separatrixFunctionMaximum);
-            outputSeparatrices1_cells_separatrixFunctionMinima->push_back(separatrixFunctionMinimum);
-            outputSeparatrices1_cells_separatrixFunctionDiffs->push_back(separatrixFunctionDiff);
-            outputSeparatrices1_cells_isOnBoundary_->push_back(isOnBoundary);
-
-            ++cellId;
-          }
-
-          oldPointId=pointId;
-          ++pointId;
-        }
-      }
-
-      ++separatrixId;
-    }
+  const int numberOfGeometries=layout.geometries_.size();
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber_)
+#endif
+  for(int i=0; i<numberOfGeometries; ++i){
+    const Separatrix& separatrix=separatrices[layout.separatrices_[i]];
+    const Cell& saddle=separatrix.source_;
+    const Cell& extremum=separatrix.destination_;
+
+    // get separatrix type
+    const char separatrixType=std::min(extremum.dim_, dimensionality-1);
+
+    // compute separatrix function diff
+    const dataType separatrixFunctionMaximum=std::max(discreteGradient_.scalarMax<dataType>(saddle, scalars),
+        discreteGradient_.scalarMax<dataType>(extremum, scalars));
+    const dataType separatrixFunctionMinimum=std::min(discreteGradient_.scalarMin<dataType>(saddle, scalars),
+        discreteGradient_.scalarMin<dataType>(extremum, scalars));
+    const dataType separatrixFunctionDiff=separatrixFunctionMaximum-separatrixFunctionMinimum;
+
+    // get boundary condition
+    const char isOnBoundary=(char)discreteGradient_.isBoundary(saddle) + (char)discreteGradient_.isBoundary(extremum);
+
+    setSeparatrix1Geometry<dataType>(separatricesGeometry[layout.geometries_[i]],
+        layout.pointOffsets_[i],
+        layout.cellOffsets_[i],
+        saddle.id_,
+        extremum.id_,
+        layout.separatrixIds_[i],
+        separatrixType,
+        separatrixFunctionMaximum,
+        separatrixFunctionMinimum,
+        separatrixFunctionDiff,
+        isOnBoundary);
   }
 
-  (*outputSeparatrices1_numberOfPoints_)=pointId;
-  (*outputSeparatrices1_numberOfCells_)=cellId;
+  (*outputSeparatrices1_numberOfPoints_)=layout.pointOffsets_.back();
+  (*outputSeparatrices1_numberOfCells_)=layout.cellOffsets_.back();
 
   return 0;
 }
@@ -155,8 +121,19 @@ int MorseSmaleComplex2D::execute(){
 
   discreteGradient_.setDebugLevel(debugLevel_);
   discreteGradient_.setThreadNumber(threadNumber_);
-  discreteGradient_.buildGradient<dataType>();
-  discreteGradient_.reverseGradient<dataType>();
+  discreteGradient_.setCollectPersistencePairs(false);
+  if(UseHierarchy){
+    if(loadHierarchy<dataType>()){
+      discreteGradient_.buildGradient<dataType>();
+      discreteGradient_.buildHierarchy<dataType>(hierarchyKey_);
+      saveHierarchy();
+    }
+    replayHierarchy();
+  }
+  else{
+    discreteGradient_.buildGradient<dataType>();
+    discreteGradient_.reverseGradient<dataType>();
+  }
 
   vector<Cell> criticalPoints;
   discreteGradient_.getCriticalPoints(criticalPoints);
@@ -271,56 +271,49 @@ int MorseSmaleComplex3D::setDescendingSegmentation(const vector<Cell>& criticalP
   std::fill(morseSmaleManifold,morseSmaleManifold+numberOfVertices, -1);
 
   // get the seeds : minima
-  vector<int> minSeeds;
+  numberOfMinima=0;
   const int numberOfCriticalPoints=criticalPoints.size();
   for(int i=0; i<numberOfCriticalPoints; ++i){
     const Cell& criticalPoint=criticalPoints[i];
 
-    if(criticalPoint.dim_==0)
-      minSeeds.push_back(criticalPoint.id_);
+    if(criticalPoint.dim_==0){
+      morseSmaleManifold[criticalPoint.id_]=numberOfMinima;
+      ++numberOfMinima;
+    }
   }
-  const int numberOfSeeds=minSeeds.size();
-  numberOfMinima=numberOfSeeds;
 
+  // each vertex points to the other end of its paired edge
+  vector<int>& successors=segmentationSuccessors_;
+  successors.resize(numberOfVertices);
 #ifdef withOpenMP
 #pragma omp parallel for num_threads(threadNumber_)
 #endif
-  for(int i=0; i<numberOfSeeds; ++i){
-    queue<int> bfs;
-
-    // push the seed
-    {
-      const int seedId=minSeeds[i];
-      bfs.push(seedId);
-    }
-
-    // BFS traversal
-    while(!bfs.empty()){
-      const int vertexId=bfs.front();
-      bfs.pop();
-
-      if(morseSmaleManifold[vertexId]==-1){
-        morseSmaleManifold[vertexId]=i;
-
-        const int edgeNumber=inputTriangulation_->getVertexEdgeNumber(vertexId);
-        for(int j=0; j<edgeNumber; ++j){
-          int edgeId;
-          inputTriangulation_->getVertexEdge(vertexId, j, edgeId);
-
-          for(int k=0; k<2; ++k){
-            int neighborId;
-            inputTriangulation_->getEdgeVertex(edgeId, k, neighborId);
+  for(int i=0; i<numberOfVertices; ++i){
+    successors[i]=i;
 
-            const int pairedCellId=discreteGradient_.getPairedCell(Cell(0, neighborId));
+    const int pairedCellId=discreteGradient_.getPairedCell(Cell(0, i));
+    if(pairedCellId!=-1){
+      for(int j=0; j<2; ++j){
+        int neighborId;
+        inputTriangulation_->getEdgeVertex(pairedCellId, j, neighborId);
 
-            if(pairedCellId==edgeId)
-              bfs.push(neighborId);
-          }
-        }
+        if(neighborId!=i)
+          successors[i]=neighborId;
       }
     }
   }
 
+  pointerJumping(successors);
+
+  // the root of each vertex is a minimum
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber_)
+#endif
+  for(int i=0; i<numberOfVertices; ++i){
+    if(successors[i]!=i)
+      morseSmaleManifold[i]=morseSmaleManifold[successors[i]];
+  }
+
   return 0;
 }
 
@@ -332,58 +325,55 @@ int MorseSmaleComplex3D::setAscendingSegmentation(const vector<Cell>& criticalPo
   std::fill(morseSmaleManifold,morseSmaleManifold+numberOfVertices, -1);
 
   const int numberOfCells=inputTriangulation_->getNumberOfCells();
-  vector<int> morseSmaleManifoldOnCells(numberOfCells, -1);
+  vector<int>& morseSmaleManifoldOnCells=cellSegmentation_;
+  morseSmaleManifoldOnCells.assign(numberOfCells, -1);
 
   // get the seeds : maxima
   const int numberOfCriticalPoints=criticalPoints.size();
   for(int i=0; i<numberOfCriticalPoints; ++i){
     const Cell& criticalPoint=criticalPoints[i];
 
-    if(criticalPoint.dim_==3)
+    if(criticalPoint.dim_==3){
+      morseSmaleManifoldOnCells[criticalPoint.id_]=maxSeeds.size();
       maxSeeds.push_back(criticalPoint.id_);
+    }
   }
   const int numberOfSeeds=maxSeeds.size();
   numberOfMaxima=numberOfSeeds;
 
+  // each tetrahedron points to the other tetrahedron sharing its paired
+  // triangle (a paired triangle on the boundary ends the v-path)
+  vector<int>& successors=segmentationSuccessors_;
+  successors.resize(numberOfCells);
 #ifdef withOpenMP
 #pragma omp parallel for num_threads(threadNumber_)
 #endif
-  for(int i=0; i<numberOfSeeds; ++i){
-    queue<int> bfs;
-
-    // push the seed
-    {
-      const int seedId=maxSeeds[i];
-      bfs.push(seedId);
-    }
-
-    // BFS traversal
-    while(!bfs.empty()){
-      const int tetraId=bfs.front();
-      bfs.pop();
+  for(int i=0; i<numberOfCells; ++i){
+    successors[i]=i;
 
-      if(morseSmaleManifoldOnCells[tetraId]==-1){
-        morseSmaleManifoldOnCells[tetraId]=i;
-
-        for(int j=0; j<4; ++j){
-          int triangleId;
-          inputTriangulation_->getCellTriangle(tetraId, j, triangleId);
-
-          const int starNumber=inputTriangulation_->getTriangleStarNumber(triangleId);
-          for(int k=0; k<starNumber; ++k){
-            int neighborId;
-            inputTriangulation_->getTriangleStar(triangleId, k, neighborId);
-
-            const int pairedCellId=discreteGradient_.getPairedCell(Cell(3, neighborId), true);
+    const int pairedCellId=discreteGradient_.getPairedCell(Cell(3, i), true);
+    if(pairedCellId!=-1){
+      const int starNumber=inputTriangulation_->getTriangleStarNumber(pairedCellId);
+      for(int j=0; j<starNumber; ++j){
+        int neighborId;
+        inputTriangulation_->getTriangleStar(pairedCellId, j, neighborId);
 
-            if(pairedCellId==triangleId)
-              bfs.push(neighborId);
-          }
-        }
+        if(neighborId!=i)
+          successors[i]=neighborId;
       }
     }
   }
 
+  pointerJumping(successors);
+
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber_)
+#endif
+  for(int i=0; i<numberOfCells; ++i){
+    if(successors[i]!=i)
+      morseSmaleManifoldOnCells[i]=morseSmaleManifoldOnCells[successors[i]];
+  }
+
   // put segmentation infos from cells to points
 #ifdef withOpenMP
 #pragma omp parallel for num_threads(threadNumber_)
@@ -102,85 +102,50 @@ template<typename dataType>
 int MorseSmaleComplex3D::setSeparatrices1(const vector<Separatrix>& separatrices,
     const vector<vector<Cell>>& separatricesGeometry) const{
   const dataType* const scalars=static_cast<dataType*>(inputScalarField_);
-  vector<dataType>* outputSeparatrices1_cells_separatrixFunctionMaxima=
-    static_cast<vector<dataType>*>(outputSeparatrices1_cells_separatrixFunctionMaxima_);
-  vector<dataType>* outputSeparatrices1_cells_separatrixFunctionMinima=
-    static_cast<vector<dataType>*>(outputSeparatrices1_cells_separatrixFunctionMinima_);
-  vector<dataType>* outputSeparatrices1_cells_separatrixFunctionDiffs=
-    static_cast<vector<dataType>*>(outputSeparatrices1_cells_separatrixFunctionDiffs_);
 
-  int pointId=(*outputSeparatrices1_numberOfPoints_);
-  int cellId=(*outputSeparatrices1_numberOfCells_);
-  int separatrixId=separatrices.size();
+  SeparatricesLayout layout;
+  getSeparatrices1Layout(separatrices, separatricesGeometry, separatrices.size(), layout);
+  resizeSeparatrices1<dataType>(layout.pointOffsets_.back(), layout.cellOffsets_.back());
 
   const int dimensionality=inputTriangulation_->getCellVertexNumber(0)-1;
 
-  for(const Separatrix& separatrix : separatrices){
-    if(separatrix.isValid_){
-      const Cell& saddle=separatrix.source_;
-      const Cell& extremum=separatrix.destination_;
-
-      // get separatrix type
-      const char separatrixType=std::min(extremum.dim_, dimensionality-1);
-
-      // compute separatrix function diff
-      const dataType separatrixFunctionMaximum=std::max(discreteGradient_.scalarMax<dataType>(saddle, scalars),
-          discreteGradient_.scalarMax<dataType>(extremum, scalars));
-      const dataType separatrixFunctionMinimum=std::min(discreteGradient_.scalarMin<dataType>(saddle, scalars),
-          discreteGradient_.scalarMin<dataType>(extremum, scalars));
-      const dataType separatrixFunctionDiff=separatrixFunctionMaximum-separatrixFunctionMinimum;
-
-      // get boundary condition
-      const char isOnBoundary=(char)discreteGradient_.isBoundary(saddle) + (char)discreteGradient_.isBoundary(extremum);
-
-      for(const int geometryId : separatrix.geometry_){
-        int oldPointId=-1;
-        for(auto cellIte=separatricesGeometry[geometryId].begin(); cellIte!=separatricesGeometry[geometryId].end(); ++cellIte){
-          const Cell& cell=*cellIte;
-
-          float point[3];
-          discreteGradient_.getCellIncenter(cell, point);
-
-          outputSeparatrices1_points_->push_back(point[0]);
-          outputSeparatrices1_points_->push_back(point[1]);
-          outputSeparatrices1_points_->push_back(point[2]);
-
-          if(cellIte==separatricesGeometry[geometryId].begin() or
-              cellIte==separatricesGeometry[geometryId].end()-1)
-            outputSeparatrices1_points_smoothingMask_->push_back(0);
-          else
-            outputSeparatrices1_points_smoothingMask_->push_back(1);
-          outputSeparatrices1_points_cellDimensions_->push_back(cell.dim_);
-          outputSeparatrices1_points_cellIds_->push_back(cell.id_);
-
-          if(oldPointId!=-1){
-            outputSeparatrices1_cells_->push_back(2);
-            outputSeparatrices1_cells_->push_back(oldPointId);
-            outputSeparatrices1_cells_->push_back(pointId);
-
-            outputSeparatrices1_cells_sourceIds_->push_back(saddle.id_);
-            outputSeparatrices1_cells_destinationIds_->push_back(extremum.id_);
-            outputSeparatrices1_cells_separatrixIds_->push_back(separatrixId);
-            outputSeparatrices1_cells_separatrixTypes_->push_back(separatrixType);
-            outputSeparatrices1_cells_separatrixFunctionMaxima->push_back(separatrixFunctionMaximum);
-            outputSeparatrices1_cells_separatrixFunctionMinima->push_back(separatrixFunctionMinimum);
-            outputSeparatrices1_cells_separatrixFunctionDiffs->push_back(separatrixFunctionDiff);
-            outputSeparatrices1_cells_isOnBoundary_->push_back(isOnBoundary);
-
-            ++cellId;
-          }
-
-          oldPointId=pointId;
-          ++pointId;
-        }
-      }
-
-      ++separatrixId;
-    }
+  const int numberOfGeometries=layout.geometries_.size();
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber_)
+#endif
+  for(int i=0; i<numberOfGeometries; ++i){
+    const Separatrix& separatrix=separatrices[layout.separatrices_[i]];
+    const Cell& saddle=separatrix.source_;
+    const Cell& extremum=separatrix.destination_;
+
+    // get separatrix type
+    const char separatrixType=std::min(extremum.dim_, dimensionality-1);
+
+    // compute separatrix function diff
+    const dataType separatrixFunctionMaximum=std::max(discreteGradient_.scalarMax<dataType>(saddle, scalars),
+        discreteGradient_.scalarMax<dataType>(extremum, scalars));
+    const dataType separatrixFunctionMinimum=std::min(discreteGradient_.scalarMin<dataType>(saddle, scalars),
+        discreteGradient_.scalarMin<dataType>(extremum, scalars));
+    const dataType separatrixFunctionDiff=separatrixFunctionMaximum-separatrixFunctionMinimum;
+
+    // get boundary condition
+    const char isOnBoundary=(char)discreteGradient_.isBoundary(saddle) + (char)discreteGradient_.isBoundary(extremum);
+
+    setSeparatrix1Geometry<dataType>(separatricesGeometry[layout.geometries_[i]],
+        layout.pointOffsets_[i],
+        layout.cellOffsets_[i],
+        saddle.id_,
+        extremum.id_,
+        layout.separatrixIds_[i],
+        separatrixType,
+        separatrixFunctionMaximum,
+        separatrixFunctionMinimum,
+        separatrixFunctionDiff,
+        isOnBoundary);
   }
 
-  (*outputSeparatrices1_numberOfPoints_)=pointId;
-  (*outputSeparatrices1_numberOfCells_)=cellId;
+  (*outputSeparatrices1_numberOfPoints_)=layout.pointOffsets_.back();
+  (*outputSeparatrices1_numberOfCells_)=layout.cellOffsets_.back();
 
   return 0;
 }
@@ -189,76 +154,48 @@ template<typename dataType>
 int MorseSmaleComplex3D::setSaddleConnectors(const vector<Separatrix>& separatrices,
     const vector<vector<Cell>>& separatricesGeometry) const{
   const dataType* const scalars=static_cast<dataType*>(inputScalarField_);
-  vector<dataType>* outputSeparatrices1_cells_separatrixFunctionMaxima=
-    static_cast<vector<dataType>*>(outputSeparatrices1_cells_separatrixFunctionMaxima_);
-  vector<dataType>* outputSeparatrices1_cells_separatrixFunctionMinima=
-    static_cast<vector<dataType>*>(outputSeparatrices1_cells_separatrixFunctionMinima_);
-  vector<dataType>* outputSeparatrices1_cells_separatrixFunctionDiffs=
-    static_cast<vector<dataType>*>(outputSeparatrices1_cells_separatrixFunctionDiffs_);
-
-  int pointId=(*outputSeparatrices1_numberOfPoints_);
-  int cellId=(*outputSeparatrices1_numberOfCells_);
-  int separatrixId=separatrices.size();
-
-  for(const Separatrix& separatrix : separatrices){
-    if(separatrix.isValid_){
-      const Cell& saddle1=separatrix.source_;
-      const Cell& saddle2=separatrix.destination_;
-
-      // get separatrix type : saddle-connector
-      const char separatrixType=1;
-
-      // compute separatrix function diff
-      const dataType separatrixFunctionMaximum=std::max(discreteGradient_.scalarMax<dataType>(saddle1, scalars),
-          discreteGradient_.scalarMax<dataType>(saddle2, scalars));
-      const dataType separatrixFunctionMinimum=std::min(discreteGradient_.scalarMin<dataType>(saddle1, scalars),
-          discreteGradient_.scalarMin<dataType>(saddle2, scalars));
-      const dataType separatrixFunctionDiff=separatrixFunctionMaximum-separatrixFunctionMinimum;
-
-      // get boundary condition
-      const char isOnBoundary=(discreteGradient_.isBoundary(saddle1) and discreteGradient_.isBoundary(saddle2));
-
-      for(const int geometryId : separatrix.geometry_){
-        int oldPointId=-1;
-        for(const Cell& cell : separatricesGeometry[geometryId]){
-          float point[3];
-          discreteGradient_.getCellIncenter(cell, point);
-
-          outputSeparatrices1_points_->push_back(point[0]);
-          outputSeparatrices1_points_->push_back(point[1]);
-          outputSeparatrices1_points_->push_back(point[2]);
-
-          outputSeparatrices1_points_cellDimensions_->push_back(cell.dim_);
-          outputSeparatrices1_points_cellIds_->push_back(cell.id_);
-
-          if(oldPointId!=-1){
-            outputSeparatrices1_cells_->push_back(2);
-            outputSeparatrices1_cells_->push_back(oldPointId);
-            outputSeparatrices1_cells_->push_back(pointId);
-
-            outputSeparatrices1_cells_sourceIds_->push_back(saddle1.id_);
-            outputSeparatrices1_cells_destinationIds_->push_back(saddle2.id_);
-            outputSeparatrices1_cells_separatrixIds_->push_back(separatrixId);
-            outputSeparatrices1_cells_separatrixTypes_->push_back(separatrixType);
-            outputSeparatrices1_cells_separatrixFunctionMaxima->push_back(separatrixFunctionMaximum);
-            outputSeparatrices1_cells_separatrixFunctionMinima->push_back(separatrixFunctionMinimum);
-            outputSeparatrices1_cells_separatrixFunctionDiffs->push_back(separatrixFunctionDiff);
-            outputSeparatrices1_cells_isOnBoundary_->push_back(isOnBoundary);
-
-            ++cellId;
-          }
-
-          oldPointId=pointId;
-          ++pointId;
-        }
-      }
 
-      ++separatrixId;
-    }
+  SeparatricesLayout layout;
+  getSeparatrices1Layout(separatrices, separatricesGeometry, separatrices.size(), layout);
+  resizeSeparatrices1<dataType>(layout.pointOffsets_.back(), layout.cellOffsets_.back());
+
+  const int numberOfGeometries=layout.geometries_.size();
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber_)
+#endif
+  for(int i=0; i<numberOfGeometries; ++i){
+    const Separatrix& separatrix=separatrices[layout.separatrices_[i]];
+    const Cell& saddle1=separatrix.source_;
+    const Cell& saddle2=separatrix.destination_;
+
+    // get separatrix type : saddle-connector
+    const char separatrixType=1;
+
+    // compute separatrix function diff
+    const dataType separatrixFunctionMaximum=std::max(discreteGradient_.scalarMax<dataType>(saddle1, scalars),
+        discreteGradient_.scalarMax<dataType>(saddle2, scalars));
+    const dataType separatrixFunctionMinimum=std::min(discreteGradient_.scalarMin<dataType>(saddle1, scalars),
+        discreteGradient_.scalarMin<dataType>(saddle2, scalars));
+    const dataType separatrixFunctionDiff=separatrixFunctionMaximum-separatrixFunctionMinimum;
+
+    // get boundary condition
+    const char isOnBoundary=(discreteGradient_.isBoundary(saddle1) and discreteGradient_.isBoundary(saddle2));
+
+    setSeparatrix1Geometry<dataType>(separatricesGeometry[layout.geometries_[i]],
+        layout.pointOffsets_[i],
+        layout.cellOffsets_[i],
+        saddle1.id_,
+        saddle2.id_,
+        layout.separatrixIds_[i],
+        separatrixType,
+        separatrixFunctionMaximum,
+        separatrixFunctionMinimum,
+        separatrixFunctionDiff,
+        isOnBoundary);
   }
 
-  (*outputSeparatrices1_numberOfPoints_)=pointId;
-  (*outputSeparatrices1_numberOfCells_)=cellId;
+  (*outputSeparatrices1_numberOfPoints_)=layout.pointOffsets_.back();
+  (*outputSeparatrices1_numberOfCells_)=layout.cellOffsets_.back();
 
   return 0;
 }
@@ -268,103 +205,149 @@ int MorseSmaleComplex3D::setAscendingSeparatrices2(const vector<Separatrix>& sep
    const vector<vector<Cell>>& separatricesGeometry,
    const vector<set<int>>& separatricesSaddles) const{
   const dataType* const scalars=static_cast<dataType*>(inputScalarField_);
-  vector<dataType>* outputSeparatrices2_cells_separatrixFunctionMaxima=
-    static_cast<vector<dataType>*>(outputSeparatrices2_cells_separatrixFunctionMaxima_);
-  vector<dataType>* outputSeparatrices2_cells_separatrixFunctionMinima=
-    static_cast<vector<dataType>*>(outputSeparatrices2_cells_separatrixFunctionMinima_);
-  vector<dataType>* outputSeparatrices2_cells_separatrixFunctionDiffs=
-    static_cast<vector<dataType>*>(outputSeparatrices2_cells_separatrixFunctionDiffs_);
-
-  int pointId=(*outputSeparatrices2_numberOfPoints_);
-  int cellId=(*outputSeparatrices2_numberOfCells_);
-  int separatrixId=separatrices.size();
-
-  const int numberOfCells=inputTriangulation_->getNumberOfCells();
-  vector<int> isVisited(numberOfCells, -1);
-
-  int i=0;
-  for(const Separatrix& separatrix : separatrices){
-    if(separatrix.isValid_){
-      const Cell& saddle=separatrix.source_;
-      const char separatrixType=1;
-      const int saddleId=saddle.id_;
-
-      const dataType separatrixFunctionMinimum=discreteGradient_.scalarMax<dataType>(saddle, scalars);
-      dataType separatrixFunctionMaximum{};
-
-      // get separatrix infos
-      char isOnBoundary{};
-      bool isFirst=true;
-      for(const int saddle2Id : separatricesSaddles[i]){
-        if(inputTriangulation_->isTriangleOnBoundary(saddle2Id))
-          ++isOnBoundary;
-
-        if(isFirst){
-          separatrixFunctionMaximum=discreteGradient_.scalarMax<dataType>(Cell(2,saddle2Id), scalars);
-          isFirst=false;
-        }
-        else{
-          separatrixFunctionMaximum=std::max(separatrixFunctionMaximum,
-              discreteGradient_.scalarMax<dataType>(Cell(2,saddle2Id), scalars));
-        }
+  vector<dataType>& outputSeparatrices2_cells_separatrixFunctionMaxima=
+    *static_cast<vector<dataType>*>(outputSeparatrices2_cells_separatrixFunctionMaxima_);
+  vector<dataType>& outputSeparatrices2_cells_separatrixFunctionMinima=
+    *static_cast<vector<dataType>*>(outputSeparatrices2_cells_separatrixFunctionMinima_);
+  vector<dataType>& outputSeparatrices2_cells_separatrixFunctionDiffs=
+    *static_cast<vector<dataType>*>(outputSeparatrices2_cells_separatrixFunctionDiffs_);
+
+  SeparatricesLayout layout;
+  getSeparatricesLayout(separatrices, separatrices.size(), layout);
+  const int numberOfGeometries=layout.geometries_.size();
+
+  // each edge of a wall with more than 2 tetrahedra in its star gives a dual polygon
+  layout.cellOffsets_.resize(numberOfGeometries+1);
+  layout.connectivityOffsets_.resize(numberOfGeometries+1);
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber_)
+#endif
+  for(int i=0; i<numberOfGeometries; ++i){
+    int numberOfCells{};
+    int connectivitySize{};
+    for(const Cell& edge : separatricesGeometry[layout.geometries_[i]]){
+      const int vertexNumber=inputTriangulation_->getEdgeStarNumber(edge.id_);
+      if(vertexNumber>2){
+        ++numberOfCells;
+        connectivitySize+=vertexNumber+1;
       }
+    }
+    layout.cellOffsets_[i+1]=numberOfCells;
+    layout.connectivityOffsets_[i+1]=connectivitySize;
+  }
+  layout.cellOffsets_[0]=(*outputSeparatrices2_numberOfCells_);
+  layout.connectivityOffsets_[0]=outputSeparatrices2_cells_->size();
+  for(int i=0; i<numberOfGeometries; ++i){
+    layout.cellOffsets_[i+1]+=layout.cellOffsets_[i];
+    layout.connectivityOffsets_[i+1]+=layout.connectivityOffsets_[i];
+  }
 
-      const dataType separatrixFunctionDiff=separatrixFunctionMaximum-separatrixFunctionMinimum;
-
-      for(const int geometryId : separatrix.geometry_){
-        for(const Cell& edge : separatricesGeometry[geometryId]){
-          const int edgeId=edge.id_;
-
-          // Transform to dual : edge -> polygon
-          vector<int> polygon;
-          getDualPolygon(edgeId, polygon);
-
-          const int vertexNumber=polygon.size();
-          if(vertexNumber>2){
-            sortDualPolygonVertices(polygon);
-
-            // add the polygon
-            outputSeparatrices2_cells_->push_back(vertexNumber);
-
-            float point[3];
-            for(int i=0; i<vertexNumber; ++i){
-              const int tetraId=polygon[i];
-              discreteGradient_.getCellIncenter(Cell(3,tetraId), point);
-
-              if(isVisited[tetraId]==-1){
-                outputSeparatrices2_points_->push_back(point[0]);
-                outputSeparatrices2_points_->push_back(point[1]);
-                outputSeparatrices2_points_->push_back(point[2]);
-
-                outputSeparatrices2_cells_->push_back(pointId);
-
-                isVisited[tetraId]=pointId;
-                ++pointId;
-              }
-              else
-                outputSeparatrices2_cells_->push_back(isVisited[tetraId]);
-            }
+  // the points are the tetrahedra of the polygons, shared between the walls
+  const int numberOfTetras=inputTriangulation_->getNumberOfCells();
+  vector<int> isVisited(numberOfTetras, -1);
+  for(const int geometryId : layout.geometries_){
+    for(const Cell& edge : separatricesGeometry[geometryId]){
+      const int starNumber=inputTriangulation_->getEdgeStarNumber(edge.id_);
+      if(starNumber>2){
+        for(int j=0; j<starNumber; ++j){
+          int tetraId;
+          inputTriangulation_->getEdgeStar(edge.id_, j, tetraId);
+          isVisited[tetraId]=0;
+        }
+      }
+    }
+  }
 
-            outputSeparatrices2_cells_sourceIds_->push_back(saddleId);
-            outputSeparatrices2_cells_separatrixIds_->push_back(separatrixId);
-            outputSeparatrices2_cells_separatrixTypes_->push_back(separatrixType);
-            outputSeparatrices2_cells_separatrixFunctionMaxima->push_back(separatrixFunctionMaximum);
-            outputSeparatrices2_cells_separatrixFunctionMinima->push_back(separatrixFunctionMinimum);
-            outputSeparatrices2_cells_separatrixFunctionDiffs->push_back(separatrixFunctionDiff);
-            outputSeparatrices2_cells_isOnBoundary_->push_back(isOnBoundary);
+  const int firstPointId=(*outputSeparatrices2_numberOfPoints_);
+  vector<int> pointTetras;
+  for(int i=0; i<numberOfTetras; ++i){
+    if(isVisited[i]!=-1){
+      isVisited[i]=firstPointId+pointTetras.size();
+      pointTetras.push_back(i);
+    }
+  }
+  const int numberOfPoints=pointTetras.size();
+
+  resizeSeparatrices2<dataType>(firstPointId+numberOfPoints,
+      layout.cellOffsets_.back(),
+      layout.connectivityOffsets_.back());
+
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber_)
+#endif
+  for(int i=0; i<numberOfPoints; ++i){
+    float point[3];
+    discreteGradient_.getCellIncenter(Cell(3,pointTetras[i]), point);
+
+    const int pointId=firstPointId+i;
+    (*outputSeparatrices2_points_)[3*pointId]=point[0];
+    (*outputSeparatrices2_points_)[3*pointId+1]=point[1];
+    (*outputSeparatrices2_points_)[3*pointId+2]=point[2];
+  }
 
-            ++cellId;
-          }
-        }
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber_)
+#endif
+  for(int i=0; i<numberOfGeometries; ++i){
+    const Separatrix& separatrix=separatrices[layout.separatrices_[i]];
+    const Cell& saddle=separatrix.source_;
+    const char separatrixType=1;
+    const int saddleId=saddle.id_;
+    const int separatrixId=layout.separatrixIds_[i];
+
+    const dataType separatrixFunctionMinimum=discreteGradient_.scalarMax<dataType>(saddle, scalars);
+    dataType separatrixFunctionMaximum{};
+
+    // get separatrix infos
+    char isOnBoundary{};
+    bool isFirst=true;
+    for(const int saddle2Id : separatricesSaddles[layout.separatrices_[i]]){
+      if(inputTriangulation_->isTriangleOnBoundary(saddle2Id))
+        ++isOnBoundary;
+
+      if(isFirst){
+        separatrixFunctionMaximum=discreteGradient_.scalarMax<dataType>(Cell(2,saddle2Id), scalars);
+        isFirst=false;
+      }
+      else{
+        separatrixFunctionMaximum=std::max(separatrixFunctionMaximum,
+            discreteGradient_.scalarMax<dataType>(Cell(2,saddle2Id), scalars));
       }
+    }
 
-      ++separatrixId;
+    const dataType separatrixFunctionDiff=separatrixFunctionMaximum-separatrixFunctionMinimum;
+
+    int cellId=layout.cellOffsets_[i];
+    int connectivityId=layout.connectivityOffsets_[i];
+    vector<int> polygon;
+    for(const Cell& edge : separatricesGeometry[layout.geometries_[i]]){
+      // Transform to dual : edge -> polygon
+      getDualPolygon(edge.id_, polygon);
+
+      const int vertexNumber=polygon.size();
+      if(vertexNumber>2){
+        sortDualPolygonVertices(polygon);
+
+        // add the polygon
+        (*outputSeparatrices2_cells_)[connectivityId++]=vertexNumber;
+        for(int j=0; j<vertexNumber; ++j)
+          (*outputSeparatrices2_cells_)[connectivityId++]=isVisited[polygon[j]];
+
+        (*outputSeparatrices2_cells_sourceIds_)[cellId]=saddleId;
+        (*outputSeparatrices2_cells_separatrixIds_)[cellId]=separatrixId;
+        (*outputSeparatrices2_cells_separatrixTypes_)[cellId]=separatrixType;
+        outputSeparatrices2_cells_separatrixFunctionMaxima[cellId]=separatrixFunctionMaximum;
+        outputSeparatrices2_cells_separatrixFunctionMinima[cellId]=separatrixFunctionMinimum;
+        outputSeparatrices2_cells_separatrixFunctionDiffs[cellId]=separatrixFunctionDiff;
+        (*outputSeparatrices2_cells_isOnBoundary_)[cellId]=isOnBoundary;
+
+        ++cellId;
+      }
     }
-    ++i;
   }
 
-  (*outputSeparatrices2_numberOfPoints_)=pointId;
-  (*outputSeparatrices2_numberOfCells_)=cellId;
+  (*outputSeparatrices2_numberOfPoints_)=firstPointId+numberOfPoints;
+  (*outputSeparatrices2_numberOfCells_)=layout.cellOffsets_.back();
 
   return 0;
 }
@@ -374,93 +357,125 @@ int MorseSmaleComplex3D::setDescendingSeparatrices2(const vector<Separatrix>& se
    const vector<vector<Cell>>& separatricesGeometry,
    const vector<set<int>>& separatricesSaddles) const{
   const dataType* const scalars=static_cast<dataType*>(inputScalarField_);
-  vector<dataType>* outputSeparatrices2_cells_separatrixFunctionMaxima=
-    static_cast<vector<dataType>*>(outputSeparatrices2_cells_separatrixFunctionMaxima_);
-  vector<dataType>* outputSeparatrices2_cells_separatrixFunctionMinima=
-    static_cast<vector<dataType>*>(outputSeparatrices2_cells_separatrixFunctionMinima_);
-  vector<dataType>* outputSeparatrices2_cells_separatrixFunctionDiffs=
-    static_cast<vector<dataType>*>(outputSeparatrices2_cells_separatrixFunctionDiffs_);
-
-  int pointId=(*outputSeparatrices2_numberOfPoints_);
-  int cellId=(*outputSeparatrices2_numberOfCells_);
-  int separatrixId=separatrices.size();
-
+  vector<dataType>& outputSeparatrices2_cells_separatrixFunctionMaxima=
+    *static_cast<vector<dataType>*>(outputSeparatrices2_cells_separatrixFunctionMaxima_);
+  vector<dataType>& outputSeparatrices2_cells_separatrixFunctionMinima=
+    *static_cast<vector<dataType>*>(outputSeparatrices2_cells_separatrixFunctionMinima_);
+  vector<dataType>& outputSeparatrices2_cells_separatrixFunctionDiffs=
+    *static_cast<vector<dataType>*>(outputSeparatrices2_cells_separatrixFunctionDiffs_);
+
+  SeparatricesLayout layout;
+  getSeparatricesLayout(separatrices, separatrices.size(), layout);
+  const int numberOfGeometries=layout.geometries_.size();
+
+  // each triangle of a wall gives a cell : [3, pointId, pointId, pointId]
+  layout.cellOffsets_.resize(numberOfGeometries+1);
+  layout.cellOffsets_[0]=(*outputSeparatrices2_numberOfCells_);
+  for(int i=0; i<numberOfGeometries; ++i)
+    layout.cellOffsets_[i+1]=layout.cellOffsets_[i]+separatricesGeometry[layout.geometries_[i]].size();
+
+  const int firstCellId=layout.cellOffsets_[0];
+  const int firstConnectivityId=outputSeparatrices2_cells_->size();
+
+  // the points are the vertices of the triangles, shared between the walls
   const int numberOfVertices=inputTriangulation_->getNumberOfVertices();
   vector<int> isVisited(numberOfVertices, -1);
+  for(const int geometryId : layout.geometries_){
+    for(const Cell& cell : separatricesGeometry[geometryId]){
+      for(int k=0; k<3; ++k){
+        int vertexId;
+        inputTriangulation_->getTriangleVertex(cell.id_, k, vertexId);
+        isVisited[vertexId]=0;
+      }
+    }
+  }
 
-  int i=0;
-  for(const Separatrix& separatrix : separatrices){
-    if(separatrix.isValid_){
-      const Cell& saddle=separatrix.source_;
-      const char separatrixType=2;
-      const int saddleId=saddle.id_;
-
-      const dataType separatrixFunctionMaximum=discreteGradient_.scalarMax<dataType>(saddle, scalars);
-      dataType separatrixFunctionMinimum{};
-
-      // get separatrix infos
-      char isOnBoundary{};
-      bool isFirst=true;
-      for(const int saddle1Id : separatricesSaddles[i]){
-        if(inputTriangulation_->isEdgeOnBoundary(saddle1Id))
-          ++isOnBoundary;
-
-        if(isFirst){
-          separatrixFunctionMinimum=discreteGradient_.scalarMin<dataType>(Cell(1,saddle1Id), scalars);
-          isFirst=false;
-        }
-        else{
-          separatrixFunctionMinimum=std::min(separatrixFunctionMinimum,
-              discreteGradient_.scalarMin<dataType>(Cell(1,saddle1Id), scalars));
-        }
+  const int firstPointId=(*outputSeparatrices2_numberOfPoints_);
+  vector<int> pointVertices;
+  for(int i=0; i<numberOfVertices; ++i){
+    if(isVisited[i]!=-1){
+      isVisited[i]=firstPointId+pointVertices.size();
+      pointVertices.push_back(i);
+    }
+  }
+  const int numberOfPoints=pointVertices.size();
+
+  resizeSeparatrices2<dataType>(firstPointId+numberOfPoints,
+      layout.cellOffsets_.back(),
+      firstConnectivityId+4*(layout.cellOffsets_.back()-firstCellId));
+
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber_)
+#endif
+  for(int i=0; i<numberOfPoints; ++i){
+    float point[3];
+    inputTriangulation_->getVertexPoint(pointVertices[i], point[0], point[1], point[2]);
+
+    const int pointId=firstPointId+i;
+    (*outputSeparatrices2_points_)[3*pointId]=point[0];
+    (*outputSeparatrices2_points_)[3*pointId+1]=point[1];
+    (*outputSeparatrices2_points_)[3*pointId+2]=point[2];
+  }
+
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber_)
+#endif
+  for(int i=0; i<numberOfGeometries; ++i){
+    const Separatrix& separatrix=separatrices[layout.separatrices_[i]];
+    const Cell& saddle=separatrix.source_;
+    const char separatrixType=2;
+    const int saddleId=saddle.id_;
+    const int separatrixId=layout.separatrixIds_[i];
+
+    const dataType separatrixFunctionMaximum=discreteGradient_.scalarMax<dataType>(saddle, scalars);
+    dataType separatrixFunctionMinimum{};
+
+    // get separatrix infos
+    char isOnBoundary{};
+    bool isFirst=true;
+    for(const int saddle1Id : separatricesSaddles[layout.separatrices_[i]]){
+      if(inputTriangulation_->isEdgeOnBoundary(saddle1Id))
+        ++isOnBoundary;
+
+      if(isFirst){
+        separatrixFunctionMinimum=discreteGradient_.scalarMin<dataType>(Cell(1,saddle1Id), scalars);
+        isFirst=false;
       }
+      else{
+        separatrixFunctionMinimum=std::min(separatrixFunctionMinimum,
+            discreteGradient_.scalarMin<dataType>(Cell(1,saddle1Id), scalars));
+      }
+    }
 
-      const dataType separatrixFunctionDiff=separatrixFunctionMaximum-separatrixFunctionMinimum;
-
-      for(const int geometryId : separatrix.geometry_){
-        for(const Cell& cell : separatricesGeometry[geometryId]){
-          const int triangleId=cell.id_;
-
-          outputSeparatrices2_cells_->push_back(3);
-          float point[3];
-          for(int k=0; k<3; ++k){
-            int vertexId;
-            inputTriangulation_->getTriangleVertex(triangleId, k, vertexId);
-
-            if(isVisited[vertexId]==-1){
-              inputTriangulation_->getVertexPoint(vertexId, point[0], point[1], point[2]);
-
-              outputSeparatrices2_points_->push_back(point[0]);
-              outputSeparatrices2_points_->push_back(point[1]);
-              outputSeparatrices2_points_->push_back(point[2]);
-
-              outputSeparatrices2_cells_->push_back(pointId);
-
-              isVisited[vertexId]=pointId;
-              ++pointId;
-            }
-            else
-              outputSeparatrices2_cells_->push_back(isVisited[vertexId]);
-          }
-          outputSeparatrices2_cells_sourceIds_->push_back(saddleId);
-          outputSeparatrices2_cells_separatrixIds_->push_back(separatrixId);
-          outputSeparatrices2_cells_separatrixTypes_->push_back(separatrixType);
-          outputSeparatrices2_cells_separatrixFunctionMaxima->push_back(separatrixFunctionMaximum);
-          outputSeparatrices2_cells_separatrixFunctionMinima->push_back(separatrixFunctionMinimum);
-          outputSeparatrices2_cells_separatrixFunctionDiffs->push_back(separatrixFunctionDiff);
-          outputSeparatrices2_cells_isOnBoundary_->push_back(isOnBoundary);
-
-          ++cellId;
-        }
+    const dataType separatrixFunctionDiff=separatrixFunctionMaximum-separatrixFunctionMinimum;
+
+    int cellId=layout.cellOffsets_[i];
+    for(const Cell& cell : separatricesGeometry[layout.geometries_[i]]){
+      const int triangleId=cell.id_;
+
+      int connectivityId=firstConnectivityId+4*(cellId-firstCellId);
+      (*outputSeparatrices2_cells_)[connectivityId++]=3;
+      for(int k=0; k<3; ++k){
+        int vertexId;
+        inputTriangulation_->getTriangleVertex(triangleId, k, vertexId);
+
+        (*outputSeparatrices2_cells_)[connectivityId++]=isVisited[vertexId];
       }
 
-      ++separatrixId;
+      (*outputSeparatrices2_cells_sourceIds_)[cellId]=saddleId;
+      (*outputSeparatrices2_cells_separatrixIds_)[cellId]=separatrixId;
+      (*outputSeparatrices2_cells_separatrixTypes_)[cellId]=separatrixType;
+      outputSeparatrices2_cells_separatrixFunctionMaxima[cellId]=separatrixFunctionMaximum;
+      outputSeparatrices2_cells_separatrixFunctionMinima[cellId]=separatrixFunctionMinimum;
+      outputSeparatrices2_cells_separatrixFunctionDiffs[cellId]=separatrixFunctionDiff;
+      (*outputSeparatrices2_cells_isOnBoundary_)[cellId]=isOnBoundary;
+
+      ++cellId;
     }
-    ++i;
   }
 
-  (*outputSeparatrices2_numberOfPoints_)=pointId;
-  (*outputSeparatrices2_numberOfCells_)=cellId;
+  (*outputSeparatrices2_numberOfPoints_)=firstPointId+numberOfPoints;
+  (*outputSeparatrices2_numberOfCells_)=layout.cellOffsets_.back();
 
   return 0;
 }
@@ -476,10 +491,22 @@ int MorseSmaleComplex3D::execute(){
   discreteGradient_.setDebugLevel(debugLevel_);
   discreteGradient_.setThreadNumber(threadNumber_);
   discreteGradient_.setCollectPersistencePairs(false);
-  discreteGradient_.buildGradient<dataType>();
-  discreteGradient_.buildGradient2<dataType>();
-  discreteGradient_.buildGradient3<dataType>();
-  discreteGradient_.reverseGradient<dataType>();
+  if(UseHierarchy){
+    if(loadHierarchy<dataType>()){
+      discreteGradient_.buildGradient<dataType>();
+      discreteGradient_.buildGradient2<dataType>();
+      discreteGradient_.buildGradient3<dataType>();
+      discreteGradient_.buildHierarchy<dataType>(hierarchyKey_);
+      saveHierarchy();
+    }
+    replayHierarchy();
+  }
+  else{
+    discreteGradient_.buildGradient<dataType>();
+    discreteGradient_.buildGradient2<dataType>();
+    discreteGradient_.buildGradient3<dataType>();
+    discreteGradient_.reverseGradient<dataType>();
+  }
 
   vector<Cell> criticalPoints;
   discreteGradient_.getCriticalPoints(criticalPoints);
@@ -13,6 +13,9 @@
 /// These curves provide useful visual clues in order to fine-tune persistence
 /// simplification thresholds.
 ///
+/// The extremum-saddle pairs are computed with ttk::PersistencePairs, which
+/// does not build the join and split trees.
+///
 /// \sa vtkPersistenceCurve.cpp %for a usage example.
 
 #ifndef _PERSISTENCECURVE_H
@@ -22,6 +25,7 @@
 #include<Wrapper.h>
 #include<Triangulation.h>
 #include<ContourForests.h>
+#include<PersistencePairs.h>
 #include<MorseSmaleComplex3D.h>
 
 namespace ttk{
@@ -48,8 +52,8 @@ namespace ttk{
       inline int setupTriangulation(Triangulation* data){
         triangulation_ = data;
         if(triangulation_){
-          ContourForests contourTree;
-          contourTree.setupTriangulation(triangulation_);
+          PersistencePairs persistencePairs;
+          persistencePairs.setupTriangulation(triangulation_);
 
           triangulation_->preprocessBoundaryVertices();
         }
@@ -124,41 +128,23 @@ int PersistenceCurve::execute() const{
   vector<pair<scalarType, idVertex>>& STPlot=*static_cast<vector<pair<scalarType, idVertex>>*>(STPlot_);
   vector<pair<scalarType, idVertex>>& MSCPlot=*static_cast<vector<pair<scalarType, idVertex>>*>(MSCPlot_);
   vector<pair<scalarType, idVertex>>& CTPlot=*static_cast<vector<pair<scalarType, idVertex>>*>(CTPlot_);
-  int* offsets=static_cast<int*>(inputOffsets_);
-
-  const idVertex numberOfVertices=triangulation_->getNumberOfVertices();
-  // convert offsets into a valid format for contour forests
-  vector<idVertex> voffsets(numberOfVertices);
-  std::copy(offsets,offsets+numberOfVertices,voffsets.begin());
-
-  // get contour tree
-  ContourForests contourTree;
-  contourTree.setupTriangulation(triangulation_, false);
-  contourTree.setVertexScalars(inputScalars_);
-  contourTree.setTreeType(TreeType::JoinAndSplit);
-  contourTree.setVertexSoSoffsets(voffsets);
-  contourTree.setLessPartition(true);
-  // at the moment, only one thread is supported
-  //contourTree->setThreadNumber(threadNumber_);
-  contourTree.setThreadNumber(1);
-  contourTree.build<scalarType>();
-
-  // get persistence pairs
-  vector<tuple<idVertex, idVertex, scalarType>> JTPairs;
-  vector<tuple<idVertex, idVertex, scalarType>> STPairs;
-#ifdef withOpenMP
-#pragma omp parallel sections
-#endif
-  {
-#ifdef withOpenMP
-#pragma omp section
-#endif
-    contourTree.getJoinTree()->computePersistencePairs<scalarType>(JTPairs);
-#ifdef withOpenMP
-#pragma omp section
-#endif
-    contourTree.getSplitTree()->computePersistencePairs<scalarType>(STPairs);
-  }
+
+  // get persistence pairs (shared with the other modules working on the
+  // same input)
+  PersistencePairs persistencePairs;
+  persistencePairs.setDebugLevel(debugLevel_);
+  persistencePairs.setThreadNumber(threadNumber_);
+  persistencePairs.setupTriangulation(triangulation_);
+  persistencePairs.setInputScalars(inputScalars_);
+  persistencePairs.setInputOffsets(inputOffsets_);
+
+  shared_ptr<PersistencePairsResult<scalarType>> sharedPairs;
+  int ret=persistencePairs.getSharedPairs<scalarType>(sharedPairs);
+  if(ret)
+    return ret;
+
+  const vector<tuple<idVertex, idVertex, scalarType>>& JTPairs=sharedPairs->JTPairs_;
+  const vector<tuple<idVertex, idVertex, scalarType>>& STPairs=sharedPairs->STPairs_;
 
   // merge pairs
   vector<tuple<idVertex, idVertex, scalarType>> CTPairs(JTPairs.size()+STPairs.size());
@@ -176,13 +162,19 @@ int PersistenceCurve::execute() const{
   vector<tuple<int,int,scalarType>> pl_saddleSaddlePairs;
   const int dimensionality=triangulation_->getDimensionality();
   if(dimensionality==3 and ComputeSaddleConnectors){
-    MorseSmaleComplex3D morseSmaleComplex;
-    morseSmaleComplex.setDebugLevel(debugLevel_);
-    morseSmaleComplex.setThreadNumber(threadNumber_);
-    morseSmaleComplex.setupTriangulation(triangulation_);
-    morseSmaleComplex.setInputScalarField(inputScalars_);
-    morseSmaleComplex.setInputOffsets(inputOffsets_);
-    morseSmaleComplex.computePersistencePairs<scalarType>(JTPairs, STPairs, pl_saddleSaddlePairs);
+    if(!PersistencePairs::getSharedSaddleSaddlePairs<scalarType>(
+          *sharedPairs, pl_saddleSaddlePairs)){
+      MorseSmaleComplex3D morseSmaleComplex;
+      morseSmaleComplex.setDebugLevel(debugLevel_);
+      morseSmaleComplex.setThreadNumber(threadNumber_);
+      morseSmaleComplex.setupTriangulation(triangulation_);
+      morseSmaleComplex.setInputScalarField(inputScalars_);
+      morseSmaleComplex.setInputOffsets(inputOffsets_);
+      morseSmaleComplex.computePersistencePairs<scalarType>(JTPairs, STPairs, pl_saddleSaddlePairs);
+
+      PersistencePairs::setSharedSaddleSaddlePairs<scalarType>(
+          *sharedPairs, pl_saddleSaddlePairs);
+    }
 
     // sort the saddle-saddle pairs by persistence value and compute curve
     {
@@ -1,4 +1,5 @@
 ttk_add_baseCode_package(contourForests)
+ttk_add_baseCode_package(persistencePairs)
 ttk_add_baseCode_package(morseSmaleComplex3D)
 ttk_add_baseCode_package(triangulation)
 
@@ -15,6 +15,9 @@
 /// vertexId and critical type. Based on that, the persistence of the pair 
 /// and its 2D embedding can easily be obtained.
 ///
+/// The extremum-saddle pairs are computed with ttk::PersistencePairs, which
+/// does not build the join and split trees (no arc, node or segmentation).
+///
 /// Persistence diagrams are useful and stable concise representations of the 
 /// topological features of a data-set. It is useful to fine-tune persistence 
 /// thresholds for topological simplification or for fast similarity 
@@ -34,6 +37,7 @@
 #include<Wrapper.h>
 #include<Triangulation.h>
 #include<ContourForests.h>
+#include<PersistencePairs.h>
 #include<MorseSmaleComplex3D.h>
 
 namespace ttk{
@@ -50,20 +54,20 @@ namespace ttk{
         return 0;
       }
 
-      NodeType getNodeType(MergeTree* tree,
-          TreeType treeType,
-          const int vertexId) const;
-
       template <typename scalarType>
         int sortPersistenceDiagram(
             vector<tuple<idVertex,NodeType,idVertex,NodeType,scalarType,idVertex>>& diagram,
             scalarType* scalars) const;
 
+      /// Build the diagram from the join and split tree pairs (no tree).
+      /// The critical types are deduced from the pairs: the global pair of
+      /// each connected component (present in both lists) is only kept once,
+      /// as a (minimum, maximum) join pair.
       template <typename scalarType>
-        int computeCTPersistenceDiagram(ContourForests& tree,
-            const vector<tuple<idVertex, idVertex, scalarType, bool>>& pairs,
-            vector<tuple<idVertex,NodeType,idVertex,NodeType,scalarType, idVertex>>& diagram,
-            scalarType* scalars) const;
+        int computeCTPersistenceDiagram(
+            const vector<tuple<idVertex, idVertex, scalarType>>& JTPairs,
+            const vector<tuple<idVertex, idVertex, scalarType>>& STPairs,
+            vector<tuple<idVertex,NodeType,idVertex,NodeType,scalarType, idVertex>>& diagram) const;
 
       template <class scalarType>
         int execute() const;
@@ -76,8 +80,8 @@ namespace ttk{
       inline int setupTriangulation(Triangulation* data){
         triangulation_ = data;
         if(triangulation_){
-          ContourForests contourTree;
-          contourTree.setupTriangulation(triangulation_);
+          PersistencePairs persistencePairs;
+          persistencePairs.setupTriangulation(triangulation_);
 
           triangulation_->preprocessBoundaryVertices();
         }
@@ -127,31 +131,61 @@ int PersistenceDiagram::sortPersistenceDiagram(
 }
 
 template <typename scalarType>
-int PersistenceDiagram::computeCTPersistenceDiagram(ContourForests& tree,
-    const vector<tuple<idVertex, idVertex, scalarType, bool>>& pairs,
-    vector<tuple<idVertex,NodeType,idVertex,NodeType,scalarType,idVertex>>& diagram,
-    scalarType* scalars) const{
-  const idVertex numberOfPairs=pairs.size();
+int PersistenceDiagram::computeCTPersistenceDiagram(
+    const vector<tuple<idVertex, idVertex, scalarType>>& JTPairs,
+    const vector<tuple<idVertex, idVertex, scalarType>>& STPairs,
+    vector<tuple<idVertex,NodeType,idVertex,NodeType,scalarType,idVertex>>& diagram) const{
+  const idVertex numberOfVertices=triangulation_->getNumberOfVertices();
+
+  // join (resp. split) pairs start at a minimum (resp. maximum)
+  vector<char> isMinimum(numberOfVertices, false);
+  vector<char> isMaximum(numberOfVertices, false);
+  for(const auto& x : JTPairs)
+    isMinimum[get<0>(x)]=true;
+  for(const auto& x : STPairs)
+    isMaximum[get<0>(x)]=true;
+
+  // merge pairs, the split pairs ending at a minimum are global pairs
+  vector<tuple<idVertex, idVertex, scalarType, bool>> CTPairs;
+  CTPairs.reserve(JTPairs.size()+STPairs.size());
+  for(const auto& x : JTPairs)
+    CTPairs.emplace_back(get<0>(x),get<1>(x),get<2>(x),true);
+  for(const auto& x : STPairs){
+    if(!isMinimum[get<1>(x)])
+      CTPairs.emplace_back(get<0>(x),get<1>(x),get<2>(x),false);
+  }
+
+  {
+    auto cmp=[](const tuple<idVertex,idVertex,scalarType,bool>& a,
+        const tuple<idVertex,idVertex,scalarType,bool>& b){
+      return get<2>(a) < get<2>(b);
+    };
+
+    std::sort(CTPairs.begin(), CTPairs.end(), cmp);
+  }
+
+  const idVertex numberOfPairs=CTPairs.size();
   diagram.resize(numberOfPairs);
   for(idVertex i=0; i<numberOfPairs; ++i){
-    const idVertex v0=get<0>(pairs[i]);
-    const idVertex v1=get<1>(pairs[i]);
-    const scalarType persistenceValue=get<2>(pairs[i]);
-    const bool type=get<3>(pairs[i]);
+    const idVertex v0=get<0>(CTPairs[i]);
+    const idVertex v1=get<1>(CTPairs[i]);
+    const scalarType persistenceValue=get<2>(CTPairs[i]);
+    const bool type=get<3>(CTPairs[i]);
 
     get<4>(diagram[i])=persistenceValue;
     if(type==true){
       get<0>(diagram[i])=v0;
-      get<1>(diagram[i])=getNodeType(tree.getJoinTree(),TreeType::Join,v0);
+      get<1>(diagram[i])=NodeType::Local_minimum;
       get<2>(diagram[i])=v1;
-      get<3>(diagram[i])=getNodeType(tree.getJoinTree(),TreeType::Join,v1);
+      get<3>(diagram[i])=
+        isMaximum[v1] ? NodeType::Local_maximum : NodeType::Saddle1;
       get<5>(diagram[i])=0;
     }
     else{
       get<0>(diagram[i])=v1;
-      get<1>(diagram[i])=getNodeType(tree.getSplitTree(),TreeType::Split,v1);
+      get<1>(diagram[i])=NodeType::Saddle2;
       get<2>(diagram[i])=v0;
-      get<3>(diagram[i])=getNodeType(tree.getSplitTree(),TreeType::Split,v0);
+      get<3>(diagram[i])=NodeType::Local_maximum;
       get<5>(diagram[i])=2;
     }
   }
@@ -165,83 +199,45 @@ int PersistenceDiagram::execute() const{
   vector<tuple<idVertex,NodeType,idVertex,NodeType,scalarType,idVertex>>& CTDiagram=
     *static_cast<vector<tuple<idVertex,NodeType,idVertex,NodeType,scalarType,idVertex>>*>(CTDiagram_);
   scalarType* scalars=static_cast<scalarType*>(inputScalars_);
-  int* offsets=static_cast<int*>(inputOffsets_);
-
-  const idVertex numberOfVertices=triangulation_->getNumberOfVertices();
-  // convert offsets into a valid format for contour forests
-  vector<idVertex> voffsets(numberOfVertices);
-  std::copy(offsets,offsets+numberOfVertices,voffsets.begin());
-
-  // get contour tree
-  ContourForests contourTree;
-  contourTree.setupTriangulation(triangulation_, false);
-  contourTree.setVertexScalars(inputScalars_);
-  contourTree.setTreeType(TreeType::JoinAndSplit);
-  contourTree.setVertexSoSoffsets(voffsets);
-  contourTree.setLessPartition(true);
-  // for now, only one thread is supported
-  //contourTree_->setThreadNumber(threadNumber_);
-  contourTree.setThreadNumber(1);
-  contourTree.build<scalarType>();
-
-  // get persistence pairs
-  vector<tuple<idVertex,idVertex,scalarType>> JTPairs;
-  vector<tuple<idVertex,idVertex,scalarType>> STPairs;
-#ifdef withOpenMP
-#pragma omp parallel sections
-#endif
-  {
-#ifdef withOpenMP
-#pragma omp section
-#endif
-    contourTree.getJoinTree()->computePersistencePairs<scalarType>(JTPairs);
-#ifdef withOpenMP
-#pragma omp section
-#endif
-    contourTree.getSplitTree()->computePersistencePairs<scalarType>(STPairs);
-  }
 
-  // merge pairs
-  vector<tuple<idVertex, idVertex, scalarType, bool>> 
-    CTPairs(JTPairs.size()+STPairs.size());
-  const idVertex JTSize=JTPairs.size();
-  for(idVertex i=0; i<JTSize; ++i){
-    const auto& x=JTPairs[i];
-    CTPairs[i]=make_tuple(get<0>(x),get<1>(x),get<2>(x),true);
-  }
-  const idVertex STSize=STPairs.size();
-  for(idVertex i=0; i<STSize; ++i){
-    const auto& x=STPairs[i];
-    CTPairs[JTSize+i]=make_tuple(get<0>(x),get<1>(x),get<2>(x),false);
-  }
+  // get persistence pairs (shared with the other modules working on the
+  // same input)
+  PersistencePairs persistencePairs;
+  persistencePairs.setDebugLevel(debugLevel_);
+  persistencePairs.setThreadNumber(threadNumber_);
+  persistencePairs.setupTriangulation(triangulation_);
+  persistencePairs.setInputScalars(inputScalars_);
+  persistencePairs.setInputOffsets(inputOffsets_);
 
-  // remove the last pair which is present two times (global extrema pair)
-  {
-    auto cmp=[](const tuple<idVertex,idVertex,scalarType,bool>& a,
-        const tuple<idVertex,idVertex,scalarType,bool>& b){
-      return get<2>(a) < get<2>(b);
-    };
+  shared_ptr<PersistencePairsResult<scalarType>> sharedPairs;
+  int ret=persistencePairs.getSharedPairs<scalarType>(sharedPairs);
+  if(ret)
+    return ret;
 
-    std::sort(CTPairs.begin(), CTPairs.end(), cmp);
-    CTPairs.erase(CTPairs.end()-1);
-  }
+  const vector<tuple<idVertex,idVertex,scalarType>>& JTPairs=sharedPairs->JTPairs_;
+  const vector<tuple<idVertex,idVertex,scalarType>>& STPairs=sharedPairs->STPairs_;
 
   // get the saddle-saddle pairs
   vector<tuple<int,int,scalarType>> pl_saddleSaddlePairs;
   const int dimensionality=triangulation_->getDimensionality();
   if(dimensionality==3 and ComputeSaddleConnectors){
-    MorseSmaleComplex3D morseSmaleComplex;
-    morseSmaleComplex.setDebugLevel(debugLevel_);
-    morseSmaleComplex.setThreadNumber(threadNumber_);
-    morseSmaleComplex.setupTriangulation(triangulation_);
-    morseSmaleComplex.setInputScalarField(inputScalars_);
-    morseSmaleComplex.setInputOffsets(inputOffsets_);
-    morseSmaleComplex.computePersistencePairs<scalarType>(JTPairs, STPairs, pl_saddleSaddlePairs);
+    if(!PersistencePairs::getSharedSaddleSaddlePairs<scalarType>(
+          *sharedPairs, pl_saddleSaddlePairs)){
+      MorseSmaleComplex3D morseSmaleComplex;
+      morseSmaleComplex.setDebugLevel(debugLevel_);
+      morseSmaleComplex.setThreadNumber(threadNumber_);
+      morseSmaleComplex.setupTriangulation(triangulation_);
+      morseSmaleComplex.setInputScalarField(inputScalars_);
+      morseSmaleComplex.setInputOffsets(inputOffsets_);
+      morseSmaleComplex.computePersistencePairs<scalarType>(JTPairs, STPairs, pl_saddleSaddlePairs);
+
+      PersistencePairs::setSharedSaddleSaddlePairs<scalarType>(
+          *sharedPairs, pl_saddleSaddlePairs);
+    }
   }
 
   // get persistence diagrams
-  computeCTPersistenceDiagram<scalarType>(
-      contourTree,CTPairs, CTDiagram, scalars);
+  computeCTPersistenceDiagram<scalarType>(JTPairs, STPairs, CTDiagram);
 
   // add saddle-saddle pairs to the diagram if needed
   if(dimensionality==3 and ComputeSaddleConnectors){
@@ -1,6 +1,7 @@
 ttk_add_baseCode_package(triangulation)
 ttk_add_baseCode_package(morseSmaleComplex3D)
 ttk_add_baseCode_package(contourForests)
+ttk_add_baseCode_package(persistencePairs)
 
 # if the package is a pure template class, comment the following line
 ttk_wrapup_library(libPersistenceDiagram "PersistenceDiagram.cpp")
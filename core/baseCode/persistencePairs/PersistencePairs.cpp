@@ -0,0 +1,12 @@
+#include                  <PersistencePairs.h>
+
+PersistencePairs::PersistencePairs(){
+
+  triangulation_ = NULL;
+  inputScalars_ = NULL;
+  inputOffsets_ = NULL;
+}
+
+PersistencePairs::~PersistencePairs(){
+  
+}
@@ -0,0 +1,494 @@
+/// \ingroup baseCode
+/// \class ttk::PersistencePairs
+/// \author agent <agent@local>
+/// \date October 2026.
+///
+/// \brief TTK processing package that computes the extremum-saddle persistence
+/// pairs of a scalar field, without building any merge or contour tree.
+///
+/// The vertices are sorted once (by scalar value, then by offset). The join
+/// (respectively split) pairs are then obtained with a union-find sweep of
+/// the vertices by increasing (respectively decreasing) order: each
+/// component keeps track of its oldest extremum and, when several components
+/// meet at a saddle, the younger extrema are paired with the saddle (elder
+/// rule). The oldest extremum of each final component is paired with the
+/// last vertex of the component.
+///
+/// Only a few integer arrays per sweep are allocated (no node, arc or
+/// segmentation structure), which makes this package much lighter than
+/// ttk::ContourForests when only the persistence pairs are needed. The
+/// output pairs are the same as the ones returned by
+/// ttk::MergeTree::computePersistencePairs() on the join and split trees.
+///
+/// The results are also shared between the modules which request them on
+/// the same input (see getSharedPairs()): for instance, a persistence diagram
+/// and a persistence curve computed on the same scalar field only sort the
+/// field and sweep it once, and only compute the saddle-saddle pairs once
+/// (see getSharedPairs() for the limits of this sharing across ParaView
+/// plugins).
+///
+/// \sa ttk::PersistenceDiagram
+/// \sa ttk::PersistenceCurve
+
+#ifndef _PERSISTENCEPAIRS_H
+#define _PERSISTENCEPAIRS_H
+
+#ifdef __APPLE__
+#include                  <algorithm>
+#else
+#ifdef _WIN32
+#include                  <algorithm>
+#else
+#include                  <parallel/algorithm>
+#endif
+#endif
+
+#include                  <list>
+#include                  <memory>
+
+// base code includes
+#include                  <Hash.h>
+#include                  <Triangulation.h>
+#include                  <Wrapper.h>
+
+
+namespace ttk{
+
+  /// Persistence pairs of an input (triangulation, scalars and offsets),
+  /// shared by all the modules which request them on the same input.
+  /// \sa PersistencePairs::getSharedPairs()
+  template <class dataType>
+    struct PersistencePairsResult{
+
+      // input identification (see Hash::addConnectivity() and
+      // PersistencePairs::getFieldKey())
+      unsigned long long    connectivityKey_, fieldKey_;
+
+      vector<tuple<int, int, dataType>> JTPairs_, STPairs_;
+
+      // saddle-saddle pairs (3D only), set by the first module which needs
+      // them (see PersistencePairs::setSharedSaddleSaddlePairs())
+      bool                  hasSaddleSaddlePairs_;
+      vector<tuple<int, int, dataType>> saddleSaddlePairs_;
+  };
+
+  class PersistencePairs : public Debug{
+
+    public:
+
+      PersistencePairs();
+
+      ~PersistencePairs();
+
+      /// Execute the package.
+      /// \param JTPairs Output join tree pairs (minimum, saddle, persistence),
+      /// sorted by increasing persistence.
+      /// \param STPairs Output split tree pairs (maximum, saddle, persistence),
+      /// sorted by increasing persistence.
+      /// \return Returns 0 upon success, negative values otherwise.
+      template <class dataType>
+        int execute(vector<tuple<int, int, dataType>> &JTPairs,
+          vector<tuple<int, int, dataType>> &STPairs) const;
+
+      /// Get a key identifying the content of the input fields (hash of the
+      /// scalars and offsets).
+      template <class dataType>
+        unsigned long long getFieldKey() const;
+
+      /// Get the pairs of the input, shared with the previous callers
+      /// (from any module) on a triangulation with the same connectivity and
+      /// the same scalars and offsets. The pairs are only computed (see
+      /// execute()) if no such result is available. The last few results of
+      /// each data type are kept.
+      ///
+      /// \note The shared results live in the binary which compiles this
+      /// header. In a ParaView build, each plugin compiles its own copy of
+      /// the base code (see ttk_wrapup_library()), hence the persistence
+      /// diagram and curve plugins only share them if the toolchain merges
+      /// these copies (e.g. GNU unique symbols with GCC under Linux).
+      /// Standalone programs and single plugins always share them.
+      /// \param result Output shared result, whose pair lists should not be
+      /// modified.
+      /// \return Returns 0 upon success, negative values otherwise.
+      template <class dataType>
+        int getSharedPairs(
+          shared_ptr<PersistencePairsResult<dataType>> &result) const;
+
+      /// Get the saddle-saddle pairs of a shared result, if a module already
+      /// computed them.
+      /// \return Returns true if the pairs were available.
+      template <class dataType>
+        static bool getSharedSaddleSaddlePairs(
+          const PersistencePairsResult<dataType> &result,
+          vector<tuple<int, int, dataType>> &saddleSaddlePairs);
+
+      /// Store the saddle-saddle pairs of a shared result for the next
+      /// modules (the first stored pairs are kept).
+      template <class dataType>
+        static int setSharedSaddleSaddlePairs(
+          PersistencePairsResult<dataType> &result,
+          const vector<tuple<int, int, dataType>> &saddleSaddlePairs);
+
+      inline int setInputScalars(const void *data){
+        inputScalars_ = data;
+        return 0;
+      }
+
+      /// Pass a pointer to the input offset field (one int per vertex), used
+      /// to disambiguate equal scalar values (simulation of simplicity).
+      inline int setInputOffsets(const void *data){
+        inputOffsets_ = data;
+        return 0;
+      }
+
+      /// Setup a (valid) triangulation object for this TTK base object.
+      ///
+      /// \pre This function should be called prior to any usage of this TTK
+      /// object, in a clearly distinct pre-processing step that involves no
+      /// traversal or computation at all. An error will be returned otherwise.
+      ///
+      /// \note It is recommended to exclude this pre-processing function from
+      /// any time performance measurement. Therefore, it is recommended to
+      /// call this function ONLY in the pre-processing steps of your program.
+      /// Note however, that your triangulation object must be valid when
+      /// calling this function (i.e. you should have filled it at this point,
+      /// see the setInput*() functions of ttk::Triangulation). See
+      /// ttkPersistenceDiagram for further examples.
+      ///
+      /// \param triangulation Pointer to a valid triangulation.
+      /// \return Returns 0 upon success, negative values otherwise.
+      inline int setupTriangulation(Triangulation *triangulation){
+        triangulation_ = triangulation;
+        if(triangulation_){
+          triangulation_->preprocessVertexNeighbors();
+        }
+        return 0;
+      }
+
+    protected:
+
+      template <class dataType>
+        int computeMergeTreePairs(const vector<int> &sortedVertices,
+          const vector<int> &vertexOrder, const bool &isJoinTree,
+          vector<tuple<int, int, dataType>> &pairs) const;
+
+      template <class dataType>
+        static inline list<shared_ptr<PersistencePairsResult<dataType>>>
+          &getSharedResults(){
+        // most recently used first
+        static list<shared_ptr<PersistencePairsResult<dataType>>> results;
+        return results;
+      }
+
+      inline int findRoot(vector<int> &parents, int vertexId) const{
+        // path halving
+        while(parents[vertexId] != vertexId){
+          parents[vertexId] = parents[parents[vertexId]];
+          vertexId = parents[vertexId];
+        }
+        return vertexId;
+      }
+
+      static const int      sharedResultNumber_ = 4;
+
+      Triangulation         *triangulation_;
+      const void            *inputScalars_, *inputOffsets_;
+  };
+}
+
+// template functions
+template <class dataType>
+  int PersistencePairs::computeMergeTreePairs(
+    const vector<int> &sortedVertices, const vector<int> &vertexOrder,
+    const bool &isJoinTree, vector<tuple<int, int, dataType>> &pairs) const{
+
+  const dataType *scalars = (const dataType *) inputScalars_;
+  const int vertexNumber = sortedVertices.size();
+
+  // union-find over the swept vertices.
+  // the oldest extremum and the last vertex of each component are stored at
+  // its root.
+  vector<int> parents(vertexNumber, -1);
+  vector<int> ranks(vertexNumber, 0);
+  vector<int> extrema(vertexNumber, -1);
+  vector<int> lastVertices(vertexNumber, -1);
+
+  vector<int> roots;
+
+  for(int i = 0; i < vertexNumber; i++){
+
+    const int vertexId =
+      isJoinTree ? sortedVertices[i] : sortedVertices[vertexNumber - 1 - i];
+
+    // components of the already swept neighbors
+    roots.clear();
+    const int neighborNumber =
+      triangulation_->getVertexNeighborNumber(vertexId);
+    for(int j = 0; j < neighborNumber; j++){
+      int neighborId = -1;
+      triangulation_->getVertexNeighbor(vertexId, j, neighborId);
+
+      if(parents[neighborId] == -1)
+        continue;
+
+      const int rootId = findRoot(parents, neighborId);
+      if(find(roots.begin(), roots.end(), rootId) == roots.end())
+        roots.push_back(rootId);
+    }
+
+    parents[vertexId] = vertexId;
+
+    if(roots.empty()){
+      // extremum
+      extrema[vertexId] = vertexId;
+      lastVertices[vertexId] = vertexId;
+      continue;
+    }
+
+    // the oldest extremum survives, the other ones die at this saddle
+    int elderId = 0;
+    for(int j = 1; j < (int) roots.size(); j++){
+      const int extremumOrder = vertexOrder[extrema[roots[j]]];
+      const int elderOrder = vertexOrder[extrema[roots[elderId]]];
+      if((extremumOrder < elderOrder) == isJoinTree)
+        elderId = j;
+    }
+    const int elderExtremum = extrema[roots[elderId]];
+
+    // union by rank
+    int rootId = roots[0];
+    for(int j = 0; j < (int) roots.size(); j++){
+      if(j != elderId){
+        const int extremumId = extrema[roots[j]];
+        pairs.emplace_back(extremumId, vertexId,
+          fabs(scalars[extremumId] - scalars[vertexId]));
+      }
+      if(ranks[roots[j]] > ranks[rootId])
+        rootId = roots[j];
+    }
+    bool isRankTied = false;
+    for(int j = 0; j < (int) roots.size(); j++){
+      if((roots[j] != rootId)&&(ranks[roots[j]] == ranks[rootId]))
+        isRankTied = true;
+      parents[roots[j]] = rootId;
+    }
+    if(isRankTied)
+      ranks[rootId]++;
+    parents[vertexId] = rootId;
+    extrema[rootId] = elderExtremum;
+    lastVertices[rootId] = vertexId;
+  }
+
+  // global pair(s), one per connected component
+  for(int i = 0; i < vertexNumber; i++){
+    if(parents[i] == i){
+      pairs.emplace_back(extrema[i], lastVertices[i],
+        fabs(scalars[extrema[i]] - scalars[lastVertices[i]]));
+    }
+  }
+
+  auto pairCmp = [](const tuple<int, int, dataType> &a,
+    const tuple<int, int, dataType> &b){
+    return get<2>(a) < get<2>(b);
+  };
+
+  sort(pairs.begin(), pairs.end(), pairCmp);
+
+  return 0;
+}
+
+template <class dataType>
+  int PersistencePairs::execute(vector<tuple<int, int, dataType>> &JTPairs,
+    vector<tuple<int, int, dataType>> &STPairs) const{
+
+  Timer t;
+
+#ifndef withKamikaze
+  if(!triangulation_)
+    return -1;
+  if(!inputScalars_)
+    return -2;
+  if(!inputOffsets_)
+    return -3;
+#endif
+
+  const dataType *scalars = (const dataType *) inputScalars_;
+  const int *offsets = (const int *) inputOffsets_;
+  const int vertexNumber = triangulation_->getNumberOfVertices();
+
+  // 1. sort the vertices (simulation of simplicity)
+  vector<int> sortedVertices(vertexNumber);
+  for(int i = 0; i < vertexNumber; i++)
+    sortedVertices[i] = i;
+
+  // vertex ids break the remaining ties
+  auto vertexCmp = [scalars, offsets](const int &a, const int &b){
+    return (scalars[a] < scalars[b])
+      ||((scalars[a] == scalars[b])&&((offsets[a] < offsets[b])
+        ||((offsets[a] == offsets[b])&&(a < b))));
+  };
+
+#if defined(withOpenMP) && !defined(__APPLE__) && !defined(_WIN32)
+  __gnu_parallel::sort(sortedVertices.begin(), sortedVertices.end(),
+    vertexCmp);
+#else
+  sort(sortedVertices.begin(), sortedVertices.end(), vertexCmp);
+#endif
+
+  vector<int> vertexOrder(vertexNumber);
+
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber_)
+#endif
+  for(int i = 0; i < vertexNumber; i++)
+    vertexOrder[sortedVertices[i]] = i;
+
+  // 2. join and split sweeps
+  JTPairs.clear();
+  STPairs.clear();
+
+#ifdef withOpenMP
+#pragma omp parallel sections num_threads(threadNumber_)
+#endif
+  {
+#ifdef withOpenMP
+#pragma omp section
+#endif
+    computeMergeTreePairs<dataType>(sortedVertices, vertexOrder, true,
+      JTPairs);
+#ifdef withOpenMP
+#pragma omp section
+#endif
+    computeMergeTreePairs<dataType>(sortedVertices, vertexOrder, false,
+      STPairs);
+  }
+
+  {
+    stringstream msg;
+    msg << "[PersistencePairs] " << JTPairs.size() << " join and "
+      << STPairs.size() << " split pair(s) computed in "
+      << t.getElapsedTime() << " s. (" << threadNumber_
+      << " thread(s))."
+      << endl;
+    dMsg(cout, msg.str(), timeMsg);
+  }
+
+  return 0;
+}
+
+template <class dataType>
+  unsigned long long PersistencePairs::getFieldKey() const{
+
+  vector<pair<const void *, int> > arrays(2);
+  arrays[0] = make_pair(inputScalars_, (int) sizeof(dataType));
+  arrays[1] = make_pair(inputOffsets_, (int) sizeof(int));
+
+  return Hash::addArrays(
+    Hash::addValue(Hash::getBasis(), sizeof(dataType)), arrays,
+    triangulation_->getNumberOfVertices(), threadNumber_);
+}
+
+template <class dataType>
+  int PersistencePairs::getSharedPairs(
+    shared_ptr<PersistencePairsResult<dataType>> &result) const{
+
+#ifndef withKamikaze
+  if(!triangulation_)
+    return -1;
+  if(!inputScalars_)
+    return -2;
+  if(!inputOffsets_)
+    return -3;
+#endif
+
+  const unsigned long long connectivityKey =
+    Hash::addConnectivity(Hash::getBasis(), triangulation_, threadNumber_);
+  const unsigned long long fieldKey = getFieldKey<dataType>();
+
+  list<shared_ptr<PersistencePairsResult<dataType>>> &results =
+    getSharedResults<dataType>();
+
+  result = nullptr;
+
+#ifdef withOpenMP
+#pragma omp critical(PersistencePairsShared)
+#endif
+  {
+    for(auto it = results.begin(); it != results.end(); ++it){
+      if(((*it)->connectivityKey_ == connectivityKey)
+        &&((*it)->fieldKey_ == fieldKey)){
+        result = *it;
+        results.splice(results.begin(), results, it);
+        break;
+      }
+    }
+  }
+
+  if(result){
+    stringstream msg;
+    msg << "[PersistencePairs] Reusing " << result->JTPairs_.size()
+      << " join and " << result->STPairs_.size()
+      << " split pair(s) (shared result)." << endl;
+    dMsg(cout, msg.str(), infoMsg);
+    return 0;
+  }
+
+  result = make_shared<PersistencePairsResult<dataType>>();
+  result->connectivityKey_ = connectivityKey;
+  result->fieldKey_ = fieldKey;
+  result->hasSaddleSaddlePairs_ = false;
+
+  int ret = execute<dataType>(result->JTPairs_, result->STPairs_);
+  if(ret)
+    return ret;
+
+#ifdef withOpenMP
+#pragma omp critical(PersistencePairsShared)
+#endif
+  {
+    results.push_front(result);
+    if((int) results.size() > sharedResultNumber_)
+      results.pop_back();
+  }
+
+  return 0;
+}
+
+template <class dataType>
+  bool PersistencePairs::getSharedSaddleSaddlePairs(
+    const PersistencePairsResult<dataType> &result,
+    vector<tuple<int, int, dataType>> &saddleSaddlePairs){
+
+  bool hasSaddleSaddlePairs = false;
+
+#ifdef withOpenMP
+#pragma omp critical(PersistencePairsShared)
+#endif
+  {
+    hasSaddleSaddlePairs = result.hasSaddleSaddlePairs_;
+    if(hasSaddleSaddlePairs)
+      saddleSaddlePairs = result.saddleSaddlePairs_;
+  }
+
+  return hasSaddleSaddlePairs;
+}
+
+template <class dataType>
+  int PersistencePairs::setSharedSaddleSaddlePairs(
+    PersistencePairsResult<dataType> &result,
+    const vector<tuple<int, int, dataType>> &saddleSaddlePairs){
+
+#ifdef withOpenMP
+#pragma omp critical(PersistencePairsShared)
+#endif
+  {
+    if(!result.hasSaddleSaddlePairs_){
+      result.saddleSaddlePairs_ = saddleSaddlePairs;
+      result.hasSaddleSaddlePairs_ = true;
+    }
+  }
+
+  return 0;
+}
+
+#endif // PERSISTENCEPAIRS_H
@@ -0,0 +1,4 @@
+ttk_add_baseCode_package(triangulation)
+
+# if the package is a pure template class, comment the following line
+ttk_wrapup_library(libPersistencePairs "PersistencePairs.cpp")
@@ -1,7 +1,3 @@
-// NOTE
-// this class has been implemented recursively. this is bad programming.
-// a non-recursive version will be implemented asap.
-
 #include                  <RangeDrivenOctree.h>
 
 RangeDrivenOctree::RangeDrivenOctree(){
@@ -20,16 +16,163 @@ RangeDrivenOctree::RangeDrivenOctree(){
   v_ = NULL;
   
   vertexNumber_ = 0;
-  rootId_ = 0; 
+  fieldKey_ = 0;
 }
 
 RangeDrivenOctree::~RangeDrivenOctree(){
   
 }
 
+int RangeDrivenOctree::appendNode(
+  const float *domainBox, const double *rangeBox,
+  const int &cellBegin, const int &cellEnd){
+  
+  nodeUMin_.push_back(rangeBox[0]);
+  nodeUMax_.push_back(rangeBox[1]);
+  nodeVMin_.push_back(rangeBox[2]);
+  nodeVMax_.push_back(rangeBox[3]);
+  
+  nodeDomainBox_.insert(nodeDomainBox_.end(), domainBox, domainBox + 6);
+  
+  nodeChildren_.push_back(-1);
+  nodeCellBegin_.push_back(cellBegin);
+  nodeCellEnd_.push_back(cellEnd);
+  
+  return 0;
+}
+
+int RangeDrivenOctree::buildNode(const int &nodeId, vector<int> &cellBuffer){
+  
+  const int cellBegin = nodeCellBegin_[nodeId];
+  const int cellEnd = nodeCellEnd_[nodeId];
+  const int cellNumber = cellEnd - cellBegin;
+  
+  // copy, the node arrays are about to grow
+  float domainBox[6];
+  for(int i = 0; i < 6; i++)
+    domainBox[i] = nodeDomainBox_[6*nodeId + i];
+  
+  float rangeArea = (nodeUMax_[nodeId] - nodeUMin_[nodeId])
+    *(nodeVMax_[nodeId] - nodeVMin_[nodeId]);
+    
+  float domainVolume = (domainBox[1] - domainBox[0])
+    *(domainBox[3] - domainBox[2])
+    *(domainBox[5] - domainBox[4]);
+ 
+  if(!((cellNumber > leafMinimumCellNumber_)
+    &&(rangeArea > leafMinimumRangeAreaRatio_*rangeArea_)
+    &&(domainVolume > leafMinimumDomainVolumeRatio_*domainVolume_))){
+    // leaf
+    return 0;
+  }
+  
+  float midX = domainBox[0] + (domainBox[1] - domainBox[0])/2.0;
+  float midY = domainBox[2] + (domainBox[3] - domainBox[2])/2.0;
+  float midZ = domainBox[4] + (domainBox[5] - domainBox[4])/2.0;
+  
+  // child i: x, y and z upper halves given by the bits 2, 1 and 0 of i
+  // (0 - - -, 1 - - +, 2 - + -, ..., 7 + + +)
+  float childDomainBox[8][6];
+  for(int i = 0; i < 8; i++){
+    
+    childDomainBox[i][0] = (i & 4) ? midX : domainBox[0];
+    childDomainBox[i][1] = (i & 4) ? domainBox[1] : midX;
+    childDomainBox[i][2] = (i & 2) ? midY : domainBox[2];
+    childDomainBox[i][3] = (i & 2) ? domainBox[3] : midY;
+    childDomainBox[i][4] = (i & 1) ? midZ : domainBox[4];
+    childDomainBox[i][5] = (i & 1) ? domainBox[5] : midZ;
+  }
+  
+  double childRangeBox[8][4];
+  int childCellNumber[8];
+  for(int i = 0; i < 8; i++){
+    for(int j = 0; j < 4; j++)
+      childRangeBox[i][j] = 0;
+    childCellNumber[i] = 0;
+  }
+  
+  // first half: child id of each cell, second half: partitioned cells
+  cellBuffer.resize(2*cellNumber);
+  
+  for(int i = 0; i < cellNumber; i++){
+    
+    const int cellId = cellIds_[cellBegin + i];
+    const float *cellDomainBox = &(cellDomainBox_[6*cellId]);
+    const double *cellRangeBox = &(cellRangeBox_[4*cellId]);
+    
+    int childId = 0;
+    
+    for(int j = 0; j < 8; j++){
+      if((cellDomainBox[0] >= childDomainBox[j][0])
+        &&(cellDomainBox[0] < childDomainBox[j][1])
+        &&(cellDomainBox[2] >= childDomainBox[j][2])
+        &&(cellDomainBox[2] < childDomainBox[j][3])
+        &&(cellDomainBox[4] >= childDomainBox[j][4])
+        &&(cellDomainBox[4] < childDomainBox[j][5])){
+        
+        childId = j;
+        break;
+      }
+    }
+    
+    // update child's range box
+    if(!childCellNumber[childId]){
+      for(int j = 0; j < 4; j++)
+        childRangeBox[childId][j] = cellRangeBox[j];
+    }
+    else{
+      if(cellRangeBox[0] < childRangeBox[childId][0])
+        childRangeBox[childId][0] = cellRangeBox[0];
+      if(cellRangeBox[1] > childRangeBox[childId][1])
+        childRangeBox[childId][1] = cellRangeBox[1];
+      if(cellRangeBox[2] < childRangeBox[childId][2])
+        childRangeBox[childId][2] = cellRangeBox[2];
+      if(cellRangeBox[3] > childRangeBox[childId][3])
+        childRangeBox[childId][3] = cellRangeBox[3];
+    }
+    
+    childCellNumber[childId]++;
+    cellBuffer[i] = childId;
+  }
+  
+  // stable partition of the node's cells among its children
+  int childOffset[8];
+  childOffset[0] = 0;
+  for(int i = 1; i < 8; i++)
+    childOffset[i] = childOffset[i - 1] + childCellNumber[i - 1];
+  
+  for(int i = 0; i < cellNumber; i++){
+    cellBuffer[cellNumber + childOffset[cellBuffer[i]]] 
+      = cellIds_[cellBegin + i];
+    childOffset[cellBuffer[i]]++;
+  }
+  for(int i = 0; i < cellNumber; i++){
+    cellIds_[cellBegin + i] = cellBuffer[cellNumber + i];
+  }
+  
+  nodeChildren_[nodeId] = nodeChildren_.size();
+  
+  int childBegin = cellBegin;
+  for(int i = 0; i < 8; i++){
+    appendNode(childDomainBox[i], childRangeBox[i], 
+      childBegin, childBegin + childCellNumber[i]);
+    childBegin += childCellNumber[i];
+  }
+  
+  return 0;
+}
+
 int RangeDrivenOctree::flush(){
 
-  nodeList_.clear();
+  nodeUMin_.clear();
+  nodeUMax_.clear();
+  nodeVMin_.clear();
+  nodeVMax_.clear();
+  nodeChildren_.clear();
+  nodeCellBegin_.clear();
+  nodeCellEnd_.clear();
+  nodeDomainBox_.clear();
+  cellIds_.clear();
   cellDomainBox_.clear();
   cellRangeBox_.clear();
   
@@ -41,20 +184,22 @@ int RangeDrivenOctree::getTet2NodeMap(
 
   vector<int> randomMap;
   if(forSegmentation){
-    randomMap.resize(nodeList_.size());
+    randomMap.resize(nodeChildren_.size());
     for(int i = 0; i < (int) randomMap.size(); i++){
       randomMap[i] = rand()%(randomMap.size());
     }
   }
   
   map.resize(cellNumber_);
-  for(int i = 0; i < (int) nodeList_.size(); i++){
-    for(int j = 0; j < (int) nodeList_[i].cellList_.size(); j++){
+  for(int i = 0; i < (int) nodeChildren_.size(); i++){
+    if(nodeChildren_[i] != -1)
+      continue;
+    for(int j = nodeCellBegin_[i]; j < nodeCellEnd_[i]; j++){
       if(forSegmentation){
-       map[nodeList_[i].cellList_[j]] = randomMap[i]; 
+       map[cellIds_[j]] = randomMap[i]; 
       }
       else{
-        map[nodeList_[i].cellList_[j]] = i;
+        map[cellIds_[j]] = i;
       }
     }
   }
@@ -67,260 +212,300 @@ int RangeDrivenOctree::rangeSegmentQuery(
   const pair<double, double> &p1,
   vector<int> &cellList) const{
 
+#ifndef withKamikaze
+  if(nodeChildren_.empty())
+    return -1;
+#endif
+  
   Timer t;
   
-  queryResultNumber_ = 0;
+  int leafNumber = 0;
   cellList.clear();
   
-  int ret = rangeSegmentQuery(p0, p1, rootId_, cellList);
+  QuerySegment segment;
+  segment.p0_ = p0;
+  segment.p1_ = p1;
+  segment.uMin_ = fmin(p0.first, p1.first);
+  segment.uMax_ = fmax(p0.first, p1.first);
+  segment.vMin_ = fmin(p0.second, p1.second);
+  segment.vMax_ = fmax(p0.second, p1.second);
+  
+  double denP = p1.first - p0.first;
+  if(!denP) denP = DBL_EPSILON;
+  
+  segment.P_ = (p1.second - p0.second)/denP;
+  if(!segment.P_) segment.P_ = DBL_EPSILON;
+  segment.bP_ = p1.second - segment.P_*p1.first;
+  
+  // depth-first traversal (same output order as a recursive traversal), 
+  // the 8 children of a node being tested at once.
+  unsigned char intersections[8];
+  vector<int> nodeStack;
+  
+  segmentIntersection(segment, 0, 1, intersections);
+  if(intersections[0])
+    nodeStack.push_back(0);
+  
+  while(!nodeStack.empty()){
+    
+    int nodeId = nodeStack.back();
+    nodeStack.pop_back();
+    
+    if(nodeChildren_[nodeId] == -1){
+      // terminal leaf
+      // return our cells
+      cellList.insert(cellList.end(), 
+        cellIds_.begin() + nodeCellBegin_[nodeId], 
+        cellIds_.begin() + nodeCellEnd_[nodeId]);
+      leafNumber++;
+    }
+    else{
+      segmentIntersection(segment, nodeChildren_[nodeId], 8, intersections);
+      for(int i = 7; i >= 0; i--){
+        if(intersections[i])
+          nodeStack.push_back(nodeChildren_[nodeId] + i);
+      }
+    }
+  }
   
   {
     stringstream msg;
     msg << "[RangeDrivenOctree] Query done in "
       << t.getElapsedTime() << " s. ("
-      << queryResultNumber_ << " non-empty leaves, "
+      << leafNumber << " non-empty leaves, "
       << cellList.size() << " cells)" << endl;
     dMsg(cout, msg.str(), 10);
   }
   
-  return ret;
+  return 0;
 }
 
-int RangeDrivenOctree::rangeSegmentQuery(
-  const pair<double, double> &p0,
-  const pair<double, double> &p1,
-  const int &nodeId,
-  vector<int> &cellList) const{
+// file format: magic, version, field key, cell number, vertex number,
+// range area, domain volume, then the node and cell arrays (size + data).
+static const char octreeMagic[8] = {'T','T','K','O','C','T','R','E'};
+static const int octreeVersion = 1;
 
-  // check for intersection for each segment of the range bounding box 
-  pair<double, double> q0, q1;
- 
-  // bottom range segment (min, min) (max, min)
-  q0.first = nodeList_[nodeId].rangeBox_.first.first;
-  q0.second = nodeList_[nodeId].rangeBox_.second.first;
+template <class dataType>
+  static int writeOctreeArray(ofstream &file, const vector<dataType> &array){
   
-  q1.first = nodeList_[nodeId].rangeBox_.first.second;
-  q1.second = q0.second;
+  int size = array.size();
+  file.write((const char *) &size, sizeof(int));
+  if(size)
+    file.write((const char *) array.data(), size*sizeof(dataType));
   
-  if(segmentIntersection(p0, p1, q0, q1)){
-    if(nodeList_[nodeId].childList_.size()){
-      for(int i = 0; i < (int) nodeList_[nodeId].childList_.size(); i++){
-        rangeSegmentQuery(p0, p1, nodeList_[nodeId].childList_[i], cellList);
-      }
-      return 0;
-    }
-    else{
-      // terminal leaf
-      // return our cells
-      {
-        stringstream msg;
-        msg << "[RangeDrivenOctree] Node #"
-          << nodeId << " returns its "
-          << nodeList_[nodeId].cellList_.size() 
-          << " cell(s)." << endl;
-        dMsg(cout, msg.str(), 10);
-      }
-      cellList.insert(cellList.end(), 
-        nodeList_[nodeId].cellList_.begin(), nodeList_[nodeId].cellList_.end());
-      queryResultNumber_++;
-      return 0;
-    }
+  return 0;
+}
+
+template <class dataType>
+  static int readOctreeArray(ifstream &file, const long long int &fileSize,
+    vector<dataType> &array){
+  
+  int size = 0;
+  file.read((char *) &size, sizeof(int));
+  if((!file)||(size < 0)
+    ||((long long int) (size*sizeof(dataType)) 
+      > fileSize - (long long int) file.tellg())){
+    file.setstate(ios::failbit);
+    return -1;
   }
   
-  // right segment (max, min) (max, max)
-  q0.first = nodeList_[nodeId].rangeBox_.first.second;
-  q0.second = nodeList_[nodeId].rangeBox_.second.first;
+  array.resize(size);
+  if(size)
+    file.read((char *) array.data(), size*sizeof(dataType));
+  if(!file)
+    return -1;
+  
+  return 0;
+}
+
+int RangeDrivenOctree::read(const string &fileName,
+  const unsigned long long &fieldKey){
+  
+  Timer t;
   
-  q1.first = nodeList_[nodeId].rangeBox_.first.second;
-  q1.second = nodeList_[nodeId].rangeBox_.second.second;
+  flush();
   
-  if(segmentIntersection(p0, p1, q0, q1)){
-    if(nodeList_[nodeId].childList_.size()){
-      for(int i = 0; i < (int) nodeList_[nodeId].childList_.size(); i++){
-        rangeSegmentQuery(p0, p1, nodeList_[nodeId].childList_[i], cellList);
-      }
-      return 0;
-    }
-    else{
-      // terminal leaf
-      // return our cells
-      {
-        stringstream msg;
-        msg << "[RangeDrivenOctree] Node #"
-          << nodeId << " returns its "
-          << nodeList_[nodeId].cellList_.size() 
-          << " cell(s)." << endl;
-        dMsg(cout, msg.str(), 10);
-      }
-      cellList.insert(cellList.end(), 
-        nodeList_[nodeId].cellList_.begin(), nodeList_[nodeId].cellList_.end());
-      queryResultNumber_++;
-      return 0;
-    }
-  }
+  ifstream file(fileName.data(), ios::in | ios::binary | ios::ate);
+  if(!file)
+    return -1;
   
-  // top segment (min, max) (max, max)
-  q0.first = nodeList_[nodeId].rangeBox_.first.first;
-  q0.second = nodeList_[nodeId].rangeBox_.second.second;
+  const long long int fileSize = file.tellg();
+  file.seekg(0, ios::beg);
   
-  q1.first = nodeList_[nodeId].rangeBox_.first.second;
-  q1.second = nodeList_[nodeId].rangeBox_.second.second;
+  char magic[sizeof(octreeMagic)];
+  int version = 0;
+  file.read(magic, sizeof(magic));
+  file.read((char *) &version, sizeof(int));
+  if((!file)||(!equal(magic, magic + sizeof(magic), octreeMagic))
+    ||(version != octreeVersion)){
+    stringstream msg;
+    msg << "[RangeDrivenOctree] `" << fileName 
+      << "' is not an octree file." << endl;
+    dMsg(cerr, msg.str(), fatalMsg);
+    return -2;
+  }
   
-  if(segmentIntersection(p0, p1, q0, q1)){
-    if(nodeList_[nodeId].childList_.size()){
-      for(int i = 0; i < (int) nodeList_[nodeId].childList_.size(); i++){
-        rangeSegmentQuery(p0, p1, nodeList_[nodeId].childList_[i], cellList);
-      }
-      return 0;
-    }
-    else{
-      // terminal leaf
-      // return our cells
-      {
-        stringstream msg;
-        msg << "[RangeDrivenOctree] Node #"
-          << nodeId << " returns its "
-          << nodeList_[nodeId].cellList_.size() 
-          << " cell(s)." << endl;
-        dMsg(cout, msg.str(), 10);
-      }
-      cellList.insert(cellList.end(), 
-        nodeList_[nodeId].cellList_.begin(), nodeList_[nodeId].cellList_.end());
-      queryResultNumber_++;
-      return 0;
-    }
+  unsigned long long key = 0;
+  int cellNumber = 0, vertexNumber = 0;
+  file.read((char *) &key, sizeof(unsigned long long));
+  file.read((char *) &cellNumber, sizeof(int));
+  file.read((char *) &vertexNumber, sizeof(int));
+  if((!file)||(key != fieldKey)){
+    stringstream msg;
+    msg << "[RangeDrivenOctree] `" << fileName 
+      << "' does not match the input fields." << endl;
+    dMsg(cout, msg.str(), infoMsg);
+    return -3;
   }
   
-  // left segment (min, min) (min, max)
-  q0.first = nodeList_[nodeId].rangeBox_.first.first;
-  q0.second = nodeList_[nodeId].rangeBox_.second.first;
+  file.read((char *) &rangeArea_, sizeof(float));
+  file.read((char *) &domainVolume_, sizeof(float));
+  file.read((char *) &leafMinimumDomainVolumeRatio_, sizeof(float));
+  
+  int ret = 0;
+  ret |= readOctreeArray(file, fileSize, nodeUMin_);
+  ret |= readOctreeArray(file, fileSize, nodeUMax_);
+  ret |= readOctreeArray(file, fileSize, nodeVMin_);
+  ret |= readOctreeArray(file, fileSize, nodeVMax_);
+  ret |= readOctreeArray(file, fileSize, nodeChildren_);
+  ret |= readOctreeArray(file, fileSize, nodeCellBegin_);
+  ret |= readOctreeArray(file, fileSize, nodeCellEnd_);
+  ret |= readOctreeArray(file, fileSize, nodeDomainBox_);
+  ret |= readOctreeArray(file, fileSize, cellIds_);
+  
+  int nodeNumber = nodeChildren_.size();
+  if((ret)||(!nodeNumber)||((int) cellIds_.size() != cellNumber)
+    ||((int) nodeUMin_.size() != nodeNumber)
+    ||((int) nodeUMax_.size() != nodeNumber)
+    ||((int) nodeVMin_.size() != nodeNumber)
+    ||((int) nodeVMax_.size() != nodeNumber)
+    ||((int) nodeCellBegin_.size() != nodeNumber)
+    ||((int) nodeCellEnd_.size() != nodeNumber)
+    ||((int) nodeDomainBox_.size() != 6*nodeNumber)){
+    ret = -1;
+  }
+  for(int i = 0; (!ret)&&(i < nodeNumber); i++){
+    if(((nodeChildren_[i] != -1)
+      &&((nodeChildren_[i] <= i)||(nodeChildren_[i] > nodeNumber - 8)))
+      ||(nodeCellBegin_[i] < 0)||(nodeCellBegin_[i] > nodeCellEnd_[i])
+      ||(nodeCellEnd_[i] > cellNumber)){
+      ret = -1;
+    }
+  }
+  for(int i = 0; (!ret)&&(i < cellNumber); i++){
+    if((cellIds_[i] < 0)||(cellIds_[i] >= cellNumber))
+      ret = -1;
+  }
+  if(ret){
+    stringstream msg;
+    msg << "[RangeDrivenOctree] `" << fileName << "' is corrupted." << endl;
+    dMsg(cerr, msg.str(), fatalMsg);
+    flush();
+    return -4;
+  }
   
-  q1.first = nodeList_[nodeId].rangeBox_.first.first;
-  q1.second = nodeList_[nodeId].rangeBox_.second.second;
+  fieldKey_ = key;
+  cellNumber_ = cellNumber;
+  vertexNumber_ = vertexNumber;
   
-  if(segmentIntersection(p0, p1, q0, q1)){
-    if(nodeList_[nodeId].childList_.size()){
-      for(int i = 0; i < (int) nodeList_[nodeId].childList_.size(); i++){
-        rangeSegmentQuery(p0, p1, nodeList_[nodeId].childList_[i], cellList);
-      }
-      return 0;
-    }
-    else{
-      // terminal leaf
-      // return our cells
-      {
-        stringstream msg;
-        msg << "[RangeDrivenOctree] Node #"
-          << nodeId << " returns its "
-          << nodeList_[nodeId].cellList_.size() 
-          << " cell(s)." << endl;
-        dMsg(cout, msg.str(), 10);
-      }
-      cellList.insert(cellList.end(), 
-        nodeList_[nodeId].cellList_.begin(), nodeList_[nodeId].cellList_.end());
-      queryResultNumber_++;
-      return 0;
-    }
+  {
+    stringstream msg;
+    msg << "[RangeDrivenOctree] Octree read from `" << fileName << "' in "
+      << t.getElapsedTime() << " s. (" << nodeNumber << " nodes)" << endl;
+    dMsg(cout, msg.str(), timeMsg);
   }
   
-  // is the segment completely included in the range bounding box?
-  if((p0.first >= nodeList_[nodeId].rangeBox_.first.first)
-    &&(p0.first < nodeList_[nodeId].rangeBox_.first.second)
-    &&(p0.second >= nodeList_[nodeId].rangeBox_.second.first)
-    &&(p0.second < nodeList_[nodeId].rangeBox_.second.second)){
+  return 0;
+}
+
+int RangeDrivenOctree::segmentIntersection(const QuerySegment &segment,
+  const int &firstNodeId, const int &nodeNumber, 
+  unsigned char *intersections) const{
+  
+  const int boxNumber = nodeNumber;
+  const double P = segment.P_, bP = segment.bP_;
+  const double *uMin = &(nodeUMin_[firstNodeId]);
+  const double *uMax = &(nodeUMax_[firstNodeId]);
+  const double *vMin = &(nodeVMin_[firstNodeId]);
+  const double *vMax = &(nodeVMax_[firstNodeId]);
+  
+  // branch-free, so that the compiler vectorizes the loop over the boxes.
+  // a node is selected if the segment crosses one of the sides of its range 
+  // box, or if one of the segment extremities lies in the box.
+  for(int i = 0; i < boxNumber; i++){
     
-    // p0 is in there
-    if(nodeList_[nodeId].childList_.size()){
-      for(int i = 0; i < (int) nodeList_[nodeId].childList_.size(); i++){
-        rangeSegmentQuery(p0, p1, nodeList_[nodeId].childList_[i], cellList);
-      }
-      return 0;
-    }
-    else{
-      // terminal leaf
-      // return our cells
-      {
-        stringstream msg;
-        msg << "[RangeDrivenOctree] Node #"
-          << nodeId << " returns its "
-          << nodeList_[nodeId].cellList_.size() 
-          << " cell(s)." << endl;
-        dMsg(cout, msg.str(), 10);
-      }
-      cellList.insert(cellList.end(), 
-        nodeList_[nodeId].cellList_.begin(), nodeList_[nodeId].cellList_.end());
-      queryResultNumber_++;
-      return 0;
-    }
-  }
-  if((p1.first >= nodeList_[nodeId].rangeBox_.first.first)
-    &&(p1.first < nodeList_[nodeId].rangeBox_.first.second)
-    &&(p1.second >= nodeList_[nodeId].rangeBox_.second.first)
-    &&(p1.second < nodeList_[nodeId].rangeBox_.second.second)){
+    // intersections of the segment's line with the lines of the box sides
+    double yLeft = P*uMin[i] + bP;
+    double yRight = P*uMax[i] + bP;
+    double xBottom = (vMin[i] - bP)/P;
+    double xTop = (vMax[i] - bP)/P;
     
-    // p1 is in there
-    if(nodeList_[nodeId].childList_.size()){
-      for(int i = 0; i < (int) nodeList_[nodeId].childList_.size(); i++){
-        rangeSegmentQuery(p0, p1, nodeList_[nodeId].childList_[i], cellList);
-      }
-      return 0;
-    }
-    else{
-      // terminal leaf
-      // return our cells
-      {
-        stringstream msg;
-        msg << "[RangeDrivenOctree] Node #"
-          << nodeId << " returns its "
-          << nodeList_[nodeId].cellList_.size() 
-          << " cell(s)." << endl;
-        dMsg(cout, msg.str(), 10);
-      }
-      cellList.insert(cellList.end(), 
-        nodeList_[nodeId].cellList_.begin(), nodeList_[nodeId].cellList_.end());
-      queryResultNumber_++;
-      return 0;
-    }
-  }
+    // NOTE: for flat boxes (uMin == uMax), the bottom and top sides are 
+    // vertical and their test is included in the left side one
+    bool horizontal = (uMin[i] != uMax[i]);
+    
+    bool bottom = horizontal
+      & (xBottom >= uMin[i]) & (xBottom <= uMax[i])
+      & !(((xBottom < segment.uMin_)|(xBottom > segment.uMax_))
+        &((vMin[i] < segment.vMin_)|(vMin[i] > segment.vMax_)));
+    
+    bool right = (yRight >= vMin[i]) & (yRight <= vMax[i])
+      & !(((uMax[i] < segment.uMin_)|(uMax[i] > segment.uMax_))
+        &((yRight < segment.vMin_)|(yRight > segment.vMax_)));
+    
+    bool top = horizontal
+      & (xTop >= uMin[i]) & (xTop <= uMax[i])
+      & !(((xTop < segment.uMin_)|(xTop > segment.uMax_))
+        &((vMax[i] < segment.vMin_)|(vMax[i] > segment.vMax_)));
     
+    bool left = (yLeft >= vMin[i]) & (yLeft <= vMax[i])
+      & !(((uMin[i] < segment.uMin_)|(uMin[i] > segment.uMax_))
+        &((yLeft < segment.vMin_)|(yLeft > segment.vMax_)));
+      
+    // is the segment completely included in the range bounding box?
+    bool p0 = (segment.p0_.first >= uMin[i])&(segment.p0_.first < uMax[i])
+      &(segment.p0_.second >= vMin[i])&(segment.p0_.second < vMax[i]);
+    bool p1 = (segment.p1_.first >= uMin[i])&(segment.p1_.first < uMax[i])
+      &(segment.p1_.second >= vMin[i])&(segment.p1_.second < vMax[i]);
+      
+    intersections[i] = bottom | right | top | left | p0 | p1;
+  }
+  
   return 0;
 }
 
 int RangeDrivenOctree::statNode(const int &nodeId,
   ostream &stream){
 
+  const float *domainBox = &(nodeDomainBox_[6*nodeId]);
+  
   stream << "[RangeDrivenOctree]" << endl;
   stream << "[RangeDrivenOctree] Node #" << nodeId << endl;
   stream << "[RangeDrivenOctree]   Domain box: ["
-    << nodeList_[nodeId].domainBox_[0].first << " "
-    << nodeList_[nodeId].domainBox_[0].second << "] ["
-    << nodeList_[nodeId].domainBox_[1].first << " "
-    << nodeList_[nodeId].domainBox_[1].second << "] ["
-    << nodeList_[nodeId].domainBox_[2].first << " "
-    << nodeList_[nodeId].domainBox_[2].second << "] "
+    << domainBox[0] << " "
+    << domainBox[1] << "] ["
+    << domainBox[2] << " "
+    << domainBox[3] << "] ["
+    << domainBox[4] << " "
+    << domainBox[5] << "] "
     << " volume=" << 
-      (nodeList_[nodeId].domainBox_[0].second 
-        - nodeList_[nodeId].domainBox_[0].first)
-      *(nodeList_[nodeId].domainBox_[1].second 
-        - nodeList_[nodeId].domainBox_[1].first)
-      *(nodeList_[nodeId].domainBox_[2].second 
-        - nodeList_[nodeId].domainBox_[2].first)
+      (domainBox[1] - domainBox[0])
+      *(domainBox[3] - domainBox[2])
+      *(domainBox[5] - domainBox[4])
     << " threshold=" << leafMinimumDomainVolumeRatio_*domainVolume_
     << endl;
   stream << "[RangeDrivenOctree]   Range box: ["
-    << nodeList_[nodeId].rangeBox_.first.first << " "
-    << nodeList_[nodeId].rangeBox_.first.second << "] ["
-    << nodeList_[nodeId].rangeBox_.second.first << " "
-    << nodeList_[nodeId].rangeBox_.second.second << "] "
+    << nodeUMin_[nodeId] << " "
+    << nodeUMax_[nodeId] << "] ["
+    << nodeVMin_[nodeId] << " "
+    << nodeVMax_[nodeId] << "] "
     << " area=" <<
-      (nodeList_[nodeId].rangeBox_.first.second
-        - nodeList_[nodeId].rangeBox_.first.first)
-      *(nodeList_[nodeId].rangeBox_.second.second
-        - nodeList_[nodeId].rangeBox_.second.first)
+      (nodeUMax_[nodeId] - nodeUMin_[nodeId])
+      *(nodeVMax_[nodeId] - nodeVMin_[nodeId])
     << " threshold=" << leafMinimumRangeAreaRatio_*rangeArea_
     << endl;
   stream << "[RangeDrivenOctree] Number of cells: " 
-    << nodeList_[nodeId].cellList_.size() << endl;
+    << nodeCellEnd_[nodeId] - nodeCellBegin_[nodeId] << endl;
     
   return 0;
 }
@@ -332,21 +517,20 @@ int RangeDrivenOctree::stats(ostream &stream){
   float averageCellNumber = 0;
   int maxCellId = 0;
 
-  for(int i = 0; i < (int) nodeList_.size(); i++){
-    if(!nodeList_[i].childList_.size()){
+  for(int i = 0; i < (int) nodeChildren_.size(); i++){
+    if(nodeChildren_[i] == -1){
       // leaf
       leafNumber++;
-      if(nodeList_[i].cellList_.size()){
+      int cellNumber = nodeCellEnd_[i] - nodeCellBegin_[i];
+      if(cellNumber){
         nonEmptyLeafNumber++;
-        storedCellNumber += nodeList_[i].cellList_.size();
+        storedCellNumber += cellNumber;
         
-        averageCellNumber += nodeList_[i].cellList_.size();
-        if((minCellNumber == -1)
-          ||((int) nodeList_[i].cellList_.size() < minCellNumber))
-          minCellNumber = nodeList_[i].cellList_.size();
-        if((maxCellNumber == -1)
-          ||((int) nodeList_[i].cellList_.size() > maxCellNumber)){
-          maxCellNumber = nodeList_[i].cellList_.size();
+        averageCellNumber += cellNumber;
+        if((minCellNumber == -1)||(cellNumber < minCellNumber))
+          minCellNumber = cellNumber;
+        if((maxCellNumber == -1)||(cellNumber > maxCellNumber)){
+          maxCellNumber = cellNumber;
           maxCellId = i;
         }
       }
@@ -372,8 +556,8 @@ int RangeDrivenOctree::stats(ostream &stream){
   stream << "[RangeDrivenOctree] Max-cell nodeId: " << maxCellId << endl;
  
   if(debugLevel_ > 5){
-    for(int i = 0; i < (int) nodeList_.size(); i++){
-      if(nodeList_[i].cellList_.size())
+    for(int i = 0; i < (int) nodeChildren_.size(); i++){
+      if((nodeChildren_[i] == -1)&&(nodeCellEnd_[i] - nodeCellBegin_[i]))
         statNode(i, stream);
     }
   }
@@ -381,51 +565,57 @@ int RangeDrivenOctree::stats(ostream &stream){
   return 0;  
 }
 
-bool RangeDrivenOctree::segmentIntersection(
-  const pair<double, double> &p0,
-  const pair<double, double> &p1,
-  const pair<double, double> &q0,
-  const pair<double, double> &q1) const{
-
-  // NOTE: [q0, q1] is axis aligned
-  bool horizontal = true;
-  double x = 0, y = 0;
+int RangeDrivenOctree::write(const string &fileName) const{
   
-  if(q0.first == q1.first) horizontal = false;
-  
-  double denP = p1.first - p0.first;
-  if(!denP) denP = DBL_EPSILON;
-  
-  double P = (p1.second - p0.second)/denP;
-  if(!P) P = DBL_EPSILON;
-  double bP = p1.second - P*p1.first;
+  Timer t;
+
+#ifndef withKamikaze
+  if(empty())
+    return -1;
+#endif
   
-  if(horizontal){
-    y = q0.second;
-    x = (y - bP)/P;
-  }
-  else{
-    x = q0.first;
-    y = P*x + bP;
+  ofstream file(fileName.data(), ios::out | ios::binary);
+  if(!file){
+    stringstream msg;
+    msg << "[RangeDrivenOctree] Could not open file `" << fileName 
+      << "'!" << endl;
+    dMsg(cerr, msg.str(), fatalMsg);
+    return -2;
   }
   
-  // does the intersection lands on the range segment?
-  if(horizontal){
-    if((x < fmin(q0.first, q1.first))||(x > fmax(q0.first, q1.first))){
-      return false;
-    }
-  }
-  else{
-     if((y < fmin(q0.second, q1.second))||(y > fmax(q0.second, q1.second))){
-      return false;
-    }
+  file.write(octreeMagic, sizeof(octreeMagic));
+  file.write((const char *) &octreeVersion, sizeof(int));
+  file.write((const char *) &fieldKey_, sizeof(unsigned long long));
+  file.write((const char *) &cellNumber_, sizeof(int));
+  file.write((const char *) &vertexNumber_, sizeof(int));
+  file.write((const char *) &rangeArea_, sizeof(float));
+  file.write((const char *) &domainVolume_, sizeof(float));
+  file.write((const char *) &leafMinimumDomainVolumeRatio_, sizeof(float));
+  
+  writeOctreeArray(file, nodeUMin_);
+  writeOctreeArray(file, nodeUMax_);
+  writeOctreeArray(file, nodeVMin_);
+  writeOctreeArray(file, nodeVMax_);
+  writeOctreeArray(file, nodeChildren_);
+  writeOctreeArray(file, nodeCellBegin_);
+  writeOctreeArray(file, nodeCellEnd_);
+  writeOctreeArray(file, nodeDomainBox_);
+  writeOctreeArray(file, cellIds_);
+  
+  if(!file){
+    stringstream msg;
+    msg << "[RangeDrivenOctree] Could not write file `" << fileName 
+      << "'!" << endl;
+    dMsg(cerr, msg.str(), fatalMsg);
+    return -3;
   }
   
-  // does it lands on the polygon segment's projection?
-  if((x < fmin(p0.first, p1.first)||(x > fmax(p0.first, p1.first)))
-    &&((y < fmin(p0.second, p1.second)||(y > fmax(p0.second, p1.second))))){
-    return false;
+  {
+    stringstream msg;
+    msg << "[RangeDrivenOctree] Octree written to `" << fileName << "' in "
+      << t.getElapsedTime() << " s." << endl;
+    dMsg(cout, msg.str(), timeMsg);
   }
   
-  return true;
+  return 0;
 }
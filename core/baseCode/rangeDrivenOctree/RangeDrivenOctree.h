@@ -20,6 +20,7 @@
 #define _RANGE_DRIVEN_OCTREE_H
 
 // base code includes
+#include                  <Hash.h>
 #include                  <Triangulation.h>
 #include                  <Wrapper.h>
 
@@ -34,14 +35,28 @@ namespace ttk{
       
       ~RangeDrivenOctree();
 
+      /// Build the octree.
+      /// \param fieldKey Key of the input, stored in the files written by
+      /// write() (see getFieldKey()). Only needed if the octree is to be 
+      /// written.
       template <class dataTypeU, class dataTypeV>
-        inline int build();
+        inline int build(const unsigned long long &fieldKey = 0);
       
       inline bool empty() const {
-        return nodeList_.empty();
+        return nodeChildren_.empty();
       }
       
       int flush();
+      
+      /// Get a key identifying the bivariate input and the build parameters
+      /// (hash of the connectivity, the leaf parameters and the u and v 
+      /// fields).
+      template <class dataTypeU, class dataTypeV>
+        inline unsigned long long getFieldKey() const;
+      
+      inline unsigned long long getKey() const{
+        return fieldKey_;
+      }
         
       int getTet2NodeMap(vector<int> &map, 
         const bool &forSegmentation = false) const;
@@ -51,6 +66,14 @@ namespace ttk{
         const pair<double, double> &p1,
         vector<int> &cellList) const;
       
+      /// Read an octree from a binary file written by write().
+      /// \param fileName Path to the file.
+      /// \param fieldKey Expected field key (see getFieldKey()).
+      /// \return Returns 0 upon success, negative values otherwise (missing 
+      /// or corrupted file, key mismatch). The octree is left empty upon 
+      /// failure.
+      int read(const string &fileName, const unsigned long long &fieldKey);
+      
       inline void setCellList(const long long int *cellList){
         cellList_ = cellList;
       }
@@ -92,36 +115,28 @@ namespace ttk{
       
       int statNode(const int &nodeId, ostream &stream);
       
+      /// Write the octree to a binary file, for later re-use with read().
+      int write(const string &fileName) const;
+      
     protected:
+      
+      // pre-computed parameters of the query segment line (y = P*x + bP)
+      typedef struct _querySegment{
+        double P_, bP_;
+        double uMin_, uMax_, vMin_, vMax_;
+        pair<double, double> p0_, p1_;
+      }QuerySegment;
    
-      class OctreeNode{
-       
-        public:
-          pair<pair<double, double>, pair<double, double> >
-                          rangeBox_;
-          vector<int>     cellList_;
-          vector<int>     childList_;
-          vector<pair<float, float> > 
-                          domainBox_;
-      };
+      int appendNode(const float *domainBox, const double *rangeBox,
+        const int &cellBegin, const int &cellEnd);
       
-      template <class dataTypeU, class dataTypeV>
-        int buildNode(const vector<int> &cellList, 
-          const vector<pair<float, float> > &domainBox,
-          const pair<pair<double, double>, pair<double, double> >
-            &rangeBox, int &nodeId);
+      int buildNode(const int &nodeId, vector<int> &cellBuffer);
       
-      int rangeSegmentQuery(
-        const pair<double, double> &p0,
-        const pair<double, double> &p1,
-        const int &nodeId,
-        vector<int> &cellList) const;
-      
-      bool segmentIntersection(
-        const pair<double, double> &p0,
-        const pair<double, double> &p1,
-        const pair<double, double> &q0,
-        const pair<double, double> &q1) const;
+      // tests the range boxes of the nodes [firstNodeId, 
+      // firstNodeId + nodeNumber) against the query segment, all at once.
+      int segmentIntersection(const QuerySegment &segment,
+        const int &firstNodeId, const int &nodeNumber, 
+        unsigned char *intersections) const;
       
       const void          *u_;
       const void          *v_;
@@ -132,13 +147,21 @@ namespace ttk{
                           leafMinimumRangeAreaRatio_, 
                           rangeArea_;
       int                 cellNumber_, vertexNumber_, 
-                          leafMinimumCellNumber_, rootId_;
-      mutable int         queryResultNumber_;
-      vector<OctreeNode>  nodeList_;
-      vector<vector<pair<float, float> > > 
-                          cellDomainBox_;
-      vector<pair<pair<double, double>, pair<double, double> > >
-                          cellRangeBox_;
+                          leafMinimumCellNumber_;
+      unsigned long long  fieldKey_;
+      
+      // nodes, in breadth-first order (structure of arrays). the 8 children 
+      // of an internal node are contiguous, starting at nodeChildren_[nodeId]
+      // (-1 for leaves). the cells of a node are 
+      // cellIds_[nodeCellBegin_[nodeId]] to cellIds_[nodeCellEnd_[nodeId] - 1].
+      vector<double>      nodeUMin_, nodeUMax_, nodeVMin_, nodeVMax_;
+      vector<int>         nodeChildren_, nodeCellBegin_, nodeCellEnd_;
+      vector<float>       nodeDomainBox_;
+      vector<int>         cellIds_;
+      
+      // per cell bounding boxes, only used during the construction
+      vector<float>       cellDomainBox_;
+      vector<double>      cellRangeBox_;
       const Triangulation *triangulation_;
   };
 }
@@ -147,7 +170,7 @@ namespace ttk{
 // #include                  <RangeDrivenOctree.cpp>
 
 template <class dataTypeU, class dataTypeV> 
-  int RangeDrivenOctree::build(){
+  int RangeDrivenOctree::build(const unsigned long long &fieldKey){
  
   Timer t;
   Memory m;
@@ -163,9 +186,14 @@ template <class dataTypeU, class dataTypeV>
     vertexNumber_ = triangulation_->getNumberOfVertices();
   }
   
-  cellDomainBox_.resize(cellNumber_, vector<pair<float, float> >(3));
+  flush();
   
-  cellRangeBox_.resize(cellNumber_);
+  fieldKey_ = fieldKey;
+  
+  // [xMin, xMax, yMin, yMax, zMin, zMax] per cell
+  cellDomainBox_.resize(6*cellNumber_);
+  // [uMin, uMax, vMin, vMax] per cell
+  cellRangeBox_.resize(4*cellNumber_);
 
   // WARNING: assuming tets only here
 #ifdef withOpenMP
@@ -173,9 +201,12 @@ template <class dataTypeU, class dataTypeV>
 #endif
   for(int i = 0; i < cellNumber_; i++){
     
+    float *domainBox = &(cellDomainBox_[6*i]);
+    double *rangeBox = &(cellRangeBox_[4*i]);
+    
     for(int j = 0; j < 3; j++){
-      cellDomainBox_[i][j].first = FLT_MAX;
-      cellDomainBox_[i][j].second = -FLT_MAX;
+      domainBox[2*j] = FLT_MAX;
+      domainBox[2*j + 1] = -FLT_MAX;
     }
     
     const long long int *cell = NULL;
@@ -205,56 +236,38 @@ template <class dataTypeU, class dataTypeV>
         p[2] = pointList_[3*vertexId + 2];
       }
       
-      // update x-range
-      if(p[0] < cellDomainBox_[i][0].first)
-        cellDomainBox_[i][0].first = p[0];
-      if(p[0] > cellDomainBox_[i][0].second)
-        cellDomainBox_[i][0].second = p[0];
-        
-      // update y-range
-      if(p[1] < cellDomainBox_[i][1].first)
-        cellDomainBox_[i][1].first = p[1];
-      if(p[1] > cellDomainBox_[i][1].second)
-        cellDomainBox_[i][1].second = p[1];
-      
-      // update z-range
-      if(p[2] < cellDomainBox_[i][2].first)
-        cellDomainBox_[i][2].first = p[2];
-      if(p[2] > cellDomainBox_[i][2].second)
-        cellDomainBox_[i][2].second = p[2];
+      for(int k = 0; k < 3; k++){
+        if(p[k] < domainBox[2*k])
+          domainBox[2*k] = p[k];
+        if(p[k] > domainBox[2*k + 1])
+          domainBox[2*k + 1] = p[k];
+      }
         
       // update the range bounding box
       if(!j){
-        cellRangeBox_[i].first.first = u[vertexId];
-        cellRangeBox_[i].first.second = u[vertexId];
-        
-        cellRangeBox_[i].second.first = v[vertexId];
-        cellRangeBox_[i].second.second = v[vertexId];
+        rangeBox[0] = rangeBox[1] = u[vertexId];
+        rangeBox[2] = rangeBox[3] = v[vertexId];
       }
       else{
         
         // update u
-        if(u[vertexId] < cellRangeBox_[i].first.first)
-          cellRangeBox_[i].first.first = u[vertexId];
-        if(u[vertexId] > cellRangeBox_[i].first.second)
-          cellRangeBox_[i].first.second = u[vertexId];
+        if(u[vertexId] < rangeBox[0])
+          rangeBox[0] = u[vertexId];
+        if(u[vertexId] > rangeBox[1])
+          rangeBox[1] = u[vertexId];
         
         // update v
-        if(v[vertexId] < cellRangeBox_[i].second.first)
-          cellRangeBox_[i].second.first = v[vertexId];
-        if(v[vertexId] > cellRangeBox_[i].second.second)
-          cellRangeBox_[i].second.second = v[vertexId];
+        if(v[vertexId] < rangeBox[2])
+          rangeBox[2] = v[vertexId];
+        if(v[vertexId] > rangeBox[3])
+          rangeBox[3] = v[vertexId];
       }
     }
   }
 
-  vector<int> domain(cellNumber_);
-  for(int i = 0; i < cellNumber_; i++)
-    domain[i] = i;
-  
   // get global bBoxes
-  vector<pair<float, float> > domainBox(3);
-  pair<pair<double, double>, pair<double, double> > rangeBox;
+  float domainBox[6];
+  double rangeBox[4];
   
   for(int i = 0; i < vertexNumber_; i++){
     
@@ -271,38 +284,37 @@ template <class dataTypeU, class dataTypeV>
     
     for(int j = 0; j < 3; j++){
       if(!i){
-        domainBox[j].first = domainBox[j].second = p[j];
+        domainBox[2*j] = domainBox[2*j + 1] = p[j];
       }
       else{
-        if(p[j] < domainBox[j].first)
-          domainBox[j].first = p[j];
-        if(p[j] > domainBox[j].second)
-          domainBox[j].second = p[j];
+        if(p[j] < domainBox[2*j])
+          domainBox[2*j] = p[j];
+        if(p[j] > domainBox[2*j + 1])
+          domainBox[2*j + 1] = p[j];
       }
     }
     
     if(!i){
-      rangeBox.first.first = rangeBox.first.second = u[i];
-      rangeBox.second.first = rangeBox.second.second = v[i];
+      rangeBox[0] = rangeBox[1] = u[i];
+      rangeBox[2] = rangeBox[3] = v[i];
     }
     else{
-      if(u[i] < rangeBox.first.first)
-        rangeBox.first.first = u[i];
-      if(u[i] > rangeBox.first.second)
-        rangeBox.first.second = u[i];
+      if(u[i] < rangeBox[0])
+        rangeBox[0] = u[i];
+      if(u[i] > rangeBox[1])
+        rangeBox[1] = u[i];
       
-      if(v[i] < rangeBox.second.first)
-        rangeBox.second.first = v[i];
-      if(v[i] > rangeBox.second.second)
-        rangeBox.second.second = v[i];
+      if(v[i] < rangeBox[2])
+        rangeBox[2] = v[i];
+      if(v[i] > rangeBox[3])
+        rangeBox[3] = v[i];
     }
   }
  
-  rangeArea_ = (rangeBox.first.second - rangeBox.first.first)
-    *(rangeBox.second.second - rangeBox.second.first);
-  domainVolume_ = (domainBox[0].second - domainBox[0].first)
-    *(domainBox[1].second - domainBox[1].first)
-    *(domainBox[2].second - domainBox[2].first);
+  rangeArea_ = (rangeBox[1] - rangeBox[0])*(rangeBox[3] - rangeBox[2]);
+  domainVolume_ = (domainBox[1] - domainBox[0])
+    *(domainBox[3] - domainBox[2])
+    *(domainBox[5] - domainBox[4]);
   
   // special case for tets obtained from regular grid subdivision (assuming 6)
   if(leafMinimumCellNumber_ < 6)
@@ -317,12 +329,29 @@ template <class dataTypeU, class dataTypeV>
       << endl;
     dMsg(cout, msg.str(), 4);
   }
-  buildNode<dataTypeU, dataTypeV>(domain, domainBox, rangeBox, rootId_);
+  
+  cellIds_.resize(cellNumber_);
+  for(int i = 0; i < cellNumber_; i++)
+    cellIds_[i] = i;
+  
+  appendNode(domainBox, rangeBox, 0, cellNumber_);
+ 
+  // breadth-first construction: the nodes are processed in order and append 
+  // their children at the end of the node list.
+  vector<int> cellBuffer;
+  for(int i = 0; i < (int) nodeChildren_.size(); i++){
+    buildNode(i, cellBuffer);
+  }
+  
+  // the per-cell boxes are not needed by the queries
+  vector<float>().swap(cellDomainBox_);
+  vector<double>().swap(cellRangeBox_);
  
   {
     stringstream msg;
     msg << "[RangeDrivenOctree] Octree built in "
-      << t.getElapsedTime() << " s." << endl;
+      << t.getElapsedTime() << " s. (" << nodeChildren_.size()
+      << " nodes)" << endl;
     dMsg(cout, msg.str(), 2);
   }
   {
@@ -340,187 +369,39 @@ template <class dataTypeU, class dataTypeV>
 }
 
 template <class dataTypeU, class dataTypeV> 
-  int RangeDrivenOctree::buildNode(
-    const vector<int> &cellList,
-    const vector<pair<float, float> > &domainBox,
-    const pair<pair<double, double>, pair<double, double> > &rangeBox, 
-    int &nodeId){
-
-  nodeId = nodeList_.size();
+  inline unsigned long long RangeDrivenOctree::getFieldKey() const{
   
-  nodeList_.resize(nodeList_.size() + 1);
-
-  nodeList_.back().rangeBox_ = rangeBox;
-  nodeList_.back().domainBox_ = domainBox;
+  int vertexNumber = vertexNumber_;
+  unsigned long long key = Hash::getBasis();
   
-  float rangeArea = (rangeBox.first.second - rangeBox.first.first)
-    *(rangeBox.second.second - rangeBox.second.first);
-    
-  float domainVolume = (domainBox[0].second - domainBox[0].first)
-    *(domainBox[1].second - domainBox[1].first)
-    *(domainBox[2].second - domainBox[2].first);
- 
-  if(((int) cellList.size() > leafMinimumCellNumber_)
-    &&(rangeArea > leafMinimumRangeAreaRatio_*rangeArea_)
-    &&(domainVolume > leafMinimumDomainVolumeRatio_*domainVolume_)){
-    
-    nodeList_.back().childList_.resize(8);
-  
-    vector<vector<pair<float, float> > > childDomainBox(8);
-    for(int i = 0; i < (int) childDomainBox.size(); i++){
-      childDomainBox[i].resize(3);
-    }
-    vector<pair<pair<dataTypeU, dataTypeU>, pair<dataTypeV, dataTypeV> > > 
-      childRangeBox(8);
-    vector<vector<int> > childCellList(8);
-
-    float midX = domainBox[0].first 
-      + (domainBox[0].second - domainBox[0].first)/2.0;
-    float midY = domainBox[1].first
-      + (domainBox[1].second - domainBox[1].first)/2.0;
-    float midZ = domainBox[2].first
-      + (domainBox[2].second - domainBox[2].first)/2.0;
-     
-    // 0 - - -
-    childDomainBox[0][0].first = domainBox[0].first;
-    childDomainBox[0][0].second = midX;
-    childDomainBox[0][1].first = domainBox[1].first;
-    childDomainBox[0][1].second = midY;
-    childDomainBox[0][2].first = domainBox[2].first;
-    childDomainBox[0][2].second = midZ;
-   
-    // 1 - - +
-    childDomainBox[1][0].first = domainBox[0].first;
-    childDomainBox[1][0].second = midX;
-    childDomainBox[1][1].first = domainBox[1].first;
-    childDomainBox[1][1].second = midY;
-    childDomainBox[1][2].first = midZ;
-    childDomainBox[1][2].second = domainBox[2].second;
-    
-    // 2 - + -
-    childDomainBox[2][0].first = domainBox[0].first;
-    childDomainBox[2][0].second = midX;
-    childDomainBox[2][1].first = midY;
-    childDomainBox[2][1].second = domainBox[1].second;
-    childDomainBox[2][2].first = domainBox[2].first;
-    childDomainBox[2][2].second = midZ;
-    
-    // 3 - + + 
-    childDomainBox[3][0].first = domainBox[0].first;
-    childDomainBox[3][0].second = midX;
-    childDomainBox[3][1].first = midY;
-    childDomainBox[3][1].second = domainBox[1].second;
-    childDomainBox[3][2].first = midZ;
-    childDomainBox[3][2].second = domainBox[2].second;
-    
-    // 4 + - -
-    childDomainBox[4][0].first = midX;
-    childDomainBox[4][0].second = domainBox[0].second;
-    childDomainBox[4][1].first = domainBox[1].first;
-    childDomainBox[4][1].second = midY;
-    childDomainBox[4][2].first = domainBox[2].first;
-    childDomainBox[4][2].second = midZ;
-    
-    // 5 + - +
-    childDomainBox[5][0].first = midX;
-    childDomainBox[5][0].second = domainBox[0].second;
-    childDomainBox[5][1].first = domainBox[1].first;
-    childDomainBox[5][1].second = midY;
-    childDomainBox[5][2].first = midZ;
-    childDomainBox[5][2].second = domainBox[2].second;
-    
-    // 6 + + -
-    childDomainBox[6][0].first = midX;
-    childDomainBox[6][0].second = domainBox[0].second;
-    childDomainBox[6][1].first = midY;
-    childDomainBox[6][1].second = domainBox[1].second;
-    childDomainBox[6][2].first = domainBox[2].first;
-    childDomainBox[6][2].second = midZ;
-    
-    // 7 + + +
-    childDomainBox[7][0].first = midX;
-    childDomainBox[7][0].second = domainBox[0].second;
-    childDomainBox[7][1].first = midY;
-    childDomainBox[7][1].second = domainBox[1].second;
-    childDomainBox[7][2].first = midZ;
-    childDomainBox[7][2].second = domainBox[2].second;
-    
-    for(int i = 0; i < (int) cellList.size(); i++){
-      
-      int childId = 0;
-      
-      for(int j = 0; j < 8; j++){
-        if((cellDomainBox_[cellList[i]][0].first 
-          >= childDomainBox[j][0].first)
-          &&(cellDomainBox_[cellList[i]][0].first
-          < childDomainBox[j][0].second)
-          &&
-          (cellDomainBox_[cellList[i]][1].first 
-          >= childDomainBox[j][1].first)
-          &&(cellDomainBox_[cellList[i]][1].first
-          < childDomainBox[j][1].second)
-          &&
-          (cellDomainBox_[cellList[i]][2].first 
-          >= childDomainBox[j][2].first)
-          &&(cellDomainBox_[cellList[i]][2].first
-          < childDomainBox[j][2].second)){
-        
-          childId = j;
-          break;
-        }
-      }
-      
-      // update child's range box
-      if(childCellList[childId].empty()){
-        childRangeBox[childId].first.first 
-          = cellRangeBox_[cellList[i]].first.first;
-        childRangeBox[childId].first.second
-          = cellRangeBox_[cellList[i]].first.second;
-          
-        childRangeBox[childId].second.first 
-          = cellRangeBox_[cellList[i]].second.first;
-        childRangeBox[childId].second.second
-          = cellRangeBox_[cellList[i]].second.second;
-      }
-      else{
-        if(cellRangeBox_[cellList[i]].first.first 
-          < childRangeBox[childId].first.first){
-          childRangeBox[childId].first.first 
-            = cellRangeBox_[cellList[i]].first.first;
-        }
-        if(cellRangeBox_[cellList[i]].first.second
-          > childRangeBox[childId].first.second){
-          childRangeBox[childId].first.second 
-            = cellRangeBox_[cellList[i]].first.second;
-        }
-        
-        if(cellRangeBox_[cellList[i]].second.first 
-          < childRangeBox[childId].second.first){
-          childRangeBox[childId].second.first 
-            = cellRangeBox_[cellList[i]].second.first;
-        }
-        if(cellRangeBox_[cellList[i]].second.second
-          > childRangeBox[childId].second.second){
-          childRangeBox[childId].second.second 
-            = cellRangeBox_[cellList[i]].second.second;
-        }
-      }
-    
-      childCellList[childId].push_back(cellList[i]);
-      
-    }
-    
-    for(int i = 0; i < 8; i++){
-      buildNode<dataTypeU, dataTypeV>(childCellList[i], 
-        childDomainBox[i], childRangeBox[i], nodeList_[nodeId].childList_[i]);
-    }
+  // connectivity
+  if(triangulation_){
+    vertexNumber = triangulation_->getNumberOfVertices();
+    key = Hash::addConnectivity(key, triangulation_, threadNumber_);
   }
   else{
-    // leaf
-    nodeList_[nodeId].cellList_ = cellList;
+    key = Hash::addValue(key, vertexNumber_);
+    key = Hash::addValue(key, cellNumber_);
+    // (vertexNumber, v0, v1, v2, v3) per tet
+    key = Hash::addArrays(key, 
+      {{cellList_, (int) (5*sizeof(long long int))}}, cellNumber_, 
+      threadNumber_);
   }
   
-  return 0;
+  // build parameters (the minimum cell number is clamped by build() and the
+  // domain volume ratio only depends on the number of cells)
+  key = Hash::addValue(key, 
+    leafMinimumCellNumber_ < 6 ? 6 : leafMinimumCellNumber_);
+  key = Hash::addValue(key, leafMinimumRangeAreaRatio_);
+  
+  // fields
+  key = Hash::addValue(key, sizeof(dataTypeU));
+  key = Hash::addValue(key, sizeof(dataTypeV));
+  key = Hash::addArrays(key, 
+    {{u_, sizeof(dataTypeU)}, {v_, sizeof(dataTypeV)}}, vertexNumber, 
+    threadNumber_);
+  
+  return key;
 }
 
 #endif // _RANGE_DRIVEN_OCTREE_H
@@ -1,6 +1,37 @@
 #include                  <ReebSpace.h>
 
+// saves a list before its update by a 3-sheet merge.
+static void saveList(vector<int> &list, 
+  vector<pair<vector<int> *, vector<int> > > &savedLists){
+  
+  savedLists.push_back(pair<vector<int> *, vector<int> >(&list, list));
+}
+
+// replaces sheetId by mergerId in the list.
+static void replaceSheet(vector<int> &list, 
+  const int &sheetId, const int &mergerId,
+  vector<pair<vector<int> *, vector<int> > > &savedLists){
+  
+  saveList(list, savedLists);
+  
+  for(int i = 0; i < (int) list.size(); i++){
+    if(list[i] == sheetId)
+      list[i] = mergerId;
+  }
+  sort(list.begin(), list.end());
+  list.erase(unique(list.begin(), list.end()), list.end());
+}
 
+// adds the entries of otherList to the list.
+static void mergeLists(vector<int> &list, const vector<int> &otherList,
+  vector<pair<vector<int> *, vector<int> > > &savedLists){
+  
+  saveList(list, savedLists);
+  
+  list.insert(list.end(), otherList.begin(), otherList.end());
+  sort(list.begin(), list.end());
+  list.erase(unique(list.begin(), list.end()), list.end());
+}
 
 ReebSpace::ReebSpace(){
 
@@ -17,6 +48,7 @@ ReebSpace::ReebSpace(){
   
   hasConnectedSheets_ = false;
   expand3sheets_ = true;
+  simplificationHierarchy_.isBuilt_ = false;
   
   triangulation_ = NULL;
   withRangeDrivenOctree_ = true;
@@ -26,6 +58,246 @@ ReebSpace::~ReebSpace(){
   
 }
 
+int ReebSpace::apply3sheetMerge(const int &mergeId){
+
+  SimplificationHierarchy &hierarchy = simplificationHierarchy_;
+  
+  int prunedId = hierarchy.prunedIds_[mergeId];
+  int mergerId = hierarchy.mergerIds_[mergeId];
+  
+  Sheet3 &prunedSheet = currentData_.sheet3List_[prunedId];
+  
+  prunedSheet.pruned_ = true;
+  
+  hierarchy.undoList_.resize(hierarchy.undoList_.size() + 1);
+  
+  if(mergerId == -1)
+    return 0;
+  
+  SimplificationHierarchy::MergeUndo &undo = hierarchy.undoList_.back();
+  
+  // same as mergeSheets()
+  Sheet3 &mergerSheet = currentData_.sheet3List_[mergerId];
+  
+  mergerSheet.vertexList_.insert(mergerSheet.vertexList_.end(),
+    prunedSheet.vertexList_.begin(), prunedSheet.vertexList_.end());
+  mergerSheet.tetList_.insert(mergerSheet.tetList_.end(),
+    prunedSheet.tetList_.begin(), prunedSheet.tetList_.end());
+  
+  for(int i = 0; i < (int) prunedSheet.vertexList_.size(); i++){
+    currentData_.vertex2sheet3_[prunedSheet.vertexList_[i]] = mergerId;
+  }
+  for(int i = 0; i < (int) prunedSheet.tetList_.size(); i++){
+    currentData_.tet2sheet3_[prunedSheet.tetList_[i]] = mergerId;
+  }
+  
+  mergerSheet.domainVolume_ += prunedSheet.domainVolume_;
+  mergerSheet.rangeArea_ += prunedSheet.rangeArea_;
+  mergerSheet.hyperVolume_ += prunedSheet.hyperVolume_;
+  
+  // connections: the sheets attached to the pruned 3-sheet get attached to
+  // the merger, which gathers the connections of the pruned 3-sheet. the 
+  // pruned 3-sheet gets back its original connections.
+  for(int i = 0; i < (int) prunedSheet.sheet0List_.size(); i++){
+    replaceSheet(
+      currentData_.sheet0List_[prunedSheet.sheet0List_[i]].sheet3List_,
+      prunedId, mergerId, undo.lists_);
+  }
+  for(int i = 0; i < (int) prunedSheet.sheet2List_.size(); i++){
+    replaceSheet(
+      currentData_.sheet2List_[prunedSheet.sheet2List_[i]].sheet3List_,
+      prunedId, mergerId, undo.lists_);
+  }
+  for(int i = 0; i < (int) prunedSheet.sheet3List_.size(); i++){
+    int otherSheetId = prunedSheet.sheet3List_[i];
+    if(otherSheetId != mergerId){
+      replaceSheet(currentData_.sheet3List_[otherSheetId].sheet3List_,
+        prunedId, mergerId, undo.lists_);
+    }
+  }
+  
+  mergeLists(mergerSheet.sheet0List_, prunedSheet.sheet0List_, undo.lists_);
+  mergeLists(mergerSheet.sheet1List_, prunedSheet.sheet1List_, undo.lists_);
+  mergeLists(mergerSheet.sheet2List_, prunedSheet.sheet2List_, undo.lists_);
+  mergeLists(mergerSheet.sheet3List_, prunedSheet.sheet3List_, undo.lists_);
+  mergerSheet.sheet3List_.erase(remove(mergerSheet.sheet3List_.begin(),
+    mergerSheet.sheet3List_.end(), mergerId), mergerSheet.sheet3List_.end());
+  mergerSheet.sheet3List_.erase(remove(mergerSheet.sheet3List_.begin(),
+    mergerSheet.sheet3List_.end(), prunedId), mergerSheet.sheet3List_.end());
+  
+  const Sheet3 &originalSheet = originalData_.sheet3List_[prunedId];
+  saveList(prunedSheet.sheet0List_, undo.lists_);
+  saveList(prunedSheet.sheet1List_, undo.lists_);
+  saveList(prunedSheet.sheet2List_, undo.lists_);
+  saveList(prunedSheet.sheet3List_, undo.lists_);
+  prunedSheet.sheet0List_ = originalSheet.sheet0List_;
+  prunedSheet.sheet1List_ = originalSheet.sheet1List_;
+  prunedSheet.sheet2List_ = originalSheet.sheet2List_;
+  prunedSheet.sheet3List_ = originalSheet.sheet3List_;
+  
+  // 1-sheets, as updated by mergeSheets()
+  for(int i = hierarchy.sheet1Offsets_[mergeId]; 
+    i < hierarchy.sheet1Offsets_[mergeId + 1]; i++){
+    
+    int sheet1Id = hierarchy.sheet1Ids_[i];
+    Sheet1 &sheet1 = currentData_.sheet1List_[sheet1Id];
+    
+    saveList(sheet1.sheet3List_, undo.lists_);
+    sheet1.sheet3List_ = hierarchy.sheet1Lists_[i];
+    
+    if((sheet1.hasSaddleEdges_)&&(sheet1.sheet3List_.size() == 1)){
+      
+      // values overwritten by prune1sheet()
+      undo.flags_.push_back(pair<bool *, bool>(
+        &(sheet1.pruned_), sheet1.pruned_));
+      undo.flags_.push_back(pair<bool *, bool>(
+        &(currentData_.sheet2List_[sheet1Id].pruned_), 
+        currentData_.sheet2List_[sheet1Id].pruned_));
+      
+      for(int j = 0; j < (int) sheet1.edgeList_.size(); j++){
+        for(int k = 0; k < 2; k++){
+          int vertexId = -1;
+          triangulation_->getEdgeVertex(sheet1.edgeList_[j], k, vertexId);
+          undo.values_.push_back(pair<int *, int>(
+            &(currentData_.vertex2sheet3_[vertexId]), 
+            currentData_.vertex2sheet3_[vertexId]));
+        }
+      }
+      for(int j = 0; j < (int) sheet1.sheet0List_.size(); j++){
+        Sheet0 &sheet0 = currentData_.sheet0List_[sheet1.sheet0List_[j]];
+        if(sheet0.sheet1List_.empty()){
+          undo.values_.push_back(pair<int *, int>(
+            &(sheet0.pruned_), sheet0.pruned_));
+          undo.values_.push_back(pair<int *, int>(
+            &(currentData_.vertex2sheet3_[sheet0.vertexId_]),
+            currentData_.vertex2sheet3_[sheet0.vertexId_]));
+        }
+      }
+      
+      prune1sheet(currentData_, sheet1Id, mergerId);
+    }
+  }
+  
+  return 0;
+}
+
+int ReebSpace::buildSimplificationHierarchy(
+  const SimplificationCriterion &simplificationCriterion){
+
+  Timer t;
+  
+  SimplificationHierarchy &hierarchy = simplificationHierarchy_;
+  
+  prepareSimplification();
+  
+  hierarchy.prunedIds_.clear();
+  hierarchy.mergerIds_.clear();
+  hierarchy.values_.clear();
+  hierarchy.domainVolumes_.clear();
+  hierarchy.rangeAreas_.clear();
+  hierarchy.hyperVolumes_.clear();
+  hierarchy.previousMergeIds_.clear();
+  hierarchy.sheet1Offsets_.resize(1, 0);
+  hierarchy.sheet1Ids_.clear();
+  hierarchy.sheet1Lists_.clear();
+  
+  // last merge into each 3-sheet
+  vector<int> lastMergeIds(currentData_.sheet3List_.size(), -1);
+  
+  // min-heap of the (value, id) of the non-pruned 3-sheets.
+  // entries are invalidated lazily: a merge re-inserts the merger with its 
+  // new value and outdated entries are skipped when popped. ties are broken
+  // by sheet identifier.
+  vector<pair<double, int> > sheetValues;
+  for(int i = 0; i < (int) currentData_.sheet3List_.size(); i++){
+    if(!currentData_.sheet3List_[i].pruned_){
+      sheetValues.push_back(
+        pair<double, int>(get3sheetValue(i, simplificationCriterion), i));
+    }
+  }
+  
+  priority_queue<pair<double, int>, vector<pair<double, int> >,
+    greater<pair<double, int> > > sheetQueue(
+      greater<pair<double, int> >(), sheetValues);
+  vector<pair<double, int> >().swap(sheetValues);
+  
+  // simplify everything
+  while(!sheetQueue.empty()){
+    
+    double minValue = sheetQueue.top().first;
+    int minId = sheetQueue.top().second;
+    sheetQueue.pop();
+    
+    if((currentData_.sheet3List_[minId].pruned_)
+      ||(minValue != get3sheetValue(minId, simplificationCriterion))){
+      // outdated entry
+      continue;
+    }
+    
+    int mergerId = -1;
+    simplifySheet(minId, simplificationCriterion, mergerId);
+    
+    int mergeId = hierarchy.prunedIds_.size();
+    
+    // a threshold stops at the first value above it
+    if((mergeId)&&(minValue < hierarchy.values_.back()))
+      minValue = hierarchy.values_.back();
+    
+    hierarchy.prunedIds_.push_back(minId);
+    hierarchy.mergerIds_.push_back(mergerId);
+    hierarchy.values_.push_back(minValue);
+    
+    if(mergerId != -1){
+      const Sheet3 &mergerSheet = currentData_.sheet3List_[mergerId];
+      hierarchy.domainVolumes_.push_back(mergerSheet.domainVolume_);
+      hierarchy.rangeAreas_.push_back(mergerSheet.rangeArea_);
+      hierarchy.hyperVolumes_.push_back(mergerSheet.hyperVolume_);
+      hierarchy.previousMergeIds_.push_back(lastMergeIds[mergerId]);
+      lastMergeIds[mergerId] = mergeId;
+      
+      // 1-sheets updated by mergeSheets()
+      const Sheet3 &prunedSheet = currentData_.sheet3List_[minId];
+      for(int i = 0; i < (int) prunedSheet.sheet1List_.size(); i++){
+        int sheet1Id = prunedSheet.sheet1List_[i];
+        hierarchy.sheet1Ids_.push_back(sheet1Id);
+        hierarchy.sheet1Lists_.push_back(
+          currentData_.sheet1List_[sheet1Id].sheet3List_);
+      }
+      
+      sheetQueue.push(pair<double, int>(
+        get3sheetValue(mergerId, simplificationCriterion), mergerId));
+    }
+    else{
+      hierarchy.domainVolumes_.push_back(0);
+      hierarchy.rangeAreas_.push_back(0);
+      hierarchy.hyperVolumes_.push_back(0);
+      hierarchy.previousMergeIds_.push_back(-1);
+    }
+    hierarchy.sheet1Offsets_.push_back(hierarchy.sheet1Ids_.size());
+  }
+  
+  printConnectivity(cout, currentData_);
+  
+  // back to the unsimplified 3-sheets
+  prepareSimplification();
+  
+  hierarchy.isBuilt_ = true;
+  hierarchy.criterion_ = simplificationCriterion;
+  hierarchy.mergeNumber_ = 0;
+  hierarchy.undoList_.clear();
+  hierarchy.orphanIds_.clear();
+  
+  {
+    stringstream msg;
+    msg << "[ReebSpace] Simplification hierarchy ("
+      << hierarchy.prunedIds_.size() << " merges) computed in "
+      << t.getElapsedTime() << " s." << endl;
+    dMsg(cout, msg.str(), timeMsg);
+  }
+  
+  return 0;
+}
+
 int ReebSpace::compute1sheetsOnly(const vector<pair<int, char> > &jacobiSet, 
   vector<pair<int, int> > &jacobiClassification){
 
@@ -373,15 +645,11 @@ int ReebSpace::compute1sheets(
   return 0;
 }
 
-int ReebSpace::compute3sheet(const int &vertexId,
+int ReebSpace::compute3sheet(const int &vertexId, const int &sheetId,
+  const vector<int> &sheetRoots,
   const vector<vector<vector<int> > > &tetTriangles){
 
-  int sheetId = originalData_.sheet3List_.size();
-  originalData_.sheet3List_.resize(originalData_.sheet3List_.size() + 1);
-  originalData_.sheet3List_.back().pruned_ = false;
-  originalData_.sheet3List_.back().preMerger_ = -1;
-  originalData_.sheet3List_.back().Id_ = sheetId;
-  
+  Sheet3 &sheet = originalData_.sheet3List_[sheetId];
   
   queue<int> vertexQueue;
   vertexQueue.push(vertexId);
@@ -394,7 +662,7 @@ int ReebSpace::compute3sheet(const int &vertexId,
     if(originalData_.vertex2sheet3_[localVertexId] == -1){
       // not visited yet
       
-      originalData_.sheet3List_.back().vertexList_.push_back(localVertexId);
+      sheet.vertexList_.push_back(localVertexId);
       originalData_.vertex2sheet3_[localVertexId] = sheetId;
       
       int vertexStarNumber = triangulation_->getVertexStarNumber(localVertexId);
@@ -404,16 +672,13 @@ int ReebSpace::compute3sheet(const int &vertexId,
         triangulation_->getVertexStar(localVertexId, i, tetId);
           
         if(tetTriangles[tetId].empty()){
-//             if(originalData_.tet2sheet3_[tetId] == -1){
-//               originalData_.tet2sheet3_[tetId] = sheetId;
-//               originalData_.sheet3List_.back().tetList_.push_back(tetId);
-//             }
           for(int j = 0; j < 4; j++){
             
             int tetVertexId = -1;
             triangulation_->getCellVertex(tetId, j, tetVertexId);
             
-            if(originalData_.vertex2sheet3_[tetVertexId] == -1){
+            if((sheetRoots[tetVertexId] == vertexId)
+              &&(originalData_.vertex2sheet3_[tetVertexId] == -1)){
               vertexQueue.push(tetVertexId);
             }
           }
@@ -424,51 +689,12 @@ int ReebSpace::compute3sheet(const int &vertexId,
             int otherVertexId = -1;
             triangulation_->getCellVertex(tetId, j, otherVertexId);
             if((otherVertexId != localVertexId)
-              &&(originalData_.vertex2sheet3_[otherVertexId] == -1)){
-              // we need to see if the edge <localVertexId, otherVertexId> is
-              // cut by a fiber surface triangle or not.
-              
-              bool isCut = false;
-              for(int k = 0; k < (int) tetTriangles[tetId].size(); k++){
-                int l = 0, m = 0, n = 0;
-                l = tetTriangles[tetId][k][0];
-                m = tetTriangles[tetId][k][1];
-                n = tetTriangles[tetId][k][2];
-                
-                for(int p = 0; p < 3; p++){
-                  pair<int, int> meshEdge;
-                  
-                  if(fiberSurfaceVertexList_.size()){
-                    // the fiber surfaces have been merged
-                    meshEdge = 
-                      fiberSurfaceVertexList_[originalData_.sheet2List_[
-                        l].triangleList_[m][n].vertexIds_[p]].meshEdge_;
-                  }
-                  else{
-                    // the fiber surfaces have not been merged
-                    meshEdge = originalData_.sheet2List_[l].vertexList_[m][
-                      originalData_.sheet2List_[
-                        l].triangleList_[m][n].vertexIds_[p]].meshEdge_;
-                  }
-                    
-                  if(((meshEdge.first == localVertexId)
-                    &&(meshEdge.second == otherVertexId))
-                    ||
-                    ((meshEdge.second == localVertexId)
-                    &&(meshEdge.first == otherVertexId))){
-                    isCut = true;
-                    break;
-                  }
-                }
-                
-                if(isCut)
-                  break;
-              }
-              
-              if(!isCut){
-                // add the vertex to the queue
-                vertexQueue.push(otherVertexId);
-              }
+              &&(sheetRoots[otherVertexId] == vertexId)
+              &&(originalData_.vertex2sheet3_[otherVertexId] == -1)
+              &&(!is3sheetEdgeCut(localVertexId, otherVertexId, 
+                tetId, tetTriangles))){
+              // add the vertex to the queue
+              vertexQueue.push(otherVertexId);
             }
           }
         }
@@ -521,12 +747,75 @@ int ReebSpace::compute3sheets(
     }
   }
   
+  // 1. connected components of the vertices, in parallel
+  vector<atomic<int> > parents(vertexNumber_);
+  
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber_)
+#endif
+  for(int i = 0; i < vertexNumber_; i++){
+    parents[i] = i;
+  }
+  
+#ifdef withOpenMP
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(threadNumber_)
+#endif
   for(int i = 0; i < vertexNumber_; i++){
     if(originalData_.vertex2sheet3_[i] == -1){
-      compute3sheet(i, tetTriangles);
+      
+      int vertexStarNumber = triangulation_->getVertexStarNumber(i);
+      
+      for(int j = 0; j < vertexStarNumber; j++){
+        int tetId = -1;
+        triangulation_->getVertexStar(i, j, tetId);
+        
+        for(int k = 0; k < 4; k++){
+          int otherVertexId = -1;
+          triangulation_->getCellVertex(tetId, k, otherVertexId);
+          
+          if((otherVertexId != i)
+            &&(originalData_.vertex2sheet3_[otherVertexId] == -1)
+            &&((tetTriangles[tetId].empty())
+              ||(!is3sheetEdgeCut(i, otherVertexId, tetId, tetTriangles)))){
+            union3sheetRoots(parents, i, otherVertexId);
+          }
+        }
+      }
+    }
+  }
+  
+  // 2. one 3-sheet per component, numbered by smallest vertex
+  vector<int> sheetRoots(vertexNumber_, -1);
+  
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber_)
+#endif
+  for(int i = 0; i < vertexNumber_; i++){
+    if(originalData_.vertex2sheet3_[i] == -1)
+      sheetRoots[i] = find3sheetRoot(parents, i);
+  }
+  vector<atomic<int> >().swap(parents);
+  
+  vector<int> sheetSeeds;
+  for(int i = 0; i < vertexNumber_; i++){
+    if(sheetRoots[i] == i){
+      int sheetId = originalData_.sheet3List_.size();
+      originalData_.sheet3List_.resize(sheetId + 1);
+      originalData_.sheet3List_.back().pruned_ = false;
+      originalData_.sheet3List_.back().preMerger_ = -1;
+      originalData_.sheet3List_.back().Id_ = sheetId;
+      sheetSeeds.push_back(i);
     }
   }
   
+  // 3. flood each 3-sheet from its seed, in parallel
+#ifdef withOpenMP
+#pragma omp parallel for schedule(dynamic) num_threads(threadNumber_)
+#endif
+  for(int i = 0; i < (int) sheetSeeds.size(); i++){
+    compute3sheet(sheetSeeds[i], i, sheetRoots, tetTriangles);
+  }
+  
   // for 3-sheet expansion
   vector<vector<pair<int, bool>> > 
     neighborList(originalData_.sheet3List_.size());
@@ -748,6 +1037,45 @@ int ReebSpace::compute3sheets(
   return 0;
 }
 
+bool ReebSpace::is3sheetEdgeCut(const int &vertexId, 
+  const int &otherVertexId, const int &tetId,
+  const vector<vector<vector<int> > > &tetTriangles) const{
+  
+  for(int k = 0; k < (int) tetTriangles[tetId].size(); k++){
+    int l = 0, m = 0, n = 0;
+    l = tetTriangles[tetId][k][0];
+    m = tetTriangles[tetId][k][1];
+    n = tetTriangles[tetId][k][2];
+    
+    for(int p = 0; p < 3; p++){
+      pair<int, int> meshEdge;
+      
+      if(fiberSurfaceVertexList_.size()){
+        // the fiber surfaces have been merged
+        meshEdge = 
+          fiberSurfaceVertexList_[originalData_.sheet2List_[
+            l].triangleList_[m][n].vertexIds_[p]].meshEdge_;
+      }
+      else{
+        // the fiber surfaces have not been merged
+        meshEdge = originalData_.sheet2List_[l].vertexList_[m][
+          originalData_.sheet2List_[
+            l].triangleList_[m][n].vertexIds_[p]].meshEdge_;
+      }
+        
+      if(((meshEdge.first == vertexId)
+        &&(meshEdge.second == otherVertexId))
+        ||
+        ((meshEdge.second == vertexId)
+        &&(meshEdge.first == otherVertexId))){
+        return true;
+      }
+    }
+  }
+  
+  return false;
+}
+
 int ReebSpace::connect3sheetTo0sheet(
   ReebSpaceData &data,
   const int &sheet3Id, const int &sheet0Id){
@@ -852,8 +1180,23 @@ int ReebSpace::connect3sheetTo3sheet(ReebSpaceData &data,
 int ReebSpace::connectSheets(){
 
   Timer t;
- 
+  
+  // the connections are listed in parallel, in per-thread lists, and then 
+  // established sequentially. with a static schedule, the concatenation of 
+  // the thread lists follows the order of the sequential traversal.
+  vector<vector<pair<int, int> > > threadedSheet2Connections(threadNumber_);
+  
+#ifdef withOpenMP
+#pragma omp parallel for schedule(static) num_threads(threadNumber_)
+#endif
   for(int i = 0; i < (int) originalData_.sheet2List_.size(); i++){
+    
+    int threadId = 0;
+#ifdef withOpenMP
+    threadId = omp_get_thread_num();
+#endif
+    vector<pair<int, int> > &connections = threadedSheet2Connections[threadId];
+    
     for(int j = 0; 
       j < (int) originalData_.sheet2List_[i].triangleList_.size(); j++){
       
@@ -869,18 +1212,44 @@ int ReebSpace::connectSheets(){
           int sheet3Id = originalData_.vertex2sheet3_[vertexId];
           
           if(sheet3Id >= 0){
-            connect3sheetTo2sheet(originalData_,
-              sheet3Id, i);
+            pair<int, int> connection(sheet3Id, i);
+            // skip the (frequent) consecutive duplicates
+            if((connections.empty())||(connections.back() != connection))
+              connections.push_back(connection);
           }
         }
       }
     }
   }
   
-  // connect 3-sheets together
+  for(int i = 0; i < threadNumber_; i++){
+    for(int j = 0; j < (int) threadedSheet2Connections[i].size(); j++){
+      connect3sheetTo2sheet(originalData_,
+        threadedSheet2Connections[i][j].first,
+        threadedSheet2Connections[i][j].second);
+    }
+  }
+  vector<vector<pair<int, int> > >().swap(threadedSheet2Connections);
+  
+  // connect 3-sheets together (and to 0- and 1-sheets)
+  // each connection is a triplet: dimension of the other sheet, 3-sheet 
+  // identifier, other sheet identifier.
+  vector<vector<int> > threadedConnections(threadNumber_);
+  
+#ifdef withOpenMP
+#pragma omp parallel for schedule(static) num_threads(threadNumber_)
+#endif
   for(int i = 0; i < vertexNumber_; i++){
     if(originalData_.vertex2sheet3_[i] >= 0){
       
+      int threadId = 0;
+#ifdef withOpenMP
+      threadId = omp_get_thread_num();
+#endif
+      vector<int> &connections = threadedConnections[threadId];
+      
+      int sheet3Id = originalData_.vertex2sheet3_[i];
+      
       int vertexEdgeNumber = triangulation_->getVertexEdgeNumber(i);
       
       for(int j = 0; j < vertexEdgeNumber; j++){
@@ -893,34 +1262,50 @@ int ReebSpace::connectSheets(){
         }
         
         if(originalData_.vertex2sheet3_[otherVertexId] >= 0){
-          if(originalData_.vertex2sheet3_[otherVertexId]
-            != originalData_.vertex2sheet3_[i]){
-            
-            connect3sheetTo3sheet(
-              originalData_,
-              originalData_.vertex2sheet3_[i],
+          if(originalData_.vertex2sheet3_[otherVertexId] != sheet3Id){
+            connections.push_back(3);
+            connections.push_back(sheet3Id);
+            connections.push_back(
               originalData_.vertex2sheet3_[otherVertexId]);
           }
         }
         
         if(originalData_.vertex2sheet0_[otherVertexId] != -1){
-          connect3sheetTo0sheet(
-            originalData_,
-            originalData_.vertex2sheet3_[i],
-            originalData_.vertex2sheet0_[otherVertexId]);
+          connections.push_back(0);
+          connections.push_back(sheet3Id);
+          connections.push_back(originalData_.vertex2sheet0_[otherVertexId]);
         }
         
         if(originalData_.vertex2sheet3_[otherVertexId] < -1){
-          int sheet1Id = -2 
-            - originalData_.vertex2sheet3_[otherVertexId];
-          connect3sheetTo1sheet(originalData_,
-            originalData_.vertex2sheet3_[i],
-            sheet1Id);
+          connections.push_back(1);
+          connections.push_back(sheet3Id);
+          connections.push_back(
+            -2 - originalData_.vertex2sheet3_[otherVertexId]);
         }
       }
     }
   }
   
+  for(int i = 0; i < threadNumber_; i++){
+    for(int j = 0; j < (int) threadedConnections[i].size(); j += 3){
+      
+      int sheet3Id = threadedConnections[i][j + 1];
+      int otherSheetId = threadedConnections[i][j + 2];
+      
+      switch(threadedConnections[i][j]){
+        case 0:
+          connect3sheetTo0sheet(originalData_, sheet3Id, otherSheetId);
+          break;
+        case 1:
+          connect3sheetTo1sheet(originalData_, sheet3Id, otherSheetId);
+          break;
+        case 3:
+          connect3sheetTo3sheet(originalData_, sheet3Id, otherSheetId);
+          break;
+      }
+    }
+  }
+  
   {
     stringstream msg;
     msg << "[ReebSpace] Sheet connectivity established." << endl;
@@ -994,31 +1379,7 @@ int ReebSpace::disconnect3sheetFrom1sheet(ReebSpaceData &data,
  
   if((data.sheet1List_[sheet1Id].hasSaddleEdges_)
     &&(data.sheet1List_[sheet1Id].sheet3List_.size() == 1)){
-    // this guy is no longer separting any body.
-    data.sheet1List_[sheet1Id].pruned_ = true;
-    data.sheet2List_[sheet1Id].pruned_ = true;
-  
-    // update the segmentation
-    for(int i = 0; i < (int) data.sheet1List_[sheet1Id].edgeList_.size(); i++){
-      
-      int vertexId = -1;
-      triangulation_->getEdgeVertex(
-        data.sheet1List_[sheet1Id].edgeList_[i], 0, vertexId);
-      data.vertex2sheet3_[vertexId] = biggerId;
-      
-      vertexId = -1;
-      triangulation_->getEdgeVertex(
-        data.sheet1List_[sheet1Id].edgeList_[i], 1, vertexId);
-      data.vertex2sheet3_[vertexId] = biggerId;
-    }
-    
-    for(int i = 0; 
-      i < (int) data.sheet1List_[sheet1Id].sheet0List_.size(); i++){
-      
-      disconnect1sheetFrom0sheet(data, 
-        sheet1Id,
-        data.sheet1List_[sheet1Id].sheet0List_[i], biggerId);
-    }
+    prune1sheet(data, sheet1Id, biggerId);
   }
   
   return 0;
@@ -1064,6 +1425,7 @@ int ReebSpace::flush(){
   totalVolume_ = -1;
   totalHyperVolume_ = -1;
   hasConnectedSheets_ = false;
+  simplificationHierarchy_.isBuilt_ = false;
   
   // store the segmentation for later purpose
   originalData_.vertex2sheet0_.resize(vertexNumber_);
@@ -1252,6 +1614,7 @@ int ReebSpace::prepareSimplification(){
       = originalData_.sheet2List_[i].sheet1Id_;
     currentData_.sheet2List_[i].sheet3List_ 
       = originalData_.sheet2List_[i].sheet3List_;
+    currentData_.sheet2List_[i].pruned_ = originalData_.sheet2List_[i].pruned_;
   }
   
   for(int i = 0; i < (int) currentData_.sheet3List_.size(); i++){
@@ -1284,6 +1647,38 @@ int ReebSpace::prepareSimplification(){
   return 0;
 }
 
+int ReebSpace::prune1sheet(ReebSpaceData &data, 
+  const int &sheet1Id, const int &biggerId){
+  
+  // this guy is no longer separting any body.
+  data.sheet1List_[sheet1Id].pruned_ = true;
+  data.sheet2List_[sheet1Id].pruned_ = true;
+
+  // update the segmentation
+  for(int i = 0; i < (int) data.sheet1List_[sheet1Id].edgeList_.size(); i++){
+    
+    int vertexId = -1;
+    triangulation_->getEdgeVertex(
+      data.sheet1List_[sheet1Id].edgeList_[i], 0, vertexId);
+    data.vertex2sheet3_[vertexId] = biggerId;
+    
+    vertexId = -1;
+    triangulation_->getEdgeVertex(
+      data.sheet1List_[sheet1Id].edgeList_[i], 1, vertexId);
+    data.vertex2sheet3_[vertexId] = biggerId;
+  }
+  
+  for(int i = 0; 
+    i < (int) data.sheet1List_[sheet1Id].sheet0List_.size(); i++){
+    
+    disconnect1sheetFrom0sheet(data, 
+      sheet1Id,
+      data.sheet1List_[sheet1Id].sheet0List_[i], biggerId);
+  }
+  
+  return 0;
+}
+
 int ReebSpace::printConnectivity(ostream& stream, 
   const ReebSpaceData &data) const{
 
@@ -1349,7 +1744,7 @@ int ReebSpace::printConnectivity(ostream& stream,
 }
 
 int ReebSpace::simplifySheet(const int &sheetId, 
-  const SimplificationCriterion &criterion){
+  const SimplificationCriterion &criterion, int &mergerId){
 
   int candidateId = -1;
   double maximumScore = -1;
@@ -1465,6 +1860,7 @@ int ReebSpace::simplifySheet(const int &sheetId,
   if(candidateId != -1){
     mergeSheets(sheetId, candidateId);
   }
+  mergerId = candidateId;
    
   currentData_.sheet3List_[sheetId].pruned_ = true;
    
@@ -1478,51 +1874,33 @@ int ReebSpace::simplifySheets(const double &simplificationThreshold,
   
   if(!currentData_.sheet3List_.size())
     return -1;
- 
-  int simplifiedSheets = 0;
-  double lastThreshold = -1;
   
-  for(int it = 0; it < (int) originalData_.sheet3List_.size(); it++){
-    
-    // do while, avoiding infinite loop
-    
-    double minValue = -1;
-    int minId = -1;
-    
-    for(int i = 0; i < (int) currentData_.sheet3List_.size(); i++){
-      if(!currentData_.sheet3List_[i].pruned_){
-        
-        double value = 0;
-        switch(simplificationCriterion){
-    
-          case ReebSpace::domainVolume:
-            value = currentData_.sheet3List_[i].domainVolume_/totalVolume_;
-            break;
-            
-          case ReebSpace::rangeArea:
-            value = currentData_.sheet3List_[i].rangeArea_/totalArea_;
-            break;
-            
-          case ReebSpace::hyperVolume:
-            value = currentData_.sheet3List_[i].hyperVolume_/totalHyperVolume_;
-            break;
-        }
-        
-        if((minId == -1)||(value < minValue)){
-          minValue = value;
-          minId = i;
-        }
-      }
-    }
-    
-    if((minId != -1)&&(minValue < simplificationThreshold)){
-      simplifySheet(minId, simplificationCriterion);
-      simplifiedSheets++;
-      lastThreshold = minValue;
-    }
-    else{
-      break;
-    }
+  SimplificationHierarchy &hierarchy = simplificationHierarchy_;
+  
+  if((!hierarchy.isBuilt_)||(hierarchy.criterion_ != simplificationCriterion)){
+    buildSimplificationHierarchy(simplificationCriterion);
+  }
+  
+  // the merges below the threshold form a prefix of the hierarchy
+  int mergeNumber = lower_bound(hierarchy.values_.begin(), 
+    hierarchy.values_.end(), simplificationThreshold) 
+    - hierarchy.values_.begin();
+  
+  // orphans of the previous threshold
+  for(int i = 0; i < (int) hierarchy.orphanIds_.size(); i++){
+    currentData_.sheet1List_[hierarchy.orphanIds_[i]].pruned_ = false;
+  }
+  hierarchy.orphanIds_.clear();
+  
+  // coarsening: apply the next merges, refining: undo the last ones. only
+  // the merges between the two thresholds are visited.
+  while(hierarchy.mergeNumber_ < mergeNumber){
+    apply3sheetMerge(hierarchy.mergeNumber_);
+    hierarchy.mergeNumber_++;
+  }
+  while(hierarchy.mergeNumber_ > mergeNumber){
+    hierarchy.mergeNumber_--;
+    undo3sheetMerge(hierarchy.mergeNumber_);
   }
   
   currentData_.simplificationThreshold_ = simplificationThreshold;
@@ -1530,6 +1908,8 @@ int ReebSpace::simplifySheets(const double &simplificationThreshold,
   
   int simplificationId = 0;
   for(int i = 0; i < (int) currentData_.sheet3List_.size(); i++){
+    currentData_.sheet3List_[i].simplificationId_ = 
+      currentData_.sheet3List_[i].Id_;
     if(!currentData_.sheet3List_[i].pruned_){
       currentData_.sheet3List_[i].simplificationId_ = simplificationId;
       simplificationId++;
@@ -1565,22 +1945,21 @@ int ReebSpace::simplifySheets(const double &simplificationThreshold,
       
       if(nonSimplified < 2){
         currentData_.sheet1List_[i].pruned_ = true;
+        hierarchy.orphanIds_.push_back(i);
       }
     }
   }
   
   // TODO: update segmentation for 1-sheets and 0-sheets?...
  
-  printConnectivity(cout, currentData_);
- 
   {
     stringstream msg;
-    msg << "[ReebSpace] " << simplifiedSheets << " 3-sheets simplified in "
+    msg << "[ReebSpace] " << mergeNumber << " 3-sheets simplified in "
       << t.getElapsedTime() << " s. (" << threadNumber_ << " thread(s))" 
       << endl;
-    if(simplifiedSheets){
+    if(mergeNumber){
       msg << "[ReebSpace] Last 3-sheet simplified at threshold "
-        << lastThreshold << endl;
+        << hierarchy.values_[mergeNumber - 1] << endl;
     }
     msg << "[ReebSpace] " << simplificationId << " 3-sheets left." << endl;
     dMsg(cout, msg.str(), timeMsg);
@@ -1589,6 +1968,66 @@ int ReebSpace::simplifySheets(const double &simplificationThreshold,
   return 0;
 }
 
+int ReebSpace::undo3sheetMerge(const int &mergeId){
+
+  SimplificationHierarchy &hierarchy = simplificationHierarchy_;
+  
+  int prunedId = hierarchy.prunedIds_[mergeId];
+  int mergerId = hierarchy.mergerIds_[mergeId];
+  
+  Sheet3 &prunedSheet = currentData_.sheet3List_[prunedId];
+  
+  prunedSheet.pruned_ = false;
+  
+  // values overwritten by apply3sheetMerge(), in reverse order
+  SimplificationHierarchy::MergeUndo &undo = hierarchy.undoList_.back();
+  for(int i = (int) undo.flags_.size() - 1; i >= 0; i--){
+    *(undo.flags_[i].first) = undo.flags_[i].second;
+  }
+  for(int i = (int) undo.values_.size() - 1; i >= 0; i--){
+    *(undo.values_[i].first) = undo.values_[i].second;
+  }
+  for(int i = (int) undo.lists_.size() - 1; i >= 0; i--){
+    undo.lists_[i].first->swap(undo.lists_[i].second);
+  }
+  hierarchy.undoList_.pop_back();
+  
+  if(mergerId == -1)
+    return 0;
+  
+  Sheet3 &mergerSheet = currentData_.sheet3List_[mergerId];
+  
+  // the pruned vertices and tets were appended to the merger's
+  mergerSheet.vertexList_.resize(
+    mergerSheet.vertexList_.size() - prunedSheet.vertexList_.size());
+  mergerSheet.tetList_.resize(
+    mergerSheet.tetList_.size() - prunedSheet.tetList_.size());
+  
+  for(int i = 0; i < (int) prunedSheet.vertexList_.size(); i++){
+    currentData_.vertex2sheet3_[prunedSheet.vertexList_[i]] = prunedId;
+  }
+  for(int i = 0; i < (int) prunedSheet.tetList_.size(); i++){
+    currentData_.tet2sheet3_[prunedSheet.tetList_[i]] = prunedId;
+  }
+  
+  // restore the measures (exactly) from the previous merge into the merger
+  int previousMergeId = hierarchy.previousMergeIds_[mergeId];
+  if(previousMergeId == -1){
+    mergerSheet.domainVolume_ = 
+      originalData_.sheet3List_[mergerId].domainVolume_;
+    mergerSheet.rangeArea_ = originalData_.sheet3List_[mergerId].rangeArea_;
+    mergerSheet.hyperVolume_ = 
+      originalData_.sheet3List_[mergerId].hyperVolume_;
+  }
+  else{
+    mergerSheet.domainVolume_ = hierarchy.domainVolumes_[previousMergeId];
+    mergerSheet.rangeArea_ = hierarchy.rangeAreas_[previousMergeId];
+    mergerSheet.hyperVolume_ = hierarchy.hyperVolumes_[previousMergeId];
+  }
+  
+  return 0;
+}
+
 // int ReebSpace::triangulateTetrahedron(const int &tetId, 
 //   const vector<vector<int> > &triangles,
 //   vector<long long int> &outputTets){
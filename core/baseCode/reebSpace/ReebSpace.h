@@ -39,7 +39,9 @@
 // to add FiberSurface.h
 #include                  <Wrapper.h>
 
+#include                  <atomic>
 #include                  <map>
+#include                  <queue>
 #include                  <set>
 
 namespace ttk{
@@ -226,6 +228,12 @@ namespace ttk{
         return 0;
       }
      
+#ifdef withrangeDrivenOctree
+      inline int setOctreeFileName(const string &fileName){
+        return fiberSurface_.setOctreeFileName(fileName);
+      }
+#endif
+      
       inline bool setRangeDrivenOctree(const bool &onOff){
        
         if(onOff != withRangeDrivenOctree_){
@@ -306,6 +314,16 @@ namespace ttk{
     
       class ReebSpaceData;
       
+      // apply the mergeId-th merge of the simplification hierarchy to 
+      // currentData_ (3-sheets, their connections and the 1-sheets it 
+      // updates), saving the overwritten values for undo3sheetMerge().
+      int apply3sheetMerge(const int &mergeId);
+      
+      // simplify all the 3-sheets with the given criterion and record the 
+      // merge sequence.
+      int buildSimplificationHierarchy(
+        const SimplificationCriterion &simplificationCriterion);
+      
       int compute1sheetsOnly(const vector<pair<int, char> > &jacobiSet,
         vector<pair<int, int> > &jacobiSetClassification);
       
@@ -319,10 +337,19 @@ namespace ttk{
       template <class dataTypeU, class dataTypeV>
         inline int compute2sheetChambers();
       
-      int compute3sheet(const int &vertexId, 
+      // flood the 3-sheet sheetId from its seed vertex (the vertices of the
+      // other 3-sheets have a different root in sheetRoots).
+      int compute3sheet(const int &vertexId, const int &sheetId,
+        const vector<int> &sheetRoots,
         const vector<vector<vector<int> > > &tetTriangles);
       
       int compute3sheets(vector<vector<vector<int> > > &tetTriangles);
+      
+      // true if the edge (vertexId, otherVertexId) of the tetrahedron tetId 
+      // is cut by a fiber surface triangle.
+      bool is3sheetEdgeCut(const int &vertexId, const int &otherVertexId,
+        const int &tetId,
+        const vector<vector<vector<int> > > &tetTriangles) const;
         
       template <class dataTypeU, class dataTypeV>
         inline int computeGeometricalMeasures(Sheet3 &sheet);
@@ -344,6 +371,41 @@ namespace ttk{
         const int &sheet3Id, const int &otherSheet3Id);
       
       int connectSheets();
+      
+      // lock-free union-find (the root of a set is its smallest element).
+      inline int find3sheetRoot(vector<atomic<int> > &parents, 
+        int vertexId) const{
+        
+        int parentId = parents[vertexId].load();
+        while(parentId != vertexId){
+          // path halving
+          int grandParentId = parents[parentId].load();
+          parents[vertexId].compare_exchange_weak(parentId, grandParentId);
+          vertexId = grandParentId;
+          parentId = parents[vertexId].load();
+        }
+        return vertexId;
+      }
+      
+      inline int union3sheetRoots(vector<atomic<int> > &parents,
+        int vertexId0, int vertexId1) const{
+        
+        do{
+          vertexId0 = find3sheetRoot(parents, vertexId0);
+          vertexId1 = find3sheetRoot(parents, vertexId1);
+          
+          if(vertexId0 == vertexId1)
+            return 0;
+          
+          // attach the bigger root to the smaller one
+          if(vertexId0 < vertexId1)
+            swap(vertexId0, vertexId1);
+          
+        }while(!parents[vertexId0].compare_exchange_strong(
+          vertexId0, vertexId1));
+        
+        return 0;
+      }
         
       int disconnect1sheetFrom0sheet(ReebSpaceData &data,
         const int &sheet1Id, const int &sheet0Id, const int &biggerId);
@@ -370,11 +432,42 @@ namespace ttk{
      
       int printConnectivity(ostream &stream, const ReebSpaceData &data) const;
       
+      // the 1-sheet sheet1Id no longer separates 3-sheets (biggerId is the 
+      // 3-sheet its vertices get attached to).
+      int prune1sheet(ReebSpaceData &data, 
+        const int &sheet1Id, const int &biggerId);
+      
       int simplifySheets(const double &simplificationThreshold,
         const SimplificationCriterion &simplificationCriterion);
      
+      // mergerId: 3-sheet in which sheetId has been merged (-1 if none).
       int simplifySheet(const int &sheetId, 
-        const SimplificationCriterion &simplificationCriterion);
+        const SimplificationCriterion &simplificationCriterion,
+        int &mergerId);
+      
+      // normalized score of a 3-sheet for the simplification.
+      inline double get3sheetValue(const int &sheetId,
+        const SimplificationCriterion &simplificationCriterion) const{
+        
+        switch(simplificationCriterion){
+          
+          case domainVolume:
+            return currentData_.sheet3List_[sheetId].domainVolume_
+              /totalVolume_;
+            
+          case rangeArea:
+            return currentData_.sheet3List_[sheetId].rangeArea_/totalArea_;
+            
+          case hyperVolume:
+            return currentData_.sheet3List_[sheetId].hyperVolume_
+              /totalHyperVolume_;
+        }
+        
+        return 0;
+      }
+      
+      // revert apply3sheetMerge() (merges are undone in reverse order).
+      int undo3sheetMerge(const int &mergeId);
       
 //       int triangulateTetrahedron(const int &tetId,
 //         const vector<vector<int> > &triangles,
@@ -418,6 +511,55 @@ namespace ttk{
                             withRangeDrivenOctree_;
       ReebSpaceData         originalData_, currentData_; 
       
+      // merge sequence of the 3-sheet simplification, computed once per 
+      // criterion. a given threshold simplifies a prefix of the sequence.
+      class SimplificationHierarchy{
+        
+        public:
+          
+          bool                isBuilt_;
+          SimplificationCriterion
+                              criterion_;
+          // number of merges applied to currentData_
+          int                 mergeNumber_;
+          
+          // i-th merge: the 3-sheet prunedIds_[i] gets merged into 
+          // mergerIds_[i] (-1 if none) for thresholds above values_[i] 
+          // (non-decreasing).
+          vector<int>         prunedIds_, mergerIds_;
+          vector<double>      values_;
+          // measures of mergerIds_[i] after the i-th merge and previous merge
+          // into mergerIds_[i] (-1 if none).
+          vector<double>      domainVolumes_, rangeAreas_, hyperVolumes_;
+          vector<int>         previousMergeIds_;
+          
+          // 3-sheet lists of the 1-sheets updated by the i-th merge, in 
+          // [sheet1Offsets_[i], sheet1Offsets_[i + 1]).
+          vector<int>         sheet1Offsets_, sheet1Ids_;
+          vector<vector<int> >
+                              sheet1Lists_;
+          
+          // values overwritten by each applied merge, in application order
+          class MergeUndo{
+            
+            public:
+              
+              vector<pair<vector<int> *, vector<int> > >
+                                  lists_;
+              vector<pair<int *, int> >
+                                  values_;
+              vector<pair<bool *, bool> >
+                                  flags_;
+          };
+          vector<MergeUndo>   undoList_;
+          
+          // 1-sheets pruned as orphans at the current threshold
+          vector<int>         orphanIds_;
+      };
+      
+      SimplificationHierarchy
+                            simplificationHierarchy_;
+      
       // information that does not get simplified
       vector<pair<int, char> >
                             jacobiSetEdges_;
@@ -890,11 +1032,6 @@ template <class dataTypeU, class dataTypeV>
     dMsg(cout, msg.str(), timeMsg);
   }
   
-  if(!((criterion == currentData_.simplificationCriterion_)
-    &&(simplificationThreshold > currentData_.simplificationThreshold_))){
-    prepareSimplification();
-  }
-  
   simplifySheets(simplificationThreshold, criterion);
   
   return 0;
@@ -945,7 +945,7 @@ namespace ttk{
       /// the grid. This vector has 3 entries (first: x, second: y, third: z).
       /// \return Returns 0 upon success, negative values otherwise (for 
       /// instance, if the object is not representing a regular grid).
-      inline int getGridDimensions(vector<int> &dimensions){
+      inline int getGridDimensions(vector<int> &dimensions) const{
         
         if((gridDimensions_[0] == -1)
           &&(gridDimensions_[1] == -1)
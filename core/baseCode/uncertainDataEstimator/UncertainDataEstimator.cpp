@@ -6,10 +6,15 @@ UncertainDataEstimator::UncertainDataEstimator(){
   outputLowerBoundField_ = NULL;
   outputUpperBoundField_ = NULL;
   outputProbability_ = NULL;
+  outputMeanField_ = NULL;
+  outputVarianceField_ = NULL;
   binValues_ = NULL;
   vertexNumber_ = 0;
   numberOfInputs_ = 0;
   binCount_ = 0;
+  numberOfRealizations_ = 0;
+  histogramRange_[0] = 0;
+  histogramRange_[1] = 0;
 }
 
 UncertainDataEstimator::~UncertainDataEstimator(){
@@ -21,3 +26,40 @@ UncertainDataEstimator::~UncertainDataEstimator(){
     free(outputProbability_);
 }
 
+int UncertainDataEstimator::finalizeHistograms(){
+
+#ifndef withKamikaze
+  if(!outputProbability_)
+    return -1;
+#endif
+
+  double **outputProbability = (double **) outputProbability_;
+
+  histograms_.normalize();
+  for(int b=0 ; b<binCount_ ; b++){
+    if(outputProbability[b])
+      histograms_.getBinField(b, outputProbability[b]);
+  }
+
+  return 0;
+}
+
+int UncertainDataEstimator::setupHistograms(const double &rangeMin, 
+  const double &rangeMax){
+
+  // Interval between bins
+  double dx = (rangeMax-rangeMin) / (double)binCount_;
+
+  // Bin values
+  for(int b=0 ; b<binCount_ ; b++){
+    binValues_[b] = rangeMin+(dx/2.0) + (double)b * dx;
+  }
+
+  histograms_.flush();
+  histograms_.setThreadNumber(threadNumber_);
+  histograms_.setNumberOfBins(binCount_);
+  histograms_.setNumberOfVertices(vertexNumber_);
+  histograms_.setRange(rangeMin, rangeMax);
+
+  return 0;
+}
@@ -50,16 +50,17 @@ namespace ttk{
           lowerBound_[i] = inputData[i];
         }
       } else { /* Update the two fields with the new input */
+        // branch-free (vectorizable) updates
+        dataType *upperBound = upperBound_.data();
+        dataType *lowerBound = lowerBound_.data();
         #pragma omp parallel for num_threads(threadNumber_)
         for (size_t i = 0 ; i < numberOfVertices ; i++) {
           // Upper Bound
-          if (inputData[i] > upperBound_[i]) {
-            upperBound_[i] = inputData[i];
-          }
+          upperBound[i] = 
+            (inputData[i] > upperBound[i]) ? inputData[i] : upperBound[i];
           // Lower Bound
-          if (inputData[i] < lowerBound_[i]) {
-            lowerBound_[i] = inputData[i];
-          }
+          lowerBound[i] = 
+            (inputData[i] < lowerBound[i]) ? inputData[i] : lowerBound[i];
         }
       }
       return 0;
@@ -126,13 +127,19 @@ namespace ttk{
     vector<dataType> lowerBound_;
   };
 
+  // Vertexwise histograms of an ensemble. The counts of each vertex are 
+  // stored in a few (bin, count) slots on 16 bits each, which is enough for 
+  // the vertices hitting a handful of bins only. The others are moved to a 
+  // dense row of 16-bit counts. Bin fields are computed on demand.
   class PDFHistograms : public Debug {
   public:
 
     PDFHistograms() {
       numberOfBins_ = 0;
       numberOfInputs_ = 0;
+      numberOfSlots_ = 4;
       numberOfVertices_ = 0;
+      normalization_ = 1.0;
       rangeMax_ = 0;
       rangeMin_ = 0;
     }
@@ -154,20 +161,41 @@ namespace ttk{
         return -3; // Number of vertices not defined
       }
       #endif
+      if((numberOfInputs_ >= maximumCount_)||(numberOfBins_ > maximumCount_)) {
+        return -4; // Counts and bins are stored on 16 bits
+      }
       if(numberOfInputs_ == 0) {
         /* Initialize */
-        probability_.resize(numberOfBins_);
+        binValue_.resize(numberOfBins_);
         double dx = (rangeMax_-rangeMin_) / static_cast<double>(numberOfBins_);
         for (size_t i=0 ; i < numberOfBins_ ; i++) {
-          probability_[i].resize(numberOfVertices_);
           binValue_[i] = rangeMin_+(dx/2.0)+(static_cast<double>(i)*dx);
         }
+        slots_.resize(numberOfSlots_*numberOfVertices_);
+        fill(slots_.begin(), slots_.end(), 0);
+        overflowCounts_.clear();
+        normalization_ = 1.0;
       }
+      binFields_.clear();
       /* Add input datas */
-      for(unsigned int i=0 ; i<numberOfVertices_ ; i++) {
-        unsigned int bin = static_cast<unsigned int>(floor((inputData[i]-rangeMin_)*numberOfBins_/(rangeMax_-rangeMin_)));
-        bin = (bin == numberOfBins_) ? numberOfBins_-1 : bin;
-        probability_[bin][i] += 1.0;
+      // vertices running out of slots are moved to a dense row afterwards
+      vector<vector<unsigned int> > overflowVertices(threadNumber_);
+      #pragma omp parallel for num_threads(threadNumber_)
+      for(int i=0 ; i< (int) numberOfVertices_ ; i++) {
+        if(addToSlots(i, getBin(inputData[i])) < 0) {
+          int threadId = 0;
+          #ifdef withOpenMP
+          threadId = omp_get_thread_num();
+          #endif
+          overflowVertices[threadId].push_back(i);
+        }
+      }
+      for(int i=0 ; i< (int) overflowVertices.size() ; i++) {
+        for(int j=0 ; j< (int) overflowVertices[i].size() ; j++) {
+          unsigned int vertexId = overflowVertices[i][j];
+          moveToOverflow(vertexId);
+          addToSlots(vertexId, getBin(inputData[vertexId]));
+        }
       }
       numberOfInputs_++;
       return 0;
@@ -175,18 +203,45 @@ namespace ttk{
 
     inline int flush() {
       binValue_.clear();
+      binFields_.clear();
+      slots_.clear();
+      overflowCounts_.clear();
       numberOfBins_ = 0;
       numberOfInputs_ = 0;
       numberOfVertices_ = 0;
+      normalization_ = 1.0;
       rangeMax_ = 0;
       rangeMin_ = 0;
       // selection_.clear(); // TODO : selection support
       return 0;
     }
 
+    /// Write the field of a bin in a caller-allocated array.
+    int getBinField(const unsigned int binId, double *binField) const {
+      if((binId >= numberOfBins_)||(!binField)) {
+        return -1;
+      }
+      #pragma omp parallel for num_threads(threadNumber_)
+      for(int i=0 ; i< (int) numberOfVertices_ ; i++) {
+        binField[i] = getVertexCount(i, binId)*normalization_;
+      }
+      return 0;
+    }
+
+    /// The returned field is computed on the first call (for each bin) and 
+    /// remains valid until the next call to evaluateRealization(), 
+    /// normalize() or flush().
     inline double* getBinFieldPointer(const unsigned int binId) {
       if(binId < numberOfBins_) {
-        return probability_[binId].data();
+        if(binFields_.size() != numberOfBins_) {
+          binFields_.resize(numberOfBins_);
+        }
+        vector<double> &binField = binFields_[binId];
+        if(binField.size() != numberOfVertices_) {
+          binField.resize(numberOfVertices_);
+          getBinField(binId, binField.data());
+        }
+        return binField.data();
       } else {
         return NULL;
       }
@@ -194,38 +249,30 @@ namespace ttk{
 
     void getVertexHistogram(const unsigned int vertexId, vector<double> &histogram) const {
       histogram.resize(numberOfBins_);
-      if(vertexId < numberOfVertices_) {
-        #ifdef _WIN32
-        #pragma omp parallel for num_threads(threadNumber_)
-        #else
-        #pragma omp parallel for num_threads(threadNumber_) \
-          schedule(static, numberOfBins_/threadNumber_)
-        #endif
-        for(int i=0 ; i< (int) numberOfBins_ ; i++) {
-          if(probability_[i].size()==numberOfVertices_) {
-            histogram[i] = probability_[i][vertexId];
-          } else {
-            histogram[i] = 0.0;
+      fill(histogram.begin(), histogram.end(), 0.0);
+      if((vertexId < numberOfVertices_)
+        &&(slots_.size() == numberOfSlots_*numberOfVertices_)) {
+        const unsigned int *slots = &(slots_[numberOfSlots_*vertexId]);
+        if(slots[0] == overflowSlot_) {
+          const unsigned short *counts = 
+            &(overflowCounts_[numberOfBins_*slots[1]]);
+          for(int i=0 ; i< (int) numberOfBins_ ; i++) {
+            histogram[i] = counts[i]*normalization_;
+          }
+        } else {
+          for(int i=0 ; i< (int) numberOfSlots_ ; i++) {
+            if(slots[i] & maximumCount_) {
+              histogram[slots[i] >> 16] = (slots[i] & maximumCount_)
+                *normalization_;
+            }
           }
         }
-      } else {
-        fill(histogram.begin(), histogram.end(), 0.0);
       }
     }
 
     int normalize() {
-      const double normalization = 1.0 / static_cast<double>(numberOfInputs_);
-      #ifdef _WIN32
-      #pragma omp parallel for num_threads(threadNumber_)
-      #else
-      #pragma omp parallel for num_threads(threadNumber_) collapse(2) \
-        schedule(static, (numberOfBins_*numberOfVertices_)/threadNumber_)
-      #endif
-      for(int i=0 ; i< (int) numberOfBins_ ; i++) {
-        for(int j=0 ; j< (int) numberOfVertices_ ; j++) {
-          probability_[i][j] *= normalization;
-        }
-      }
+      normalization_ = 1.0 / static_cast<double>(numberOfInputs_);
+      binFields_.clear();
       return 0;
     }
 
@@ -234,6 +281,13 @@ namespace ttk{
       return 0;
     }
 
+    /// Set the number of (bin, count) slots per vertex (at least 2) before
+    /// the first realization.
+    inline int setNumberOfSlots(const unsigned int number) {
+      numberOfSlots_ = (number < 2) ? 2 : number;
+      return 0;
+    }
+
     inline int setNumberOfVertices(const unsigned int number) {
       numberOfVertices_ = number;
       return 0;
@@ -246,11 +300,88 @@ namespace ttk{
     }
 
   protected:
+
+    // 16-bit counts, a slot packs a bin (high bits) and a count (low bits).
+    // the first slot of a vertex moved to a dense row is overflowSlot_ and 
+    // its second one the row index.
+    static const unsigned int maximumCount_ = 0xFFFF;
+    static const unsigned int overflowSlot_ = 0xFFFFFFFF;
+
+    // returns -1 if the vertex has no free slot left.
+    inline int addToSlots(const unsigned int vertexId, 
+      const unsigned int bin) {
+      unsigned int *slots = &(slots_[numberOfSlots_*vertexId]);
+      if(slots[0] == overflowSlot_) {
+        overflowCounts_[numberOfBins_*slots[1] + bin]++;
+        return 0;
+      }
+      for(int i=0 ; i< (int) numberOfSlots_ ; i++) {
+        if(!(slots[i] & maximumCount_)) {
+          slots[i] = (bin << 16) | 1;
+          return 0;
+        }
+        if((slots[i] >> 16) == bin) {
+          slots[i]++;
+          return 0;
+        }
+      }
+      return -1;
+    }
+
+    template <class dataType>
+    inline unsigned int getBin(const dataType &value) const {
+      if((!(rangeMin_<rangeMax_))||(!(value > rangeMin_))) {
+        return 0;
+      }
+      if(!(value < rangeMax_)) {
+        return numberOfBins_-1;
+      }
+      unsigned int bin = static_cast<unsigned int>(floor((value-rangeMin_)*numberOfBins_/(rangeMax_-rangeMin_)));
+      return (bin == numberOfBins_) ? numberOfBins_-1 : bin;
+    }
+
+    inline unsigned int getVertexCount(const unsigned int vertexId, 
+      const unsigned int binId) const {
+      if(slots_.size() != numberOfSlots_*numberOfVertices_) {
+        return 0;
+      }
+      const unsigned int *slots = &(slots_[numberOfSlots_*vertexId]);
+      if(slots[0] == overflowSlot_) {
+        return overflowCounts_[numberOfBins_*slots[1] + binId];
+      }
+      for(int i=0 ; i< (int) numberOfSlots_ ; i++) {
+        if(((slots[i] & maximumCount_))&&((slots[i] >> 16) == binId)) {
+          return slots[i] & maximumCount_;
+        }
+      }
+      return 0;
+    }
+
+    inline int moveToOverflow(const unsigned int vertexId) {
+      unsigned int *slots = &(slots_[numberOfSlots_*vertexId]);
+      unsigned int rowId = overflowCounts_.size()/numberOfBins_;
+      overflowCounts_.resize(overflowCounts_.size() + numberOfBins_, 0);
+      unsigned short *counts = &(overflowCounts_[numberOfBins_*rowId]);
+      for(int i=0 ; i< (int) numberOfSlots_ ; i++) {
+        if(slots[i] & maximumCount_) {
+          counts[slots[i] >> 16] = slots[i] & maximumCount_;
+        }
+        slots[i] = 0;
+      }
+      slots[0] = overflowSlot_;
+      slots[1] = rowId;
+      return 0;
+    }
+
     vector<double>            binValue_;
-    vector<vector<double> >   probability_;
+    vector<vector<double> >   binFields_;
+    vector<unsigned int>      slots_;
+    vector<unsigned short>    overflowCounts_;
     unsigned int              numberOfBins_;
     unsigned int              numberOfInputs_;
+    unsigned int              numberOfSlots_;
     unsigned int              numberOfVertices_;
+    double                    normalization_;
     double                    rangeMin_;
     double                    rangeMax_;
     // vector<int> selection_; // TODO : selection support
@@ -264,10 +395,61 @@ namespace ttk{
 
       ~UncertainDataEstimator();
 
-      /// Execute the package.
+      /// Execute the package on the input scalar fields (see 
+      /// setInputDataPointer()).
+      /// \return Returns 0 upon success, negative values otherwise.
+      template <class dataType>
+        int execute();
+
+      /// Accumulate a realization into the output bound, mean and variance
+      /// fields. The realizations can be passed one at a time (for instance, 
+      /// while reading them from disk), none of them is kept. If a histogram
+      /// range is set (see setHistogramRange()), the realization is also 
+      /// accumulated into the histograms.
+      /// \param data Pointer to the realization.
       /// \return Returns 0 upon success, negative values otherwise.
+      /// \sa finalize()
       template <class dataType>
-        int execute() const;
+        int addRealization(const void *data);
+
+      /// Accumulate a realization into the histograms, when no histogram 
+      /// range is set. This second pass over the realizations requires the 
+      /// range of the bounds, hence a prior call to finalize().
+      /// \param data Pointer to the realization.
+      /// \return Returns 0 upon success, negative values otherwise.
+      /// \sa finalizeHistograms()
+      template <class dataType>
+        int addHistogramRealization(const void *data);
+
+      /// Finalize the output mean and variance fields and, if no histogram
+      /// range is set and both bounds are computed, set the range and the 
+      /// bin values of the histograms from the bounds.
+      /// \return Returns 0 upon success, negative values otherwise.
+      template <class dataType>
+        int finalize();
+
+      /// Write the output probability fields.
+      /// \return Returns 0 upon success, negative values otherwise.
+      int finalizeHistograms();
+
+      /// Start a new accumulation.
+      inline int reset(){
+        numberOfRealizations_ = 0;
+        histograms_.flush();
+        return 0;
+      }
+
+      /// Set the range of the histograms, such that they are accumulated in
+      /// the addRealization() pass (the realizations are then read only 
+      /// once). The values out of the range are counted in the first or the 
+      /// last bin. An empty range (rangeMin >= rangeMax, default) derives the 
+      /// range from the bounds, in a second pass.
+      inline int setHistogramRange(const double &rangeMin, 
+        const double &rangeMax){
+        histogramRange_[0] = rangeMin;
+        histogramRange_[1] = rangeMax;
+        return 0;
+      }
 
       /// Pass a pointer to an input array representing a scalarfield.
       /// The array is expected to be correctly allocated. idx in [0,numberOfInputs_[
@@ -318,6 +500,13 @@ namespace ttk{
         return 0;
       }
 
+      /// Pass a pointer to an (optional) output array of doubles 
+      /// representing the variance scalar field.
+      inline int setOutputVarianceField(void *data) {
+        outputVarianceField_ = data;
+        return 0;
+      }
+
 
       inline int setComputeLowerBound(const bool &state){
         computeLowerBound_ = state;
@@ -379,10 +568,18 @@ namespace ttk{
 
     protected:
 
+      inline bool hasHistogramRange() const{
+        return (binCount_ > 0)&&(histogramRange_[0] < histogramRange_[1]);
+      }
+
+      // set the bin values and configure the histograms.
+      int setupHistograms(const double &rangeMin, const double &rangeMax);
+
       int                   vertexNumber_;
       int                   numberOfInputs_;
       int                   binCount_;
       double                *binValues_; //TODO : vector<double>
+      double                histogramRange_[2];
       bool                  computeLowerBound_;
       bool                  computeUpperBound_;
       void                  **inputData_; //TODO : vector<void*>
@@ -390,6 +587,10 @@ namespace ttk{
       void                  *outputUpperBoundField_;
       void                  **outputProbability_; //TODO : vector<void*>
       void                  *outputMeanField_;
+      void                  *outputVarianceField_;
+      // number of realizations added since the last reset()
+      int                   numberOfRealizations_;
+      PDFHistograms         histograms_;
   };
 }
 
@@ -397,103 +598,114 @@ namespace ttk{
 // #include                  <UncertainDataEstimator.cpp>
 
 // template functions
-template <class dataType> int UncertainDataEstimator::execute() const{
+template <class dataType> 
+  int UncertainDataEstimator::addRealization(const void *data){
 
-  Timer t;
-
-  // Check the consistency of the variables
 #ifndef withKamikaze
-  if(!numberOfInputs_)
-    return -1;
   if(!vertexNumber_)
+    return -1;
+  if(!data)
     return -2;
-  if(!inputData_)
+  if((computeLowerBound_)&&(!outputLowerBoundField_))
     return -3;
-
-  for(int i=0 ; i<numberOfInputs_ ; i++){
-      if(!inputData_[i])
-        return -4;
-    }
-  if(!outputLowerBoundField_)
+  if((computeUpperBound_)&&(!outputUpperBoundField_))
+    return -4;
+  if(!outputMeanField_)
     return -5;
-  if(!outputUpperBoundField_)
-    return -6;
 #endif
 
-  int count = 0;
+  const dataType *inputData = (const dataType *) data;
+  
+  // single pass histograms
+  if(hasHistogramRange()){
+    if(!numberOfRealizations_)
+      setupHistograms(histogramRange_[0], histogramRange_[1]);
+    if(histograms_.evaluateRealization(inputData)){
+      stringstream msg;
+      msg << "[UncertainDataEstimator] Too many realizations or bins for "
+        << "16-bit histogram counts." << endl;
+      dMsg(cerr, msg.str(), fatalMsg);
+      return -6;
+    }
+  }
 
-  // Pointers type casting
   dataType *outputLowerBoundField = (dataType *) outputLowerBoundField_;
   dataType *outputUpperBoundField = (dataType *) outputUpperBoundField_;
-  double **outputProbability = (double **) outputProbability_;
-  dataType **inputData = (dataType **) inputData_;
   double *outputMeanField = static_cast<double*>(outputMeanField_);
+  // sum of the squared deviations until finalize()
+  double *outputVarianceField = static_cast<double*>(outputVarianceField_);
 
+  const bool isFirst = !numberOfRealizations_;
+  const double weight = 1.0/(numberOfRealizations_ + 1.0);
 
 #ifdef withOpenMP
-  omp_lock_t writeLock;
-  omp_init_lock(&writeLock);
 #pragma omp parallel for num_threads(threadNumber_)
 #endif
+  for(int v=0 ; v<vertexNumber_ ; v++){
 
-  for(int v = 0; v < (int) vertexNumber_; v++){
+    const dataType value = inputData[v];
 
-    // Avoid any processing if the abort signal is sent
-    if((!wrapper_)||((wrapper_)&&(!wrapper_->needsToAbort()))){
-
-      // For the lower bound scalar field
-      if(computeLowerBound_){
-        // Initialisation : values of the first input
-        outputLowerBoundField[v] = inputData[0][v];
-        // Loop over the inputs
-        for(int inp=1 ; inp < numberOfInputs_ ; inp++){
-          // Minimum value
-          if(computeLowerBound_)
-            if(inputData[inp][v] < outputLowerBoundField[v])
-              outputLowerBoundField[v] = inputData[inp][v];
-        }
-      }
+    if(computeLowerBound_){
+      outputLowerBoundField[v] = 
+        ((isFirst)||(value < outputLowerBoundField[v])) 
+        ? value : outputLowerBoundField[v];
+    }
+    if(computeUpperBound_){
+      outputUpperBoundField[v] = 
+        ((isFirst)||(value > outputUpperBoundField[v])) 
+        ? value : outputUpperBoundField[v];
+    }
 
-      // For the upper bound scalar field
-      if(computeUpperBound_){
-        // Initialisation : values of the first input
-        outputUpperBoundField[v] = inputData[0][v];
-        // Loop over the inputs
-        for(int inp=1 ; inp < numberOfInputs_ ; inp++){
-          // Maximum value
-          if(computeUpperBound_)
-            if(inputData[inp][v] > outputUpperBoundField[v])
-              outputUpperBoundField[v] = inputData[inp][v];
-        }
-      }
+    // Welford's update
+    const double x = static_cast<double>(value);
+    const double mean = isFirst ? 0.0 : outputMeanField[v];
+    const double delta = x - mean;
+    outputMeanField[v] = mean + delta*weight;
+    if(outputVarianceField){
+      outputVarianceField[v] = (isFirst ? 0.0 : outputVarianceField[v])
+        + delta*(x - outputMeanField[v]);
+    }
+  }
 
-      // Update the progress bar of the wrapping code -- to adapt
-      if(debugLevel_ > advancedInfoMsg){
-#ifdef withOpenMP
-        omp_set_lock(&writeLock);
+  numberOfRealizations_++;
+
+  return 0;
+}
+
+template <class dataType> int UncertainDataEstimator::finalize(){
+
+#ifndef withKamikaze
+  if(!numberOfRealizations_)
+    return -1;
 #endif
-        if((wrapper_)
-          &&(!(count % ((vertexNumber_)/10)))){
-          wrapper_->updateProgress((count + 1.0)
-            /vertexNumber_);
-        }
 
-        count++;
+  double *outputVarianceField = static_cast<double*>(outputVarianceField_);
+  if(outputVarianceField){
+    const double numberOfRealizations = numberOfRealizations_;
 #ifdef withOpenMP
-        omp_unset_lock(&writeLock);
+#pragma omp parallel for num_threads(threadNumber_)
 #endif
-      }
+    for(int v=0 ; v<vertexNumber_ ; v++){
+      outputVarianceField[v] /= numberOfRealizations;
     }
   }
 
+  if(hasHistogramRange())
+    return 0;
+
+  histograms_.flush();
+
+  if((computeLowerBound_)&&(computeUpperBound_)&&(binCount_)){
+
+    const dataType *outputLowerBoundField = 
+      (const dataType *) outputLowerBoundField_;
+    const dataType *outputUpperBoundField = 
+      (const dataType *) outputUpperBoundField_;
 
-  // Histogram
-  if(computeUpperBound_ && computeLowerBound_){
     // Range
     double range[2];
     range[0] = outputLowerBoundField[0];
     range[1] = outputUpperBoundField[0];
-
     for(int v=0 ; v<vertexNumber_ ; v++){
       if(outputLowerBoundField[v] < range[0])
         range[0] = outputLowerBoundField[v];
@@ -501,42 +713,99 @@ template <class dataType> int UncertainDataEstimator::execute() const{
         range[1] = outputUpperBoundField[v];
     }
 
-    // Interval between bins
-    double dx = (range[1]-range[0]) / (double)binCount_;
+    setupHistograms(range[0], range[1]);
+  }
 
-    // Bin values
-    for(int b=0 ; b<binCount_ ; b++){
-      binValues_[b] = range[0]+(dx/2.0) + (double)b * dx;
-    }
+  return 0;
+}
 
-    int idx;
-    double increment = 1.0 / (double)numberOfInputs_;
-#ifdef withOpenMP
-#pragma omp parallel for private(idx) num_threads(threadNumber_)
+template <class dataType> 
+  int UncertainDataEstimator::addHistogramRealization(const void *data){
+
+#ifndef withKamikaze
+  if((!computeLowerBound_)||(!computeUpperBound_)||(!binCount_)
+    ||(hasHistogramRange()))
+    return -1;
+  if(!data)
+    return -2;
 #endif
-    for(int v=0 ; v<vertexNumber_ ; v++){
-      for(int i=0 ; i<numberOfInputs_ ; i++){
-        idx = (unsigned int) floor((inputData[i][v]-range[0])*binCount_/(range[1]-range[0]));
-        idx = (idx==binCount_) ? binCount_-1 : idx;
-        outputProbability[idx][v] += increment;
-      }
-    }
+
+  if(histograms_.evaluateRealization((const dataType *) data)){
+    stringstream msg;
+    msg << "[UncertainDataEstimator] Too many realizations or bins for "
+      << "16-bit histogram counts." << endl;
+    dMsg(cerr, msg.str(), fatalMsg);
+    return -3;
   }
 
-  // Mean field
-  for(int v=0 ; v<vertexNumber_ ; v++) {
-    double sum = 0.0;
-    for(int i=0 ; i<numberOfInputs_ ; i++) {
-      sum += static_cast<double>(inputData[i][v]);
+  return 0;
+}
+
+template <class dataType> int UncertainDataEstimator::execute(){
+
+  Timer t;
+
+  // Check the consistency of the variables
+#ifndef withKamikaze
+  if(!numberOfInputs_)
+    return -1;
+  if(!vertexNumber_)
+    return -2;
+  if(!inputData_)
+    return -3;
+
+  for(int i=0 ; i<numberOfInputs_ ; i++){
+      if(!inputData_[i])
+        return -4;
+    }
+  if(!outputLowerBoundField_)
+    return -5;
+  if(!outputUpperBoundField_)
+    return -6;
+#endif
+
+  // histograms in a second pass if their range is given by the bounds
+  const bool computeHistograms = (!hasHistogramRange())
+    && computeUpperBound_ && computeLowerBound_;
+
+  reset();
+
+  for(int i=0 ; i<numberOfInputs_ ; i++){
+
+    // Avoid any processing if the abort signal is sent
+    if((wrapper_)&&(wrapper_->needsToAbort()))
+      return -7;
+
+    if(addRealization<dataType>(inputData_[i]))
+      return -8;
+
+    // Update the progress bar of the wrapping code -- to adapt
+    if((wrapper_)&&(debugLevel_ > advancedInfoMsg)){
+      wrapper_->updateProgress((i + 1.0)
+        /(computeHistograms ? 2*numberOfInputs_ : numberOfInputs_));
     }
-    outputMeanField[v] = sum / static_cast<double>(numberOfInputs_);
   }
 
+  finalize<dataType>();
 
+  // Histogram (second pass, now that the range is known)
+  if(computeHistograms){
+    for(int i=0 ; i<numberOfInputs_ ; i++){
 
-#ifdef withOpenMP
-  omp_destroy_lock(&writeLock);
-#endif
+      if((wrapper_)&&(wrapper_->needsToAbort()))
+        return -7;
+
+      if(addHistogramRealization<dataType>(inputData_[i]))
+        return -8;
+
+      if((wrapper_)&&(debugLevel_ > advancedInfoMsg)){
+        wrapper_->updateProgress((numberOfInputs_ + i + 1.0)
+          /(2*numberOfInputs_));
+      }
+    }
+  }
+  if((computeHistograms)||(hasHistogramRange()))
+    finalizeHistograms();
 
   {
     stringstream msg;
@@ -0,0 +1,12 @@
+#include                  <VertexWelder.h>
+
+VertexWelder::VertexWelder(){
+
+  vertexNumber_ = 0;
+  distanceThreshold_ = 0;
+  inputData_ = NULL;
+}
+
+VertexWelder::~VertexWelder(){
+  
+}
@@ -0,0 +1,274 @@
+/// \ingroup baseCode
+/// \class ttk::VertexWelder
+/// \author agent <agent@local>
+/// \date October 2026.
+///
+/// \brief TTK processing package that welds the vertices of a point set which
+/// are closer than a given distance threshold.
+///
+/// The points are hashed into a uniform grid whose cells are twice as large as
+/// the distance threshold, such that two points to weld always lie in the 
+/// same or in adjacent grid cells. Each point is then compared to the points 
+/// of the (at most 8) neighbor cells reached by its threshold ball only, which
+/// makes the welding linear in the number of points (as opposed to sort-based
+/// approaches).
+///
+/// Each point is attached to the smallest point identifier it can be welded
+/// with. A zero distance threshold welds exactly coincident points only.
+///
+/// \sa ttk::FiberSurface
+/// \sa vtkMeshSubdivision.cpp %for a usage example.
+
+#ifndef _VERTEXWELDER_H
+#define _VERTEXWELDER_H
+
+#include                  <cstring>
+
+// base code includes
+#include                  <Geometry.h>
+#include                  <Wrapper.h>
+
+
+namespace ttk{
+
+  class VertexWelder : public Debug{
+
+    public:
+
+      VertexWelder();
+
+      ~VertexWelder();
+
+      /// Execute the package.
+      /// \param weldedIds Output vector storing, for each input point, the
+      /// identifier of its welded vertex. Welded vertices are numbered in the
+      /// order of their first input point.
+      /// \param weldedVertexNumber Output number of welded vertices.
+      /// \return Returns 0 upon success, negative values otherwise.
+      template <class dataType>
+        inline int execute(vector<int> &weldedIds,
+          int &weldedVertexNumber) const{
+          return execute<dataType>(weldedIds, weldedVertexNumber,
+            [](const int &vertexId0, const int &vertexId1){ return true; });
+        }
+
+      /// Execute the package, only welding the pairs of points for which the
+      /// predicate \p canMerge (called with two input point identifiers)
+      /// returns true.
+      template <class dataType, class predicateType>
+        int execute(vector<int> &weldedIds, int &weldedVertexNumber,
+          const predicateType &canMerge) const;
+
+      /// Set the maximum distance between two points to weld.
+      inline int setDistanceThreshold(const double &threshold){
+        distanceThreshold_ = threshold;
+        return 0;
+      }
+
+      /// Pass a pointer to an input array representing a 3D point set.
+      /// The expected format for the array is the following:
+      /// <vertex0-x> <vertex0-y> <vertex0-z> <vertex1-x> <vertex1-y> ...
+      /// The array is expected to be correctly allocated.
+      /// \param data Pointer to the data array.
+      /// \return Returns 0 upon success, negative values otherwise.
+      /// \sa setVertexNumber().
+      inline int setInputDataPointer(const void *data){
+        inputData_ = data;
+        return 0;
+      }
+
+      inline int setVertexNumber(const int &vertexNumber){
+        vertexNumber_ = vertexNumber;
+        return 0;
+      }
+
+    protected:
+
+      inline unsigned long long int getCellHash(
+        const long long int *cell) const{
+
+        unsigned long long int hash =
+          ((unsigned long long int) cell[0])*0x9E3779B97F4A7C15ULL
+          ^ ((unsigned long long int) cell[1])*0xC2B2AE3D27D4EB4FULL
+          ^ ((unsigned long long int) cell[2])*0x165667B19E3779F9ULL;
+
+        return hash ^ (hash >> 32);
+      }
+
+      int                   vertexNumber_;
+      double                distanceThreshold_;
+      const void            *inputData_;
+  };
+}
+
+// template functions
+template <class dataType, class predicateType>
+  int VertexWelder::execute(vector<int> &weldedIds, int &weldedVertexNumber,
+    const predicateType &canMerge) const{
+
+  Timer t;
+
+#ifndef withKamikaze
+  if(!inputData_)
+    return -1;
+  if(vertexNumber_ < 0)
+    return -2;
+  if(distanceThreshold_ < 0)
+    return -3;
+#endif
+
+  const dataType *inputData = (const dataType *) inputData_;
+
+  // 1. grid cell of each point.
+  // with cells twice as large as the threshold, the neighborhood of a point
+  // overlaps at most two cells along each axis.
+  // with a zero threshold, the cell is given by the coordinates themselves
+  // and only exactly coincident points are compared.
+  const int cellRange = (distanceThreshold_ > 0) ? 1 : 0;
+  const double cellSize = 2*distanceThreshold_;
+
+  vector<long long int> cells(3*vertexNumber_);
+
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber_)
+#endif
+  for(int i = 0; i < vertexNumber_; i++){
+    for(int j = 0; j < 3; j++){
+      if(cellRange){
+        cells[3*i + j] =
+          (long long int) floor(inputData[3*i + j]/cellSize);
+      }
+      else{
+        // + 0 turns -0 into 0
+        double value = inputData[3*i + j] + 0.0;
+        memcpy(&(cells[3*i + j]), &value, sizeof(double));
+      }
+    }
+  }
+
+  // 2. bucket the points (counting sort on the cell hash).
+  // buckets list the points by increasing identifiers.
+  unsigned long long int bucketNumber = 1;
+  while(bucketNumber < 2*((unsigned long long int) vertexNumber_))
+    bucketNumber *= 2;
+
+  vector<int> pointBuckets(vertexNumber_);
+
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber_)
+#endif
+  for(int i = 0; i < vertexNumber_; i++){
+    pointBuckets[i] = getCellHash(&(cells[3*i])) & (bucketNumber - 1);
+  }
+
+  vector<int> bucketOffsets(bucketNumber + 1, 0);
+  for(int i = 0; i < vertexNumber_; i++){
+    bucketOffsets[pointBuckets[i] + 1]++;
+  }
+  for(unsigned long long int i = 0; i < bucketNumber; i++){
+    bucketOffsets[i + 1] += bucketOffsets[i];
+  }
+
+  vector<int> bucketPoints(vertexNumber_);
+  {
+    vector<int> bucketCursors(bucketOffsets.begin(), bucketOffsets.end() - 1);
+    for(int i = 0; i < vertexNumber_; i++){
+      bucketPoints[bucketCursors[pointBuckets[i]]] = i;
+      bucketCursors[pointBuckets[i]]++;
+    }
+  }
+  vector<int>().swap(pointBuckets);
+
+  // 3. attach each point to the smallest point it can be welded with, among
+  // the points of the neighbor cells.
+  vector<int> parents(vertexNumber_);
+
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber_)
+#endif
+  for(int i = 0; i < vertexNumber_; i++){
+
+    parents[i] = i;
+
+    double p[3];
+    for(int j = 0; j < 3; j++)
+      p[j] = inputData[3*i + j];
+
+    // neighbor cells reached by the threshold ball
+    int minOffset[3] = {0, 0, 0}, maxOffset[3] = {0, 0, 0};
+    for(int j = 0; (j < 3)&&(cellRange); j++){
+      if(p[j] - cells[3*i + j]*cellSize <= distanceThreshold_)
+        minOffset[j] = -1;
+      if((cells[3*i + j] + 1)*cellSize - p[j] <= distanceThreshold_)
+        maxOffset[j] = 1;
+    }
+
+    long long int neighborCell[3];
+    for(int dx = minOffset[0]; dx <= maxOffset[0]; dx++){
+      for(int dy = minOffset[1]; dy <= maxOffset[1]; dy++){
+        for(int dz = minOffset[2]; dz <= maxOffset[2]; dz++){
+
+          neighborCell[0] = cells[3*i] + dx;
+          neighborCell[1] = cells[3*i + 1] + dy;
+          neighborCell[2] = cells[3*i + 2] + dz;
+
+          int bucketId = getCellHash(neighborCell) & (bucketNumber - 1);
+
+          for(int j = bucketOffsets[bucketId];
+            j < bucketOffsets[bucketId + 1]; j++){
+
+            int candidateId = bucketPoints[j];
+
+            // points are listed by increasing identifiers
+            if(candidateId >= parents[i])
+              break;
+
+            // skip hash collisions
+            if((cells[3*candidateId] != neighborCell[0])
+              ||(cells[3*candidateId + 1] != neighborCell[1])
+              ||(cells[3*candidateId + 2] != neighborCell[2]))
+              continue;
+
+            double q[3];
+            for(int k = 0; k < 3; k++)
+              q[k] = inputData[3*candidateId + k];
+
+            if((Geometry::distance(p, q) <= distanceThreshold_)
+              &&(canMerge(i, candidateId))){
+              parents[i] = candidateId;
+              break;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  // 4. number the welded vertices.
+  // parents have smaller identifiers, hence they are already numbered.
+  weldedIds.resize(vertexNumber_);
+  weldedVertexNumber = 0;
+  for(int i = 0; i < vertexNumber_; i++){
+    if(parents[i] == i){
+      weldedIds[i] = weldedVertexNumber;
+      weldedVertexNumber++;
+    }
+    else{
+      weldedIds[i] = weldedIds[parents[i]];
+    }
+  }
+
+  {
+    stringstream msg;
+    msg << "[VertexWelder] " << vertexNumber_ << " points welded into "
+      << weldedVertexNumber << " vertices in "
+      << t.getElapsedTime() << " s. (" << threadNumber_
+      << " thread(s))."
+      << endl;
+    dMsg(cout, msg.str(), timeMsg);
+  }
+
+  return 0;
+}
+
+#endif // VERTEXWELDER_H
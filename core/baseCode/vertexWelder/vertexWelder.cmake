@@ -0,0 +1,4 @@
+ttk_add_baseCode_package(geometry)
+
+# if the package is a pure template class, comment the following line
+ttk_wrapup_library(libVertexWelder "VertexWelder.cpp")
@@ -10,6 +10,9 @@ ttkContinuousScatterPlot::ttkContinuousScatterPlot():
   SetNumberOfOutputPorts(1);
 
   ProjectImageSupport = true;
+  Progressive = false;
+  ProgressiveLevelNumber = 8;
+  ProgressiveErrorThreshold = 0;
   UcomponentId = 0;
   VcomponentId = 1;
   triangulation_ = NULL;
@@ -98,6 +101,37 @@ int ttkContinuousScatterPlot::getTriangulation(vtkDataSet* input){
   return 0;
 }
 
+int ttkContinuousScatterPlot::updateImage(
+  const vector<vector<double>>& density, const vector<vector<char>>& mask){
+
+  int id{};
+  for(int i=0; i<ScatterplotResolution[0]; i++){
+    for(int j=0; j<ScatterplotResolution[1]; j++){
+      maskScalars_->SetTuple1(id,mask[i][j]);
+      densityScalars_->SetTuple1(id,density[i][j]);
+      ++id;
+    }
+  }
+  maskScalars_->Modified();
+  densityScalars_->Modified();
+
+  return 0;
+}
+
+int ttkContinuousScatterPlot::progressiveSink(
+  const vector<vector<double>>& density, const vector<vector<char>>& mask,
+  const double& processedRatio, const double& error, void* sinkData){
+
+  ttkContinuousScatterPlot* filter=(ttkContinuousScatterPlot*) sinkData;
+
+  // refresh the output image in place and let the progress observers
+  // display it
+  filter->updateImage(density, mask);
+  filter->UpdateProgress(processedRatio);
+
+  return filter->needsToAbort();
+}
+
 int ttkContinuousScatterPlot::doIt(vector<vtkDataSet *> &inputs,
   vector<vtkDataSet *> &outputs){
   
@@ -173,76 +207,12 @@ int ttkContinuousScatterPlot::doIt(vector<vtkDataSet *> &inputs,
   }
 #endif
 
-  // calling the executing package
-  ContinuousScatterPlot continuousScatterPlot;
-  continuousScatterPlot.setWrapper(this);
-  continuousScatterPlot.setVertexNumber(numberOfPoints);
-  continuousScatterPlot.setDummyValue(WithDummyValue, DummyValue);
-  continuousScatterPlot.setTriangulation(triangulation_);
-  continuousScatterPlot.setResolutions(ScatterplotResolution[0],ScatterplotResolution[1]);
-  continuousScatterPlot.setInputScalarField1(inputScalars1_->GetVoidPointer(0));
-  continuousScatterPlot.setInputScalarField2(inputScalars2_->GetVoidPointer(0));
-  continuousScatterPlot.setScalarMin(scalarMin_);
-  continuousScatterPlot.setScalarMax(scalarMax_);
-  continuousScatterPlot.setOutputDensity(&density_);
-  continuousScatterPlot.setOutputMask(&validPointMask_);
-  switch(inputScalars1_->GetDataType()){
-    case VTK_CHAR:
-      switch(inputScalars2_->GetDataType()){
-        vtkTemplateMacro(({ret=continuousScatterPlot.execute<char,VTK_TT>();}));
-      }
-      break;
-    case VTK_UNSIGNED_CHAR:
-      switch(inputScalars2_->GetDataType()){
-        vtkTemplateMacro(({ret=continuousScatterPlot.execute<unsigned char,VTK_TT>();}));
-      }
-      break;
-    case VTK_SHORT:
-      switch(inputScalars2_->GetDataType()){
-        vtkTemplateMacro(({ret=continuousScatterPlot.execute<short,VTK_TT>();}));
-      }
-      break;
-    case VTK_UNSIGNED_SHORT:
-      switch(inputScalars2_->GetDataType()){
-        vtkTemplateMacro(({ret=continuousScatterPlot.execute<unsigned short,VTK_TT>();}));
-      }
-      break;
-    case VTK_INT:
-      switch(inputScalars2_->GetDataType()){
-        vtkTemplateMacro(({ret=continuousScatterPlot.execute<int,VTK_TT>();}));
-      }
-      break;
-    case VTK_UNSIGNED_INT:
-      switch(inputScalars2_->GetDataType()){
-        vtkTemplateMacro(({ret=continuousScatterPlot.execute<unsigned int,VTK_TT>();}));
-      }
-      break;
-    case VTK_FLOAT:
-      switch(inputScalars2_->GetDataType()){
-        vtkTemplateMacro(({ret=continuousScatterPlot.execute<float,VTK_TT>();}));
-      }
-      break;
-    case VTK_DOUBLE:
-      switch(inputScalars2_->GetDataType()){
-        vtkTemplateMacro(({ret=continuousScatterPlot.execute<double,VTK_TT>();}));
-      }
-      break;
-  }
-
-#ifndef withKamikaze
-  // something wrong in baseCode
-  if(ret){
-    cerr << "[ttkContinuousScatterPlot] ContinuousScatterPlot.execute() error code : " << ret << endl;
-    return -6;
-  }
-#endif
-
-  vtkSmartPointer<vtkCharArray> maskScalars = 
-    vtkSmartPointer<vtkCharArray>::New();
-  if(maskScalars){
-    maskScalars->SetNumberOfComponents(1);
-    maskScalars->SetNumberOfTuples(numberOfPixels);
-    maskScalars->SetName("ValidPointMask");
+  // output geometry (the density and the mask are filled by updateImage())
+  maskScalars_=vtkSmartPointer<vtkCharArray>::New();
+  if(maskScalars_){
+    maskScalars_->SetNumberOfComponents(1);
+    maskScalars_->SetNumberOfTuples(numberOfPixels);
+    maskScalars_->SetName("ValidPointMask");
   }
 #ifndef withKamikaze
   // allocation problem
@@ -252,11 +222,11 @@ int ttkContinuousScatterPlot::doIt(vector<vtkDataSet *> &inputs,
   }
 #endif
 
-  vtkSmartPointer<vtkDoubleArray> densityScalars=vtkSmartPointer<vtkDoubleArray>::New();
-  if(densityScalars){
-    densityScalars->SetNumberOfComponents(1);
-    densityScalars->SetNumberOfTuples(numberOfPixels);
-    densityScalars->SetName("Density");
+  densityScalars_=vtkSmartPointer<vtkDoubleArray>::New();
+  if(densityScalars_){
+    densityScalars_->SetNumberOfComponents(1);
+    densityScalars_->SetNumberOfTuples(numberOfPixels);
+    densityScalars_->SetName("Density");
   }
 #ifndef withKamikaze
   // allocation problem
@@ -323,12 +293,7 @@ int ttkContinuousScatterPlot::doIt(vector<vtkDataSet *> &inputs,
       double y=imageMin[1]+j*imageDelta[1];
       pts_->SetPoint(id,x,y,0);
 
-      // scalars:
-      // valid mask
-      maskScalars->SetTuple1(id,validPointMask_[i][j]);
-      // density
-      densityScalars->SetTuple1(id,density_[i][j]);
-      // original scalar fields
+      // scalars: original scalar fields
       double d1=scalarMin_[0]+i*delta[0];
       double d2=scalarMin_[1]+j*delta[1];
       scalars1->SetTuple1(id,d1);
@@ -349,12 +314,85 @@ int ttkContinuousScatterPlot::doIt(vector<vtkDataSet *> &inputs,
     }
   }
   vtu_->SetPoints(pts_);
-  vtu_->GetPointData()->AddArray(maskScalars);
-  vtu_->GetPointData()->AddArray(densityScalars);
+  vtu_->GetPointData()->AddArray(maskScalars_);
+  vtu_->GetPointData()->AddArray(densityScalars_);
   vtu_->GetPointData()->AddArray(scalars1);
   vtu_->GetPointData()->AddArray(scalars2);
+  updateImage(density_, validPointMask_);
   output->ShallowCopy(vtu_);
 
+  // calling the executing package
+  ContinuousScatterPlot continuousScatterPlot;
+  continuousScatterPlot.setWrapper(this);
+  continuousScatterPlot.setVertexNumber(numberOfPoints);
+  continuousScatterPlot.setDummyValue(WithDummyValue, DummyValue);
+  continuousScatterPlot.setTriangulation(triangulation_);
+  continuousScatterPlot.setResolutions(ScatterplotResolution[0],ScatterplotResolution[1]);
+  continuousScatterPlot.setInputScalarField1(inputScalars1_->GetVoidPointer(0));
+  continuousScatterPlot.setInputScalarField2(inputScalars2_->GetVoidPointer(0));
+  continuousScatterPlot.setScalarMin(scalarMin_);
+  continuousScatterPlot.setScalarMax(scalarMax_);
+  continuousScatterPlot.setOutputDensity(&density_);
+  continuousScatterPlot.setOutputMask(&validPointMask_);
+  continuousScatterPlot.setProgressive(Progressive);
+  continuousScatterPlot.setProgressiveLevelNumber(ProgressiveLevelNumber);
+  continuousScatterPlot.setProgressiveErrorThreshold(
+    ProgressiveErrorThreshold);
+  continuousScatterPlot.setProgressiveSink(progressiveSink, this);
+  switch(inputScalars1_->GetDataType()){
+    case VTK_CHAR:
+      switch(inputScalars2_->GetDataType()){
+        vtkTemplateMacro(({ret=continuousScatterPlot.execute<char,VTK_TT>();}));
+      }
+      break;
+    case VTK_UNSIGNED_CHAR:
+      switch(inputScalars2_->GetDataType()){
+        vtkTemplateMacro(({ret=continuousScatterPlot.execute<unsigned char,VTK_TT>();}));
+      }
+      break;
+    case VTK_SHORT:
+      switch(inputScalars2_->GetDataType()){
+        vtkTemplateMacro(({ret=continuousScatterPlot.execute<short,VTK_TT>();}));
+      }
+      break;
+    case VTK_UNSIGNED_SHORT:
+      switch(inputScalars2_->GetDataType()){
+        vtkTemplateMacro(({ret=continuousScatterPlot.execute<unsigned short,VTK_TT>();}));
+      }
+      break;
+    case VTK_INT:
+      switch(inputScalars2_->GetDataType()){
+        vtkTemplateMacro(({ret=continuousScatterPlot.execute<int,VTK_TT>();}));
+      }
+      break;
+    case VTK_UNSIGNED_INT:
+      switch(inputScalars2_->GetDataType()){
+        vtkTemplateMacro(({ret=continuousScatterPlot.execute<unsigned int,VTK_TT>();}));
+      }
+      break;
+    case VTK_FLOAT:
+      switch(inputScalars2_->GetDataType()){
+        vtkTemplateMacro(({ret=continuousScatterPlot.execute<float,VTK_TT>();}));
+      }
+      break;
+    case VTK_DOUBLE:
+      switch(inputScalars2_->GetDataType()){
+        vtkTemplateMacro(({ret=continuousScatterPlot.execute<double,VTK_TT>();}));
+      }
+      break;
+  }
+
+#ifndef withKamikaze
+  // something wrong in baseCode
+  if(ret){
+    cerr << "[ttkContinuousScatterPlot] ContinuousScatterPlot.execute() error code : " << ret << endl;
+    return -6;
+  }
+#endif
+
+  // final image (the output shares the arrays of vtu_)
+  updateImage(density_, validPointMask_);
+
   {
     stringstream msg;
     msg << "[ttkContinuousScatterPlot] Memory usage: " << m.getElapsedUsage()
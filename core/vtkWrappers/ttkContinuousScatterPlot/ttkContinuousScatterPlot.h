@@ -11,6 +11,11 @@
 /// "Density") representing the continuous scatter plot (attached to the 
 /// 2D geometry as point data). A point mask is also attached to the 2D 
 /// geometry as point data.
+///
+/// In progressive mode, the density and the mask of the output are updated 
+/// in place after each refinement level and a progress event is emitted, 
+/// such that the observers of the filter can display the intermediate 
+/// images.
 /// 
 /// The components of the input bivariate data must be specified as independent
 /// scalar fields attached to the input geometry as point data.
@@ -100,6 +105,15 @@ class VTKFILTERSCORE_EXPORT ttkContinuousScatterPlot
     vtkSetMacro(ProjectImageSupport, bool);
     vtkGetMacro(ProjectImageSupport, bool);
 
+    vtkSetMacro(Progressive, bool);
+    vtkGetMacro(Progressive, bool);
+
+    vtkSetMacro(ProgressiveLevelNumber, int);
+    vtkGetMacro(ProgressiveLevelNumber, int);
+
+    vtkSetMacro(ProgressiveErrorThreshold, double);
+    vtkGetMacro(ProgressiveErrorThreshold, double);
+
     void SetScatterplotResolution(int N, int M){
       ScatterplotResolution[0]=N;
       ScatterplotResolution[1]=M;
@@ -124,10 +138,20 @@ class VTKFILTERSCORE_EXPORT ttkContinuousScatterPlot
     
   private:
 
+    static int progressiveSink(const vector<vector<double>>& density,
+      const vector<vector<char>>& mask, const double& processedRatio,
+      const double& error, void* sinkData);
+
+    int updateImage(const vector<vector<double>>& density,
+      const vector<vector<char>>& mask);
+
     bool WithVaryingConnectivity;
     bool WithDummyValue;
     double DummyValue;
     bool ProjectImageSupport;
+    bool Progressive;
+    int ProgressiveLevelNumber;
+    double ProgressiveErrorThreshold;
     int ScatterplotResolution[3];
     int UcomponentId, VcomponentId;
     string ScalarField1;
@@ -144,6 +168,8 @@ class VTKFILTERSCORE_EXPORT ttkContinuousScatterPlot
     // output
     vtkSmartPointer<vtkUnstructuredGrid> vtu_;
     vtkSmartPointer<vtkPoints> pts_;
+    vtkSmartPointer<vtkDoubleArray> densityScalars_;
+    vtkSmartPointer<vtkCharArray> maskScalars_;
     
 };
 
@@ -137,6 +137,7 @@ int ttkFiberSurface::doIt(vector<vtkDataSet *> &inputs,
     fiberSurface_.flushOctree();
     Modified();
   }
+  fiberSurface_.setOctreeFileName(OctreeFileName);
 #endif
   
   inputPolygon_.clear();
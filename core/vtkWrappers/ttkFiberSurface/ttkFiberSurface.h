@@ -115,6 +115,9 @@ class VTKFILTERSCORE_EXPORT ttkFiberSurface
     vtkGetMacro(RangeOctree, bool);
     vtkSetMacro(RangeOctree, bool);
     
+    vtkGetMacro(OctreeFileName, string);
+    vtkSetMacro(OctreeFileName, string);
+    
     vtkGetMacro(PointMergeDistanceThreshold, double);
     vtkSetMacro(PointMergeDistanceThreshold, double);
    
@@ -158,7 +161,8 @@ class VTKFILTERSCORE_EXPORT ttkFiberSurface
     double                PointMergeDistanceThreshold;
     
     string                DataUcomponent, DataVcomponent,
-                          PolygonUcomponent, PolygonVcomponent;
+                          PolygonUcomponent, PolygonVcomponent,
+                          OctreeFileName;
 
     // NOTE: we assume here that this guy is small and that making a copy from
     // VTK is not an issue.
@@ -1 +1,3 @@
-ttk_add_source("ttkMeshSubdivision.cpp")
+ttk_add_baseCode_package(vertexWelder)
+
+ttk_add_source("ttkMeshSubdivision.cpp")
\ No newline at end of file
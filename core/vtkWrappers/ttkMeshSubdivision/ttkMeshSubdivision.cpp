@@ -6,6 +6,7 @@ ttkMeshSubdivision::ttkMeshSubdivision(){
 
   // init
   IterationNumber = 1;
+  WeldVertices = false;
 }
 
 ttkMeshSubdivision::~ttkMeshSubdivision(){
@@ -452,16 +453,52 @@ int ttkMeshSubdivision::doIt(vtkUnstructuredGrid *input,
       cellData[j]->SetName(tmpGrid->GetCellData()->GetArray(j)->GetName());
     }
     
+    // weld the points duplicated by adjacent cells
+    vector<int> weldedIds;
+    int weldedPointNumber = 0;
+    if(WeldVertices){
+      
+      vector<double> points;
+      for(int j = 0; j < (int) newPoints.size(); j++){
+        for(int k = 0; k < (int) newPoints[j].size(); k++){
+          points.insert(points.end(), 
+            newPoints[j][k].begin(), newPoints[j][k].end());
+        }
+      }
+      
+      VertexWelder vertexWelder;
+      vertexWelder.setWrapper(this);
+      vertexWelder.setDistanceThreshold(
+        pow(10, -FLT_DIG)*tmpGrid->GetLength());
+      vertexWelder.setInputDataPointer(points.data());
+      vertexWelder.setVertexNumber(points.size()/3);
+      vertexWelder.execute<double>(weldedIds, weldedPointNumber);
+      
+      for(int j = 0; j < (int) newCells.size(); j++){
+        for(int k = 0; k < (int) newCells[j].size(); k++){
+          for(int l = 0; l < newCells[j][k]->GetNumberOfIds(); l++){
+            newCells[j][k]->SetId(l, weldedIds[newCells[j][k]->GetId(l)]);
+          }
+        }
+      }
+    }
+    
     // order is really important here
+    int pointId = 0;
     for(int j = 0; j < (int) newPoints.size(); j++){
       for(int k = 0; k < (int) newPoints[j].size(); k++){
+        
+        // only keep the first point of each welded vertex
+        if((WeldVertices)&&(weldedIds[pointId + k] 
+          != pointSet->GetNumberOfPoints()))
+          continue;
+        
         pointSet->InsertNextPoint(newPoints[j][k].data());
-      }
-      for(int k = 0; k < (int) newPointData[j].size(); k++){
         for(int l = 0; l < (int) newPointData[j][k].size(); l++){
           pointData[l]->InsertNextTuple1(newPointData[j][k][l]);
         }
       }
+      pointId += newPoints[j].size();
     }
     output->SetPoints(pointSet);
     for(int j = 0; j < (int) pointData.size(); j++){
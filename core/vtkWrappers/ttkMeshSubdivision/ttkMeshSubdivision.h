@@ -24,8 +24,9 @@
 /// and any 3D mesh into a hexadrehal mesh.
 /// 
 /// This filter assumes that all the cells of the input mesh are of the same 
-/// type. Also, the filter creates duplicate points, to be merged after the 
-/// fact with "Clean to Grid" under ParaView or vtkMergePoints for instance.
+/// type. Also, unless vertex welding is enabled (see SetWeldVertices()), the 
+/// filter creates duplicate points, to be merged after the fact with "Clean 
+/// to Grid" under ParaView or vtkMergePoints for instance.
 ///
 /// This filter can be used as any other VTK filter (for instance, by using the 
 /// sequence of calls SetInputData(), Update(), GetOutput()).
@@ -37,6 +38,7 @@
 #define _TTK_MESHSUBDIVISION_H
 
 // ttk code includes
+#include                  <VertexWelder.h>
 #include                  <Wrapper.h>
 
 // VTK includes -- to adapt
@@ -93,6 +95,9 @@ class VTKFILTERSCORE_EXPORT ttkMeshSubdivision
     vtkSetMacro(IterationNumber, int);
     vtkGetMacro(IterationNumber, int);
     
+    vtkSetMacro(WeldVertices, bool);
+    vtkGetMacro(WeldVertices, bool);
+    
     
   protected:
     
@@ -108,6 +113,7 @@ class VTKFILTERSCORE_EXPORT ttkMeshSubdivision
     
     bool                  UseAllCores;
     int                   ThreadNumber;
+    bool                  WeldVertices;
     int                   IterationNumber;
     
     // base code features
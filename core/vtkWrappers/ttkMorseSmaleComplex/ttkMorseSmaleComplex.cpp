@@ -7,6 +7,9 @@ vtkStandardNewMacro(ttkMorseSmaleComplex)
     InputOffsetScalarFieldName{"OutputOffsetScalarField"},
     UseInputOffsetScalarField{},
     IterationThreshold{-1},
+    UseHierarchy{},
+    HierarchyFileName{},
+    PersistenceThreshold{-1},
     ReverseSaddleMaximumConnection{true},
     ReverseSaddleSaddleConnection{true},
     ComputeAscendingSeparatrices1{true},
@@ -303,6 +306,10 @@ int ttkMorseSmaleComplex::doIt(vector<vtkDataSet *> &inputs,
 
   morseSmaleComplex_.setIterationThreshold(IterationThreshold);
 
+  morseSmaleComplex_.setUseHierarchy(UseHierarchy);
+  morseSmaleComplex_.setHierarchyFileName(HierarchyFileName);
+  morseSmaleComplex_.setPersistenceThreshold(PersistenceThreshold);
+
   morseSmaleComplex_.setReverseSaddleMaximumConnection(
       ReverseSaddleMaximumConnection);
 
@@ -668,47 +675,90 @@ int ttkMorseSmaleComplex::doIt(vector<vtkDataSet *> &inputs,
             isOnBoundary->SetNumberOfComponents(1);
             isOnBoundary->SetName("NumberOfCriticalPointsOnBoundary");
 
-            for(int i=0; i<separatrices1_numberOfPoints; ++i){
-              points->InsertNextPoint(separatrices1_points[3*i],
-                  separatrices1_points[3*i+1],
-                  separatrices1_points[3*i+2]);
-
-              smoothingMask->InsertNextTuple1(separatrices1_points_smoothingMask[i]);
-              cellDimensions->InsertNextTuple1(separatrices1_points_cellDimensions[i]);
-              cellIds->InsertNextTuple1(separatrices1_points_cellIds[i]);
-            }
-            outputSeparatrices1->SetPoints(points);
-
-            outputSeparatrices1->Allocate(separatrices1_numberOfCells);
-            int ptr{};
-            for(int i=0; i<separatrices1_numberOfCells; ++i){
-              vtkIdType line[2];
-              line[0]=separatrices1_cells[ptr+1];
-              line[1]=separatrices1_cells[ptr+2];
-
-              outputSeparatrices1->InsertNextCell(VTK_LINE, 2, line);
-
-              sourceIds->InsertNextTuple1(separatrices1_cells_sourceIds[i]);
+            // bulk copy of the flat arrays, released as soon as copied
+            points->SetNumberOfPoints(separatrices1_numberOfPoints);
+            std::copy(separatrices1_points.begin(), separatrices1_points.end(),
+                static_cast<float*>(points->GetVoidPointer(0)));
+            vector<float>().swap(separatrices1_points);
 
-              destinationIds->InsertNextTuple1(separatrices1_cells_destinationIds[i]);
+            smoothingMask->SetNumberOfTuples(separatrices1_numberOfPoints);
+            std::copy(separatrices1_points_smoothingMask.begin(),
+                separatrices1_points_smoothingMask.end(), smoothingMask->GetPointer(0));
+            vector<char>().swap(separatrices1_points_smoothingMask);
 
-              separatrixIds->InsertNextTuple1(separatrices1_cells_separatrixIds[i]);
+            cellDimensions->SetNumberOfTuples(separatrices1_numberOfPoints);
+            std::copy(separatrices1_points_cellDimensions.begin(),
+                separatrices1_points_cellDimensions.end(), cellDimensions->GetPointer(0));
+            vector<int>().swap(separatrices1_points_cellDimensions);
 
-              separatrixTypes->InsertNextTuple1(separatrices1_cells_separatrixTypes[i]);
+            cellIds->SetNumberOfTuples(separatrices1_numberOfPoints);
+            std::copy(separatrices1_points_cellIds.begin(),
+                separatrices1_points_cellIds.end(), cellIds->GetPointer(0));
+            vector<int>().swap(separatrices1_points_cellIds);
 
-              separatrixFunctionMaxima->InsertNextTuple1(
-                  separatrices1_cells_separatrixFunctionMaxima[i]);
-
-              separatrixFunctionMinima->InsertNextTuple1(
-                  separatrices1_cells_separatrixFunctionMinima[i]);
-
-              separatrixFunctionDiffs->InsertNextTuple1(
-                  separatrices1_cells_separatrixFunctionDiffs[i]);
-
-              isOnBoundary->InsertNextTuple1(separatrices1_cells_isOnBoundary[i]);
+            outputSeparatrices1->SetPoints(points);
 
-              ptr+=(separatrices1_cells[ptr]+1);
-            }
+            vtkSmartPointer<vtkIdTypeArray> connectivity=
+              vtkSmartPointer<vtkIdTypeArray>::New();
+            vtkSmartPointer<vtkCellArray> cells=
+              vtkSmartPointer<vtkCellArray>::New();
+#ifndef withKamikaze
+            if(!connectivity or !cells){
+              cerr << "[ttkMorseSmaleComplex] Error : vtkCellArray allocation "
+                << "problem." << endl;
+              return -31;
+            }
+#endif
+            connectivity->SetNumberOfTuples(separatrices1_cells.size());
+            std::copy(separatrices1_cells.begin(), separatrices1_cells.end(),
+                connectivity->GetPointer(0));
+            vector<int>().swap(separatrices1_cells);
+
+            cells->SetCells(separatrices1_numberOfCells, connectivity);
+            outputSeparatrices1->SetCells(VTK_LINE, cells);
+
+            sourceIds->SetNumberOfTuples(separatrices1_numberOfCells);
+            std::copy(separatrices1_cells_sourceIds.begin(),
+                separatrices1_cells_sourceIds.end(), sourceIds->GetPointer(0));
+            vector<int>().swap(separatrices1_cells_sourceIds);
+
+            destinationIds->SetNumberOfTuples(separatrices1_numberOfCells);
+            std::copy(separatrices1_cells_destinationIds.begin(),
+                separatrices1_cells_destinationIds.end(), destinationIds->GetPointer(0));
+            vector<int>().swap(separatrices1_cells_destinationIds);
+
+            separatrixIds->SetNumberOfTuples(separatrices1_numberOfCells);
+            std::copy(separatrices1_cells_separatrixIds.begin(),
+                separatrices1_cells_separatrixIds.end(), separatrixIds->GetPointer(0));
+            vector<int>().swap(separatrices1_cells_separatrixIds);
+
+            separatrixTypes->SetNumberOfTuples(separatrices1_numberOfCells);
+            std::copy(separatrices1_cells_separatrixTypes.begin(),
+                separatrices1_cells_separatrixTypes.end(), separatrixTypes->GetPointer(0));
+            vector<char>().swap(separatrices1_cells_separatrixTypes);
+
+            separatrixFunctionMaxima->SetNumberOfTuples(separatrices1_numberOfCells);
+            std::copy(separatrices1_cells_separatrixFunctionMaxima.begin(),
+                separatrices1_cells_separatrixFunctionMaxima.end(),
+                static_cast<VTK_TT*>(separatrixFunctionMaxima->GetVoidPointer(0)));
+            vector<VTK_TT>().swap(separatrices1_cells_separatrixFunctionMaxima);
+
+            separatrixFunctionMinima->SetNumberOfTuples(separatrices1_numberOfCells);
+            std::copy(separatrices1_cells_separatrixFunctionMinima.begin(),
+                separatrices1_cells_separatrixFunctionMinima.end(),
+                static_cast<VTK_TT*>(separatrixFunctionMinima->GetVoidPointer(0)));
+            vector<VTK_TT>().swap(separatrices1_cells_separatrixFunctionMinima);
+
+            separatrixFunctionDiffs->SetNumberOfTuples(separatrices1_numberOfCells);
+            std::copy(separatrices1_cells_separatrixFunctionDiffs.begin(),
+                separatrices1_cells_separatrixFunctionDiffs.end(),
+                static_cast<VTK_TT*>(separatrixFunctionDiffs->GetVoidPointer(0)));
+            vector<VTK_TT>().swap(separatrices1_cells_separatrixFunctionDiffs);
+
+            isOnBoundary->SetNumberOfTuples(separatrices1_numberOfCells);
+            std::copy(separatrices1_cells_isOnBoundary.begin(),
+                separatrices1_cells_isOnBoundary.end(), isOnBoundary->GetPointer(0));
+            vector<char>().swap(separatrices1_cells_isOnBoundary);
 
             vtkPointData* pointData=outputSeparatrices1->GetPointData();
 #ifndef withKamikaze
@@ -830,50 +880,78 @@ int ttkMorseSmaleComplex::doIt(vector<vtkDataSet *> &inputs,
             isOnBoundary->SetNumberOfComponents(1);
             isOnBoundary->SetName("NumberOfCriticalPointsOnBoundary");
 
-            for(int i=0; i<separatrices2_numberOfPoints; ++i){
-              points->InsertNextPoint(separatrices2_points[3*i],
-                  separatrices2_points[3*i+1],
-                  separatrices2_points[3*i+2]);
-            }
+            // bulk copy of the flat arrays, released as soon as copied
+            points->SetNumberOfPoints(separatrices2_numberOfPoints);
+            std::copy(separatrices2_points.begin(), separatrices2_points.end(),
+                static_cast<float*>(points->GetVoidPointer(0)));
+            vector<float>().swap(separatrices2_points);
+
             outputSeparatrices2->SetPoints(points);
 
-            outputSeparatrices2->Allocate(separatrices2_numberOfCells);
+            vector<int> cellTypes(separatrices2_numberOfCells);
             int ptr{};
             for(int i=0; i<separatrices2_numberOfCells; ++i){
-              const int vertexNumber=separatrices2_cells[ptr];
-
-              if(vertexNumber==3){
-                vtkIdType triangle[3];
-                triangle[0]=separatrices2_cells[ptr+1];
-                triangle[1]=separatrices2_cells[ptr+2];
-                triangle[2]=separatrices2_cells[ptr+3];
-
-                outputSeparatrices2->InsertNextCell(VTK_TRIANGLE, vertexNumber, triangle);
-              }
-              else{
-                vtkIdType ids[16];
-                for(int j=1; j<=vertexNumber; ++j)
-                  ids[j-1]=separatrices2_cells[ptr+j];
-
-                outputSeparatrices2->InsertNextCell(VTK_POLYGON, vertexNumber, ids);
-              }
-
-              sourceIds->InsertNextTuple1(separatrices2_cells_sourceIds[i]);
-              separatrixIds->InsertNextTuple1(separatrices2_cells_separatrixIds[i]);
-              separatrixTypes->InsertNextTuple1(separatrices2_cells_separatrixTypes[i]);
-              separatrixFunctionMaxima->InsertNextTuple1(
-                  separatrices2_cells_separatrixFunctionMaxima[i]);
-
-              separatrixFunctionMinima->InsertNextTuple1(
-                  separatrices2_cells_separatrixFunctionMinima[i]);
-
-              separatrixFunctionDiffs->InsertNextTuple1(
-                  separatrices2_cells_separatrixFunctionDiffs[i]);
-              isOnBoundary->InsertNextTuple1(separatrices2_cells_isOnBoundary[i]);
-
+              cellTypes[i]=(separatrices2_cells[ptr]==3)?VTK_TRIANGLE:VTK_POLYGON;
               ptr+=(separatrices2_cells[ptr]+1);
             }
 
+            vtkSmartPointer<vtkIdTypeArray> connectivity=
+              vtkSmartPointer<vtkIdTypeArray>::New();
+            vtkSmartPointer<vtkCellArray> cells=
+              vtkSmartPointer<vtkCellArray>::New();
+#ifndef withKamikaze
+            if(!connectivity or !cells){
+              cerr << "[ttkMorseSmaleComplex] Error : vtkCellArray allocation "
+                << "problem." << endl;
+              return -38;
+            }
+#endif
+            connectivity->SetNumberOfTuples(separatrices2_cells.size());
+            std::copy(separatrices2_cells.begin(), separatrices2_cells.end(),
+                connectivity->GetPointer(0));
+            vector<int>().swap(separatrices2_cells);
+
+            cells->SetCells(separatrices2_numberOfCells, connectivity);
+            outputSeparatrices2->SetCells(cellTypes.data(), cells);
+
+            sourceIds->SetNumberOfTuples(separatrices2_numberOfCells);
+            std::copy(separatrices2_cells_sourceIds.begin(),
+                separatrices2_cells_sourceIds.end(), sourceIds->GetPointer(0));
+            vector<int>().swap(separatrices2_cells_sourceIds);
+
+            separatrixIds->SetNumberOfTuples(separatrices2_numberOfCells);
+            std::copy(separatrices2_cells_separatrixIds.begin(),
+                separatrices2_cells_separatrixIds.end(), separatrixIds->GetPointer(0));
+            vector<int>().swap(separatrices2_cells_separatrixIds);
+
+            separatrixTypes->SetNumberOfTuples(separatrices2_numberOfCells);
+            std::copy(separatrices2_cells_separatrixTypes.begin(),
+                separatrices2_cells_separatrixTypes.end(), separatrixTypes->GetPointer(0));
+            vector<char>().swap(separatrices2_cells_separatrixTypes);
+
+            separatrixFunctionMaxima->SetNumberOfTuples(separatrices2_numberOfCells);
+            std::copy(separatrices2_cells_separatrixFunctionMaxima.begin(),
+                separatrices2_cells_separatrixFunctionMaxima.end(),
+                static_cast<VTK_TT*>(separatrixFunctionMaxima->GetVoidPointer(0)));
+            vector<VTK_TT>().swap(separatrices2_cells_separatrixFunctionMaxima);
+
+            separatrixFunctionMinima->SetNumberOfTuples(separatrices2_numberOfCells);
+            std::copy(separatrices2_cells_separatrixFunctionMinima.begin(),
+                separatrices2_cells_separatrixFunctionMinima.end(),
+                static_cast<VTK_TT*>(separatrixFunctionMinima->GetVoidPointer(0)));
+            vector<VTK_TT>().swap(separatrices2_cells_separatrixFunctionMinima);
+
+            separatrixFunctionDiffs->SetNumberOfTuples(separatrices2_numberOfCells);
+            std::copy(separatrices2_cells_separatrixFunctionDiffs.begin(),
+                separatrices2_cells_separatrixFunctionDiffs.end(),
+                static_cast<VTK_TT*>(separatrixFunctionDiffs->GetVoidPointer(0)));
+            vector<VTK_TT>().swap(separatrices2_cells_separatrixFunctionDiffs);
+
+            isOnBoundary->SetNumberOfTuples(separatrices2_numberOfCells);
+            std::copy(separatrices2_cells_isOnBoundary.begin(),
+                separatrices2_cells_isOnBoundary.end(), isOnBoundary->GetPointer(0));
+            vector<char>().swap(separatrices2_cells_isOnBoundary);
+
             vtkCellData* cellData=outputSeparatrices2->GetCellData();
 #ifndef withKamikaze
             if(!cellData){
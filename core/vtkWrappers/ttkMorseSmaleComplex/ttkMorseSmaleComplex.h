@@ -40,6 +40,7 @@
 #include<ttkWrapper.h>
 
 // VTK includes -- to adapt
+#include<vtkCellArray.h>
 #include<vtkCharArray.h>
 #include<vtkDataArray.h>
 #include<vtkDataSet.h>
@@ -47,6 +48,7 @@
 #include<vtkDoubleArray.h>
 #include<vtkFiltersCoreModule.h>
 #include<vtkFloatArray.h>
+#include<vtkIdTypeArray.h>
 #include<vtkInformation.h>
 #include<vtkInformationVector.h>
 #include<vtkIntArray.h>
@@ -96,6 +98,15 @@ class VTKFILTERSCORE_EXPORT ttkMorseSmaleComplex
     vtkSetMacro(IterationThreshold, int);
     vtkGetMacro(IterationThreshold, int);
 
+    vtkSetMacro(UseHierarchy, int);
+    vtkGetMacro(UseHierarchy, int);
+
+    vtkSetMacro(HierarchyFileName, string);
+    vtkGetMacro(HierarchyFileName, string);
+
+    vtkSetMacro(PersistenceThreshold, double);
+    vtkGetMacro(PersistenceThreshold, double);
+
     vtkSetMacro(ReverseSaddleMaximumConnection, int);
     vtkGetMacro(ReverseSaddleMaximumConnection, int);
 
@@ -145,6 +156,9 @@ class VTKFILTERSCORE_EXPORT ttkMorseSmaleComplex
     string InputOffsetScalarFieldName;
     bool UseInputOffsetScalarField;
     int IterationThreshold;
+    bool UseHierarchy;
+    string HierarchyFileName;
+    double PersistenceThreshold;
     bool ReverseSaddleMaximumConnection;
     bool ReverseSaddleSaddleConnection;
     bool ComputeAscendingSeparatrices1;
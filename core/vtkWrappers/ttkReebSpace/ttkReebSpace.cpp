@@ -77,6 +77,9 @@ template<class dataTypeU, class dataTypeV> int ttkReebSpace::baseCall(
     vField->GetVoidPointer(0));
   reebSpace_.setSosOffsetsU(&sosOffsetsU_);
   reebSpace_.setSosOffsetsV(&sosOffsetsV_);
+#ifdef withrangeDrivenOctree
+  reebSpace_.setOctreeFileName(OctreeFileName);
+#endif
     
   Triangulation *triangulation = ttkTriangulation::getTriangulation(input);
   
@@ -111,6 +111,9 @@ class VTKFILTERSCORE_EXPORT ttkReebSpace
     vtkGetMacro(UseOctreeAcceleration, bool);
     vtkSetMacro(UseOctreeAcceleration, bool);
     
+    vtkGetMacro(OctreeFileName, string);
+    vtkSetMacro(OctreeFileName, string);
+    
     vtkGetMacro(OffsetFieldU, string);
     vtkSetMacro(OffsetFieldU, string);
     
@@ -246,7 +249,8 @@ class VTKFILTERSCORE_EXPORT ttkReebSpace
     bool                  UseOctreeAcceleration;
     int                   SimplificationCriterion;
     double                SimplificationThreshold;
-    string                Ucomponent, Vcomponent, OffsetFieldU, OffsetFieldV;
+    string                Ucomponent, Vcomponent, OffsetFieldU, OffsetFieldV,
+                          OctreeFileName;
    
     vtkDataArray          *uComponent_, *vComponent_,
                           *offsetFieldU_, *offsetFieldV_;
@@ -9,6 +9,7 @@ ttkUncertainDataEstimator::ttkUncertainDataEstimator(){
   outputUpperBoundScalarField_ = NULL;
   outputProbabilityScalarField_ = NULL;
   outputMeanField_ = NULL;
+  outputVarianceField_ = NULL;
 
   UseAllCores = false;
 
@@ -31,6 +32,9 @@ ttkUncertainDataEstimator::~ttkUncertainDataEstimator(){
   if(outputMeanField_) {
     outputMeanField_->Delete();
   }
+  if(outputVarianceField_) {
+    outputVarianceField_->Delete();
+  }
 }
 
 
@@ -168,6 +172,13 @@ int ttkUncertainDataEstimator::doIt(vtkDataSet **input, vtkDataSet *outputBoundF
     outputMeanField_->FillComponent(0, 0.0);
   }
   outputMean->GetPointData()->AddArray(outputMeanField_);
+  if(!outputVarianceField_) {
+    outputVarianceField_ = vtkDoubleArray::New();
+    outputVarianceField_->SetNumberOfTuples(input[0]->GetNumberOfPoints());
+    outputVarianceField_->SetName("varianceField");
+    outputVarianceField_->FillComponent(0, 0.0);
+  }
+  outputMean->GetPointData()->AddArray(outputVarianceField_);
 
 
   // On the output, replace the field array by a pointer to its processed version
@@ -206,11 +217,6 @@ int ttkUncertainDataEstimator::doIt(vtkDataSet **input, vtkDataSet *outputBoundF
 
         uncertainDataEstimator.setVertexNumber(outputBoundFields->GetNumberOfPoints());
 
-        uncertainDataEstimator.setNumberOfInputs(numInputs);
-        for(int i=0 ; i<numInputs ; i++){
-          uncertainDataEstimator.setInputDataPointer(i, inputScalarField[i]->GetVoidPointer(0));
-        }
-
         uncertainDataEstimator.setComputeLowerBound(computeLowerBound_);
         uncertainDataEstimator.setComputeUpperBound(computeUpperBound_);
 
@@ -218,13 +224,37 @@ int ttkUncertainDataEstimator::doIt(vtkDataSet **input, vtkDataSet *outputBoundF
         uncertainDataEstimator.setOutputUpperBoundField(outputUpperBoundScalarField_->GetVoidPointer(0));
 
         uncertainDataEstimator.setOutputMeanField(outputMeanField_->GetVoidPointer(0));
+        uncertainDataEstimator.setOutputVarianceField(outputVarianceField_->GetVoidPointer(0));
 
         uncertainDataEstimator.setBinCount(binCount_);
         for(int b=0 ; b<binCount_ ; b++){
           uncertainDataEstimator.setOutputProbability(b, outputProbabilityScalarField_[b]->GetVoidPointer(0));
         }
 
-        uncertainDataEstimator.execute<VTK_TT>();
+        // the members are passed one at a time, then once more for the
+        // histograms (see UncertainDataEstimator::addRealization())
+        const bool computeHistograms = computeLowerBound_ && computeUpperBound_;
+        const int numberOfPasses = computeHistograms ? 2 : 1;
+        for(int i=0 ; i<numInputs ; i++){
+          if(needsToAbort())
+            break;
+          uncertainDataEstimator.addRealization<VTK_TT>(
+            inputScalarField[i]->GetVoidPointer(0));
+          updateProgress((i + 1.0)/(numberOfPasses*numInputs));
+        }
+        uncertainDataEstimator.finalize<VTK_TT>();
+
+        if(computeHistograms){
+          for(int i=0 ; i<numInputs ; i++){
+            if(needsToAbort())
+              break;
+            if(uncertainDataEstimator.addHistogramRealization<VTK_TT>(
+              inputScalarField[i]->GetVoidPointer(0)))
+              break;
+            updateProgress((numInputs + i + 1.0)/(2*numInputs));
+          }
+          uncertainDataEstimator.finalizeHistograms();
+        }
 
         for(int b=0 ; b<binCount_ ; b++){
           stringstream name;
@@ -14,7 +14,7 @@
 /// \param Output0 Lower and upper bound fields (vtkDataSet)
 /// \param Output1 Histogram estimations of the vertex probability density 
 /// functions (vtkDataSet)
-/// \param Output2 Mean field (vtkDataSet)
+/// \param Output2 Mean and variance fields (vtkDataSet)
 ///
 /// This filter can be used as any other VTK filter (for instance, by using the 
 /// sequence of calls SetInputData(), Update(), GetOutput()).
@@ -147,6 +147,7 @@ class VTKFILTERSCORE_EXPORT ttkUncertainDataEstimator
     vtkDataArray          *outputUpperBoundScalarField_;
     vtkDoubleArray        **outputProbabilityScalarField_;
     vtkDoubleArray        *outputMeanField_;
+    vtkDoubleArray        *outputVarianceField_;
 
     // base code features
     int doIt(vtkDataSet **input,
@@ -14,6 +14,8 @@ int main(int argc, char **argv) {
   // specify local parameters to the TTK module with default values.
   int scalarFieldId = 0, offsetFieldId = -1;
   bool plCompliantExtrema = true, plCompliantSaddles = false;
+  string hierarchyFileName;
+  double persistenceThreshold = -1;
 
   // register these arguments to the command line parser
   program.parser_.setArgument("F", &scalarFieldId,
@@ -24,6 +26,10 @@ int main(int argc, char **argv) {
     "PL-compliant extrema");
   program.parser_.setOption("plS", &plCompliantSaddles,
     "PL-compliant saddles");
+  program.parser_.setArgument("H", &hierarchyFileName,
+    "Gradient reversal hierarchy file (read or written)", true);
+  program.parser_.setArgument("P", &persistenceThreshold,
+    "Persistence threshold for the hierarchy replay", true);
   
   int ret = 0;
   ret = program.init(argc, argv);
@@ -37,6 +43,9 @@ int main(int argc, char **argv) {
   program.ttkObject_->SetOffsetFieldId(offsetFieldId);
   program.ttkObject_->SetReverseSaddleMaximumConnection(plCompliantExtrema);
   program.ttkObject_->SetReverseSaddleSaddleConnection(plCompliantSaddles);
+  program.ttkObject_->SetUseHierarchy(hierarchyFileName.length() > 0);
+  program.ttkObject_->SetHierarchyFileName(hierarchyFileName);
+  program.ttkObject_->SetPersistenceThreshold(persistenceThreshold);
   
   // execute data processing
   ret = program.run();
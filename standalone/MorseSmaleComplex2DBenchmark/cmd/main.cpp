@@ -0,0 +1,377 @@
+/// \author agent <agent@local>.
+/// \date October 2026.
+///
+/// \brief Command line benchmark for 2D Morse-Smale complex computation on
+/// large synthetic images (base code only, no VTK).
+///
+/// The complex (critical points, 1-separatrices and segmentations) is
+/// computed several times with the requested number of threads, which reuses
+/// the buffers across calls, and once with a single thread. All the outputs
+/// must be identical. Optionally, the segmentations are also checked
+/// against a sequential walk of the gradient paths of each vertex.
+
+// include the local headers
+#include                  <CommandLineParser.h>
+#include                  <Hash.h>
+#include                  <MorseSmaleComplex.h>
+
+using namespace ttk;
+
+struct ComplexOutput{
+
+  int criticalPoints_numberOfPoints;
+  vector<float> criticalPoints_points;
+  vector<int> criticalPoints_points_cellDimensions;
+  vector<int> criticalPoints_points_cellIds;
+  vector<float> criticalPoints_points_cellScalars;
+  vector<char> criticalPoints_points_isOnBoundary;
+  vector<int> criticalPoints_points_PLVertexIdentifiers;
+  vector<int> criticalPoints_points_manifoldSize;
+
+  int separatrices1_numberOfPoints;
+  vector<float> separatrices1_points;
+  vector<char> separatrices1_points_smoothingMask;
+  vector<int> separatrices1_points_cellDimensions;
+  vector<int> separatrices1_points_cellIds;
+  int separatrices1_numberOfCells;
+  vector<int> separatrices1_cells;
+  vector<int> separatrices1_cells_sourceIds;
+  vector<int> separatrices1_cells_destinationIds;
+  vector<int> separatrices1_cells_separatrixIds;
+  vector<char> separatrices1_cells_separatrixTypes;
+  vector<float> separatrices1_cells_separatrixFunctionMaxima;
+  vector<float> separatrices1_cells_separatrixFunctionMinima;
+  vector<float> separatrices1_cells_separatrixFunctionDiffs;
+  vector<char> separatrices1_cells_isOnBoundary;
+
+  vector<int> ascendingManifold;
+  vector<int> descendingManifold;
+  vector<int> morseSmaleManifold;
+};
+
+template <class dataType>
+  unsigned long long addVector(const unsigned long long &key,
+    const vector<dataType> &array, const int &threadNumber){
+
+  unsigned long long arrayKey = Hash::addValue(key, array.size());
+  return Hash::addArrays(arrayKey, {{array.data(), sizeof(dataType)}},
+    array.size(), threadNumber);
+}
+
+unsigned long long getOutputKey(const ComplexOutput &output,
+  const int &threadNumber){
+
+  unsigned long long key = Hash::getBasis();
+
+  key = Hash::addValue(key, output.criticalPoints_numberOfPoints);
+  key = addVector(key, output.criticalPoints_points, threadNumber);
+  key = addVector(key, output.criticalPoints_points_cellDimensions,
+    threadNumber);
+  key = addVector(key, output.criticalPoints_points_cellIds, threadNumber);
+  key = addVector(key, output.criticalPoints_points_cellScalars,
+    threadNumber);
+  key = addVector(key, output.criticalPoints_points_isOnBoundary,
+    threadNumber);
+  key = addVector(key, output.criticalPoints_points_PLVertexIdentifiers,
+    threadNumber);
+  key = addVector(key, output.criticalPoints_points_manifoldSize,
+    threadNumber);
+
+  key = Hash::addValue(key, output.separatrices1_numberOfPoints);
+  key = addVector(key, output.separatrices1_points, threadNumber);
+  key = addVector(key, output.separatrices1_points_smoothingMask,
+    threadNumber);
+  key = addVector(key, output.separatrices1_points_cellDimensions,
+    threadNumber);
+  key = addVector(key, output.separatrices1_points_cellIds, threadNumber);
+  key = Hash::addValue(key, output.separatrices1_numberOfCells);
+  key = addVector(key, output.separatrices1_cells, threadNumber);
+  key = addVector(key, output.separatrices1_cells_sourceIds, threadNumber);
+  key = addVector(key, output.separatrices1_cells_destinationIds,
+    threadNumber);
+  key = addVector(key, output.separatrices1_cells_separatrixIds,
+    threadNumber);
+  key = addVector(key, output.separatrices1_cells_separatrixTypes,
+    threadNumber);
+  key = addVector(key, output.separatrices1_cells_separatrixFunctionMaxima,
+    threadNumber);
+  key = addVector(key, output.separatrices1_cells_separatrixFunctionMinima,
+    threadNumber);
+  key = addVector(key, output.separatrices1_cells_separatrixFunctionDiffs,
+    threadNumber);
+  key = addVector(key, output.separatrices1_cells_isOnBoundary,
+    threadNumber);
+
+  key = addVector(key, output.ascendingManifold, threadNumber);
+  key = addVector(key, output.descendingManifold, threadNumber);
+  key = addVector(key, output.morseSmaleManifold, threadNumber);
+
+  return key;
+}
+
+int computeComplex(MorseSmaleComplex &morseSmaleComplex,
+  const int &threadNumber, ComplexOutput &output, double &time){
+
+  morseSmaleComplex.setThreadNumber(threadNumber);
+
+  // the critical points are appended to their arrays (as with the fresh
+  // arrays of ttkMorseSmaleComplex), clearing them keeps their capacity
+  output.criticalPoints_points.clear();
+  output.criticalPoints_points_cellDimensions.clear();
+  output.criticalPoints_points_cellIds.clear();
+  output.criticalPoints_points_cellScalars.clear();
+  output.criticalPoints_points_isOnBoundary.clear();
+  output.criticalPoints_points_PLVertexIdentifiers.clear();
+  output.criticalPoints_points_manifoldSize.clear();
+
+  morseSmaleComplex.setOutputCriticalPoints(
+    &output.criticalPoints_numberOfPoints,
+    &output.criticalPoints_points,
+    &output.criticalPoints_points_cellDimensions,
+    &output.criticalPoints_points_cellIds,
+    &output.criticalPoints_points_cellScalars,
+    &output.criticalPoints_points_isOnBoundary,
+    &output.criticalPoints_points_PLVertexIdentifiers,
+    &output.criticalPoints_points_manifoldSize);
+
+  morseSmaleComplex.setOutputSeparatrices1(
+    &output.separatrices1_numberOfPoints,
+    &output.separatrices1_points,
+    &output.separatrices1_points_smoothingMask,
+    &output.separatrices1_points_cellDimensions,
+    &output.separatrices1_points_cellIds,
+    &output.separatrices1_numberOfCells,
+    &output.separatrices1_cells,
+    &output.separatrices1_cells_sourceIds,
+    &output.separatrices1_cells_destinationIds,
+    &output.separatrices1_cells_separatrixIds,
+    &output.separatrices1_cells_separatrixTypes,
+    &output.separatrices1_cells_separatrixFunctionMaxima,
+    &output.separatrices1_cells_separatrixFunctionMinima,
+    &output.separatrices1_cells_separatrixFunctionDiffs,
+    &output.separatrices1_cells_isOnBoundary);
+
+  morseSmaleComplex.setOutputMorseComplexes(
+    output.ascendingManifold.data(),
+    output.descendingManifold.data(),
+    output.morseSmaleManifold.data());
+
+  Timer t;
+
+  int ret = morseSmaleComplex.execute<float>();
+
+  time = t.getElapsedTime();
+
+  return ret;
+}
+
+// sequential reference : each vertex follows its gradient paths (ascending
+// from its first star triangle, descending from itself) to an extremum
+int checkSegmentation(Triangulation &triangulation,
+  vector<float> &scalars, vector<int> &offsets,
+  const bool &reverseSaddleMaximumConnection,
+  const bool &reverseSaddleSaddleConnection,
+  const ComplexOutput &output){
+
+  DiscreteGradient discreteGradient;
+  discreteGradient.setDebugLevel(0);
+  discreteGradient.setupTriangulation(&triangulation);
+  discreteGradient.setInputScalarField(scalars.data());
+  discreteGradient.setInputOffsets(offsets.data());
+  discreteGradient.setReverseSaddleMaximumConnection(
+    reverseSaddleMaximumConnection);
+  discreteGradient.setReverseSaddleSaddleConnection(
+    reverseSaddleSaddleConnection);
+  discreteGradient.buildGradient<float>();
+  discreteGradient.reverseGradient<float>();
+
+  // the extrema are numbered by order of appearance
+  vector<Cell> criticalPoints;
+  discreteGradient.getCriticalPoints(criticalPoints);
+
+  vector<int> minimumIds(triangulation.getNumberOfVertices(), -1);
+  vector<int> maximumIds(triangulation.getNumberOfCells(), -1);
+  int minimumNumber = 0, maximumNumber = 0;
+  for(int i = 0; i < (int) criticalPoints.size(); i++){
+    if(criticalPoints[i].dim_ == 0)
+      minimumIds[criticalPoints[i].id_] = minimumNumber++;
+    else if(criticalPoints[i].dim_ == 2)
+      maximumIds[criticalPoints[i].id_] = maximumNumber++;
+  }
+
+  int mismatchNumber = 0;
+  vector<Cell> vpath;
+  for(int i = 0; i < triangulation.getNumberOfVertices(); i++){
+
+    int starId;
+    triangulation.getVertexStar(i, 0, starId);
+
+    vpath.clear();
+    discreteGradient.getAscendingPath(Cell(2, starId), vpath);
+    int ascendingId = -1;
+    if((vpath.size())&&(vpath.back().dim_ == 2))
+      ascendingId = maximumIds[vpath.back().id_];
+
+    vpath.clear();
+    discreteGradient.getDescendingPath(Cell(0, i), vpath);
+    int descendingId = -1;
+    if((vpath.size())&&(vpath.back().dim_ == 0))
+      descendingId = minimumIds[vpath.back().id_];
+
+    if((output.ascendingManifold[i] != ascendingId)
+      ||(output.descendingManifold[i] != descendingId))
+      mismatchNumber++;
+  }
+
+  return mismatchNumber;
+}
+
+int main(int argc, char **argv) {
+
+  CommandLineParser parser;
+
+  // specify local parameters with default values.
+  int size = 16384, runNumber = 3, seed = 0;
+  bool plCompliantExtrema = true, plCompliantSaddles = false,
+    checkPaths = false;
+
+  // register these arguments to the command line parser
+  parser.setArgument("n", &size, "Image size (n x n vertices)", true);
+  parser.setArgument("r", &runNumber, "Number of timed runs", true);
+  parser.setArgument("s", &seed, "Random seed of the noise", true);
+  parser.setOption("plE", &plCompliantExtrema, "PL-compliant extrema");
+  parser.setOption("plS", &plCompliantSaddles, "PL-compliant saddles");
+  parser.setOption("c", &checkPaths,
+    "Check the segmentations against sequential gradient path walks");
+
+  parser.parse(argc, argv);
+
+  const int threadNumber = parser.getThreadNumber();
+
+  // the benchmark reports are printed whatever the global debug level
+  Debug debug;
+
+  if((size < 2)||(runNumber < 1)){
+    parser.printUsage(argv[0]);
+    return -1;
+  }
+
+  // synthetic terrain : a few bumps per side plus random heights on a coarse
+  // lattice (one node every latticeStep vertices), bilinearly interpolated
+  Triangulation triangulation;
+  triangulation.setInputGrid(0, 0, 0, 1, 1, 1, size, size, 1);
+
+  const int vertexNumber = size*size;
+  vector<float> scalars(vertexNumber);
+  vector<int> offsets(vertexNumber);
+  {
+    const int latticeStep = 32;
+    const int latticeSize = (size - 1)/latticeStep + 2;
+    vector<float> lattice(latticeSize*latticeSize);
+    srand(seed);
+    for(int i = 0; i < (int) lattice.size(); i++)
+      lattice[i] = rand()/(float) RAND_MAX;
+
+    const double frequency = 2*M_PI*8/size;
+#ifdef withOpenMP
+#pragma omp parallel for num_threads(threadNumber)
+#endif
+    for(int i = 0; i < vertexNumber; i++){
+      const int x = i%size, y = i/size;
+      const int u = x/latticeStep, v = y/latticeStep;
+      const double s = (x%latticeStep)/(double) latticeStep,
+        t = (y%latticeStep)/(double) latticeStep;
+      const double noise =
+        (1 - t)*((1 - s)*lattice[v*latticeSize + u]
+          + s*lattice[v*latticeSize + u + 1])
+        + t*((1 - s)*lattice[(v + 1)*latticeSize + u]
+          + s*lattice[(v + 1)*latticeSize + u + 1]);
+
+      scalars[i] = sin(frequency*x)*cos(frequency*y) + 0.5*noise;
+      offsets[i] = i;
+    }
+  }
+
+  MorseSmaleComplex morseSmaleComplex;
+  morseSmaleComplex.setDebugLevel(globalDebugLevel_);
+  morseSmaleComplex.setupTriangulation(&triangulation);
+  morseSmaleComplex.setReverseSaddleMaximumConnection(plCompliantExtrema);
+  morseSmaleComplex.setReverseSaddleSaddleConnection(plCompliantSaddles);
+  morseSmaleComplex.setComputeAscendingSeparatrices1(true);
+  morseSmaleComplex.setComputeDescendingSeparatrices1(true);
+  morseSmaleComplex.setComputeAscendingSegmentation(true);
+  morseSmaleComplex.setComputeDescendingSegmentation(true);
+  morseSmaleComplex.setComputeFinalSegmentation(true);
+  morseSmaleComplex.setInputScalarField(scalars.data());
+  morseSmaleComplex.setInputOffsets(offsets.data());
+
+  ComplexOutput output;
+  output.ascendingManifold.resize(vertexNumber);
+  output.descendingManifold.resize(vertexNumber);
+  output.morseSmaleManifold.resize(vertexNumber);
+
+  int ret = 0;
+  double time = 0, minTime = -1;
+  unsigned long long referenceKey = 0;
+  bool isIdentical = true;
+
+  // timed runs, the buffers of the complex are reused across calls
+  for(int i = 0; i < runNumber; i++){
+    ret = computeComplex(morseSmaleComplex, threadNumber, output, time);
+    if(ret != 0)
+      return ret;
+
+    const unsigned long long key = getOutputKey(output, threadNumber);
+    if(!i)
+      referenceKey = key;
+    else if(key != referenceKey)
+      isIdentical = false;
+
+    if((minTime < 0)||(time < minTime))
+      minTime = time;
+
+    stringstream msg;
+    msg << "[MorseSmaleComplex2DBenchmark] Run #" << i << ": " << time
+      << " s. (" << threadNumber << " thread(s))." << endl;
+    debug.dMsg(cout, msg.str(), Debug::timeMsg);
+  }
+
+  // sequential run
+  double sequentialTime = 0;
+  ret = computeComplex(morseSmaleComplex, 1, output, sequentialTime);
+  if(ret != 0)
+    return ret;
+  if(getOutputKey(output, threadNumber) != referenceKey)
+    isIdentical = false;
+
+  int mismatchNumber = 0;
+  if(checkPaths){
+    mismatchNumber = checkSegmentation(triangulation, scalars, offsets,
+      plCompliantExtrema, plCompliantSaddles, output);
+  }
+
+  {
+    stringstream msg;
+    msg << "[MorseSmaleComplex2DBenchmark] " << size << "x" << size
+      << " image: " << output.criticalPoints_numberOfPoints
+      << " critical point(s), " << output.separatrices1_numberOfCells
+      << " separatrix cell(s)." << endl;
+    msg << "[MorseSmaleComplex2DBenchmark] Best run: " << minTime
+      << " s. (" << threadNumber << " thread(s)), 1 thread: "
+      << sequentialTime << " s." << endl;
+    msg << "[MorseSmaleComplex2DBenchmark] Outputs "
+      << (isIdentical ? "identical" : "DIFFER")
+      << " across runs and thread numbers." << endl;
+    if(checkPaths){
+      msg << "[MorseSmaleComplex2DBenchmark] " << mismatchNumber
+        << " vertex(ices) with a segmentation different from their "
+        << "gradient paths." << endl;
+    }
+    debug.dMsg(cout, msg.str(), Debug::infoMsg);
+  }
+
+  if((!isIdentical)||(mismatchNumber))
+    return -2;
+
+  return 0;
+}
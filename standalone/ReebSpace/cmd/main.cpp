@@ -16,6 +16,7 @@ int main(int argc, char **argv) {
   double threshold = 0;
   int criterion = 0;
   int uId = 0, vId = 1;
+  string octreeFileName;
   
   // register these arguments to the command line parser
   program.parser_.setArgument("s", &threshold,
@@ -27,6 +28,8 @@ int main(int argc, char **argv) {
     "Identifier of the u-component field", true);
   program.parser_.setArgument("v", &vId, 
     "Identifier of the v-component field", true);
+  program.parser_.setArgument("O", &octreeFileName,
+    "Range driven octree file (read or written)", true);
   
   int ret = program.init(argc, argv);
  
@@ -39,6 +42,7 @@ int main(int argc, char **argv) {
   program.ttkObject_->SetVcomponentId(vId);
   program.ttkObject_->SetSimplificationCriterion(criterion);
   program.ttkObject_->SetSimplificationThreshold(threshold);
+  program.ttkObject_->SetOctreeFileName(octreeFileName);
   
   // execute data processing
   ret = program.run();